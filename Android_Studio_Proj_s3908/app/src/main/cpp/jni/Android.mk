@@ -1,4 +1,42 @@
 LOCAL_PATH := $(call my-dir)
+
+# C files shared by the jni library and the command-line runner
+SYNA_CORE_SRC_FILES := err_msg_ctrl.c \
+                       syna_dev_manager.c \
+                       rmi_control.c \
+                       rmi_identify.c \
+                       rmi_report_access.c \
+                       rmi_production_test.c \
+                       rmi_touch_data.c \
+                       tcm_control.c \
+                       tcm_identify.c \
+                       tcm_report_access.c \
+                       tcm_production_test.c \
+                       tcm_touch_data.c \
+                       tcm_flash_access.c \
+                       extended_high_resistance.c \
+                       syna_capture_file.c \
+                       syna_frame_codec.c \
+                       syna_limit_store.c \
+                       syna_ref_store.c \
+                       syna_test_job.c \
+                       syna_raw_script.c \
+                       syna_bus_trace.c \
+                       syna_frame_latency.c \
+                       syna_image_stream.c \
+                       syna_drift_tracker.c \
+                       syna_touch_classifier.c \
+                       syna_blob.c
+
+# the heatmap renderer and the config diff are vectorized with NEON on armeabi-v7a
+ifeq ($(TARGET_ARCH_ABI),armeabi-v7a)
+SYNA_CORE_SRC_FILES += syna_heatmap.c.neon \
+                       syna_config_diff.c.neon
+else
+SYNA_CORE_SRC_FILES += syna_heatmap.c \
+                       syna_config_diff.c
+endif
+
 include $(CLEAR_VARS)
 
 # give module name
@@ -6,21 +44,32 @@ LOCAL_MODULE    := native_syna
 
 # list your C files to compile
 LOCAL_SRC_FILES := native_syna_lib.c \
-                   err_msg_ctrl.c \
-                   syna_dev_manager.c \
-                   rmi_control.c \
-                   rmi_identify.c \
-                   rmi_report_access.c \
-                   rmi_production_test.c \
-                   rmi_touch_data.c \
-                   tcm_control.c \
-                   tcm_identify.c \
-                   tcm_report_access.c \
-                   tcm_production_test.c \
-                   tcm_touch_data.c \
-                   tcm_flash_access.c \
-                   extended_high_resistance.c
+                   $(SYNA_CORE_SRC_FILES)
 
 LOCAL_LDLIBS    := -L$(SYSROOT)/usr/lib -llog
 
 include $(BUILD_SHARED_LIBRARY)
+
+include $(CLEAR_VARS)
+
+# standalone runner, push to device and run by adb shell
+LOCAL_MODULE    := syna_cli
+
+LOCAL_SRC_FILES := syna_cli.c \
+                   $(SYNA_CORE_SRC_FILES)
+
+LOCAL_LDLIBS    := -L$(SYSROOT)/usr/lib -llog
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+# micro-benchmark of the frame, test and analysis kernels, run by adb shell
+LOCAL_MODULE    := syna_bench
+
+LOCAL_SRC_FILES := syna_bench.c \
+                   $(SYNA_CORE_SRC_FILES)
+
+LOCAL_LDLIBS    := -L$(SYSROOT)/usr/lib -llog
+
+include $(BUILD_EXECUTABLE)
@@ -26,11 +26,26 @@
  * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
  */
 #include <jni.h>
+#include <errno.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "native_syna_lib.h"
 #include "syna_dev_manager.h"
+#include "syna_capture_file.h"
+#include "syna_frame_codec.h"
+#include "syna_limit_store.h"
+#include "syna_ref_store.h"
+#include "syna_test_job.h"
+#include "syna_config_diff.h"
+#include "syna_raw_script.h"
+#include "syna_frame_latency.h"
+#include "syna_heatmap.h"
+#include "syna_image_stream.h"
+#include "syna_drift_tracker.h"
+#include "syna_touch_classifier.h"
+#include "syna_blob.h"
 
 #ifdef SAVE_ERR_MSG
 #include "err_msg_ctrl.h"
@@ -53,6 +68,37 @@ jint JNI_OnLoad(JavaVM* vm, void* reserved)
 
     return JNI_VERSION_1_6;
 }
+/*
+ * Function:  check_device_busy
+ * --------------------
+ * helper function to check whether the device is occupied by the test job
+ * or by the image stream, the device must not be accessed from java then
+ *
+ * return: -EBUSY, the device is busy
+ *         otherwise, the device is available
+ */
+static int check_device_busy(const char *func)
+{
+    const char *owner = NULL;
+#ifdef SAVE_ERR_MSG
+    char err[MAX_ERR_STRING_LEN];
+#endif
+
+    if (syna_job_is_running())
+        owner = "test job";
+    else if (syna_image_stream_is_running())
+        owner = "image stream";
+
+    if (!owner)
+        return 0;
+
+    printf_e("%s error: device is busy, %s is running\n", func, owner);
+#ifdef SAVE_ERR_MSG
+    sprintf(err, "%s error: device is busy, %s is running\n", func, owner);
+    add_error_msg(err);
+#endif
+    return -EBUSY;
+}
 /*
  * Function:  getNumErrMsgJNI
  * --------------------
@@ -193,11 +239,69 @@ JNIEXPORT jboolean JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWr
     g_jni_env = env;
     g_jni_obj = obj;
 
+    if (check_device_busy(__FUNCTION__) < 0)
+        return (jboolean)false;
+
     /* close synaptics device interface */
     syna_close_dev(g_dev_node);
 
     return (jboolean) true;
 }
+/*
+ * Function:  startBusTraceJNI
+ * --------------------
+ * record all transactions of the device into the trace file,
+ * call before openSynaDevJNI to replay the session from the beginning
+ */
+JNIEXPORT jboolean JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_startBusTraceJNI(
+        JNIEnv *env, jobject obj, jstring trace_path)
+{
+    int retval;
+    const char *str_trace_path;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if (!trace_path) {
+        printf_e("%s error: invalid parameter\n", __FUNCTION__);
+        return (jboolean) false;
+    }
+
+    if (check_device_busy(__FUNCTION__) < 0)
+        return (jboolean) false;
+
+    str_trace_path = (*env)->GetStringUTFChars(env, trace_path, NULL);
+
+    retval = syna_start_bus_trace(str_trace_path);
+    if (retval < 0) {
+        printf_e("%s error: fail to start the trace, %s\n", __FUNCTION__, str_trace_path);
+    }
+
+    (*env)->ReleaseStringUTFChars(env, trace_path, str_trace_path);
+
+    return (jboolean) (retval >= 0);
+}
+/*
+ * Function:  stopBusTraceJNI
+ * --------------------
+ * stop the recording
+ *
+ * return: number of transactions recorded, -EBUSY if the test job or
+ *         the image stream is running, or <0 if failed
+ */
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_stopBusTraceJNI(
+        JNIEnv *env, jobject obj)
+{
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if (check_device_busy(__FUNCTION__) < 0)
+        return -EBUSY;
+
+    return syna_stop_bus_trace();
+}
 /*
  * Function:  doDevPreparationJNI
  * --------------------
@@ -212,6 +316,9 @@ JNIEXPORT jboolean JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWr
     g_jni_env = env;
     g_jni_obj = obj;
 
+    if (check_device_busy(__FUNCTION__) < 0)
+        return (jboolean)false;
+
     retval = syna_do_preparation(do_nosleep, do_rezero);
     if (retval < 0) {
         printf_e("%s error: fail to do preparation", __FUNCTION__);
@@ -327,6 +434,20 @@ JNIEXPORT jint JNICALL Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper
 
     return syna_get_num_force_elecs();
 }
+/*
+ * Function:  getResetLatencyJNI
+ * --------------------
+ * retrieve the latency of the last sw reset, in micro-seconds
+ */
+JNIEXPORT jint JNICALL Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_getResetLatencyJNI(
+        JNIEnv *env, jobject obj)
+{
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    return syna_get_reset_latency();
+}
 /*
  * Function:  getProductIDJNI
  * --------------------
@@ -378,6 +499,9 @@ JNIEXPORT jboolean JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWr
     g_jni_env = env;
     g_jni_obj = obj;
 
+    if (check_device_busy(__FUNCTION__) < 0)
+        return (jboolean)false;
+
     printf_i("%s info: enable the report\n", __FUNCTION__);
 
     /* enable the requested report */
@@ -404,6 +528,9 @@ JNIEXPORT jboolean JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWr
     g_jni_env = env;
     g_jni_obj = obj;
 
+    if (check_device_busy(__FUNCTION__) < 0)
+        return (jboolean)false;
+
     printf_i("%s info: disable the report\n", __FUNCTION__);
 
     /* disable the requested report */
@@ -434,6 +561,12 @@ JNIEXPORT jboolean JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWr
     g_jni_env = env;
     g_jni_obj = obj;
 
+    if (check_device_busy(__FUNCTION__) < 0)
+        return (jboolean)false;
+
+    /* tag the frame to trace the latency of each stage */
+    syna_frame_latency_begin();
+
     /* retrieve a short array from java layer */
     native_array = (*env)->GetIntArrayElements(env, array, &isCopy);
     len_data_array = (*env)->GetArrayLength(env, array);
@@ -455,487 +588,1992 @@ JNIEXPORT jboolean JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWr
 
     /* release the java array */
     (*env)->ReleaseIntArrayElements(env, array, native_array, 0);
+
+    /* the frame is handed off to java */
+    syna_frame_latency_end();
+
     return (jboolean)true;
 }
-
 /*
- * Function:  runProductionTestJNI
+ * Function:  getFrameLatencyJNI
  * --------------------
- * perform the specific production testing
- * based on the variable, item
+ * get the percentile of the frame latency, in micro-seconds,
+ * over the latest frames requested by requestReportImageJNI
  *
- * return  0, pass
- *        >0, number of failure
- *        <0, error out
+ * return: <0, no frame is traced
+ *         otherwise, the latency
  */
-JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_runProductionTestJNI(
-        JNIEnv *env, jobject obj, jint item, jint col, jint row,
-        jintArray limit_1, jint limit_1_size, jintArray limit_2, jint limit_2_size,
-        jintArray result, jint result_size)
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_getFrameLatencyJNI(
+        JNIEnv *env, jobject obj, jint latency, jint percent)
 {
-    int retval;
-    int *native_limit_1 = NULL;
-    int *native_limit_2 = NULL;
-    int *native_result = NULL;
-    jsize len_array;
-    jboolean isCopy;
-
     /* save JNIEnv */
     g_jni_env = env;
     g_jni_obj = obj;
 
-    /* get a array of test limit parameter 1 from java layer */
-    if (limit_1_size > 0) {
-        native_limit_1 = (*env)->GetIntArrayElements(env, limit_1, &isCopy);
-        len_array = (*env)->GetArrayLength(env, limit_1);
-        if ((len_array <= 0) || (len_array !=  limit_1_size)) {
-            printf_e("%s error: invalid parameter. (limit_1_size = %d, len_array = %d)\n",
-                     __FUNCTION__, limit_1_size, len_array);
-            retval = -10;
-            goto exit;
-        }
-    }
-    /* get a array of test limit parameter 2 from java layer */
-    if (limit_2_size > 0) {
-        native_limit_2 = (*env)->GetIntArrayElements(env, limit_2, &isCopy);
-        len_array = (*env)->GetArrayLength(env, limit_2);
-        if ((len_array <= 0) || (len_array !=  limit_2_size)) {
-            printf_e("%s error: invalid parameter. (limit_2_size = %d, len_array = %d)\n",
-                     __FUNCTION__, limit_2_size, len_array);
-            retval = -10;
-            goto exit;
-        }
-    }
+    return (jint)syna_frame_latency_get_percentile((enum syna_frame_latency)latency, (int)percent);
+}
+/*
+ * Function:  getFrameLatencyReportJNI
+ * --------------------
+ * get the statistics of the frame latency
+ *
+ * return: "<stage>,<frames>,<p50>,<p90>,<p99>,<max>" per line
+ *         or null if no frame is traced
+ */
+JNIEXPORT jstring JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_getFrameLatencyReportJNI(
+        JNIEnv *env, jobject obj)
+{
+    char report[SYNA_FRAME_LATENCY_REPORT_LEN];
 
-    /* get a int array from java layer */
-    if (result_size > 0) {
-        native_result = (*env)->GetIntArrayElements(env, result, &isCopy);
-        len_array = (*env)->GetArrayLength(env, result);
-        if (len_array != result_size) {
-            retval = -10;
-            goto exit;
-        }
-    }
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
 
-    /* call function to perform the requested production test */
-    retval = syna_run_test_entry(item, native_result, result_size, col, row,
-                                 native_limit_1, limit_1_size, native_limit_2, limit_2_size);
-    if (retval < 0) {
-        printf_e("%s error: fail to run production test, test item (0x%x) \n", __FUNCTION__, item);
-    }
+    if (syna_frame_latency_report(report, sizeof(report)) <= 0)
+        return NULL;
 
-exit:
-    if (limit_1_size > 0)
-        (*env)->ReleaseIntArrayElements(env, limit_1, native_limit_1, 0);
-    if (limit_2_size > 0)
-        (*env)->ReleaseIntArrayElements(env, limit_2, native_limit_2, 0);
-    if (result_size > 0)
-        (*env)->ReleaseIntArrayElements(env, result, native_result, 0);
+    return (*env)->NewStringUTF(env, report);
+}
+/*
+ * Function:  resetFrameLatencyJNI
+ * --------------------
+ * clear the statistics of the frame latency
+ */
+JNIEXPORT void JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_resetFrameLatencyJNI(
+        JNIEnv *env, jobject obj)
+{
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
 
-    return retval;
+    syna_frame_latency_reset();
 }
 
 /*
- * Function:  runProductionTestExHighResistanceJNI
+ * Function:  startImageStreamJNI
  * --------------------
- * perform the extended high resistance test
- *
- * return  0, pass
- *        >0, number of failure
- *        <0, error out
+ * start to acquire the report images in the native thread,
+ * the frames are taken by the recorder and the preview at their own rate
+ * this function should be called after startReportJNI
  */
-JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_runProductionTestExHighResistanceJNI(
-        JNIEnv *env, jobject obj, jint jcols, jint jrows, jshortArray jref_frame,
-        jint jlimit_surface, jint jlimit_txroe, jint jlimit_rxroe,
-        jintArray jresult, jint jsize_result, jintArray jresult_txroe, jintArray jsize_result_txroe,
-        jintArray jresult_rxroe, jintArray jsize_result_rxroe)
+JNIEXPORT jboolean JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_startImageStreamJNI(
+        JNIEnv *env, jobject obj, jbyte type, jint row, jint col, jint frame_size,
+        jint recorder_depth, jint capture_stream)
 {
     int retval;
-    short *ref_frame_array = NULL;
-    int *result_array = NULL;
-    int *result_txroe_array = NULL;
-    int *result_rxroe_array = NULL;
-    int *size_txroe_array = NULL;
-    int *size_rxroe_array = NULL;
-    jsize len_array;
-    jboolean isCopy;
 
     /* save JNIEnv */
     g_jni_env = env;
     g_jni_obj = obj;
 
-    /* get a short array, reference frame, from java layer */
-    ref_frame_array = (*env)->GetShortArrayElements(env, jref_frame, &isCopy);
-    len_array = (*env)->GetArrayLength(env, jref_frame);
-    if (len_array <= 0) {
-        printf_e("%s error: invalid parameter. (len_array = %d)\n", __FUNCTION__, len_array);
-        retval = -10;
-        goto exit;
-    }
-
-    /* get a int array from java layer */
-    if (jsize_result > 0) {
-        result_array = (*env)->GetIntArrayElements(env, jresult, &isCopy);
-        len_array = (*env)->GetArrayLength(env, jresult);
-        if (len_array != jsize_result) {
-            printf_e("%s error: invalid parameter. (jresult_size = %d, len_array = %d)\n",
-                     __FUNCTION__, jsize_result, len_array);
-            retval = -10;
-            goto exit;
-        }
-    }
-    result_txroe_array = (*env)->GetIntArrayElements(env, jresult_txroe, &isCopy);
-    len_array = (*env)->GetArrayLength(env, jresult_txroe);
-    if (len_array < 0) {
-        printf_e("%s error: invalid parameter. (jresult_txroe = %d)\n", __FUNCTION__, len_array);
-        retval = -10;
-        goto exit;
-    }
-    result_rxroe_array = (*env)->GetIntArrayElements(env, jresult_rxroe, &isCopy);
-    len_array = (*env)->GetArrayLength(env, jresult_rxroe);
-    if (len_array < 0) {
-        printf_e("%s error: invalid parameter. (jresult_rxroe = %d)\n", __FUNCTION__, len_array);
-        retval = -10;
-        goto exit;
-    }
-
-    size_txroe_array = (*env)->GetIntArrayElements(env, jsize_result_txroe, &isCopy);
-    len_array = (*env)->GetArrayLength(env, jsize_result_txroe);
-    if (len_array < 0) {
-        printf_e("%s error: invalid parameter. (jsize_result_txroe = %d)\n", __FUNCTION__, len_array);
-        retval = -10;
-        goto exit;
-    }
-
-    size_rxroe_array = (*env)->GetIntArrayElements(env, jsize_result_rxroe, &isCopy);
-    len_array = (*env)->GetArrayLength(env, jsize_result_rxroe);
-    if (len_array < 0) {
-        printf_e("%s error: invalid parameter. (jsize_result_rxroe = %d)\n", __FUNCTION__, len_array);
+    if (check_device_busy(__FUNCTION__) < 0)
         return (jboolean)false;
-    }
 
-    /* call function to perform the requested production test */
-    retval = syna_run_test_ex_high_resistance_entry(result_array, jsize_result,
-                                                    result_txroe_array, size_txroe_array,
-                                                    result_rxroe_array, size_rxroe_array,
-                                                    ref_frame_array, jcols, jrows,
-                                                    jlimit_surface, jlimit_txroe, jlimit_rxroe);
+    retval = syna_image_stream_start((unsigned char)type, (int)col, (int)row, (int)frame_size,
+                                     (int)recorder_depth, (int)capture_stream);
     if (retval < 0) {
-        printf_e("%s error: fail to run extended high resistance test\n", __FUNCTION__);
+        printf_e("%s error: fail to start the image stream\n", __FUNCTION__);
+        return (jboolean)false;
     }
-exit:
-    (*env)->ReleaseShortArrayElements(env, jref_frame, ref_frame_array, 0);
-    (*env)->ReleaseIntArrayElements(env, jresult, result_array, 0);
-    (*env)->ReleaseIntArrayElements(env, jresult_txroe, result_txroe_array, 0);
-    (*env)->ReleaseIntArrayElements(env, jresult_rxroe, result_rxroe_array, 0);
-    (*env)->ReleaseIntArrayElements(env, jsize_result_txroe, size_txroe_array, 0);
-    (*env)->ReleaseIntArrayElements(env, jsize_result_rxroe, size_rxroe_array, 0);
-    return retval;
-}
 
+    return (jboolean)true;
+}
 /*
- * Function:  runProductionTestExTRxShortJNI
+ * Function:  stopImageStreamJNI
  * --------------------
- * perform the extended trx short test
+ * stop the acquisition of the report images
  *
- * return  0, pass
- *        >0, number of failure
- *        <0, error out
+ * return: <0, the acquisition was stopped by an error
+ *         otherwise, the number of frames acquired
  */
-JNIEXPORT jint JNICALL Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_runProductionTestExTRxShortJNI(
-        JNIEnv *env, jobject obj, jintArray jlimit, jint jsize_limit, jintArray jlimit_ex_pin,
-        jint jsize_limit_ex_pin, jintArray jresult_data, jint jsize_result_data,
-        jintArray jresult_data_ex_pin, jint jsize_result_data_ex_pin,
-        jintArray jresult_pin, jint jsize_result_pin)
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_stopImageStreamJNI(
+        JNIEnv *env, jobject obj)
 {
-    int retval;
-    int *native_limit = NULL;
-    int *native_limit_ex_pin = NULL;
-    int *native_result_data = NULL;
-    int *native_result_data_ex_pin = NULL;
-    int *native_result_pin = NULL;
-    jsize len_array;
-    jboolean isCopy;
-
     /* save JNIEnv */
     g_jni_env = env;
     g_jni_obj = obj;
 
-    /* get an array of test limit from java layer */
-    if (jsize_limit > 0) {
-        native_limit = (*env)->GetIntArrayElements(env, jlimit, &isCopy);
-        len_array = (*env)->GetArrayLength(env, jlimit);
-        if ((len_array <= 0) || (len_array !=  jsize_limit)) {
-            printf_e("%s: invalid parameter. (jsize_limit = %d, array_len = %d)\n",
-                     __FUNCTION__, jsize_limit, len_array);
-            retval = -10;
-            goto exit;
-        }
+    return (jint)syna_image_stream_stop();
+}
+/*
+ * Function:  setStreamPreviewJNI
+ * --------------------
+ * configure the frame handed to the preview
+ */
+JNIEXPORT jboolean JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_setStreamPreviewJNI(
+        JNIEnv *env, jobject obj, jint mode, jint num_frames, jint interval_ms)
+{
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    return (jboolean)(syna_image_stream_set_preview((int)mode, (int)num_frames, (int)interval_ms) == 0);
+}
+/*
+ * Function:  readStreamRecorderJNI
+ * --------------------
+ * take the next frame for the recorder
+ *
+ * return: <0, the stream is stopped or error out
+ *         0, no frame in time
+ *         otherwise, the number of data copied
+ */
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_readStreamRecorderJNI(
+        JNIEnv *env, jobject obj, jintArray array, jint timeout_ms)
+{
+    int retval;
+    jint *native_array;
+    jsize len_array;
+
+    if (!array)
+        return -EINVAL;
+
+    len_array = (*env)->GetArrayLength(env, array);
+    native_array = (*env)->GetIntArrayElements(env, array, NULL);
+
+    retval = syna_image_stream_read_recorder(native_array, len_array, (int)timeout_ms);
+
+    /* the java array is updated only if a frame is taken */
+    (*env)->ReleaseIntArrayElements(env, array, native_array, (retval > 0) ? 0 : JNI_ABORT);
+
+    /* no frame in time is not an error */
+    if (retval == -ETIMEDOUT)
+        retval = 0;
+
+    return retval;
+}
+/*
+ * Function:  readStreamPreviewJNI
+ * --------------------
+ * take the frame for the preview
+ *
+ * return: <0, the stream is stopped or error out
+ *         0, no frame in time
+ *         otherwise, the number of frames represented by the preview
+ */
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_readStreamPreviewJNI(
+        JNIEnv *env, jobject obj, jintArray array, jint timeout_ms)
+{
+    int retval;
+    jint *native_array;
+    jsize len_array;
+
+    if (!array)
+        return -EINVAL;
+
+    len_array = (*env)->GetArrayLength(env, array);
+    native_array = (*env)->GetIntArrayElements(env, array, NULL);
+
+    retval = syna_image_stream_read_preview(native_array, len_array, (int)timeout_ms);
+
+    /* the java array is updated only if a frame is taken */
+    (*env)->ReleaseIntArrayElements(env, array, native_array, (retval > 0) ? 0 : JNI_ABORT);
+
+    /* no frame in time is not an error */
+    if (retval == -ETIMEDOUT)
+        retval = 0;
+
+    return retval;
+}
+/*
+ * Function:  getImageStreamStatsJNI
+ * --------------------
+ * copy the counters of the image stream
+ *
+ * return: <0, invalid parameter
+ *         otherwise, the number of counters copied
+ */
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_getImageStreamStatsJNI(
+        JNIEnv *env, jobject obj, jintArray stats)
+{
+    int retval;
+    jint *native_stats;
+    jsize len_array;
+
+    if (!stats)
+        return -EINVAL;
+
+    len_array = (*env)->GetArrayLength(env, stats);
+    native_stats = (*env)->GetIntArrayElements(env, stats, NULL);
+
+    retval = syna_image_stream_get_stats(native_stats, len_array);
+
+    (*env)->ReleaseIntArrayElements(env, stats, native_stats, 0);
+
+    return retval;
+}
+/*
+ * Function:  startDriftTrackerJNI
+ * --------------------
+ * start to track the baseline drift of the frames acquired by the image stream
+ * the snapshots are appended to log_path, which could be null
+ *
+ * return: <0, fail to start the tracker
+ *         otherwise, succeed
+ */
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_startDriftTrackerJNI(
+        JNIEnv *env, jobject obj, jint col, jint row, jintArray tau_ms, jint warmup_frames,
+        jint snapshot_interval_ms, jint threshold, jint event_tau_index, jstring log_path)
+{
+    int retval;
+    jint *native_tau;
+    jsize len_array;
+    const char *str_log_path = NULL;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if (!tau_ms) {
+        printf_e("%s error: invalid parameter\n", __FUNCTION__);
+        return -EINVAL;
     }
 
-    /* get an array of test limit for extended pins from java layer */
-    if (jsize_limit_ex_pin > 0) {
-        native_limit_ex_pin = (*env)->GetIntArrayElements(env, jlimit_ex_pin, &isCopy);
-        len_array = (*env)->GetArrayLength(env, jlimit_ex_pin);
-        if ((len_array <= 0) || (len_array !=  jsize_limit_ex_pin)) {
-            printf_e("%s: invalid parameter. (jsize_limit_ex_pin = %d, array_len = %d)\n",
-                     __FUNCTION__, jsize_limit_ex_pin, len_array);
-            retval = -10;
-            goto exit;
-        }
+    len_array = (*env)->GetArrayLength(env, tau_ms);
+    native_tau = (*env)->GetIntArrayElements(env, tau_ms, NULL);
+    if (log_path)
+        str_log_path = (*env)->GetStringUTFChars(env, log_path, NULL);
+
+    retval = syna_drift_start(col, row, native_tau, len_array, warmup_frames,
+                              snapshot_interval_ms, threshold, event_tau_index, str_log_path);
+    if (retval < 0) {
+        printf_e("%s error: fail to start the drift tracker\n", __FUNCTION__);
     }
 
-    /* get an int array of test result data from java layer */
-    if (jsize_result_data > 0) {
-        native_result_data = (*env)->GetIntArrayElements(env, jresult_data, &isCopy);
-        len_array = (*env)->GetArrayLength(env, jresult_data);
-        if (len_array != jsize_result_data) {
-            printf_e("%s: invalid parameter. (jsize_result_data = %d, len_array = %d)\n",
-                     __FUNCTION__, jsize_result_data, len_array);
+    (*env)->ReleaseIntArrayElements(env, tau_ms, native_tau, JNI_ABORT);
+    if (log_path)
+        (*env)->ReleaseStringUTFChars(env, log_path, str_log_path);
+
+    return retval;
+}
+/*
+ * Function:  stopDriftTrackerJNI
+ * --------------------
+ * stop the drift tracker
+ *
+ * return: <0, the tracker is not running
+ *         otherwise, the number of frames tracked
+ */
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_stopDriftTrackerJNI(
+        JNIEnv *env, jobject obj)
+{
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    return syna_drift_stop();
+}
+/*
+ * Function:  readDriftSnapshotJNI
+ * --------------------
+ * take the oldest drift snapshot, wait for up to timeout_ms
+ *
+ * return: <0, the tracker is stopped
+ *         0, no snapshot in time
+ *         otherwise, the number of data copied
+ */
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_readDriftSnapshotJNI(
+        JNIEnv *env, jobject obj, jintArray array, jint timeout_ms)
+{
+    int retval;
+    jint *native_array;
+    jsize len_array;
+
+    if (!array)
+        return -EINVAL;
+
+    len_array = (*env)->GetArrayLength(env, array);
+    native_array = (*env)->GetIntArrayElements(env, array, NULL);
+
+    retval = syna_drift_read_snapshot(native_array, len_array, (int)timeout_ms);
+
+    (*env)->ReleaseIntArrayElements(env, array, native_array, (retval > 0) ? 0 : JNI_ABORT);
+
+    /* no snapshot in time is not an error */
+    if (retval == -ETIMEDOUT)
+        retval = 0;
+
+    return retval;
+}
+/*
+ * Function:  waitDriftEventJNI
+ * --------------------
+ * wait for up to timeout_ms for the event that the drift exceeds the threshold
+ *
+ * return: <0, the tracker is stopped
+ *         0, no event in time
+ *         otherwise, the number of data copied
+ */
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_waitDriftEventJNI(
+        JNIEnv *env, jobject obj, jintArray array, jint timeout_ms)
+{
+    int retval;
+    jint *native_array;
+    jsize len_array;
+
+    if (!array)
+        return -EINVAL;
+
+    len_array = (*env)->GetArrayLength(env, array);
+    native_array = (*env)->GetIntArrayElements(env, array, NULL);
+
+    retval = syna_drift_wait_event(native_array, len_array, (int)timeout_ms);
+
+    (*env)->ReleaseIntArrayElements(env, array, native_array, (retval > 0) ? 0 : JNI_ABORT);
+
+    /* no event in time is not an error */
+    if (retval == -ETIMEDOUT)
+        retval = 0;
+
+    return retval;
+}
+/*
+ * Function:  getDriftFrameJNI
+ * --------------------
+ * copy the current drift of every tixel at the time constant
+ *
+ * return: <0, the drift is not available
+ *         otherwise, the number of data copied
+ */
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_getDriftFrameJNI(
+        JNIEnv *env, jobject obj, jint tau_index, jintArray array)
+{
+    int retval;
+    jint *native_array;
+    jsize len_array;
+
+    if (!array)
+        return -EINVAL;
+
+    len_array = (*env)->GetArrayLength(env, array);
+    native_array = (*env)->GetIntArrayElements(env, array, NULL);
+
+    retval = syna_drift_get_frame(tau_index, native_array, len_array);
+
+    (*env)->ReleaseIntArrayElements(env, array, native_array, (retval > 0) ? 0 : JNI_ABORT);
+
+    return retval;
+}
+
+/*
+ * Function:  initTouchClassifierJNI
+ * --------------------
+ * initialize the classifier of delta frames, threshold 0 is to learn
+ * the touch threshold from the noise of untouched frames
+ *
+ * return: <0, fail to initialize
+ *         otherwise, succeed
+ */
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_initTouchClassifierJNI(
+        JNIEnv *env, jobject obj, jint col, jint row, jint threshold, jint stable_frames,
+        jint stable_distance, jint stable_percent, jint settle_frames)
+{
+    return syna_touch_classifier_init(col, row, threshold, stable_frames,
+                                      stable_distance, stable_percent, settle_frames);
+}
+
+/*
+ * Function:  classifyTouchFrameJNI
+ * --------------------
+ * classify one delta frame, and copy the information of frame to info
+ *
+ * return: <0, fail to classify
+ *         otherwise, the class of frame
+ */
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_classifyTouchFrameJNI(
+        JNIEnv *env, jobject obj, jintArray frame, jintArray info)
+{
+    int retval;
+    jint *native_frame;
+    jint *native_info = NULL;
+    jsize len_frame;
+    jsize len_info = 0;
+
+    if (!frame)
+        return -EINVAL;
+
+    len_frame = (*env)->GetArrayLength(env, frame);
+    native_frame = (*env)->GetIntArrayElements(env, frame, NULL);
+
+    if (info) {
+        len_info = (*env)->GetArrayLength(env, info);
+        native_info = (*env)->GetIntArrayElements(env, info, NULL);
+    }
+
+    retval = syna_touch_classifier_classify(native_frame, len_frame, native_info, len_info);
+
+    if (native_info)
+        (*env)->ReleaseIntArrayElements(env, info, native_info, (retval >= 0) ? 0 : JNI_ABORT);
+
+    (*env)->ReleaseIntArrayElements(env, frame, native_frame, JNI_ABORT);
+
+    return retval;
+}
+
+/*
+ * Function:  detectBlobsJNI
+ * --------------------
+ * find the connected blobs of the delta frame, the peak, area and
+ * centroid of blobs are copied to blobs in descending order of the peak
+ *
+ * return: <0, fail to detect
+ *         otherwise, the number of blobs found
+ */
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_detectBlobsJNI(
+        JNIEnv *env, jobject obj, jintArray frame, jint col, jint row, jint threshold,
+        jint low_threshold, jint min_area, jintArray blobs)
+{
+    int retval;
+    jint *native_frame;
+    jint *native_blobs = NULL;
+    jsize len_blobs = 0;
+
+    if (!frame)
+        return -EINVAL;
+
+    if ((*env)->GetArrayLength(env, frame) < col * row)
+        return -EINVAL;
+
+    native_frame = (*env)->GetIntArrayElements(env, frame, NULL);
+
+    if (blobs) {
+        len_blobs = (*env)->GetArrayLength(env, blobs);
+        native_blobs = (*env)->GetIntArrayElements(env, blobs, NULL);
+    }
+
+    retval = syna_blob_detect(native_frame, col, row, threshold, low_threshold, min_area,
+                              native_blobs, len_blobs);
+
+    if (native_blobs)
+        (*env)->ReleaseIntArrayElements(env, blobs, native_blobs, (retval > 0) ? 0 : JNI_ABORT);
+
+    (*env)->ReleaseIntArrayElements(env, frame, native_frame, JNI_ABORT);
+
+    return retval;
+}
+
+/*
+ * Function:  runProductionTestJNI
+ * --------------------
+ * perform the specific production testing
+ * based on the variable, item
+ *
+ * return  0, pass
+ *        >0, number of failure
+ *        <0, error out
+ */
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_runProductionTestJNI(
+        JNIEnv *env, jobject obj, jint item, jint col, jint row,
+        jintArray limit_1, jint limit_1_size, jintArray limit_2, jint limit_2_size,
+        jintArray result, jint result_size)
+{
+    int retval;
+    int *native_limit_1 = NULL;
+    int *native_limit_2 = NULL;
+    int *native_result = NULL;
+    jsize len_array;
+    jboolean isCopy;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if (check_device_busy(__FUNCTION__) < 0)
+        return -EBUSY;
+
+    /* get a array of test limit parameter 1 from java layer */
+    if (limit_1_size > 0) {
+        native_limit_1 = (*env)->GetIntArrayElements(env, limit_1, &isCopy);
+        len_array = (*env)->GetArrayLength(env, limit_1);
+        if ((len_array <= 0) || (len_array !=  limit_1_size)) {
+            printf_e("%s error: invalid parameter. (limit_1_size = %d, len_array = %d)\n",
+                     __FUNCTION__, limit_1_size, len_array);
             retval = -10;
             goto exit;
         }
     }
-
-    /* get an int array of test result data ex pin from java layer */
-    if (jsize_result_data_ex_pin > 0) {
-        native_result_data_ex_pin = (*env)->GetIntArrayElements(env, jresult_data_ex_pin, &isCopy);
-        len_array = (*env)->GetArrayLength(env, jresult_data_ex_pin);
-        if (len_array != jsize_result_data_ex_pin) {
-            printf_e("%s: invalid parameter. (jsize_result_data_ex_pin = %d, len_array = %d)\n",
-                     __FUNCTION__, jsize_result_data_ex_pin, len_array);
+    /* get a array of test limit parameter 2 from java layer */
+    if (limit_2_size > 0) {
+        native_limit_2 = (*env)->GetIntArrayElements(env, limit_2, &isCopy);
+        len_array = (*env)->GetArrayLength(env, limit_2);
+        if ((len_array <= 0) || (len_array !=  limit_2_size)) {
+            printf_e("%s error: invalid parameter. (limit_2_size = %d, len_array = %d)\n",
+                     __FUNCTION__, limit_2_size, len_array);
             retval = -10;
             goto exit;
         }
     }
 
-    /* get an int array of pin result from java layer */
-    if (jsize_result_pin > 0) {
-        native_result_pin = (*env)->GetIntArrayElements(env, jresult_pin, &isCopy);
-        len_array = (*env)->GetArrayLength(env, jresult_pin);
-        if (len_array != jsize_result_pin) {
-            printf_e("%s: invalid parameter. (jsize_result_pin = %d, len_array = %d)\n",
-                     __FUNCTION__, jsize_result_pin, len_array);
+    /* get a int array from java layer */
+    if (result_size > 0) {
+        native_result = (*env)->GetIntArrayElements(env, result, &isCopy);
+        len_array = (*env)->GetArrayLength(env, result);
+        if (len_array != result_size) {
             retval = -10;
             goto exit;
         }
     }
 
-    retval = syna_run_test_ex_trx_short_entry(native_result_data, jsize_result_data,
-                                              native_result_data_ex_pin, jsize_result_data_ex_pin,
-                                              native_result_pin, jsize_result_pin,
-                                              native_limit, jsize_limit,
+    /* call function to perform the requested production test */
+    retval = syna_run_test_entry(item, native_result, result_size, col, row,
+                                 native_limit_1, limit_1_size, native_limit_2, limit_2_size);
+    if (retval < 0) {
+        printf_e("%s error: fail to run production test, test item (0x%x) \n", __FUNCTION__, item);
+    }
+
+exit:
+    if (limit_1_size > 0)
+        (*env)->ReleaseIntArrayElements(env, limit_1, native_limit_1, 0);
+    if (limit_2_size > 0)
+        (*env)->ReleaseIntArrayElements(env, limit_2, native_limit_2, 0);
+    if (result_size > 0)
+        (*env)->ReleaseIntArrayElements(env, result, native_result, 0);
+
+    return retval;
+}
+
+/*
+ * Function:  runProductionTestExHighResistanceJNI
+ * --------------------
+ * perform the extended high resistance test
+ * if ref_frame is null, the reference frame in the reference store is used
+ *
+ * return  0, pass
+ *        >0, number of failure
+ *        <0, error out
+ */
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_runProductionTestExHighResistanceJNI(
+        JNIEnv *env, jobject obj, jint jcols, jint jrows, jshortArray jref_frame,
+        jint jlimit_surface, jint jlimit_txroe, jint jlimit_rxroe,
+        jintArray jresult, jint jsize_result, jintArray jresult_txroe, jintArray jsize_result_txroe,
+        jintArray jresult_rxroe, jintArray jsize_result_rxroe)
+{
+    int retval;
+    short *ref_frame_array = NULL;
+    int *result_array = NULL;
+    int *result_txroe_array = NULL;
+    int *result_rxroe_array = NULL;
+    int *size_txroe_array = NULL;
+    int *size_rxroe_array = NULL;
+    jsize len_array;
+    jboolean isCopy;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if (check_device_busy(__FUNCTION__) < 0)
+        return -EBUSY;
+
+    /* get a short array, reference frame, from java layer */
+    if (jref_frame) {
+        ref_frame_array = (*env)->GetShortArrayElements(env, jref_frame, &isCopy);
+        len_array = (*env)->GetArrayLength(env, jref_frame);
+        if (len_array <= 0) {
+            printf_e("%s error: invalid parameter. (len_array = %d)\n", __FUNCTION__, len_array);
+            retval = -10;
+            goto exit;
+        }
+    }
+
+    /* get a int array from java layer */
+    if (jsize_result > 0) {
+        result_array = (*env)->GetIntArrayElements(env, jresult, &isCopy);
+        len_array = (*env)->GetArrayLength(env, jresult);
+        if (len_array != jsize_result) {
+            printf_e("%s error: invalid parameter. (jresult_size = %d, len_array = %d)\n",
+                     __FUNCTION__, jsize_result, len_array);
+            retval = -10;
+            goto exit;
+        }
+    }
+    result_txroe_array = (*env)->GetIntArrayElements(env, jresult_txroe, &isCopy);
+    len_array = (*env)->GetArrayLength(env, jresult_txroe);
+    if (len_array < 0) {
+        printf_e("%s error: invalid parameter. (jresult_txroe = %d)\n", __FUNCTION__, len_array);
+        retval = -10;
+        goto exit;
+    }
+    result_rxroe_array = (*env)->GetIntArrayElements(env, jresult_rxroe, &isCopy);
+    len_array = (*env)->GetArrayLength(env, jresult_rxroe);
+    if (len_array < 0) {
+        printf_e("%s error: invalid parameter. (jresult_rxroe = %d)\n", __FUNCTION__, len_array);
+        retval = -10;
+        goto exit;
+    }
+
+    size_txroe_array = (*env)->GetIntArrayElements(env, jsize_result_txroe, &isCopy);
+    len_array = (*env)->GetArrayLength(env, jsize_result_txroe);
+    if (len_array < 0) {
+        printf_e("%s error: invalid parameter. (jsize_result_txroe = %d)\n", __FUNCTION__, len_array);
+        retval = -10;
+        goto exit;
+    }
+
+    size_rxroe_array = (*env)->GetIntArrayElements(env, jsize_result_rxroe, &isCopy);
+    len_array = (*env)->GetArrayLength(env, jsize_result_rxroe);
+    if (len_array < 0) {
+        printf_e("%s error: invalid parameter. (jsize_result_rxroe = %d)\n", __FUNCTION__, len_array);
+        return (jboolean)false;
+    }
+
+    /* call function to perform the requested production test */
+    retval = syna_run_test_ex_high_resistance_entry(result_array, jsize_result,
+                                                    result_txroe_array, size_txroe_array,
+                                                    result_rxroe_array, size_rxroe_array,
+                                                    ref_frame_array, jcols, jrows,
+                                                    jlimit_surface, jlimit_txroe, jlimit_rxroe);
+    if (retval < 0) {
+        printf_e("%s error: fail to run extended high resistance test\n", __FUNCTION__);
+    }
+exit:
+    if (jref_frame)
+        (*env)->ReleaseShortArrayElements(env, jref_frame, ref_frame_array, JNI_ABORT);
+    (*env)->ReleaseIntArrayElements(env, jresult, result_array, 0);
+    (*env)->ReleaseIntArrayElements(env, jresult_txroe, result_txroe_array, 0);
+    (*env)->ReleaseIntArrayElements(env, jresult_rxroe, result_rxroe_array, 0);
+    (*env)->ReleaseIntArrayElements(env, jsize_result_txroe, size_txroe_array, 0);
+    (*env)->ReleaseIntArrayElements(env, jsize_result_rxroe, size_rxroe_array, 0);
+    return retval;
+}
+
+/*
+ * Function:  runProductionTestExTRxShortJNI
+ * --------------------
+ * perform the extended trx short test
+ *
+ * return  0, pass
+ *        >0, number of failure
+ *        <0, error out
+ */
+JNIEXPORT jint JNICALL Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_runProductionTestExTRxShortJNI(
+        JNIEnv *env, jobject obj, jintArray jlimit, jint jsize_limit, jintArray jlimit_ex_pin,
+        jint jsize_limit_ex_pin, jintArray jresult_data, jint jsize_result_data,
+        jintArray jresult_data_ex_pin, jint jsize_result_data_ex_pin,
+        jintArray jresult_pin, jint jsize_result_pin)
+{
+    int retval;
+    int *native_limit = NULL;
+    int *native_limit_ex_pin = NULL;
+    int *native_result_data = NULL;
+    int *native_result_data_ex_pin = NULL;
+    int *native_result_pin = NULL;
+    jsize len_array;
+    jboolean isCopy;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if (check_device_busy(__FUNCTION__) < 0)
+        return -EBUSY;
+
+    /* get an array of test limit from java layer */
+    if (jsize_limit > 0) {
+        native_limit = (*env)->GetIntArrayElements(env, jlimit, &isCopy);
+        len_array = (*env)->GetArrayLength(env, jlimit);
+        if ((len_array <= 0) || (len_array !=  jsize_limit)) {
+            printf_e("%s: invalid parameter. (jsize_limit = %d, array_len = %d)\n",
+                     __FUNCTION__, jsize_limit, len_array);
+            retval = -10;
+            goto exit;
+        }
+    }
+
+    /* get an array of test limit for extended pins from java layer */
+    if (jsize_limit_ex_pin > 0) {
+        native_limit_ex_pin = (*env)->GetIntArrayElements(env, jlimit_ex_pin, &isCopy);
+        len_array = (*env)->GetArrayLength(env, jlimit_ex_pin);
+        if ((len_array <= 0) || (len_array !=  jsize_limit_ex_pin)) {
+            printf_e("%s: invalid parameter. (jsize_limit_ex_pin = %d, array_len = %d)\n",
+                     __FUNCTION__, jsize_limit_ex_pin, len_array);
+            retval = -10;
+            goto exit;
+        }
+    }
+
+    /* get an int array of test result data from java layer */
+    if (jsize_result_data > 0) {
+        native_result_data = (*env)->GetIntArrayElements(env, jresult_data, &isCopy);
+        len_array = (*env)->GetArrayLength(env, jresult_data);
+        if (len_array != jsize_result_data) {
+            printf_e("%s: invalid parameter. (jsize_result_data = %d, len_array = %d)\n",
+                     __FUNCTION__, jsize_result_data, len_array);
+            retval = -10;
+            goto exit;
+        }
+    }
+
+    /* get an int array of test result data ex pin from java layer */
+    if (jsize_result_data_ex_pin > 0) {
+        native_result_data_ex_pin = (*env)->GetIntArrayElements(env, jresult_data_ex_pin, &isCopy);
+        len_array = (*env)->GetArrayLength(env, jresult_data_ex_pin);
+        if (len_array != jsize_result_data_ex_pin) {
+            printf_e("%s: invalid parameter. (jsize_result_data_ex_pin = %d, len_array = %d)\n",
+                     __FUNCTION__, jsize_result_data_ex_pin, len_array);
+            retval = -10;
+            goto exit;
+        }
+    }
+
+    /* get an int array of pin result from java layer */
+    if (jsize_result_pin > 0) {
+        native_result_pin = (*env)->GetIntArrayElements(env, jresult_pin, &isCopy);
+        len_array = (*env)->GetArrayLength(env, jresult_pin);
+        if (len_array != jsize_result_pin) {
+            printf_e("%s: invalid parameter. (jsize_result_pin = %d, len_array = %d)\n",
+                     __FUNCTION__, jsize_result_pin, len_array);
+            retval = -10;
+            goto exit;
+        }
+    }
+
+    retval = syna_run_test_ex_trx_short_entry(native_result_data, jsize_result_data,
+                                              native_result_data_ex_pin, jsize_result_data_ex_pin,
+                                              native_result_pin, jsize_result_pin,
+                                              native_limit, jsize_limit,
                                               native_limit_ex_pin, jsize_limit_ex_pin);
 
     if (retval < 0) {
-        printf_e("%s error: fail to run extended trx short test\n", __FUNCTION__);
+        printf_e("%s error: fail to run extended trx short test\n", __FUNCTION__);
+    }
+
+exit:
+    (*env)->ReleaseIntArrayElements(env, jlimit, native_limit, 0);
+    (*env)->ReleaseIntArrayElements(env, jlimit_ex_pin, native_limit_ex_pin, 0);
+    (*env)->ReleaseIntArrayElements(env, jresult_data, native_result_data, 0);
+    (*env)->ReleaseIntArrayElements(env, jresult_data_ex_pin, native_result_data_ex_pin, 0);
+    (*env)->ReleaseIntArrayElements(env, jresult_pin, native_result_pin, 0);
+    return retval;
+}
+
+/*
+ * Function:  getFwConfigSizeJNI
+ * --------------------
+ * retrieve the size of firmware config in byte
+ */
+JNIEXPORT jint JNICALL Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_getFwConfigSizeJNI(
+        JNIEnv *env, jobject obj)
+{
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if (check_device_busy(__FUNCTION__) < 0)
+        return -EBUSY;
+
+    return syna_get_firmware_config_size();
+}
+/*
+ * Function:  getFwConfigJNI
+ * --------------------
+ * retrieve the firmware configuration
+ */
+JNIEXPORT jboolean JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_getFwConfigJNI(
+        JNIEnv *env, jobject obj, jbyteArray array, jint size_of_array)
+{
+    int retval;
+    jbyte *native_array;
+    jsize len_data_array;
+    jboolean isCopy;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if (check_device_busy(__FUNCTION__) < 0)
+        return (jboolean)false;
+
+    /* retrieve a short array from java layer */
+    native_array = (*env)->GetByteArrayElements(env, array, &isCopy);
+    len_data_array = (*env)->GetArrayLength(env, array);
+    if (len_data_array != size_of_array) {
+        (*env)->ReleaseByteArrayElements(env, array, native_array, 0);
+        printf_e("%s error: invalid parameter. (len_data_array = %d)\n", __FUNCTION__, len_data_array);
+        return (jboolean)false;
+    }
+
+    retval = syna_get_firmware_config((unsigned char*)native_array, size_of_array);
+    if (retval < 0) {
+        printf_e("%s error: fail to get firmware config\n", __FUNCTION__);
+        /* release the java array */
+        (*env)->ReleaseByteArrayElements(env, array, native_array, 0);
+        return (jboolean)false;
+    }
+
+    /* release the java array */
+    (*env)->ReleaseByteArrayElements(env, array, native_array, 0);
+    return (jboolean)true;
+}
+/*
+ * Function:  streamFwConfigJNI
+ * --------------------
+ * read back the config or flash area into out_path in chunks, and compare
+ * with the golden image on the fly, both paths could be null
+ * the result is filled into info, see enum SYNA_STREAM_INFO
+ *
+ * return: <0, fail to stream the area
+ *          1, mismatch is found
+ *          0, otherwise
+ */
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_streamFwConfigJNI(
+        JNIEnv *env, jobject obj, jint area, jstring out_path, jstring golden_path,
+        jboolean stop_on_mismatch, jintArray info)
+{
+    int retval;
+    const char *str_out_path = NULL;
+    const char *str_golden_path = NULL;
+    int native_info[STREAM_INFO_SIZE] = {0};
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if (check_device_busy(__FUNCTION__) < 0)
+        return -EBUSY;
+
+    if (out_path)
+        str_out_path = (*env)->GetStringUTFChars(env, out_path, NULL);
+    if (golden_path)
+        str_golden_path = (*env)->GetStringUTFChars(env, golden_path, NULL);
+
+    retval = syna_stream_firmware_config((int)area, str_out_path, str_golden_path,
+                                         (bool)stop_on_mismatch, native_info, STREAM_INFO_SIZE);
+    if (retval < 0) {
+        printf_e("%s error: fail to stream the firmware config, area = %d\n", __FUNCTION__, area);
+    }
+    else if (info) {
+        (*env)->SetIntArrayRegion(env, info, 0,
+                                  MIN((*env)->GetArrayLength(env, info), STREAM_INFO_SIZE), native_info);
+    }
+
+    if (out_path)
+        (*env)->ReleaseStringUTFChars(env, out_path, str_out_path);
+    if (golden_path)
+        (*env)->ReleaseStringUTFChars(env, golden_path, str_golden_path);
+
+    return retval;
+}
+/*
+ * Function:  programFwAreaJNI
+ * --------------------
+ * write the image into the flash area of tcm device, and verify it by reading back
+ * area is one of enum tcm_data_area, 1 lcm, 2 oem, 3 ppdt, 4 force calibration
+ * the result is filled into info, see enum SYNA_PROGRAM_INFO
+ *
+ * return: <0, fail to program the area
+ *         otherwise, succeed
+ */
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_programFwAreaJNI(
+        JNIEnv *env, jobject obj, jint area, jbyteArray image, jboolean is_4byte_format,
+        jintArray info)
+{
+    int retval;
+    jbyte *native_image;
+    jsize len_image;
+    int native_info[PROGRAM_INFO_SIZE] = {0};
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if (check_device_busy(__FUNCTION__) < 0)
+        return -EBUSY;
+
+    if (!image) {
+        printf_e("%s error: invalid parameter\n", __FUNCTION__);
+        return -EINVAL;
+    }
+
+    /* not a critical region, the programming takes seconds on the bus */
+    native_image = (*env)->GetByteArrayElements(env, image, NULL);
+    len_image = (*env)->GetArrayLength(env, image);
+    if (!native_image) {
+        printf_e("%s error: fail to get the image\n", __FUNCTION__);
+        return -ENOMEM;
+    }
+
+    retval = syna_program_firmware_area((int)area, (unsigned char *)native_image, (int)len_image,
+                                        (bool)is_4byte_format, native_info, PROGRAM_INFO_SIZE);
+    if (retval < 0) {
+        printf_e("%s error: fail to program the flash area, area = %d\n", __FUNCTION__, area);
+    }
+    else if (info) {
+        (*env)->SetIntArrayRegion(env, info, 0,
+                                  MIN((*env)->GetArrayLength(env, info), PROGRAM_INFO_SIZE), native_info);
+    }
+
+    /* the image is not modified */
+    (*env)->ReleaseByteArrayElements(env, image, native_image, JNI_ABORT);
+
+    return retval;
+}
+/*
+ * Function:  diffFwConfigJNI
+ * --------------------
+ * compare the firmware config with the golden image
+ * config_path is the config read back to file, or null to use the device config
+ * golden_path is the golden image, or the folder of golden images named as <config id>.bin
+ * layout_path could be null
+ *
+ * return: the differing ranges, one range per line, "<offset>,<length>[,<field>...]"
+ *         empty string if identical, or null if failed
+ */
+JNIEXPORT jstring JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_diffFwConfigJNI(
+        JNIEnv *env, jobject obj, jstring config_path, jstring golden_path, jstring layout_path)
+{
+    int retval;
+    const char *str_config_path = NULL;
+    const char *str_golden_path;
+    const char *str_layout_path = NULL;
+    char *report;
+    jstring jreport = NULL;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    /* the config is read from the device, if the file is not given */
+    if (!config_path && (check_device_busy(__FUNCTION__) < 0))
+        return NULL;
+
+    if (!golden_path) {
+        printf_e("%s error: invalid parameter\n", __FUNCTION__);
+        return NULL;
+    }
+
+    report = calloc(SYNA_CONFIG_REPORT_LEN, sizeof(char));
+    if (!report) {
+        printf_e("%s error: can't allocate memory for report\n", __FUNCTION__);
+        return NULL;
+    }
+
+    str_golden_path = (*env)->GetStringUTFChars(env, golden_path, NULL);
+    if (config_path)
+        str_config_path = (*env)->GetStringUTFChars(env, config_path, NULL);
+    if (layout_path)
+        str_layout_path = (*env)->GetStringUTFChars(env, layout_path, NULL);
+
+    retval = syna_diff_firmware_config(str_config_path, str_golden_path, str_layout_path,
+                                       report, SYNA_CONFIG_REPORT_LEN);
+    if (retval < 0) {
+        printf_e("%s error: fail to compare the firmware config, %s\n", __FUNCTION__, str_golden_path);
+    }
+    else {
+        jreport = (*env)->NewStringUTF(env, report);
+    }
+
+    (*env)->ReleaseStringUTFChars(env, golden_path, str_golden_path);
+    if (config_path)
+        (*env)->ReleaseStringUTFChars(env, config_path, str_config_path);
+    if (layout_path)
+        (*env)->ReleaseStringUTFChars(env, layout_path, str_layout_path);
+
+    free(report);
+
+    return jreport;
+}
+/*
+ * Function:  queryTouchResponseJNI
+ * --------------------
+ * query a touch report
+ * it can assign the maximum number of fingers being reported
+ */
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_queryTouchResponseJNI(
+        JNIEnv *env, jobject obj, jint max_fingers)
+{
+    int retval;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if (check_device_busy(__FUNCTION__) < 0)
+        return -EBUSY;
+
+    /* try to query the force data */
+    retval = syna_query_touch_response_entry(max_fingers);
+    if (retval < 0) {
+        printf_e("%s error: fail to query the touch response\n", __FUNCTION__);
+        return retval;
+    }
+
+    return retval;
+}
+
+/*
+ * Function:  callback_finger_down
+ * --------------------
+ * the callback function to notify the activity a finger-down event
+ */
+void callback_finger_down(int index, int x_pos, int y_pos)
+{
+    printf_i("callback_finger_down + \n");
+
+    jclass clazz = (*g_jni_env)->FindClass(g_jni_env, "com/vivotouchscreen/sensortestsyna3908/NativeWrapper");
+    if (clazz == 0) {
+        printf_e("%s error: fail on FindClass, com/vivotouchscreen/sensortestsyna3908/NativeWrapper\n", __FUNCTION__);
+        return;
+    }
+    jmethodID javamethod = (*g_jni_env)->GetMethodID(g_jni_env, clazz, "callbackFingerDown", "(III)V");
+    if (javamethod == 0) {
+        printf_e("%s error: fail on GetMethodID, callbackFingerDown\n", __FUNCTION__);
+        return;
+    }
+    (*g_jni_env)->CallVoidMethod(g_jni_env, g_jni_obj, javamethod, index, x_pos, y_pos);
+
+}
+
+/*
+ * Function:  callback_finger_up
+ * --------------------
+ * the callback function to notify the activity a finger-up event
+ */
+void callback_finger_up(int index)
+{
+    printf_i("callback_one_finger_up + \n");
+
+    jclass clazz = (*g_jni_env)->FindClass(g_jni_env, "com/vivotouchscreen/sensortestsyna3908/NativeWrapper");
+    if (clazz == 0) {
+        printf_e("%s error: fail on FindClass, com/vivotouchscreen/sensortestsyna3908/NativeWrapper\n", __FUNCTION__);
+        return;
+    }
+    jmethodID javamethod = (*g_jni_env)->GetMethodID(g_jni_env, clazz, "callbackFingerUp", "(I)V");
+    if (javamethod == 0) {
+        printf_e("%s error: fail on GetMethodID, callbackFingerUp\n", __FUNCTION__);
+        return;
+    }
+    (*g_jni_env)->CallVoidMethod(g_jni_env, g_jni_obj, javamethod, index);
+
+}
+/*
+ * Function:  runRawCommandJNI
+ * --------------------
+ * execute the given raw command
+ */
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_runRawCommandJNI(
+        JNIEnv *env, jobject obj, jbyte type, jint cmd,
+        jbyteArray in, jint size_of_in, jbyteArray resp, jint size_of_resp)
+{
+    int retval;
+    jbyte *native_in;
+    jbyte *native_resp = NULL;
+    jsize len_array;
+    jboolean isCopy;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if (check_device_busy(__FUNCTION__) < 0)
+        return -EBUSY;
+
+    /* get a char array from java layer */
+    native_in = (*env)->GetByteArrayElements(env, in, &isCopy);
+    len_array = (*env)->GetArrayLength(env, in);
+    if (len_array != size_of_in) {
+        printf_e("%s error: invalid parameter of in array. (len_array = %d)\n", __FUNCTION__, len_array);
+        retval = -1;
+        goto exit;
+    }
+
+    /* get a char array from java layer */
+    if (size_of_resp > 0) {
+        native_resp = (*env)->GetByteArrayElements(env, resp, &isCopy);
+        len_array = (*env)->GetArrayLength(env, resp);
+        if (len_array != size_of_resp) {
+            printf_e("%s error: invalid parameter of out array (len_array = %d)\n", __FUNCTION__, len_array);
+            retval = -1;
+            goto exit;
+        }
+    }
+
+    retval = syna_run_raw_command((unsigned char)type, cmd,
+                                  (unsigned char*)native_in, size_of_in,
+                                  (unsigned char*)native_resp, size_of_resp);
+    if (retval < 0) {
+        printf_e("%s error: fail to run the command\n", __FUNCTION__);
+    }
+
+exit:
+    /* release the java array */
+    (*env)->ReleaseByteArrayElements(env, in, native_in, 0);
+    if (native_resp)
+        (*env)->ReleaseByteArrayElements(env, resp, native_resp, 0);
+    return retval;
+}
+/*
+ * Function:  runRawScriptJNI
+ * --------------------
+ * execute the whole raw command script
+ *
+ * return: the timing of each command, "<line>,<op>,<count>,<fail>,<min>,<avg>,<max>"
+ *         or null if failed
+ */
+JNIEXPORT jstring JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_runRawScriptJNI(
+        JNIEnv *env, jobject obj, jstring script_path, jboolean stop_on_fail)
+{
+    int retval;
+    const char *str_script_path;
+    char *report;
+    jstring jreport = NULL;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if (check_device_busy(__FUNCTION__) < 0)
+        return NULL;
+
+    if (!script_path) {
+        printf_e("%s error: invalid parameter\n", __FUNCTION__);
+        return NULL;
+    }
+
+    report = calloc(SYNA_SCRIPT_REPORT_LEN, sizeof(char));
+    if (!report) {
+        printf_e("%s error: can't allocate memory for report\n", __FUNCTION__);
+        return NULL;
+    }
+
+    str_script_path = (*env)->GetStringUTFChars(env, script_path, NULL);
+
+    retval = syna_run_raw_script(str_script_path, (bool)stop_on_fail,
+                                 report, SYNA_SCRIPT_REPORT_LEN);
+    if (retval < 0) {
+        printf_e("%s error: fail to run the script, %s\n", __FUNCTION__, str_script_path);
+    }
+    else {
+        jreport = (*env)->NewStringUTF(env, report);
+    }
+
+    (*env)->ReleaseStringUTFChars(env, script_path, str_script_path);
+
+    free(report);
+
+    return jreport;
+}
+/*
+ * Function:  getPinsMappingJNI
+ * --------------------
+ * inquiry the pin assignment
+ */
+JNIEXPORT jboolean JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_getPinsMappingJNI(
+        JNIEnv *env, jobject obj, jint rxes_offset, jint rxes_len, jint txes_offset, jint txes_len)
+{
+    int retval;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    retval = syna_get_pins_mapping(rxes_offset, rxes_len, txes_offset, txes_len);
+    if (retval < 0) {
+        printf_e("%s error: fail to retrieve trx pins mapping\n", __FUNCTION__);
+        return (jboolean)false;
+    }
+
+    return (jboolean)true;
+}
+
+/* reader of the capture file opened from java layer */
+static struct syna_capture_reader g_capture_reader;
+static bool g_is_capture_reader_opened;
+/*
+ * Function:  openCaptureFileJNI
+ * --------------------
+ * create a capture file to record the streams
+ */
+JNIEXPORT jboolean JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_openCaptureFileJNI(
+        JNIEnv *env, jobject obj, jstring path, jint row, jint col)
+{
+    int retval;
+    const char *str_path;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if (!path) {
+        printf_e("%s error: invalid parameter\n", __FUNCTION__);
+        return (jboolean)false;
+    }
+
+    str_path = (*env)->GetStringUTFChars(env, path, NULL);
+    retval = syna_capture_open(str_path, (int)row, (int)col);
+    (*env)->ReleaseStringUTFChars(env, path, str_path);
+
+    return (jboolean)(retval == 0);
+}
+/*
+ * Function:  closeCaptureFileJNI
+ * --------------------
+ * complete the capture file with the index
+ *
+ * return: <0, fail to close the capture file
+ *         otherwise, the number of records
+ */
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_closeCaptureFileJNI(
+        JNIEnv *env, jobject obj)
+{
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    return syna_capture_close();
+}
+/*
+ * Function:  writeCaptureRecordJNI
+ * --------------------
+ * append one record to the specified stream of capture file
+ */
+JNIEXPORT jboolean JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_writeCaptureRecordJNI(
+        JNIEnv *env, jobject obj, jint stream, jintArray array, jint size_of_array)
+{
+    int retval;
+    int *native_array;
+    jsize len_data_array;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    len_data_array = (*env)->GetArrayLength(env, array);
+    if ((len_data_array <= 0) || (size_of_array > len_data_array)) {
+        printf_e("%s error: invalid parameter. (len_data_array = %d)\n",
+                 __FUNCTION__, len_data_array);
+        return (jboolean)false;
+    }
+
+    /* file i/o is performed, not in the critical region */
+    native_array = (*env)->GetIntArrayElements(env, array, NULL);
+    if (!native_array) {
+        printf_e("%s error: fail to get the array elements\n", __FUNCTION__);
+        return (jboolean)false;
+    }
+
+    retval = syna_capture_append_values((int)stream, native_array, (int)size_of_array);
+    (*env)->ReleaseIntArrayElements(env, array, native_array, JNI_ABORT);
+
+    return (jboolean)(retval == 0);
+}
+/*
+ * Function:  openCaptureReaderJNI
+ * --------------------
+ * open a capture file for reading
+ */
+JNIEXPORT jboolean JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_openCaptureReaderJNI(
+        JNIEnv *env, jobject obj, jstring path)
+{
+    int retval;
+    const char *str_path;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if (!path) {
+        printf_e("%s error: invalid parameter\n", __FUNCTION__);
+        return (jboolean)false;
+    }
+
+    if (g_is_capture_reader_opened) {
+        syna_capture_reader_close(&g_capture_reader);
+        g_is_capture_reader_opened = false;
+    }
+
+    str_path = (*env)->GetStringUTFChars(env, path, NULL);
+    retval = syna_capture_reader_open(str_path, &g_capture_reader);
+    (*env)->ReleaseStringUTFChars(env, path, str_path);
+
+    g_is_capture_reader_opened = (retval == 0);
+
+    return (jboolean)g_is_capture_reader_opened;
+}
+/*
+ * Function:  closeCaptureReaderJNI
+ * --------------------
+ * close the capture file opened for reading
+ */
+JNIEXPORT void JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_closeCaptureReaderJNI(
+        JNIEnv *env, jobject obj)
+{
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if (g_is_capture_reader_opened) {
+        syna_capture_reader_close(&g_capture_reader);
+        g_is_capture_reader_opened = false;
+    }
+}
+/*
+ * Function:  getCaptureRecordCountJNI
+ * --------------------
+ * return the number of records in the specified stream
+ */
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_getCaptureRecordCountJNI(
+        JNIEnv *env, jobject obj, jint stream)
+{
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if (!g_is_capture_reader_opened)
+        return -1;
+
+    return syna_capture_get_count(&g_capture_reader, (int)stream);
+}
+/*
+ * Function:  readCaptureRecordJNI
+ * --------------------
+ * read the n-th record of the specified stream
+ *
+ * return: <0, fail to read the record
+ *         otherwise, the number of values
+ */
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_readCaptureRecordJNI(
+        JNIEnv *env, jobject obj, jint stream, jint n, jintArray array, jint size_of_array)
+{
+    int retval;
+    int *native_array;
+    jsize len_data_array;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if (!g_is_capture_reader_opened)
+        return -1;
+
+    len_data_array = (*env)->GetArrayLength(env, array);
+    if ((len_data_array <= 0) || (size_of_array > len_data_array)) {
+        printf_e("%s error: invalid parameter. (len_data_array = %d)\n",
+                 __FUNCTION__, len_data_array);
+        return -1;
+    }
+
+    /* the mapped file may fault in pages, not in the critical region */
+    native_array = (*env)->GetIntArrayElements(env, array, NULL);
+    if (!native_array) {
+        printf_e("%s error: fail to get the array elements\n", __FUNCTION__);
+        return -1;
+    }
+
+    retval = syna_capture_read_values(&g_capture_reader, (int)stream, (int)n,
+                                      native_array, (int)size_of_array, NULL);
+    (*env)->ReleaseIntArrayElements(env, array, native_array, (retval >= 0) ? 0 : JNI_ABORT);
+
+    return retval;
+}
+/*
+ * Function:  getCaptureRecordTimeJNI
+ * --------------------
+ * return the timestamp of the n-th record, in micro-seconds
+ */
+JNIEXPORT jlong JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_getCaptureRecordTimeJNI(
+        JNIEnv *env, jobject obj, jint stream, jint n)
+{
+    const unsigned char *p_data;
+    long long timestamp_us = -1;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if (!g_is_capture_reader_opened)
+        return -1;
+
+    if (syna_capture_get_record(&g_capture_reader, (int)stream, (int)n, &p_data, &timestamp_us) < 0)
+        return -1;
+
+    return (jlong)timestamp_us;
+}
+/*
+ * Function:  findCaptureRecordByTimeJNI
+ * --------------------
+ * return the index of the first record at or after the specified time
+ */
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_findCaptureRecordByTimeJNI(
+        JNIEnv *env, jobject obj, jint stream, jlong timestamp_us)
+{
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if (!g_is_capture_reader_opened)
+        return -1;
+
+    return syna_capture_find_by_time(&g_capture_reader, (int)stream, (long long)timestamp_us);
+}
+/*
+ * Function:  runCodecBenchmarkJNI
+ * --------------------
+ * run the frame codec benchmark with one stream of capture file
+ *
+ * return: the report of benchmark, or null if failed
+ */
+JNIEXPORT jstring JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_runCodecBenchmarkJNI(
+        JNIEnv *env, jobject obj, jstring path, jint stream)
+{
+    int retval;
+    const char *str_path;
+    char report[MAX_STRING_LEN];
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if (!path) {
+        printf_e("%s error: invalid parameter\n", __FUNCTION__);
+        return NULL;
+    }
+
+    str_path = (*env)->GetStringUTFChars(env, path, NULL);
+    retval = syna_codec_benchmark(str_path, (int)stream, report, sizeof(report));
+    (*env)->ReleaseStringUTFChars(env, path, str_path);
+
+    if (retval < 0) {
+        printf_e("%s error: fail to run the codec benchmark\n", __FUNCTION__);
+        return NULL;
+    }
+
+    return (*env)->NewStringUTF(env, report);
+}
+/*
+ * Function:  loadTestLimitJNI
+ * --------------------
+ * load the test limits from the test configuration (.ini) file into the limit store
+ * the compiled limits are cached in cache_path, which could be null
+ *
+ * return: <0, fail to load the test limits
+ *          0, the .ini file is parsed
+ *          1, the cache file is used
+ */
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_loadTestLimitJNI(
+        JNIEnv *env, jobject obj, jstring ini_path, jstring cache_path)
+{
+    int retval;
+    const char *str_ini_path;
+    const char *str_cache_path = NULL;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if (!ini_path) {
+        printf_e("%s error: invalid parameter\n", __FUNCTION__);
+        return -EINVAL;
+    }
+
+    str_ini_path = (*env)->GetStringUTFChars(env, ini_path, NULL);
+    if (cache_path)
+        str_cache_path = (*env)->GetStringUTFChars(env, cache_path, NULL);
+
+    retval = syna_limit_store_load(str_ini_path, str_cache_path);
+    if (retval < 0) {
+        printf_e("%s error: fail to load the test limits, %s\n", __FUNCTION__, str_ini_path);
     }
 
-exit:
-    (*env)->ReleaseIntArrayElements(env, jlimit, native_limit, 0);
-    (*env)->ReleaseIntArrayElements(env, jlimit_ex_pin, native_limit_ex_pin, 0);
-    (*env)->ReleaseIntArrayElements(env, jresult_data, native_result_data, 0);
-    (*env)->ReleaseIntArrayElements(env, jresult_data_ex_pin, native_result_data_ex_pin, 0);
-    (*env)->ReleaseIntArrayElements(env, jresult_pin, native_result_pin, 0);
+    (*env)->ReleaseStringUTFChars(env, ini_path, str_ini_path);
+    if (cache_path)
+        (*env)->ReleaseStringUTFChars(env, cache_path, str_cache_path);
+
     return retval;
 }
-
 /*
- * Function:  getFwConfigSizeJNI
+ * Function:  releaseTestLimitJNI
  * --------------------
- * retrieve the size of firmware config in byte
+ * release the limit store
  */
-JNIEXPORT jint JNICALL Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_getFwConfigSizeJNI(
+JNIEXPORT void JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_releaseTestLimitJNI(
         JNIEnv *env, jobject obj)
 {
     /* save JNIEnv */
     g_jni_env = env;
     g_jni_obj = obj;
 
-    return syna_get_firmware_config_size();
+    syna_limit_store_release();
 }
 /*
- * Function:  getFwConfigJNI
+ * Function:  getTestLimitJNI
  * --------------------
- * retrieve the firmware configuration
+ * copy the test limit of the test item in the limit store to the java layer
+ * it is used to present the limit only, the testing uses the limit store directly
+ *
+ * return: <0, the limit is not defined
+ *         otherwise, the size of limit, could be larger than the size of array
  */
-JNIEXPORT jboolean JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_getFwConfigJNI(
-        JNIEnv *env, jobject obj, jbyteArray array, jint size_of_array)
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_getTestLimitJNI(
+        JNIEnv *env, jobject obj, jint item, jboolean is_max, jintArray array)
 {
     int retval;
-    jbyte *native_array;
-    jsize len_data_array;
-    jboolean isCopy;
+    int *p_limit_min;
+    int *p_limit_max;
+    int size_min;
+    int size_max;
+    int *p_limit;
+    int size;
+    jsize len_array;
 
     /* save JNIEnv */
     g_jni_env = env;
     g_jni_obj = obj;
 
-    /* retrieve a short array from java layer */
-    native_array = (*env)->GetByteArrayElements(env, array, &isCopy);
-    len_data_array = (*env)->GetArrayLength(env, array);
-    if (len_data_array != size_of_array) {
-        (*env)->ReleaseByteArrayElements(env, array, native_array, 0);
-        printf_e("%s error: invalid parameter. (len_data_array = %d)\n", __FUNCTION__, len_data_array);
-        return (jboolean)false;
-    }
+    retval = syna_get_test_limit(item, &p_limit_min, &size_min, &p_limit_max, &size_max);
+    if (retval < 0)
+        return retval;
 
-    retval = syna_get_firmware_config((unsigned char*)native_array, size_of_array);
-    if (retval < 0) {
-        printf_e("%s error: fail to get firmware config\n", __FUNCTION__);
-        /* release the java array */
-        (*env)->ReleaseByteArrayElements(env, array, native_array, 0);
-        return (jboolean)false;
+    p_limit = (is_max) ? p_limit_max : p_limit_min;
+    size = (is_max) ? size_max : size_min;
+    if (!p_limit)
+        return -ENOENT;
+
+    if (array) {
+        len_array = (*env)->GetArrayLength(env, array);
+        (*env)->SetIntArrayRegion(env, array, 0, MIN(len_array, size), p_limit);
     }
 
-    /* release the java array */
-    (*env)->ReleaseByteArrayElements(env, array, native_array, 0);
-    return (jboolean)true;
+    return size;
 }
 /*
- * Function:  queryTouchResponseJNI
+ * Function:  openReferenceStoreJNI
  * --------------------
- * query a touch report
- * it can assign the maximum number of fingers being reported
+ * open the reference store file, an empty store is created if not existed
+ *
+ * return: <0, fail to open the reference store
+ *         otherwise, the number of frames in the store
  */
-JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_queryTouchResponseJNI(
-        JNIEnv *env, jobject obj, jint max_fingers)
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_openReferenceStoreJNI(
+        JNIEnv *env, jobject obj, jstring path)
 {
     int retval;
+    const char *str_path;
 
     /* save JNIEnv */
     g_jni_env = env;
     g_jni_obj = obj;
 
-    /* try to query the force data */
-    retval = syna_query_touch_response_entry(max_fingers);
+    if (!path) {
+        printf_e("%s error: invalid parameter\n", __FUNCTION__);
+        return -EINVAL;
+    }
+
+    str_path = (*env)->GetStringUTFChars(env, path, NULL);
+
+    retval = syna_ref_store_open(str_path);
     if (retval < 0) {
-        printf_e("%s error: fail to query the touch response\n", __FUNCTION__);
-        return retval;
+        printf_e("%s error: fail to open the reference store, %s\n", __FUNCTION__, str_path);
     }
 
+    (*env)->ReleaseStringUTFChars(env, path, str_path);
+
     return retval;
 }
+/*
+ * Function:  closeReferenceStoreJNI
+ * --------------------
+ * close the reference store
+ */
+JNIEXPORT void JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_closeReferenceStoreJNI(
+        JNIEnv *env, jobject obj)
+{
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
 
+    syna_ref_store_close();
+}
 /*
- * Function:  callback_finger_down
+ * Function:  updateReferenceFrameJNI
  * --------------------
- * the callback function to notify the activity a finger-down event
+ * update the frame of the test item in the reference store with the average of
+ * num_frames frames, which are placed one after another in the array
+ *
+ * return: <0, fail to update the frame
+ *         otherwise, succeed
  */
-void callback_finger_down(int index, int x_pos, int y_pos)
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_updateReferenceFrameJNI(
+        JNIEnv *env, jobject obj, jint test_id, jint kind, jint col, jint row,
+        jintArray frames, jint num_frames)
 {
-    printf_i("callback_finger_down + \n");
+    int retval;
+    jint *native_frames;
+    jsize len_array;
 
-    jclass clazz = (*g_jni_env)->FindClass(g_jni_env, "com/vivotouchscreen/sensortestsyna3908/NativeWrapper");
-    if (clazz == 0) {
-        printf_e("%s error: fail on FindClass, com/vivotouchscreen/sensortestsyna3908/NativeWrapper\n", __FUNCTION__);
-        return;
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if ((!frames) || (col <= 0) || (row <= 0) || (num_frames <= 0)) {
+        printf_e("%s error: invalid parameter\n", __FUNCTION__);
+        return -EINVAL;
     }
-    jmethodID javamethod = (*g_jni_env)->GetMethodID(g_jni_env, clazz, "callbackFingerDown", "(III)V");
-    if (javamethod == 0) {
-        printf_e("%s error: fail on GetMethodID, callbackFingerDown\n", __FUNCTION__);
-        return;
+
+    len_array = (*env)->GetArrayLength(env, frames);
+    if (len_array < col * row * num_frames) {
+        printf_e("%s error: invalid parameter. (len_array = %d, frames = %d x %d x %d)\n",
+                 __FUNCTION__, len_array, col, row, num_frames);
+        return -EINVAL;
     }
-    (*g_jni_env)->CallVoidMethod(g_jni_env, g_jni_obj, javamethod, index, x_pos, y_pos);
 
-}
+    native_frames = (*env)->GetIntArrayElements(env, frames, NULL);
+
+    retval = syna_update_reference_frame(test_id, kind, col, row, native_frames, num_frames);
+    if (retval < 0) {
+        printf_e("%s error: fail to update the reference frame of test 0x%x\n",
+                 __FUNCTION__, test_id);
+    }
+
+    (*env)->ReleaseIntArrayElements(env, frames, native_frames, JNI_ABORT);
 
+    return retval;
+}
 /*
- * Function:  callback_finger_up
+ * Function:  importReferenceFrameJNI
  * --------------------
- * the callback function to notify the activity a finger-up event
+ * import the frame of the test item in the test config into the reference store,
+ * unless the frame in the store is averaged from the captures, or is imported
+ * from the same frame already
+ *
+ * return: <0, fail to import the frame
+ *         0, the frame in the store is kept
+ *         1, the frame is imported
  */
-void callback_finger_up(int index)
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_importReferenceFrameJNI(
+        JNIEnv *env, jobject obj, jint test_id, jint kind, jint col, jint row, jintArray frame)
 {
-    printf_i("callback_one_finger_up + \n");
+    int retval;
+    jint *native_frame;
+    jsize len_array;
 
-    jclass clazz = (*g_jni_env)->FindClass(g_jni_env, "com/vivotouchscreen/sensortestsyna3908/NativeWrapper");
-    if (clazz == 0) {
-        printf_e("%s error: fail on FindClass, com/vivotouchscreen/sensortestsyna3908/NativeWrapper\n", __FUNCTION__);
-        return;
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if ((!frame) || (col <= 0) || (row <= 0)) {
+        printf_e("%s error: invalid parameter\n", __FUNCTION__);
+        return -EINVAL;
     }
-    jmethodID javamethod = (*g_jni_env)->GetMethodID(g_jni_env, clazz, "callbackFingerUp", "(I)V");
-    if (javamethod == 0) {
-        printf_e("%s error: fail on GetMethodID, callbackFingerUp\n", __FUNCTION__);
-        return;
+
+    len_array = (*env)->GetArrayLength(env, frame);
+    if (len_array < col * row) {
+        printf_e("%s error: invalid parameter. (len_array = %d, frame = %d x %d)\n",
+                 __FUNCTION__, len_array, col, row);
+        return -EINVAL;
     }
-    (*g_jni_env)->CallVoidMethod(g_jni_env, g_jni_obj, javamethod, index);
 
+    native_frame = (*env)->GetIntArrayElements(env, frame, NULL);
+
+    retval = syna_import_reference_frame(test_id, kind, col, row, native_frame);
+    if (retval < 0) {
+        printf_e("%s error: fail to import the reference frame of test 0x%x\n",
+                 __FUNCTION__, test_id);
+    }
+
+    (*env)->ReleaseIntArrayElements(env, frame, native_frame, JNI_ABORT);
+
+    return retval;
 }
 /*
- * Function:  runRawCommandJNI
+ * Function:  getReferenceFrameJNI
  * --------------------
- * execute the given raw command
+ * copy the frame of the test item in the reference store to the java layer
+ * it is used to present the frame only, the testing uses the reference store directly
+ *
+ * return: <0, the frame is not found
+ *         otherwise, the size of frame, could be larger than the size of array
  */
-JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_runRawCommandJNI(
-        JNIEnv *env, jobject obj, jbyte type, jint cmd,
-        jbyteArray in, jint size_of_in, jbyteArray resp, jint size_of_resp)
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_getReferenceFrameJNI(
+        JNIEnv *env, jobject obj, jint test_id, jint kind, jint col, jint row, jintArray array)
 {
     int retval;
-    jbyte *native_in;
-    jbyte *native_resp = NULL;
+    int i;
+    short *p_frame = NULL;
+    jint *native_array;
     jsize len_array;
-    jboolean isCopy;
 
     /* save JNIEnv */
     g_jni_env = env;
     g_jni_obj = obj;
 
-    /* get a char array from java layer */
-    native_in = (*env)->GetByteArrayElements(env, in, &isCopy);
-    len_array = (*env)->GetArrayLength(env, in);
-    if (len_array != size_of_in) {
-        printf_e("%s error: invalid parameter of in array. (len_array = %d)\n", __FUNCTION__, len_array);
-        retval = -1;
-        goto exit;
+    retval = syna_get_reference_frame(test_id, kind, col, row, &p_frame);
+    if ((retval <= 0) || (!array))
+        return retval;
+
+    len_array = (*env)->GetArrayLength(env, array);
+    native_array = (*env)->GetIntArrayElements(env, array, NULL);
+
+    for (i = 0; (i < retval) && (i < len_array); i++)
+        native_array[i] = p_frame[i];
+
+    (*env)->ReleaseIntArrayElements(env, array, native_array, 0);
+
+    return retval;
+}
+/*
+ * Function:  submitTestJobJNI
+ * --------------------
+ * submit a list of production tests to run in a background thread
+ * the test limits are taken from the limit store, see loadTestLimitJNI
+ * deadlines and aux_sizes could be null
+ * is_scheduled, true to re-order the tests to reduce the resets between them
+ *
+ * return: <0, fail to submit
+ *         otherwise, the handle of job
+ */
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_submitTestJobJNI(
+        JNIEnv *env, jobject obj, jintArray test_ids, jintArray deadlines_ms,
+        jintArray result_sizes, jintArray aux_sizes, jint col, jint row, jboolean is_scheduled)
+{
+    int retval;
+    jint *native_ids = NULL;
+    jint *native_deadlines = NULL;
+    jint *native_result_sizes = NULL;
+    jint *native_aux_sizes = NULL;
+    jsize num_tests;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if (check_device_busy(__FUNCTION__) < 0)
+        return -EBUSY;
+
+    if (!test_ids || !result_sizes) {
+        printf_e("%s error: invalid parameter\n", __FUNCTION__);
+        return -EINVAL;
     }
 
-    /* get a char array from java layer */
-    if (size_of_resp > 0) {
-        native_resp = (*env)->GetByteArrayElements(env, resp, &isCopy);
-        len_array = (*env)->GetArrayLength(env, resp);
-        if (len_array != size_of_resp) {
-            printf_e("%s error: invalid parameter of out array (len_array = %d)\n", __FUNCTION__, len_array);
-            retval = -1;
-            goto exit;
-        }
+    num_tests = (*env)->GetArrayLength(env, test_ids);
+    if (((*env)->GetArrayLength(env, result_sizes) != num_tests) ||
+        (deadlines_ms && ((*env)->GetArrayLength(env, deadlines_ms) != num_tests)) ||
+        (aux_sizes && ((*env)->GetArrayLength(env, aux_sizes) != num_tests))) {
+        printf_e("%s error: size of arrays is mismatching (num_tests = %d)\n", __FUNCTION__, num_tests);
+        return -EINVAL;
     }
 
-    retval = syna_run_raw_command((unsigned char)type, cmd,
-                                  (unsigned char*)native_in, size_of_in,
-                                  (unsigned char*)native_resp, size_of_resp);
+    native_ids = (*env)->GetIntArrayElements(env, test_ids, NULL);
+    native_result_sizes = (*env)->GetIntArrayElements(env, result_sizes, NULL);
+    if (deadlines_ms)
+        native_deadlines = (*env)->GetIntArrayElements(env, deadlines_ms, NULL);
+    if (aux_sizes)
+        native_aux_sizes = (*env)->GetIntArrayElements(env, aux_sizes, NULL);
+
+    retval = syna_job_submit(native_ids, native_deadlines, native_result_sizes, native_aux_sizes,
+                             num_tests, col, row, is_scheduled);
     if (retval < 0) {
-        printf_e("%s error: fail to run the command\n", __FUNCTION__);
+        printf_e("%s error: fail to submit the test job\n", __FUNCTION__);
     }
 
-exit:
-    /* release the java array */
-    (*env)->ReleaseByteArrayElements(env, in, native_in, 0);
-    if (native_resp)
-        (*env)->ReleaseByteArrayElements(env, resp, native_resp, 0);
+    /* release the java arrays, no change */
+    (*env)->ReleaseIntArrayElements(env, test_ids, native_ids, JNI_ABORT);
+    (*env)->ReleaseIntArrayElements(env, result_sizes, native_result_sizes, JNI_ABORT);
+    if (deadlines_ms)
+        (*env)->ReleaseIntArrayElements(env, deadlines_ms, native_deadlines, JNI_ABORT);
+    if (aux_sizes)
+        (*env)->ReleaseIntArrayElements(env, aux_sizes, native_aux_sizes, JNI_ABORT);
+
     return retval;
 }
 /*
- * Function:  getPinsMappingJNI
+ * Function:  cancelTestJobJNI
  * --------------------
- * inquiry the pin assignment
+ * cancel the test job, the test being run stops at its next polling
  */
-JNIEXPORT jboolean JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_getPinsMappingJNI(
-        JNIEnv *env, jobject obj, jint rxes_offset, jint rxes_len, jint txes_offset, jint txes_len)
+JNIEXPORT jboolean JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_cancelTestJobJNI(
+        JNIEnv *env, jobject obj, jint handle)
+{
+    return (jboolean)(syna_job_cancel(handle) == 0);
+}
+/*
+ * Function:  waitTestJobJNI
+ * --------------------
+ * wait for the completion of test job
+ *
+ * return: <0, timeout or invalid handle
+ *         otherwise, the state of job
+ */
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_waitTestJobJNI(
+        JNIEnv *env, jobject obj, jint handle, jint timeout_ms)
+{
+    return syna_job_wait(handle, timeout_ms);
+}
+/*
+ * Function:  releaseTestJobJNI
+ * --------------------
+ * cancel the test job if it is running, and release the results
+ */
+JNIEXPORT void JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_releaseTestJobJNI(
+        JNIEnv *env, jobject obj, jint handle)
+{
+    syna_job_release(handle);
+}
+/*
+ * Function:  getTestJobProgressJNI
+ * --------------------
+ * get the progress of test job
+ * info = { state, current index, completed, number of tests }
+ */
+JNIEXPORT jboolean JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_getTestJobProgressJNI(
+        JNIEnv *env, jobject obj, jint handle, jintArray info)
+{
+    int retval;
+    int native_info[JOB_INFO_MAX];
+    jsize len_array;
+
+    if (!info)
+        return (jboolean)false;
+
+    retval = syna_job_get_progress(handle, native_info, JOB_INFO_MAX);
+    if (retval < 0)
+        return (jboolean)false;
+
+    len_array = (*env)->GetArrayLength(env, info);
+    (*env)->SetIntArrayRegion(env, info, 0, MIN(len_array, retval), native_info);
+
+    return (jboolean)true;
+}
+/*
+ * Function:  getTestJobTestInfoJNI
+ * --------------------
+ * get the state of one test in the test job
+ * info = { test id, state, retval, elapsed time in ms }
+ */
+JNIEXPORT jboolean JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_getTestJobTestInfoJNI(
+        JNIEnv *env, jobject obj, jint handle, jint index, jintArray info)
+{
+    int retval;
+    int native_info[JOB_TEST_INFO_MAX];
+    jsize len_array;
+
+    if (!info)
+        return (jboolean)false;
+
+    retval = syna_job_get_test_info(handle, index, native_info, JOB_TEST_INFO_MAX);
+    if (retval < 0)
+        return (jboolean)false;
+
+    len_array = (*env)->GetArrayLength(env, info);
+    (*env)->SetIntArrayRegion(env, info, 0, MIN(len_array, retval), native_info);
+
+    return (jboolean)true;
+}
+/*
+ * Function:  getTestJobResultJNI
+ * --------------------
+ * copy the result data of one completed test in the test job
+ *
+ * return: <0, the test is not completed or invalid parameter
+ *         otherwise, the number of data copied
+ */
+JNIEXPORT jint JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_getTestJobResultJNI(
+        JNIEnv *env, jobject obj, jint handle, jint index, jboolean is_aux, jintArray result)
 {
     int retval;
+    jint *native_result;
+    jsize len_array;
+
+    if (!result)
+        return -EINVAL;
+
+    len_array = (*env)->GetArrayLength(env, result);
+    native_result = (*env)->GetIntArrayElements(env, result, NULL);
+
+    retval = syna_job_get_test_result(handle, index, is_aux, native_result, len_array);
+
+    (*env)->ReleaseIntArrayElements(env, result, native_result, 0);
+
+    return retval;
+}
+
+/* heatmap renderer used by the preview of java layer */
+static struct syna_heatmap g_heatmap;
+static bool g_is_heatmap_initialized;
+static int g_heatmap_colormap;
+static int g_heatmap_scaling;
+static short *g_heatmap_frame;
+static int g_heatmap_frame_size;
+/*
+ * Function:  renderHeatmapJNI
+ * --------------------
+ * render the report image into the pixel array of android.graphics.Bitmap
+ * the range is determined by each frame if range_max <= range_min
+ */
+JNIEXPORT jboolean JNICALL  Java_com_vivotouchscreen_sensortestsyna3908_NativeWrapper_renderHeatmapJNI(
+        JNIEnv *env, jobject obj, jintArray image, jint col, jint row,
+        jintArray pixels, jint width, jint height, jint colormap, jint scaling,
+        jint range_min, jint range_max)
+{
+    int retval;
+    int *native_image;
+    unsigned int *native_pixels;
+    int size = (int)(col * row);
+    int i;
 
     /* save JNIEnv */
     g_jni_env = env;
     g_jni_obj = obj;
 
-    retval = syna_get_pins_mapping(rxes_offset, rxes_len, txes_offset, txes_len);
+    if ((!image) || (!pixels) || (size <= 0) || (width <= 0) || (height <= 0) ||
+        ((*env)->GetArrayLength(env, image) < size) ||
+        ((*env)->GetArrayLength(env, pixels) < width * height)) {
+        printf_e("%s error: invalid parameter\n", __FUNCTION__);
+        return (jboolean)false;
+    }
+
+    /* the colormap and scaling are applied when the renderer is initialized */
+    if ((!g_is_heatmap_initialized) ||
+        (colormap != g_heatmap_colormap) || (scaling != g_heatmap_scaling)) {
+        syna_heatmap_release(&g_heatmap);
+
+        retval = syna_heatmap_init(&g_heatmap, (int)colormap, HEATMAP_FORMAT_ARGB_INT, (int)scaling);
+        if (retval < 0) {
+            printf_e("%s error: fail to initialize the heatmap (colormap = %d, scaling = %d)\n",
+                     __FUNCTION__, colormap, scaling);
+            g_is_heatmap_initialized = false;
+            return (jboolean)false;
+        }
+        g_is_heatmap_initialized = true;
+        g_heatmap_colormap = (int)colormap;
+        g_heatmap_scaling = (int)scaling;
+    }
+    syna_heatmap_set_range(&g_heatmap, (range_max <= range_min), (int)range_min, (int)range_max);
+
+    if (size > g_heatmap_frame_size) {
+        free(g_heatmap_frame);
+        g_heatmap_frame = calloc((size_t)size, sizeof(short));
+        if (!g_heatmap_frame) {
+            printf_e("%s error: can't allocate memory for heatmap frame\n", __FUNCTION__);
+            g_heatmap_frame_size = 0;
+            return (jboolean)false;
+        }
+        g_heatmap_frame_size = size;
+    }
+
+    /* the report image is in 16-bit */
+    native_image = (*env)->GetPrimitiveArrayCritical(env, image, NULL);
+    if (!native_image) {
+        printf_e("%s error: fail to access the image array\n", __FUNCTION__);
+        return (jboolean)false;
+    }
+    for (i = 0; i < size; i++)
+        g_heatmap_frame[i] = (short)native_image[i];
+    (*env)->ReleasePrimitiveArrayCritical(env, image, native_image, JNI_ABORT);
+
+    native_pixels = (*env)->GetPrimitiveArrayCritical(env, pixels, NULL);
+    if (!native_pixels) {
+        printf_e("%s error: fail to access the pixel array\n", __FUNCTION__);
+        return (jboolean)false;
+    }
+    retval = syna_heatmap_render(&g_heatmap, g_heatmap_frame, (int)col, (int)row,
+                                 native_pixels, (int)width, (int)height, (int)width);
+    (*env)->ReleasePrimitiveArrayCritical(env, pixels, native_pixels, 0);
+
     if (retval < 0) {
-        printf_e("%s error: fail to retrieve trx pins mapping\n", __FUNCTION__);
+        printf_e("%s error: fail to render the heatmap (retval = %d)\n", __FUNCTION__, retval);
         return (jboolean)false;
     }
 
     return (jboolean)true;
 }
-
-
@@ -37,6 +37,8 @@
 
 #include "syna_dev_manager.h"
 #include "rmi_control.h"
+#include "syna_test_job.h"
+#include "syna_bus_trace.h"
 
 #ifdef SAVE_ERR_MSG
 #include "err_msg_ctrl.h"
@@ -50,12 +52,33 @@
 
 static bool rmi_is_initialized;
 
+/* shadow copy of the control registers, indexed by the 16-bit rmi address */
+#define RMI_SHADOW_SIZE (0x10000)
+struct rmi_reg_shadow {
+    unsigned char data[RMI_SHADOW_SIZE];
+    unsigned char valid[RMI_SHADOW_SIZE / 8];
+    unsigned char dirty[RMI_SHADOW_SIZE / 8];
+    int batch_depth;
+    int dirty_start;            /* range of dirty bytes, dirty_start > dirty_end if none */
+    int dirty_end;
+};
+static struct rmi_reg_shadow g_rmi_shadow = {
+    .dirty_start = RMI_SHADOW_SIZE,
+    .dirty_end = -1,
+};
+#define SHADOW_TEST(map, addr) ((map)[(addr) >> 3] & (1 << ((addr) & 0x07)))
+#define SHADOW_SET(map, addr) ((map)[(addr) >> 3] |= (unsigned char)(1 << ((addr) & 0x07)))
+#define SHADOW_CLEAR(map, addr) ((map)[(addr) >> 3] &= (unsigned char)~(1 << ((addr) & 0x07)))
+
 static int g_rmi_available_gears;
 static unsigned char g_rmi_gear_en[MAX_RMI_FREUENCY_GEAR]; /* 1: enable; 0: disable*/
 
 
 int rmi_scan_pdt();
 int rmi_f54_scan_freq_gear();
+static void rmi_shadow_drop(unsigned short address, int len);
+static void rmi_shadow_drop_clean(void);
+static bool rmi_is_command_addr(unsigned short address, int len);
 
 /*
  * Function:  rmi_find_dev
@@ -110,7 +133,7 @@ int rmi_open_dev(const char *dev_node)
         return 0;
     }
 
-    g_dev_file_descriptor = open(dev_node, O_RDWR, S_IRWXU | S_IRWXG | S_IRWXO);
+    g_dev_file_descriptor = syna_bus_open(dev_node);
     if (g_dev_file_descriptor < 0) {
         printf_e("%s error: fail to open %s (err: %s)\n",
                  __func__, dev_node, strerror(errno));
@@ -125,6 +148,8 @@ int rmi_open_dev(const char *dev_node)
     printf_i("%s info: open %s (fd = %d)\n",
              __func__, dev_node, g_dev_file_descriptor);
 
+    rmi_shadow_invalidate();
+
     /* to parse the pdt if it is rmi device */
     if (rmi_scan_pdt() < 0) {
         printf_e("%s error: fail to parse the rmi pdt.\n", __func__);
@@ -153,10 +178,12 @@ int rmi_close_dev(const char *dev_node)
         return 0;
     }
     /* close the device node */
-    close(g_dev_file_descriptor);
+    syna_bus_close(g_dev_file_descriptor);
 
     g_dev_file_descriptor = 0;
 
+    rmi_shadow_invalidate();
+
     printf_i("%s info: close %s (fd = %d)\n",
              __func__, dev_node, g_dev_file_descriptor);
 
@@ -192,9 +219,7 @@ int rmi_read_reg(unsigned short address, unsigned char *p_rd_data, int bytes_to_
         return (-EINVAL);
     }
 
-    lseek(g_dev_file_descriptor, address, SEEK_SET);
-
-    retval = (int) read(g_dev_file_descriptor, (void *)p_rd_data, (size_t)bytes_to_read);
+    retval = syna_bus_read(BUS_OP_RMI_READ, address, p_rd_data, bytes_to_read);
     if (retval < 0)  {
         printf_e("%s error: fail to read data. addr = 0x%x, bytes_to_read = %d (retval = %d)\n",
                  __func__, address, bytes_to_read, retval);
@@ -233,9 +258,14 @@ int rmi_write_reg(unsigned short address, unsigned char *p_wr_data, int bytes_to
         return (-EINVAL);
     }
 
-    lseek(g_dev_file_descriptor, address, SEEK_SET);
+    /* the cached copy is no longer trusted once the register is written directly */
+    /* a command, e.g. reset, rezero or force update, could change any control register */
+    if (rmi_is_command_addr(address, bytes_to_write))
+        rmi_shadow_drop_clean();
+    else
+        rmi_shadow_drop(address, bytes_to_write);
 
-    retval = (int) write(g_dev_file_descriptor, p_wr_data, (size_t)bytes_to_write);
+    retval = syna_bus_write(BUS_OP_RMI_WRITE, address, p_wr_data, bytes_to_write);
     if (retval < 0)  {
         printf_e("%s error: fail to write data. addr = 0x%x, bytes_to_write = %d, (retval = %d)",
                  __func__, address, bytes_to_write, retval);
@@ -245,6 +275,264 @@ int rmi_write_reg(unsigned short address, unsigned char *p_wr_data, int bytes_to
     return retval;
 }
 
+/*
+ * Function:  rmi_shadow_invalidate
+ * --------------------
+ * discard all cached registers, the pending writes are dropped as well
+ * called once the device settings are restored, e.g. reset and rezero
+ */
+void rmi_shadow_invalidate(void)
+{
+    memset(g_rmi_shadow.valid, 0x00, sizeof(g_rmi_shadow.valid));
+    memset(g_rmi_shadow.dirty, 0x00, sizeof(g_rmi_shadow.dirty));
+    g_rmi_shadow.dirty_start = RMI_SHADOW_SIZE;
+    g_rmi_shadow.dirty_end = -1;
+}
+/*
+ * Function:  rmi_shadow_drop
+ * --------------------
+ * discard the cached registers in the range
+ */
+static void rmi_shadow_drop(unsigned short address, int len)
+{
+    int addr;
+    int end = MIN((int)address + len, RMI_SHADOW_SIZE);
+
+    for (addr = address; addr < end; addr++) {
+        SHADOW_CLEAR(g_rmi_shadow.valid, addr);
+        SHADOW_CLEAR(g_rmi_shadow.dirty, addr);
+    }
+}
+/*
+ * Function:  rmi_shadow_drop_clean
+ * --------------------
+ * discard all cached registers, except the pending writes of the batch
+ */
+static void rmi_shadow_drop_clean(void)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(g_rmi_shadow.valid); i++)
+        g_rmi_shadow.valid[i] &= g_rmi_shadow.dirty[i];
+}
+/*
+ * Function:  rmi_is_command_addr
+ * --------------------
+ * check whether the range covers the F01 or F54 command register
+ *
+ * return: true, the command register is in the range
+ */
+static bool rmi_is_command_addr(unsigned short address, int len)
+{
+    int end = (int)address + len;
+
+    if (!rmi_is_initialized)
+        return false;
+
+    return (((int)g_rmi_pdt.F01.command_base_addr >= (int)address) &&
+            ((int)g_rmi_pdt.F01.command_base_addr < end)) ||
+           (((int)g_rmi_pdt.F54.command_base_addr >= (int)address) &&
+            ((int)g_rmi_pdt.F54.command_base_addr < end));
+}
+/*
+ * Function:  rmi_shadow_read_reg
+ * --------------------
+ * read the control register through the shadow copy
+ * the device is accessed only if any byte in the range is not cached
+ *
+ * return: <0 - fail to read rmi reg
+ *         otherwise, number of bytes of p_rd_data
+ */
+int rmi_shadow_read_reg(unsigned short address, unsigned char *p_rd_data, int bytes_to_read)
+{
+    int retval;
+    int i;
+    int addr;
+    bool is_cached = true;
+    unsigned char *p_buf;
+
+    if (!p_rd_data || (bytes_to_read <= 0) || ((int)address + bytes_to_read > RMI_SHADOW_SIZE))
+        return rmi_read_reg(address, p_rd_data, bytes_to_read);
+
+    for (i = 0; i < bytes_to_read; i++) {
+        if (!SHADOW_TEST(g_rmi_shadow.valid, address + i)) {
+            is_cached = false;
+            break;
+        }
+    }
+
+    if (!is_cached) {
+        p_buf = malloc((size_t)bytes_to_read);
+        if (!p_buf)
+            return -ENOMEM;
+
+        retval = rmi_read_reg(address, p_buf, bytes_to_read);
+        if (retval < 0) {
+            free(p_buf);
+            return retval;
+        }
+        /* the pending writes are newer than the device */
+        for (i = 0; i < bytes_to_read; i++) {
+            addr = address + i;
+            if (!SHADOW_TEST(g_rmi_shadow.valid, addr)) {
+                g_rmi_shadow.data[addr] = p_buf[i];
+                SHADOW_SET(g_rmi_shadow.valid, addr);
+            }
+        }
+        free(p_buf);
+    }
+
+    memcpy(p_rd_data, &g_rmi_shadow.data[address], (size_t)bytes_to_read);
+
+    return bytes_to_read;
+}
+/*
+ * Function:  rmi_shadow_write_reg
+ * --------------------
+ * write the control register through the shadow copy
+ * nothing is written if the value is the same as the cached one.
+ * in a batch, the writing is kept until rmi_shadow_commit(),
+ * otherwise, it is written to the device immediately.
+ *
+ * return: <0 - fail to write rmi reg
+ *         0  - value is unchanged, no writing
+ *         otherwise, the value is changed
+ */
+int rmi_shadow_write_reg(unsigned short address, unsigned char *p_wr_data, int bytes_to_write)
+{
+    int retval;
+    int i;
+    int addr;
+    bool is_changed = false;
+
+    if (!p_wr_data || (bytes_to_write <= 0) || ((int)address + bytes_to_write > RMI_SHADOW_SIZE))
+        return rmi_write_reg(address, p_wr_data, bytes_to_write);
+
+    for (i = 0; i < bytes_to_write; i++) {
+        addr = address + i;
+        if (!SHADOW_TEST(g_rmi_shadow.valid, addr) || (g_rmi_shadow.data[addr] != p_wr_data[i])) {
+            is_changed = true;
+            break;
+        }
+    }
+    if (!is_changed)
+        return 0;
+
+    if (g_rmi_shadow.batch_depth == 0) {
+        retval = rmi_write_reg(address, p_wr_data, bytes_to_write);
+        if (retval < 0)
+            return retval;
+    }
+
+    for (i = 0; i < bytes_to_write; i++) {
+        addr = address + i;
+        g_rmi_shadow.data[addr] = p_wr_data[i];
+        SHADOW_SET(g_rmi_shadow.valid, addr);
+        if (g_rmi_shadow.batch_depth > 0)
+            SHADOW_SET(g_rmi_shadow.dirty, addr);
+    }
+    if (g_rmi_shadow.batch_depth > 0) {
+        g_rmi_shadow.dirty_start = MIN(g_rmi_shadow.dirty_start, (int)address);
+        g_rmi_shadow.dirty_end = MAX(g_rmi_shadow.dirty_end, (int)address + bytes_to_write - 1);
+    }
+
+    return bytes_to_write;
+}
+/*
+ * Function:  rmi_shadow_begin
+ * --------------------
+ * start a batch of register writing
+ * the batch could be nested, the writes are committed by the outermost one
+ */
+void rmi_shadow_begin(void)
+{
+    g_rmi_shadow.batch_depth += 1;
+}
+/*
+ * Function:  rmi_shadow_commit
+ * --------------------
+ * complete the batch, and write all changed registers to the device
+ * contiguous registers are written in one transfer
+ * a single force update is issued if requested and any register is changed
+ *
+ * return: <0 - fail to write the registers
+ *         otherwise, number of transfers
+ */
+int rmi_shadow_commit(bool do_force_update)
+{
+    int retval = 0;
+    int addr, start, i;
+    int count = 0;
+#ifdef SAVE_ERR_MSG
+    char err[MAX_ERR_STRING_LEN];
+#endif
+
+    if (g_rmi_shadow.batch_depth <= 0)
+        return 0;
+
+    g_rmi_shadow.batch_depth -= 1;
+    if (g_rmi_shadow.batch_depth > 0)
+        return 0;
+
+    addr = g_rmi_shadow.dirty_start;
+    while (addr <= g_rmi_shadow.dirty_end) {
+        if (!SHADOW_TEST(g_rmi_shadow.dirty, addr)) {
+            addr++;
+            continue;
+        }
+        start = addr;
+        while ((addr <= g_rmi_shadow.dirty_end) && SHADOW_TEST(g_rmi_shadow.dirty, addr))
+            addr++;
+
+        retval = rmi_write_reg((unsigned short)start, &g_rmi_shadow.data[start], addr - start);
+        if (retval < 0) {
+            printf_e("%s error: fail to write the registers (addr=0x%x, len=%d)\n",
+                     __func__, start, addr - start);
+#ifdef SAVE_ERR_MSG
+            sprintf(err, "%s error: fail to write the registers (addr=0x%x, len=%d)\n",
+                    __func__, start, addr - start);
+            add_error_msg(err);
+#endif
+            /* state of device is unknown */
+            rmi_shadow_invalidate();
+            goto exit;
+        }
+        /* rmi_write_reg drops the range, the written data is valid */
+        for (i = start; i < addr; i++)
+            SHADOW_SET(g_rmi_shadow.valid, i);
+
+        count += 1;
+    }
+
+    memset(g_rmi_shadow.dirty, 0x00, sizeof(g_rmi_shadow.dirty));
+    g_rmi_shadow.dirty_start = RMI_SHADOW_SIZE;
+    g_rmi_shadow.dirty_end = -1;
+
+    if (do_force_update && (count > 0)) {
+        retval = rmi_f54_force_update();
+        if (retval < 0)
+            goto exit;
+    }
+
+    retval = count;
+exit:
+    return retval;
+}
+/*
+ * Function:  rmi_shadow_discard
+ * --------------------
+ * abandon the batch being opened, the pending writes are dropped
+ * and the shadow copy is invalidated as the state of device is unknown
+ */
+void rmi_shadow_discard(void)
+{
+    if (g_rmi_shadow.batch_depth <= 0)
+        return;
+
+    g_rmi_shadow.batch_depth = 0;
+    rmi_shadow_invalidate();
+}
+
 /*
  * Function:  rmi_parse_f34_information
  * --------------------
@@ -2594,7 +2882,10 @@ int rmi_f01_sw_reset()
     if (retval < 0)
         printf_e("%s error: fail to do sw reset\n", __func__);
 
-    usleep(RMI_SW_RESET_DELAY_MS * 1000);  // delay 250 ms
+    /* all control registers are restored to the default */
+    rmi_shadow_invalidate();
+
+    syna_bus_delay_us(RMI_SW_RESET_DELAY_MS * 1000);  // delay 250 ms
     return retval;
 }
 /*
@@ -2610,9 +2901,9 @@ int rmi_f01_set_no_sleep()
     int retval;
     unsigned char device_ctrl;
 
-    retval = rmi_read_reg(g_rmi_pdt.F01.control_base_addr,
-                          &device_ctrl,
-                          sizeof(device_ctrl));
+    retval = rmi_shadow_read_reg(g_rmi_pdt.F01.control_base_addr,
+                                 &device_ctrl,
+                                 sizeof(device_ctrl));
     if (retval < 0) {
         printf_e("%s error: fail to read device ctrl\n", __func__);
         return retval;
@@ -2620,9 +2911,10 @@ int rmi_f01_set_no_sleep()
 
     device_ctrl |= RMI_NO_SLEEP_ON;
 
-    retval = rmi_write_reg(g_rmi_pdt.F01.control_base_addr,
-                           &device_ctrl,
-                           sizeof(device_ctrl));
+    /* nothing is written if no sleep is set already */
+    retval = rmi_shadow_write_reg(g_rmi_pdt.F01.control_base_addr,
+                                  &device_ctrl,
+                                  sizeof(device_ctrl));
     if (retval < 0) {
         printf_e("%s error: fail to set no sleep\n", __func__);
         return retval;
@@ -2662,7 +2954,7 @@ int rmi_f54_force_update()
         goto exit;
     }
 
-    usleep(100000); // delay 100 ms before polling the flag
+    syna_bus_delay_us(100000); // delay 100 ms before polling the flag
 
     do {
         retval = rmi_read_reg(g_rmi_pdt.F54.command_base_addr, &cmd_data, sizeof(cmd_data));
@@ -2679,9 +2971,13 @@ int rmi_f54_force_update()
         if ((cmd_data & 0x04) == 0x00)
             break;
 
-        usleep(100000);  // polling every 100 ms
+        syna_bus_delay_us(100000);  // polling every 100 ms
         time_count += 1;
 
+        /* stop waiting once the test job is cancelled or over its deadline */
+        retval = syna_job_check_abort();
+        if (retval < 0)
+            goto exit;
     } while (time_count < RMI_COMMAND_TIMEOUT);
 
     if (time_count == RMI_COMMAND_TIMEOUT) {
@@ -2715,7 +3011,7 @@ int rmi_f54_no_relax(bool en)
     char err[MAX_ERR_STRING_LEN];
 #endif
 
-    retval = rmi_read_reg(g_rmi_pdt.F54.control_base_addr, &value, sizeof(value));
+    retval = rmi_shadow_read_reg(g_rmi_pdt.F54.control_base_addr, &value, sizeof(value));
     if (retval < 0) {
         printf_e("%s error: fail to read F54Ctr00 register\n", __func__);
 #ifdef SAVE_ERR_MSG
@@ -2731,7 +3027,7 @@ int rmi_f54_no_relax(bool en)
     else
         value = (unsigned char) (value & 0xfe);
 
-    retval = rmi_write_reg(g_rmi_pdt.F54.control_base_addr, &value, sizeof(value));
+    retval = rmi_shadow_write_reg(g_rmi_pdt.F54.control_base_addr, &value, sizeof(value));
     if (retval < 0) {
         printf_e("%s error: fail to write data to F54Ctr00 register\n", __func__);
 #ifdef SAVE_ERR_MSG
@@ -2741,6 +3037,10 @@ int rmi_f54_no_relax(bool en)
 #endif
         goto exit;
     }
+    if (retval == 0) {
+        printf_i("%s: no relax is configured already\n", __func__);
+        goto exit;
+    }
 
     retval = rmi_f54_force_update();
     if (retval < 0) {
@@ -2749,10 +3049,26 @@ int rmi_f54_no_relax(bool en)
         sprintf(err, "%s error: fail to do force_update\n", __func__);
         add_error_msg(err);
 #endif
+        goto exit;
     }
 
+    /* verify the setting on the device, the shadow copy is not used here */
     value = 0x00;
     retval = rmi_read_reg(g_rmi_pdt.F54.control_base_addr, &value, sizeof(value));
+    if (retval < 0) {
+        printf_e("%s error: fail to read back F54Ctr00 register\n", __func__);
+        goto exit;
+    }
+    if ((bool)(value & 0x01) != en) {
+        printf_e("%s error: F54Ctr00 is not updated (data=0x%x)\n", __func__, value);
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: F54Ctr00 is not updated (addr=0x%x)(data=0x%x)\n",
+                __func__, g_rmi_pdt.F54.control_base_addr, value);
+        add_error_msg(err);
+#endif
+        retval = -EIO;
+        goto exit;
+    }
 
     printf_i("%s: no relax done\n", __func__);
 
@@ -2790,7 +3106,7 @@ int rmi_f54_force_cal()
         goto exit;
     }
 
-    usleep(100000); // delay 100 ms before polling the flag
+    syna_bus_delay_us(100000); // delay 100 ms before polling the flag
 
     do {
         retval = rmi_read_reg(g_rmi_pdt.F54.command_base_addr, &cmd_data, sizeof(cmd_data));
@@ -2807,9 +3123,13 @@ int rmi_f54_force_cal()
         if ((cmd_data & 0x04) == 0x00)
             break;
 
-        usleep(100000);  // polling every 100 ms
+        syna_bus_delay_us(100000);  // polling every 100 ms
         time_count += 1;
 
+        /* stop waiting once the test job is cancelled or over its deadline */
+        retval = syna_job_check_abort();
+        if (retval < 0)
+            goto exit;
     } while (time_count < RMI_COMMAND_TIMEOUT);
 
     if (time_count == RMI_COMMAND_TIMEOUT) {
@@ -2826,6 +3146,9 @@ int rmi_f54_force_cal()
 
     printf_i("%s: force cal done\n", __func__);
 
+    /* re-read the control registers after the rezero */
+    rmi_shadow_invalidate();
+
 exit:
     return retval;
 }
@@ -2905,7 +3228,7 @@ int rmi_f54_enable_one_gear(int gear)
     char err[MAX_ERR_STRING_LEN];
 #endif
 
-    retval = rmi_read_reg(g_rmi_pdt.f54_control_reg95_offset, freqCtrl, sizeof(freqCtrl));
+    retval = rmi_shadow_read_reg(g_rmi_pdt.f54_control_reg95_offset, freqCtrl, sizeof(freqCtrl));
     if (retval < 0) {
         printf_e("%s error: fail to read F54Ctr95 register\n", __func__);
 #ifdef SAVE_ERR_MSG
@@ -2926,7 +3249,7 @@ int rmi_f54_enable_one_gear(int gear)
             freqCtrl[i * size] = (unsigned char) (freqCtrl[i * size] | 0x80);
         }
     }
-    retval = rmi_write_reg(g_rmi_pdt.f54_control_reg95_offset, freqCtrl, sizeof(freqCtrl));
+    retval = rmi_shadow_write_reg(g_rmi_pdt.f54_control_reg95_offset, freqCtrl, sizeof(freqCtrl));
     if (retval < 0) {
         printf_e("%s error: fail to write data to the f54Ctrl95, try to enable gear %d \n",
                  __func__, gear);
@@ -2945,6 +3268,10 @@ int rmi_f54_enable_one_gear(int gear)
 #endif
         goto exit;
     }
+    if (retval == 0) {
+        printf_i("%s: frequency gear-%d is enabled already\n", __func__, gear);
+        goto exit;
+    }
 
     retval = rmi_f54_force_update();
     if (retval < 0) {
@@ -3008,11 +3335,14 @@ int rmi_disable_cbc_cdm()
         return 0;
     }
 
+    /* registers are written together, nothing is written if all are disabled already */
+    rmi_shadow_begin();
+
     if (g_rmi_pdt.f54_query.touch_controller_family == 1) {
         // disable cbc, reg_7
-        retval = rmi_read_reg(g_rmi_pdt.f54_control.reg_7.address,
-                              g_rmi_pdt.f54_control.reg_7.data,
-                              sizeof(g_rmi_pdt.f54_control.reg_7.data));
+        retval = rmi_shadow_read_reg(g_rmi_pdt.f54_control.reg_7.address,
+                                     g_rmi_pdt.f54_control.reg_7.data,
+                                     sizeof(g_rmi_pdt.f54_control.reg_7.data));
         if (retval < 0) {
             printf_e("%s error: fail to read data f54_control reg_7\n", __func__);
 #ifdef SAVE_ERR_MSG
@@ -3022,9 +3352,9 @@ int rmi_disable_cbc_cdm()
             goto exit;
         }
         g_rmi_pdt.f54_control.reg_7.cbc_tx_carrier_selection = 0;
-        retval = rmi_write_reg(g_rmi_pdt.f54_control.reg_7.address,
-                               g_rmi_pdt.f54_control.reg_7.data,
-                               sizeof(g_rmi_pdt.f54_control.reg_7.data));
+        retval = rmi_shadow_write_reg(g_rmi_pdt.f54_control.reg_7.address,
+                                      g_rmi_pdt.f54_control.reg_7.data,
+                                      sizeof(g_rmi_pdt.f54_control.reg_7.data));
         if (retval < 0) {
 #ifdef SAVE_ERR_MSG
             printf_e("%s error: fail to write data f54_control reg_7\n", __func__);
@@ -3036,9 +3366,9 @@ int rmi_disable_cbc_cdm()
     }
     else if (g_rmi_pdt.f54_query.has_ctrl88) {
         // disable cbc, reg_88
-        retval = rmi_read_reg(g_rmi_pdt.f54_control.reg_88.address,
-                              g_rmi_pdt.f54_control.reg_88.data,
-                              sizeof(g_rmi_pdt.f54_control.reg_88.data));
+        retval = rmi_shadow_read_reg(g_rmi_pdt.f54_control.reg_88.address,
+                                     g_rmi_pdt.f54_control.reg_88.data,
+                                     sizeof(g_rmi_pdt.f54_control.reg_88.data));
         if (retval < 0) {
             printf_e("%s error: fail to read data f54_control reg_88\n", __func__);
 #ifdef SAVE_ERR_MSG
@@ -3048,9 +3378,9 @@ int rmi_disable_cbc_cdm()
             goto exit;
         }
         g_rmi_pdt.f54_control.reg_88.cbc_tx_carrier_selection = 0;
-        retval = rmi_write_reg(g_rmi_pdt.f54_control.reg_88.address,
-                               g_rmi_pdt.f54_control.reg_88.data,
-                               sizeof(g_rmi_pdt.f54_control.reg_88.data));
+        retval = rmi_shadow_write_reg(g_rmi_pdt.f54_control.reg_88.address,
+                                      g_rmi_pdt.f54_control.reg_88.data,
+                                      sizeof(g_rmi_pdt.f54_control.reg_88.data));
         if (retval < 0) {
             printf_e("%s error: fail to write data f54_control reg_88\n", __func__);
 #ifdef SAVE_ERR_MSG
@@ -3063,9 +3393,9 @@ int rmi_disable_cbc_cdm()
 
     if (g_rmi_pdt.f54_query.has_0d_acquisition_control) {
         // disable cbc, reg_57
-        retval = rmi_read_reg(g_rmi_pdt.f54_control.reg_57.address,
-                              g_rmi_pdt.f54_control.reg_57.data,
-                              sizeof(g_rmi_pdt.f54_control.reg_57.data));
+        retval = rmi_shadow_read_reg(g_rmi_pdt.f54_control.reg_57.address,
+                                     g_rmi_pdt.f54_control.reg_57.data,
+                                     sizeof(g_rmi_pdt.f54_control.reg_57.data));
         if (retval < 0) {
             printf_e("%s error: fail to read data f54_control reg_57\n", __func__);
 #ifdef SAVE_ERR_MSG
@@ -3075,9 +3405,9 @@ int rmi_disable_cbc_cdm()
             goto exit;
         }
         g_rmi_pdt.f54_control.reg_57.cbc_tx_carrier_selection = 0;
-        retval = rmi_write_reg(g_rmi_pdt.f54_control.reg_57.address,
-                               g_rmi_pdt.f54_control.reg_57.data,
-                               sizeof(g_rmi_pdt.f54_control.reg_57.data));
+        retval = rmi_shadow_write_reg(g_rmi_pdt.f54_control.reg_57.address,
+                                      g_rmi_pdt.f54_control.reg_57.data,
+                                      sizeof(g_rmi_pdt.f54_control.reg_57.data));
         if (retval < 0) {
             printf_e("%s error: fail to write data f54_control reg_57\n", __func__);
 #ifdef SAVE_ERR_MSG
@@ -3098,9 +3428,21 @@ int rmi_disable_cbc_cdm()
         (g_rmi_pdt.f54_query_33.has_query36) &&
         (g_rmi_pdt.f54_query_36.has_query38) &&
         (g_rmi_pdt.f54_query_38.has_ctrl149)) {
-        retval = rmi_write_reg(g_rmi_pdt.f54_control.reg_149.address,
-                               &zero,
-                               sizeof(g_rmi_pdt.f54_control.reg_149.data));
+        /* read at first, so the writing can be skipped if it is disabled already */
+        retval = rmi_shadow_read_reg(g_rmi_pdt.f54_control.reg_149.address,
+                                     g_rmi_pdt.f54_control.reg_149.data,
+                                     sizeof(g_rmi_pdt.f54_control.reg_149.data));
+        if (retval < 0) {
+            printf_e("%s error: fail to read data f54_control reg_149\n", __func__);
+#ifdef SAVE_ERR_MSG
+            sprintf(err, "%s error: fail to read data f54_control reg_149\n", __func__);
+            add_error_msg(err);
+#endif
+            goto exit;
+        }
+        retval = rmi_shadow_write_reg(g_rmi_pdt.f54_control.reg_149.address,
+                                      &zero,
+                                      sizeof(g_rmi_pdt.f54_control.reg_149.data));
         if (retval < 0) {
             printf_e("%s error: fail to write data f54_control reg_149\n", __func__);
 #ifdef SAVE_ERR_MSG
@@ -3112,9 +3454,9 @@ int rmi_disable_cbc_cdm()
     }
 
     if (g_rmi_pdt.f54_query.has_signal_clarity) {
-        retval = rmi_read_reg(g_rmi_pdt.f54_control.reg_41.address,
-                              &value,
-                              sizeof(g_rmi_pdt.f54_control.reg_41.data));
+        retval = rmi_shadow_read_reg(g_rmi_pdt.f54_control.reg_41.address,
+                                     &value,
+                                     sizeof(g_rmi_pdt.f54_control.reg_41.data));
         if (retval < 0) {
             printf_e("%s error: fail to read data f54_control reg_41\n", __func__);
 #ifdef SAVE_ERR_MSG
@@ -3124,9 +3466,9 @@ int rmi_disable_cbc_cdm()
             goto exit;
         }
         value |= 0x01;
-        retval = rmi_write_reg(g_rmi_pdt.f54_control.reg_41.address,
-                               &value,
-                               sizeof(g_rmi_pdt.f54_control.reg_41.data));
+        retval = rmi_shadow_write_reg(g_rmi_pdt.f54_control.reg_41.address,
+                                      &value,
+                                      sizeof(g_rmi_pdt.f54_control.reg_41.data));
         if (retval < 0) {
             printf_e("%s error: fail to write data f54_control reg_149\n", __func__);
 #ifdef SAVE_ERR_MSG
@@ -3137,7 +3479,7 @@ int rmi_disable_cbc_cdm()
         }
     }
 
-    retval = rmi_f54_force_update();
+    retval = rmi_shadow_commit(true);
     if (retval < 0) {
         printf_e("%s error: fail to do force update\n", __func__);
 #ifdef SAVE_ERR_MSG
@@ -3147,7 +3489,11 @@ int rmi_disable_cbc_cdm()
         goto exit;
     }
 
-    retval =  rmi_f54_force_cal();;
+    if (retval == 0)
+        printf_i("%s info: cbc/cdm is disabled already, no force update\n", __func__);
+
+    /* always rezero, the baseline is expected to be fresh before the test */
+    retval = rmi_f54_force_cal();
     if (retval < 0) {
         printf_e("%s error: fail to do force cal\n", __func__);
 #ifdef SAVE_ERR_MSG
@@ -3157,5 +3503,9 @@ int rmi_disable_cbc_cdm()
         goto exit;
     }
 exit:
+    /* drop the pending writes if fail */
+    if (retval < 0)
+        rmi_shadow_discard();
+
     return retval;
 }
@@ -1578,6 +1578,14 @@ int rmi_close_dev(const char *dev_node);
 int rmi_read_reg(unsigned short address, unsigned char *p_rd_data, int bytes_to_read);
 int rmi_write_reg(unsigned short address, unsigned char *p_wr_data, int bytes_to_write);
 
+/* helper to access the control registers through the shadow copy */
+int rmi_shadow_read_reg(unsigned short address, unsigned char *p_rd_data, int bytes_to_read);
+int rmi_shadow_write_reg(unsigned short address, unsigned char *p_wr_data, int bytes_to_write);
+void rmi_shadow_begin(void);
+int rmi_shadow_commit(bool do_force_update);
+void rmi_shadow_discard(void);
+void rmi_shadow_invalidate(void);
+
 /* helper to issue a sw reset */
 int rmi_f01_sw_reset();
 /* helper to configure into no sleep mode */
@@ -235,8 +235,8 @@ int rmi_do_test_noise_rt02(int *p_result_img, int result_img_col, int result_img
     printf_i("%s info: %s (failure_frame_cnt = %d)\n",
              __func__, (failure_frame_cnt == 0)?"pass":"fail", failure_frame_cnt);
 exit:
-    /* issue a sw reset at the end */
-    syna_do_sw_reset();
+    /* issue a sw reset at the end, unless the test plan skips it */
+    syna_do_test_post_reset();
 
     if(p_data_rt2)
         free(p_data_rt2);
@@ -317,7 +317,7 @@ int rmi_do_test_full_raw_cap_rt20(int *p_result_img, int result_img_col, int res
     }
 
     /* do on-preparation before reading the rt20 */
-    retval = rmi_disable_cbc_cdm();
+    retval = syna_do_test_disable_cbc_cdm();
     if (retval < 0) {
         printf_e("%s error: fail to do preparation before running the rt20\n", __func__);
 #ifdef SAVE_ERR_MSG
@@ -393,8 +393,8 @@ int rmi_do_test_full_raw_cap_rt20(int *p_result_img, int result_img_col, int res
     printf_i("%s info: %s (fail_cnt = %d)\n",
              __func__, (failure_cnt == 0)?"pass":"fail", failure_cnt);
 exit:
-    /* issue a sw reset at the end */
-    syna_do_sw_reset();
+    /* issue a sw reset at the end, unless the test plan skips it */
+    syna_do_test_post_reset();
 
     if(p_data_rt20)
         free(p_data_rt20);
@@ -535,8 +535,8 @@ int rmi_do_test_full_raw_tddi_rt92(int *p_result_img, int result_img_col, int re
     printf_i("%s info: %s (fail_cnt = %d)\n",
              __func__, (failure_cnt == 0)?"pass":"fail", failure_cnt);
 exit:
-    /* issue a sw reset at the end */
-    syna_do_sw_reset();
+    /* issue a sw reset at the end, unless the test plan skips it */
+    syna_do_test_post_reset();
 
     if(p_data_rt92)
         free(p_data_rt92);
@@ -654,7 +654,7 @@ int rmi_do_test_ex_high_resistance_rt20(short *p_result_tixel, short *p_result_r
 
 
     /* do on-preparation before reading the rt20 */
-    retval = rmi_disable_cbc_cdm();
+    retval = syna_do_test_disable_cbc_cdm();
     if (retval < 0) {
         printf_e("%s error: fail to do preparation before running the rt20\n", __func__);
 #ifdef SAVE_ERR_MSG
@@ -735,8 +735,8 @@ int rmi_do_test_ex_high_resistance_rt20(short *p_result_tixel, short *p_result_r
     printf_i("%s info: %s (fail_cnt = %d)\n",
              __func__, (failure_cnt == 0)?"pass":"fail", failure_cnt);
 exit:
-    /* issue a sw reset at the end */
-    syna_do_sw_reset();
+    /* issue a sw reset at the end, unless the test plan skips it */
+    syna_do_test_post_reset();
 
     if(p_data_rt20)
         free(p_data_rt20);
@@ -941,8 +941,8 @@ int rmi_do_test_trx_short_rt26(int *p_result_data, int size_of_result_data, int
     printf_i("%s info: %s (fail_cnt = %d)\n",
              __func__, (failure_cnt == 0)?"pass":"fail", failure_cnt);
 exit:
-    /* issue a sw reset at the end */
-    syna_do_sw_reset();
+    /* issue a sw reset at the end, unless the test plan skips it */
+    syna_do_test_post_reset();
 
     return (retval < 0)? retval : failure_cnt;
 }
@@ -1327,8 +1327,8 @@ int rmi_do_test_ex_trx_short_rt26100(int *p_result_data_26, int size_of_result_d
              __func__, (failure_cnt_26 + failure_cnt_100 == 0)?"pass":"fail", failure_cnt_26 + failure_cnt_100);
 
 exit:
-    /* issue a sw reset at the end */
-    syna_do_sw_reset();
+    /* issue a sw reset at the end, unless the test plan skips it */
+    syna_do_test_post_reset();
 
     if(p_rt100_img1)
         free(p_rt100_img1);
@@ -1500,8 +1500,8 @@ int rmi_do_test_abs_open_rt63(int *p_result_img, int size_of_result_data,
     printf_i("%s info: %s (fail_cnt = %d)\n",
              __func__, (failure_cnt == 0)?"pass":"fail", failure_cnt);
 exit:
-    /* issue a sw reset at the end */
-    syna_do_sw_reset();
+    /* issue a sw reset at the end, unless the test plan skips it */
+    syna_do_test_post_reset();
 
     if(p_rt63_data)
         free(p_rt63_data);
@@ -1683,8 +1683,8 @@ int rmi_do_test_adc_range_rt23(int *p_result_img, int result_img_col, int result
     printf_i("%s info: %s (fail_cnt = %d)\n",
              __func__, (failure_cnt == 0)?"pass":"fail", failure_cnt);
 exit:
-    /* issue a sw reset at the end */
-    syna_do_sw_reset();
+    /* issue a sw reset at the end, unless the test plan skips it */
+    syna_do_test_post_reset();
 
     if (p_rt23_data)
         free(p_rt23_data);
@@ -1826,8 +1826,8 @@ int rmi_do_test_sensor_speed_rt22(int *p_result_img, int result_img_col, int res
     printf_i("%s info: %s (fail_cnt = %d)\n",
              __func__, (failure_cnt == 0)?"pass":"fail", failure_cnt);
 exit:
-    /* issue a sw reset at the end */
-    syna_do_sw_reset();
+    /* issue a sw reset at the end, unless the test plan skips it */
+    syna_do_test_post_reset();
 
     if (p_data_rt22)
         free(p_data_rt22);
@@ -1949,8 +1949,8 @@ int rmi_do_test_tagsmoisture_rt76(int *p_result_img, int result_img_col, int res
     printf_i("%s info: %s (fail_cnt = %d)\n",
              __func__, (failure_cnt == 0)?"pass":"fail", failure_cnt);
 exit:
-    /* issue a sw reset at the end */
-    syna_do_sw_reset();
+    /* issue a sw reset at the end, unless the test plan skips it */
+    syna_do_test_post_reset();
 
     if (p_data_rt76)
         free(p_data_rt76);
@@ -2072,8 +2072,8 @@ int rmi_do_test_rt133(int *p_result_img, int size_of_result_data,
     printf_i("%s info: %s (fail_cnt = %d)\n",
              __func__, (failure_cnt == 0)?"pass":"fail", failure_cnt);
 exit:
-    /* issue a sw reset at the end */
-    syna_do_sw_reset();
+    /* issue a sw reset at the end, unless the test plan skips it */
+    syna_do_test_post_reset();
 
     if (p_rt133_data)
         free(p_rt133_data);
@@ -2252,8 +2252,8 @@ int rmi_do_test_abs_delta_rt59(int *p_result_img, int size_of_result_data,
     printf_i("%s info: %s (fail_cnt = %d)\n",
              __func__, (failure_cnt == 0)?"pass":"fail", failure_cnt);
 exit:
-    /* issue a sw reset at the end */
-    syna_do_sw_reset();
+    /* issue a sw reset at the end, unless the test plan skips it */
+    syna_do_test_post_reset();
 
     if(p_rt59_data)
         free(p_rt59_data);
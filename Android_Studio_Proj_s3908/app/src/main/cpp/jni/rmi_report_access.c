@@ -33,6 +33,9 @@
 
 #include "syna_dev_manager.h"
 #include "rmi_control.h"
+#include "syna_test_job.h"
+#include "syna_bus_trace.h"
+#include "syna_frame_latency.h"
 
 #ifdef SAVE_ERR_MSG
 #include "err_msg_ctrl.h"
@@ -86,7 +89,13 @@ static int rmi_f54_read_report_data(int report_type)
                             __func__, g_rmi_pdt.F54.command_base_addr, cmd_data, retry);
             add_error_msg(err);
 #endif
-            usleep(GET_REPORT_REG_CLEAR_DELAY);
+            syna_bus_delay_us(GET_REPORT_REG_CLEAR_DELAY);
+
+            /* stop waiting once the test job is cancelled or over its deadline */
+            retval = syna_job_check_abort();
+            if (retval < 0)
+                goto exit;
+
             retry += 1;
             retval = rmi_read_reg(g_rmi_pdt.F54.command_base_addr, &cmd_data, sizeof(cmd_data));
         } while( (retry < GET_REPORT_REG_CLEAR_RETRY) && ((cmd_data & 0x01) != 0x00) );
@@ -147,7 +156,12 @@ static int rmi_f54_read_report_data(int report_type)
     }
 
     do {
-        usleep(10000);  // polling every 10 ms
+        syna_bus_delay_us(10000);  // polling every 10 ms
+
+        /* stop waiting once the test job is cancelled or over its deadline */
+        retval = syna_job_check_abort();
+        if (retval < 0)
+            goto exit;
 
         retval = rmi_read_reg(g_rmi_pdt.F54.command_base_addr, &cmd_data, sizeof(cmd_data));
         if (retval < 0) {
@@ -238,6 +252,7 @@ int rmi_f54_read_report_frame(int report_type, int *p_out, int size_out, bool ou
 #endif
         goto exit;
     }
+    syna_frame_latency_mark(FRAME_STAMP_HEADER);
 
     /* step 5 */
     /* retrieve report data */
@@ -252,6 +267,7 @@ int rmi_f54_read_report_frame(int report_type, int *p_out, int size_out, bool ou
 #endif
         goto exit;
     }
+    syna_frame_latency_mark(FRAME_STAMP_PAYLOAD);
 
     /* copy data to the output buffer                                                   */
     /* however, there are two different layout in f54 report                            */
@@ -289,6 +305,7 @@ int rmi_f54_read_report_frame(int report_type, int *p_out, int size_out, bool ou
             p_data_16++;
         }
     }
+    syna_frame_latency_mark(FRAME_STAMP_REORDER);
 exit:
     if(data_buf)
         free(data_buf);
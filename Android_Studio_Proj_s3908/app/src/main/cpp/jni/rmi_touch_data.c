@@ -34,6 +34,7 @@
 
 #include "syna_dev_manager.h"
 #include "rmi_control.h"
+#include "syna_bus_trace.h"
 
 #ifdef SAVE_ERR_MSG
 #include "err_msg_ctrl.h"
@@ -259,7 +260,7 @@ int rmi_query_touch_response(int *touch_x, int* touch_y, int* touch_status,
         }
 
         retry += 1;
-        usleep(POLLING_TOUCH_REPORT_DELAY_MS * 1000);
+        syna_bus_delay_us(POLLING_TOUCH_REPORT_DELAY_MS * 1000);
 
     } while( (retry < POLLING_TOUCH_REPORT_CNT) );
 
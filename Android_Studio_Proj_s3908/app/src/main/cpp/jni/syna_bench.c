@@ -0,0 +1,653 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+/*
+ * standalone micro-benchmark of the frame, test and analysis kernels,
+ * built from the same sources as libnative_syna.
+ *
+ * the kernels are driven through their public entry points, and the device
+ * transactions are fed by a synthetic trace replayed without delay, see
+ * syna_bus_trace.h. so the numbers include the memory copy of the transport,
+ * which is reported separately as "tcm_read_message" for reference.
+ *
+ * the result of each kernel and sensor size is printed as one JSON object per line.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+#include "syna_dev_manager.h"
+#include "rmi_control.h"
+#include "tcm_control.h"
+#include "syna_bus_trace.h"
+#include "syna_heatmap.h"
+
+#define BENCH_DEFAULT_ITERATIONS (200)
+#define BENCH_WARMUP_ITERATIONS  (10)
+#define BENCH_DEFAULT_TMP_DIR    "/data/local/tmp"
+
+#define BENCH_TCM_DEV_TYPE  (2)
+#define BENCH_RMI_DEV_TYPE  (1)
+
+/* upscaling of the heatmap kernels */
+#define BENCH_HEATMAP_SCALE (10)
+
+#define BENCH_RMI_CMD_BASE  (0x0100)
+#define BENCH_RMI_DATA_BASE (0x0200)
+
+/* sensor sizes, tx x rx */
+static const int g_bench_sizes[][2] = {
+    {16, 32},
+    {24, 48},
+    {32, 64},
+    {48, 96},
+};
+
+/* layout of touch report used by the touch parsing kernel */
+static const unsigned char g_bench_touch_config[] = {
+    5, 32,          /* TOUCH_TIMESTAMP */
+    24, 8,          /* TOUCH_NUM_OF_ACTIVE_OBJECTS */
+    1,              /* TOUCH_FOREACH_ACTIVE_OBJECT */
+    6, 4,           /* TOUCH_OBJECT_N_INDEX */
+    7, 4,           /* TOUCH_OBJECT_N_CLASSIFICATION */
+    8, 16,          /* TOUCH_OBJECT_N_X_POSITION */
+    9, 16,          /* TOUCH_OBJECT_N_Y_POSITION */
+    10, 8,          /* TOUCH_OBJECT_N_Z */
+    11, 8,          /* TOUCH_OBJECT_N_X_WIDTH */
+    12, 8,          /* TOUCH_OBJECT_N_Y_WIDTH */
+    3,              /* TOUCH_FOREACH_END */
+    0,              /* TOUCH_END */
+};
+#define BENCH_TOUCH_OBJECT_BYTES (8)
+
+extern void extended_high_resistance_test(
+        unsigned char rx_2d_channel, unsigned char tx_2d_channel,
+        signed short * delta_2d_image, signed short * baseline_image, signed short * ref_2d_image,
+        signed short * rx_Result, signed short * tx_Result, signed short * surface_Result);
+
+/* destination of the JSON output */
+static FILE *g_out;
+
+/* synthetic trace being written */
+static FILE *g_trace_fp;
+static char g_trace_path[MAX_STRING_LEN];
+
+/* variables of the kernel being measured */
+struct bench_ctx {
+    int tx;
+    int rx;
+    int *p_out;
+    int *p_limit_min;
+    int *p_limit_max;
+    int pins_result[TCM_MAX_PINS];
+    int pins_limit[TCM_MAX_PINS];
+    int trx_data[TCM_MAX_PINS / 8];
+    short *p_delta;
+    short *p_baseline;
+    short *p_ref;
+    short *p_surface;
+    short *p_rx_result;
+    short *p_tx_result;
+    unsigned char *p_buf;
+    int payload;
+    unsigned int *p_pixels;
+    struct syna_heatmap heatmap_nearest;
+    struct syna_heatmap heatmap_bilinear;
+};
+
+struct bench_kernel {
+    const char *name;
+    int dev_type;
+    /* put the transactions of one call into the trace */
+    void (*put)(struct bench_ctx *p_ctx);
+    /* the call being measured */
+    int (*run)(struct bench_ctx *p_ctx);
+};
+
+/* callbacks of touch report, declared in native_syna_lib.h */
+void callback_finger_down(int index, int x_pos, int y_pos)
+{
+}
+void callback_finger_up(int index)
+{
+}
+
+/*
+ * Function:  bench_put_record
+ * --------------------
+ * append one transaction to the synthetic trace
+ */
+static void bench_put_record(int op, unsigned short addr, const void *p_data,
+                             int length, int retval)
+{
+    struct syna_bus_record record;
+
+    memset(&record, 0x00, sizeof(record));
+    record.op = (unsigned char)op;
+    record.addr = addr;
+    record.retval = retval;
+    record.length = (unsigned int)length;
+
+    fwrite(&record, sizeof(record), 1, g_trace_fp);
+    if (length > 0)
+        fwrite(p_data, 1, (size_t)length, g_trace_fp);
+}
+/*
+ * Function:  bench_put_tcm_header
+ * --------------------
+ * append the 4-byte tcm message header
+ */
+static void bench_put_tcm_header(unsigned char code, int payload)
+{
+    unsigned char header[4];
+
+    header[0] = 0xa5;
+    header[1] = code;
+    header[2] = (unsigned char)(payload & 0xff);
+    header[3] = (unsigned char)((payload >> 8) & 0xff);
+
+    bench_put_record(BUS_OP_TCM_READ, 0, header, sizeof(header), sizeof(header));
+}
+/*
+ * Function:  bench_put_tcm_payload
+ * --------------------
+ * append the tcm payload, 2-byte header + payload + 1-byte ending
+ */
+static void bench_put_tcm_payload(struct bench_ctx *p_ctx, const unsigned char *p_payload, int payload)
+{
+    p_ctx->p_buf[0] = 0xa5;
+    p_ctx->p_buf[1] = STATUS_CONTINUED_READ;
+    memcpy(&p_ctx->p_buf[2], p_payload, (size_t)payload);
+    p_ctx->p_buf[payload + 2] = 0x5a;
+
+    bench_put_record(BUS_OP_TCM_READ, 0, p_ctx->p_buf, payload + 3, payload + 3);
+}
+/*
+ * Function:  bench_put_tcm_test_command
+ * --------------------
+ * append a production test command and its response
+ */
+static void bench_put_tcm_test_command(unsigned char test_id, int payload)
+{
+    unsigned char command[4] = {CMD_PRODUCTION_TEST, 0x01, 0x00, 0x00};
+
+    command[3] = test_id;
+    bench_put_record(BUS_OP_TCM_WRITE, 0, command, sizeof(command), sizeof(command));
+    bench_put_tcm_header(STATUS_OK, payload);
+}
+/*
+ * Function:  bench_fill_image
+ * --------------------
+ * generate a synthetic 16-bit image around the given level
+ */
+static void bench_fill_image(short *p_image, int size, int level, int seed)
+{
+    int i;
+    unsigned int lfsr = 0xace1u + (unsigned int)seed;
+
+    for (i = 0; i < size; i++) {
+        lfsr = lfsr * 1103515245u + 12345u;
+        p_image[i] = (short)(level + (int)((lfsr >> 16) % 64) - 32);
+    }
+}
+
+/* kernel: transport only, the copy of one tcm frame */
+static void bench_put_tcm_read(struct bench_ctx *p_ctx)
+{
+    bench_put_tcm_payload(p_ctx, p_ctx->p_buf + p_ctx->payload + 3, p_ctx->payload);
+}
+static int bench_run_tcm_read(struct bench_ctx *p_ctx)
+{
+    return tcm_read_message(p_ctx->p_buf, (unsigned int)(p_ctx->payload + 3));
+}
+
+/* kernel: tcm_get_touch_report, including tcm_parse_touch_report */
+static void bench_put_tcm_touch(struct bench_ctx *p_ctx)
+{
+    unsigned char report[5 + TCM_FINGERS_TO_SUPPORT * BENCH_TOUCH_OBJECT_BYTES];
+    unsigned char *p_obj;
+    int i;
+
+    memset(report, 0x00, sizeof(report));
+    report[4] = TCM_FINGERS_TO_SUPPORT;
+    for (i = 0; i < TCM_FINGERS_TO_SUPPORT; i++) {
+        p_obj = &report[5 + i * BENCH_TOUCH_OBJECT_BYTES];
+        p_obj[0] = (unsigned char)(i | 0x10);                 /* index, classification */
+        p_obj[1] = (unsigned char)(i * 40);                   /* x */
+        p_obj[3] = (unsigned char)(i * 80);                   /* y */
+        p_obj[5] = 0x30;                                      /* z */
+        p_obj[6] = 0x05;
+        p_obj[7] = 0x05;
+    }
+    bench_put_tcm_payload(p_ctx, report, sizeof(report));
+}
+static int bench_run_tcm_touch(struct bench_ctx *p_ctx)
+{
+    return tcm_get_touch_report(5 + TCM_FINGERS_TO_SUPPORT * BENCH_TOUCH_OBJECT_BYTES);
+}
+
+/* kernel: tcm_read_report_frame, reordered into the landscape layout */
+static void bench_put_tcm_frame(struct bench_ctx *p_ctx)
+{
+    bench_put_tcm_header(TCM_REPORT_DELTA, p_ctx->payload);
+    bench_put_tcm_payload(p_ctx, (unsigned char *)p_ctx->p_delta, p_ctx->payload);
+}
+static int bench_run_tcm_frame(struct bench_ctx *p_ctx)
+{
+    return tcm_read_report_frame(TCM_REPORT_DELTA, p_ctx->p_out, p_ctx->tx * p_ctx->rx, true);
+}
+
+/* kernel: rmi_f54_read_report_frame, reordered into the landscape layout */
+static void bench_put_rmi_frame(struct bench_ctx *p_ctx)
+{
+    unsigned char cmd = 0x00;
+    unsigned char fifo[2] = {0x00, 0x00};
+    unsigned char report_type = 2;
+
+    bench_put_record(BUS_OP_RMI_READ, BENCH_RMI_CMD_BASE, &cmd, 1, 1);
+    bench_put_record(BUS_OP_RMI_WRITE, BENCH_RMI_DATA_BASE, &report_type, 1, 1);
+    bench_put_record(BUS_OP_RMI_WRITE, BENCH_RMI_DATA_BASE + 1, fifo, 2, 2);
+    cmd = RMI_COMMAND_GET_REPORT;
+    bench_put_record(BUS_OP_RMI_WRITE, BENCH_RMI_CMD_BASE, &cmd, 1, 1);
+    cmd = 0x00;
+    bench_put_record(BUS_OP_RMI_READ, BENCH_RMI_CMD_BASE, &cmd, 1, 1);
+    bench_put_record(BUS_OP_RMI_READ, BENCH_RMI_DATA_BASE + RMI_REPROT_DATA_OFFSET,
+                     p_ctx->p_delta, p_ctx->payload, p_ctx->payload);
+}
+static int bench_run_rmi_frame(struct bench_ctx *p_ctx)
+{
+    return rmi_f54_read_report_frame(2, p_ctx->p_out, p_ctx->tx * p_ctx->rx, true);
+}
+
+/* kernel: full raw test, reordering and the per-pixel limit checking */
+static void bench_put_tcm_full_raw(struct bench_ctx *p_ctx)
+{
+    bench_put_tcm_test_command(TEST_FULLRAW, p_ctx->payload);
+    bench_put_tcm_payload(p_ctx, (unsigned char *)p_ctx->p_baseline, p_ctx->payload);
+}
+static int bench_run_tcm_full_raw(struct bench_ctx *p_ctx)
+{
+    int rows = syna_get_image_rows(true);
+    int cols = syna_get_image_cols(true);
+
+    return tcm_do_test_full_raw_pid05(p_ctx->p_out, cols, rows,
+                                      p_ctx->p_limit_min, rows * cols,
+                                      p_ctx->p_limit_max, rows * cols);
+}
+
+/* kernel: trx short test, the pin analysis */
+static void bench_put_tcm_trx_short(struct bench_ctx *p_ctx)
+{
+    unsigned char data[TCM_MAX_PINS / 8];
+
+    memset(data, 0x00, sizeof(data));
+    bench_put_tcm_test_command(TEST_TRX_SENSOR_OPEN, sizeof(data));
+    bench_put_tcm_payload(p_ctx, data, sizeof(data));
+}
+static int bench_run_tcm_trx_short(struct bench_ctx *p_ctx)
+{
+    return tcm_do_test_trx_trx_short_pid01(p_ctx->trx_data, p_ctx->pins_result, TCM_MAX_PINS,
+                                           p_ctx->pins_limit, TCM_MAX_PINS);
+}
+
+/* kernel: extended high resistance, no device transaction */
+static int bench_run_ex_high_resistance(struct bench_ctx *p_ctx)
+{
+    extended_high_resistance_test((unsigned char)p_ctx->rx, (unsigned char)p_ctx->tx,
+                                  p_ctx->p_delta, p_ctx->p_baseline, p_ctx->p_ref,
+                                  p_ctx->p_rx_result, p_ctx->p_tx_result, p_ctx->p_surface);
+    return 0;
+}
+
+/* kernel: heatmap rendering of the preview, auto range */
+static int bench_run_heatmap_nearest(struct bench_ctx *p_ctx)
+{
+    return syna_heatmap_render(&p_ctx->heatmap_nearest, p_ctx->p_delta, p_ctx->rx, p_ctx->tx,
+                               p_ctx->p_pixels, p_ctx->rx * BENCH_HEATMAP_SCALE,
+                               p_ctx->tx * BENCH_HEATMAP_SCALE, p_ctx->rx * BENCH_HEATMAP_SCALE);
+}
+static int bench_run_heatmap_bilinear(struct bench_ctx *p_ctx)
+{
+    return syna_heatmap_render(&p_ctx->heatmap_bilinear, p_ctx->p_delta, p_ctx->rx, p_ctx->tx,
+                               p_ctx->p_pixels, p_ctx->rx * BENCH_HEATMAP_SCALE,
+                               p_ctx->tx * BENCH_HEATMAP_SCALE, p_ctx->rx * BENCH_HEATMAP_SCALE);
+}
+
+static const struct bench_kernel g_bench_kernels[] = {
+    {"tcm_read_message", BENCH_TCM_DEV_TYPE, bench_put_tcm_read, bench_run_tcm_read},
+    {"tcm_get_touch_report", BENCH_TCM_DEV_TYPE, bench_put_tcm_touch, bench_run_tcm_touch},
+    {"tcm_read_report_frame", BENCH_TCM_DEV_TYPE, bench_put_tcm_frame, bench_run_tcm_frame},
+    {"rmi_f54_read_report_frame", BENCH_RMI_DEV_TYPE, bench_put_rmi_frame, bench_run_rmi_frame},
+    {"tcm_full_raw_limit_check", BENCH_TCM_DEV_TYPE, bench_put_tcm_full_raw, bench_run_tcm_full_raw},
+    {"tcm_trx_short_pins", BENCH_TCM_DEV_TYPE, bench_put_tcm_trx_short, bench_run_tcm_trx_short},
+    {"extended_high_resistance", BENCH_TCM_DEV_TYPE, NULL, bench_run_ex_high_resistance},
+    {"heatmap_nearest", BENCH_TCM_DEV_TYPE, NULL, bench_run_heatmap_nearest},
+    {"heatmap_bilinear", BENCH_TCM_DEV_TYPE, NULL, bench_run_heatmap_bilinear},
+};
+
+/*
+ * Function:  bench_setup_device
+ * --------------------
+ * fill the device information used by the kernels
+ */
+static void bench_setup_device(struct bench_ctx *p_ctx)
+{
+    int i;
+    int pins;
+
+    memset(&g_tcm_handler.app_info_report, 0x00, sizeof(g_tcm_handler.app_info_report));
+    g_tcm_handler.app_info_report.num_of_image_rows[0] = (unsigned char)p_ctx->tx;
+    g_tcm_handler.app_info_report.num_of_image_cols[0] = (unsigned char)p_ctx->rx;
+    g_tcm_handler.app_info_report.max_objects[0] = TCM_FINGERS_TO_SUPPORT;
+
+    memset(g_tcm_handler.touch_config, 0x00, sizeof(g_tcm_handler.touch_config));
+    memcpy(g_tcm_handler.touch_config, g_bench_touch_config, sizeof(g_bench_touch_config));
+
+    /* physical pins are limited to TCM_MAX_PINS, tx pins first */
+    pins = 0;
+    g_tcm_handler.tx_assigned = MIN(p_ctx->tx, TCM_MAX_PINS / 2);
+    for (i = 0; i < g_tcm_handler.tx_assigned; i++)
+        g_tcm_handler.tx_pins[i] = pins++;
+    g_tcm_handler.rx_assigned = MIN(p_ctx->rx, TCM_MAX_PINS - pins);
+    for (i = 0; i < g_tcm_handler.rx_assigned; i++)
+        g_tcm_handler.rx_pins[i] = pins++;
+    g_tcm_handler.guard_assigned = 0;
+
+    g_rmi_pdt.tx_assigned = (unsigned char)p_ctx->tx;
+    g_rmi_pdt.rx_assigned = (unsigned char)p_ctx->rx;
+    g_rmi_pdt.F54.command_base_addr = BENCH_RMI_CMD_BASE;
+    g_rmi_pdt.F54.data_base_addr = BENCH_RMI_DATA_BASE;
+}
+/*
+ * Function:  bench_compare
+ * --------------------
+ * comparison of qsort
+ */
+static int bench_compare(const void *a, const void *b)
+{
+    long long x = *(const long long *)a;
+    long long y = *(const long long *)b;
+
+    return (x > y) - (x < y);
+}
+/*
+ * Function:  bench_run_kernel
+ * --------------------
+ * measure one kernel at one sensor size
+ *
+ * return: <0, fail to run the kernel
+ *         otherwise, 0
+ */
+static int bench_run_kernel(const struct bench_kernel *p_kernel, struct bench_ctx *p_ctx,
+                            const char *tmp_dir, int iterations)
+{
+    int retval = 0;
+    int fd;
+    int i;
+    int total = iterations + BENCH_WARMUP_ITERATIONS;
+    int failures = 0;
+    int divergences = 0;
+    long long *p_samples = NULL;
+    long long sum = 0;
+    long long start;
+    struct syna_bus_trace_header header;
+
+    p_samples = calloc((size_t)iterations, sizeof(long long));
+    if (!p_samples)
+        return -ENOMEM;
+
+    /* prepare the transactions of all calls */
+    if (p_kernel->put) {
+        snprintf(g_trace_path, sizeof(g_trace_path), "%s/syna_bench_XXXXXX", tmp_dir);
+        fd = mkstemp(g_trace_path);
+        if (fd < 0) {
+            fprintf(stderr, "fail to create the trace in %s (err: %s)\n", tmp_dir, strerror(errno));
+            retval = -EIO;
+            goto exit;
+        }
+        g_trace_fp = fdopen(fd, "wb");
+
+        memset(&header, 0x00, sizeof(header));
+        header.magic = SYNA_BUS_TRACE_MAGIC;
+        header.version = SYNA_BUS_TRACE_VERSION;
+        header.dev_type = (unsigned int)p_kernel->dev_type;
+        snprintf(header.dev_node, sizeof(header.dev_node), "%s",
+                 (p_kernel->dev_type == BENCH_RMI_DEV_TYPE) ? "/dev/rmi0" : "/dev/tcm0");
+        fwrite(&header, sizeof(header), 1, g_trace_fp);
+
+        for (i = 0; i < total; i++)
+            p_kernel->put(p_ctx);
+
+        fclose(g_trace_fp);
+        g_trace_fp = NULL;
+
+        retval = syna_start_bus_replay(g_trace_path, SYNA_BUS_TIME_NO_DELAY);
+        if (retval < 0) {
+            fprintf(stderr, "fail to replay %s\n", g_trace_path);
+            unlink(g_trace_path);
+            goto exit;
+        }
+    }
+
+    for (i = 0; i < total; i++) {
+        start = syna_get_time_ns();
+        if (p_kernel->run(p_ctx) < 0)
+            failures += 1;
+        if (i >= BENCH_WARMUP_ITERATIONS)
+            p_samples[i - BENCH_WARMUP_ITERATIONS] = syna_get_time_ns() - start;
+    }
+
+    if (p_kernel->put) {
+        divergences = syna_stop_bus_replay();
+        unlink(g_trace_path);
+    }
+
+    for (i = 0; i < iterations; i++)
+        sum += p_samples[i];
+    qsort(p_samples, (size_t)iterations, sizeof(long long), bench_compare);
+
+    fprintf(g_out, "{\"kernel\":\"%s\",\"tx\":%d,\"rx\":%d,\"iterations\":%d,"
+            "\"min_ns\":%lld,\"p50_ns\":%lld,\"p90_ns\":%lld,\"max_ns\":%lld,\"mean_ns\":%lld,"
+            "\"failures\":%d,\"divergences\":%d}\n",
+            p_kernel->name, p_ctx->tx, p_ctx->rx, iterations,
+            p_samples[0], p_samples[iterations / 2], p_samples[iterations * 9 / 10],
+            p_samples[iterations - 1], sum / iterations, failures, divergences);
+
+    if ((failures > 0) || (divergences > 0))
+        retval = 1;
+
+exit:
+    free(p_samples);
+
+    return retval;
+}
+/*
+ * Function:  bench_alloc_ctx
+ * --------------------
+ * allocate the buffers and synthetic images of one sensor size
+ *
+ * return: <0, fail to allocate
+ *         otherwise, 0
+ */
+static int bench_alloc_ctx(struct bench_ctx *p_ctx, int tx, int rx)
+{
+    int size = tx * rx;
+    int i;
+
+    memset(p_ctx, 0x00, sizeof(struct bench_ctx));
+    p_ctx->tx = tx;
+    p_ctx->rx = rx;
+    p_ctx->payload = size * (int)sizeof(short);
+
+    p_ctx->p_out = calloc((size_t)size, sizeof(int));
+    p_ctx->p_limit_min = calloc((size_t)size, sizeof(int));
+    p_ctx->p_limit_max = calloc((size_t)size, sizeof(int));
+    p_ctx->p_delta = calloc((size_t)size, sizeof(short));
+    p_ctx->p_baseline = calloc((size_t)size, sizeof(short));
+    p_ctx->p_ref = calloc((size_t)size, sizeof(short));
+    p_ctx->p_surface = calloc((size_t)size, sizeof(short));
+    p_ctx->p_rx_result = calloc((size_t)rx, sizeof(short));
+    p_ctx->p_tx_result = calloc((size_t)tx, sizeof(short));
+    /* the second half is the source of the transport kernel */
+    p_ctx->p_buf = calloc((size_t)(2 * (p_ctx->payload + 3)), sizeof(unsigned char));
+    p_ctx->p_pixels = calloc((size_t)(size * BENCH_HEATMAP_SCALE * BENCH_HEATMAP_SCALE),
+                             sizeof(unsigned int));
+
+    if ((!p_ctx->p_out) || (!p_ctx->p_limit_min) || (!p_ctx->p_limit_max) ||
+        (!p_ctx->p_delta) || (!p_ctx->p_baseline) || (!p_ctx->p_ref) || (!p_ctx->p_surface) ||
+        (!p_ctx->p_rx_result) || (!p_ctx->p_tx_result) || (!p_ctx->p_buf) || (!p_ctx->p_pixels))
+        return -ENOMEM;
+
+    bench_fill_image(p_ctx->p_delta, size, 0, 1);
+    bench_fill_image(p_ctx->p_baseline, size, 1500, 2);
+    bench_fill_image(p_ctx->p_ref, size, 1480, 3);
+    for (i = 0; i < size; i++) {
+        p_ctx->p_limit_min[i] = 1000;
+        p_ctx->p_limit_max[i] = 2000;
+    }
+    for (i = 0; i < TCM_MAX_PINS; i++)
+        p_ctx->pins_limit[i] = 0;
+
+    syna_heatmap_init(&p_ctx->heatmap_nearest, HEATMAP_COLORMAP_JET, HEATMAP_FORMAT_RGBA,
+                      HEATMAP_SCALING_NEAREST);
+    syna_heatmap_init(&p_ctx->heatmap_bilinear, HEATMAP_COLORMAP_JET, HEATMAP_FORMAT_RGBA,
+                      HEATMAP_SCALING_BILINEAR);
+
+    return 0;
+}
+/*
+ * Function:  bench_free_ctx
+ * --------------------
+ * release the buffers of one sensor size
+ */
+static void bench_free_ctx(struct bench_ctx *p_ctx)
+{
+    free(p_ctx->p_out);
+    free(p_ctx->p_limit_min);
+    free(p_ctx->p_limit_max);
+    free(p_ctx->p_delta);
+    free(p_ctx->p_baseline);
+    free(p_ctx->p_ref);
+    free(p_ctx->p_surface);
+    free(p_ctx->p_rx_result);
+    free(p_ctx->p_tx_result);
+    free(p_ctx->p_buf);
+    free(p_ctx->p_pixels);
+    syna_heatmap_release(&p_ctx->heatmap_nearest);
+    syna_heatmap_release(&p_ctx->heatmap_bilinear);
+}
+
+static void bench_usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [-n <iterations>] [-k <kernel>] [-t <tmp dir>] [-o <output>]\n"
+            "  -n, iterations of each kernel, default %d\n"
+            "  -k, run the kernels whose name contains the string only\n"
+            "  -t, folder of the temporary trace, default %s or $TMPDIR\n"
+            "  -o, write the result to the file instead of stdout\n"
+            "output is one JSON object per kernel and sensor size, exit code is 0 on success\n",
+            name, BENCH_DEFAULT_ITERATIONS, BENCH_DEFAULT_TMP_DIR);
+}
+
+int main(int argc, char *argv[])
+{
+    int retval = 0;
+    int opt;
+    int iterations = BENCH_DEFAULT_ITERATIONS;
+    char *filter = NULL;
+    char *out_path = NULL;
+    const char *tmp_dir = getenv("TMPDIR");
+    struct bench_ctx ctx;
+    int i, k;
+    int ret;
+
+    g_out = stdout;
+    if (!tmp_dir)
+        tmp_dir = BENCH_DEFAULT_TMP_DIR;
+
+    while ((opt = getopt(argc, argv, "n:k:t:o:h")) != -1) {
+        switch (opt) {
+            case 'n': iterations = (int)strtol(optarg, NULL, 0); break;
+            case 'k': filter = optarg; break;
+            case 't': tmp_dir = optarg; break;
+            case 'o': out_path = optarg; break;
+            default:
+                bench_usage(argv[0]);
+                return 2;
+        }
+    }
+    if (iterations <= 0) {
+        bench_usage(argv[0]);
+        return 2;
+    }
+
+    if (out_path) {
+        g_out = fopen(out_path, "w");
+        if (!g_out) {
+            fprintf(stderr, "fail to create %s (err: %s)\n", out_path, strerror(errno));
+            return 2;
+        }
+    }
+
+    for (i = 0; i < (int)(sizeof(g_bench_sizes) / sizeof(g_bench_sizes[0])); i++) {
+        if (bench_alloc_ctx(&ctx, g_bench_sizes[i][0], g_bench_sizes[i][1]) < 0) {
+            fprintf(stderr, "fail to allocate the buffers\n");
+            bench_free_ctx(&ctx);
+            retval = -ENOMEM;
+            break;
+        }
+        bench_setup_device(&ctx);
+
+        for (k = 0; k < (int)(sizeof(g_bench_kernels) / sizeof(g_bench_kernels[0])); k++) {
+            if (filter && !strstr(g_bench_kernels[k].name, filter))
+                continue;
+
+            ret = bench_run_kernel(&g_bench_kernels[k], &ctx, tmp_dir, iterations);
+            if (ret < 0) {
+                retval = ret;
+                break;
+            }
+            if ((ret > 0) && (retval == 0))
+                retval = ret;
+        }
+
+        bench_free_ctx(&ctx);
+        if (retval < 0)
+            break;
+    }
+
+    if (g_out != stdout)
+        fclose(g_out);
+
+    if (retval < 0)
+        return 2;
+    return (retval > 0) ? 1 : 0;
+}
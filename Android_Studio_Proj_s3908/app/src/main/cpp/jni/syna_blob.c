@@ -0,0 +1,185 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "syna_dev_manager.h"
+#include "syna_blob.h"
+
+/*
+ * Function:  blob_insert
+ * --------------------
+ * helper function to keep the blobs in descending order of the peak,
+ * only the strongest num_slots blobs are kept
+ */
+static void blob_insert(int *p_blobs, int num_kept, int num_slots, const int *p_blob)
+{
+    int i;
+
+    if (num_slots <= 0)
+        return;
+
+    /* weaker than all the kept blobs, and there is no room */
+    if ((num_kept >= num_slots) &&
+        (p_blob[BLOB_INFO_PEAK] <= p_blobs[(num_slots - 1) * BLOB_INFO_SIZE + BLOB_INFO_PEAK]))
+        return;
+
+    i = MIN(num_kept, num_slots - 1);
+    while ((i > 0) &&
+           (p_blobs[(i - 1) * BLOB_INFO_SIZE + BLOB_INFO_PEAK] < p_blob[BLOB_INFO_PEAK])) {
+        memcpy(&p_blobs[i * BLOB_INFO_SIZE], &p_blobs[(i - 1) * BLOB_INFO_SIZE],
+               BLOB_INFO_SIZE * sizeof(int));
+        i--;
+    }
+    memcpy(&p_blobs[i * BLOB_INFO_SIZE], p_blob, BLOB_INFO_SIZE * sizeof(int));
+}
+/*
+ * Function:  syna_blob_detect
+ * --------------------
+ * find the 8-connected blobs of the delta frame, and the peak, area and
+ * weighted centroid of each blob
+ * the frame is in landscape, index = x * row + y
+ *
+ *   threshold     : min. delta of the tixels in a blob
+ *   low_threshold : hysteresis mode if it is > 0 and < threshold,
+ *                   a blob grows through the tixels >= low_threshold,
+ *                   but it is kept only if its peak is >= threshold
+ *   min_area      : blobs with fewer tixels are ignored
+ *
+ * the blobs are copied to p_blobs in descending order of the peak,
+ * BLOB_INFO_SIZE integers per blob, see enum SYNA_BLOB_INFO
+ *
+ * return: <0, invalid parameter or no memory
+ *         otherwise, the number of blobs found, which could be more
+ *         than the blobs copied
+ */
+int syna_blob_detect(const int *p_frame, int col, int row, int threshold,
+                     int low_threshold, int min_area, int *p_blobs, int blobs_size)
+{
+    int retval = 0;
+    int num_tixels;
+    int num_slots;
+    int grow_threshold;
+    int *p_queue = NULL;
+    unsigned char *p_visited = NULL;
+    int blob[BLOB_INFO_SIZE];
+    long long sum_x, sum_y;
+    int head, tail;
+    int idx, n;
+    int x, y, nx, ny;
+    int value;
+    int num_blobs = 0;
+
+    if ((!p_frame) || (col <= 0) || (row <= 0) || (threshold <= 0)) {
+        printf_e("%s error: invalid parameter\n", __func__);
+        return -EINVAL;
+    }
+
+    num_tixels = col * row;
+    num_slots = (p_blobs) ? (blobs_size / BLOB_INFO_SIZE) : 0;
+    grow_threshold = ((low_threshold > 0) && (low_threshold < threshold)) ?
+                        low_threshold : threshold;
+
+    p_visited = calloc((size_t)num_tixels, sizeof(unsigned char));
+    p_queue = malloc((size_t)num_tixels * sizeof(int));
+    if ((!p_visited) || (!p_queue)) {
+        printf_e("%s error: fail to allocate the buffers for %d tixels\n", __func__, num_tixels);
+        retval = -ENOMEM;
+        goto exit;
+    }
+
+    for (idx = 0; idx < num_tixels; idx++) {
+        if ((p_visited[idx]) || (p_frame[idx] < grow_threshold))
+            continue;
+
+        memset(blob, 0x00, sizeof(blob));
+        blob[BLOB_INFO_PEAK] = p_frame[idx];
+        blob[BLOB_INFO_PEAK_TIXEL] = idx;
+        sum_x = 0;
+        sum_y = 0;
+
+        /* flood fill from the tixel */
+        head = 0;
+        tail = 0;
+        p_queue[tail++] = idx;
+        p_visited[idx] = 1;
+
+        while (head < tail) {
+            n = p_queue[head++];
+            value = p_frame[n];
+            x = n / row;
+            y = n % row;
+
+            blob[BLOB_INFO_AREA] += 1;
+            blob[BLOB_INFO_SUM] += value;
+            sum_x += (long long)value * x;
+            sum_y += (long long)value * y;
+            if (value > blob[BLOB_INFO_PEAK]) {
+                blob[BLOB_INFO_PEAK] = value;
+                blob[BLOB_INFO_PEAK_TIXEL] = n;
+            }
+
+            for (nx = x - 1; nx <= x + 1; nx++) {
+                if ((nx < 0) || (nx >= col))
+                    continue;
+                for (ny = y - 1; ny <= y + 1; ny++) {
+                    if ((ny < 0) || (ny >= row))
+                        continue;
+
+                    if ((p_visited[nx * row + ny]) || (p_frame[nx * row + ny] < grow_threshold))
+                        continue;
+
+                    p_visited[nx * row + ny] = 1;
+                    p_queue[tail++] = nx * row + ny;
+                }
+            }
+        }
+
+        if ((blob[BLOB_INFO_PEAK] < threshold) || (blob[BLOB_INFO_AREA] < min_area))
+            continue;
+
+        blob[BLOB_INFO_CENTROID_X] = (int)(sum_x * SYNA_BLOB_CENTROID_SCALE / blob[BLOB_INFO_SUM]);
+        blob[BLOB_INFO_CENTROID_Y] = (int)(sum_y * SYNA_BLOB_CENTROID_SCALE / blob[BLOB_INFO_SUM]);
+
+        blob_insert(p_blobs, num_blobs, num_slots, blob);
+        num_blobs++;
+    }
+
+    retval = num_blobs;
+
+exit:
+    if (p_queue)
+        free(p_queue);
+    if (p_visited)
+        free(p_visited);
+
+    return retval;
+}
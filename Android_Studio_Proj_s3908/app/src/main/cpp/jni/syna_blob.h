@@ -0,0 +1,52 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+#ifndef _SYNA_BLOB_H__
+#define _SYNA_BLOB_H__
+
+/* the centroid is reported in fixed-point, 1/16 of a tixel */
+#define SYNA_BLOB_CENTROID_SCALE     (16)
+
+/*
+ * information of each blob
+ * must be equivalent to the same id in java layer
+ */
+enum SYNA_BLOB_INFO {
+    BLOB_INFO_PEAK = 0,             /* max. delta of the blob */
+    BLOB_INFO_PEAK_TIXEL,           /* index of the tixel with the max. delta */
+    BLOB_INFO_AREA,                 /* number of tixels */
+    BLOB_INFO_SUM,                  /* sum of the delta */
+    BLOB_INFO_CENTROID_X,           /* weighted centroid, in 1/16 tixel */
+    BLOB_INFO_CENTROID_Y,
+    BLOB_INFO_SIZE,
+};
+
+/* helper to find the connected blobs of the delta frame */
+int syna_blob_detect(const int *p_frame, int col, int row, int threshold,
+                     int low_threshold, int min_area, int *p_blobs, int blobs_size);
+
+#endif // _SYNA_BLOB_H__
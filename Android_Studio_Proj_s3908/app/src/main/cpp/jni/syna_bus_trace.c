@@ -0,0 +1,640 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+
+#include "syna_dev_manager.h"
+#include "syna_bus_trace.h"
+
+#ifdef SAVE_ERR_MSG
+#include "err_msg_ctrl.h"
+#endif
+
+/* records are buffered and written to the file once the buffer is full */
+#define BUS_RECORD_BUF_SIZE (64 * 1024)
+
+int g_syna_bus_mode = SYNA_BUS_DIRECT;
+
+/* lock of the recording and the replay state below, the bus is accessed by
+ * the test job thread and the image stream thread while java starts or stops
+ * the trace; g_syna_bus_mode is checked again once the lock is taken */
+static pthread_mutex_t g_trace_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* variables of the recording */
+static FILE *g_record_fp;
+static unsigned char *g_record_buf;
+static int g_record_used;
+static long long g_record_last_us;
+static int g_record_count;
+
+/* variables of the replay */
+static FILE *g_replay_fp;
+static unsigned char *g_replay_buf;
+static int g_replay_buf_size;
+static int g_replay_time_scale;
+static long long g_replay_start_us;
+static long long g_replay_trace_us;
+static int g_replay_count;
+static int g_replay_divergence;
+
+/*
+ * Function:  bus_record_flush
+ * --------------------
+ * helper function to write the buffered records to the trace file
+ *
+ * return: <0, fail to write
+ *         otherwise, 0
+ */
+static int bus_record_flush(void)
+{
+    if ((!g_record_fp) || (g_record_used == 0))
+        return 0;
+
+    if (fwrite(g_record_buf, 1, (size_t)g_record_used, g_record_fp) != (size_t)g_record_used) {
+        printf_e("%s error: fail to write the trace (err: %s)\n", __func__, strerror(errno));
+        g_record_used = 0;
+        return -EIO;
+    }
+    g_record_used = 0;
+
+    return 0;
+}
+
+/*
+ * Function:  bus_record
+ * --------------------
+ * helper function to append one transaction to the trace
+ * payload is the data written, or the data read if retval > 0
+ * nothing is recorded if the recording is stopped in the meantime
+ *
+ * return: n/a
+ */
+static void bus_record(int op, unsigned short addr, const unsigned char *p_data,
+                       int length, int retval)
+{
+    struct syna_bus_record record;
+    long long now_us;
+
+    pthread_mutex_lock(&g_trace_mutex);
+
+    if ((SYNA_BUS_RECORD != g_syna_bus_mode) || (!g_record_fp))
+        goto exit;
+
+    now_us = syna_get_time_ns() / 1000;
+
+    record.op = (unsigned char)op;
+    record.reserved = 0;
+    record.addr = addr;
+    record.delta_us = (unsigned int)(now_us - g_record_last_us);
+    record.retval = retval;
+    record.length = (unsigned int)((p_data && (length > 0)) ? length : 0);
+
+    g_record_last_us = now_us;
+    g_record_count += 1;
+
+    if (g_record_used + (int)sizeof(record) + (int)record.length > BUS_RECORD_BUF_SIZE)
+        bus_record_flush();
+
+    memcpy(&g_record_buf[g_record_used], &record, sizeof(record));
+    g_record_used += (int)sizeof(record);
+
+    if (record.length == 0)
+        goto exit;
+
+    /* payload larger than the buffer is written directly */
+    if ((int)record.length > BUS_RECORD_BUF_SIZE - g_record_used) {
+        bus_record_flush();
+        fwrite(p_data, 1, record.length, g_record_fp);
+        goto exit;
+    }
+
+    memcpy(&g_record_buf[g_record_used], p_data, record.length);
+    g_record_used += (int)record.length;
+
+exit:
+    pthread_mutex_unlock(&g_trace_mutex);
+}
+
+/*
+ * Function:  bus_replay_next
+ * --------------------
+ * helper function to fetch the next record and its payload,
+ * the payload is kept in g_replay_buf.
+ * the record is returned once the time of the original session, scaled by
+ * the time_scale, is elapsed.
+ * the caller must hold g_trace_mutex until g_replay_buf is consumed
+ *
+ * return: <0, end of the trace or the record is not expected
+ *         otherwise, 0
+ */
+static int bus_replay_next(int op, struct syna_bus_record *p_record)
+{
+    unsigned char *p_buf;
+    long long target_us;
+    long long now_us;
+
+    if ((SYNA_BUS_REPLAY != g_syna_bus_mode) || (!g_replay_fp)) {
+        printf_e("%s error: replay is stopped\n", __func__);
+        return -ENODEV;
+    }
+
+    if (fread(p_record, sizeof(struct syna_bus_record), 1, g_replay_fp) != 1) {
+        printf_e("%s error: end of the trace, %d records are replayed\n",
+                 __func__, g_replay_count);
+        return -ENODATA;
+    }
+
+    if ((int)p_record->length > g_replay_buf_size) {
+        p_buf = realloc(g_replay_buf, p_record->length);
+        if (!p_buf)
+            return -ENOMEM;
+        g_replay_buf = p_buf;
+        g_replay_buf_size = (int)p_record->length;
+    }
+
+    if ((p_record->length > 0) &&
+        (fread(g_replay_buf, 1, p_record->length, g_replay_fp) != p_record->length)) {
+        printf_e("%s error: the trace is truncated at record %d\n", __func__, g_replay_count);
+        return -ENODATA;
+    }
+
+    g_replay_count += 1;
+    g_replay_trace_us += p_record->delta_us;
+
+    if (p_record->op != op) {
+        printf_e("%s error: record %d diverges, op %d is expected but %d is called\n",
+                 __func__, g_replay_count, p_record->op, op);
+        g_replay_divergence += 1;
+        return -EIO;
+    }
+
+    if (g_replay_time_scale > 0) {
+        target_us = g_replay_start_us + g_replay_trace_us * g_replay_time_scale / 100;
+        now_us = syna_get_time_ns() / 1000;
+        if (target_us > now_us)
+            usleep((unsigned int)(target_us - now_us));
+    }
+
+    return 0;
+}
+
+/*
+ * Function:  syna_bus_open
+ * --------------------
+ * open the device node
+ * during the replay, nothing is opened but a duplicate of the trace file
+ * is returned, so that the caller is able to close it as usual
+ *
+ * return: <0, fail to open
+ *         otherwise, file descriptor
+ */
+int syna_bus_open(const char *dev_node)
+{
+    int fd = -ENODEV;
+
+    if (SYNA_BUS_REPLAY == g_syna_bus_mode) {
+        pthread_mutex_lock(&g_trace_mutex);
+        if (g_replay_fp)
+            fd = dup(fileno(g_replay_fp));
+        pthread_mutex_unlock(&g_trace_mutex);
+        return fd;
+    }
+
+    return open(dev_node, O_RDWR, S_IRWXU | S_IRWXG | S_IRWXO);
+}
+
+/*
+ * Function:  syna_bus_close
+ * --------------------
+ * close the device node
+ *
+ * return: result of close()
+ */
+int syna_bus_close(int fd)
+{
+    return close(fd);
+}
+
+/*
+ * Function:  syna_bus_read
+ * --------------------
+ * read data from the device node, the rmi register is given by addr
+ *
+ * return: <0, fail to read
+ *         otherwise, bytes read
+ */
+int syna_bus_read(int op, unsigned short addr, unsigned char *p_data, int length)
+{
+    int retval;
+    struct syna_bus_record record;
+
+    if (SYNA_BUS_REPLAY == g_syna_bus_mode) {
+        pthread_mutex_lock(&g_trace_mutex);
+
+        retval = bus_replay_next(op, &record);
+        if (retval < 0)
+            goto exit;
+
+        if ((op == BUS_OP_RMI_READ) && (record.addr != addr)) {
+            printf_e("%s error: record %d diverges, reg 0x%x is expected but 0x%x is read\n",
+                     __func__, g_replay_count, record.addr, addr);
+            g_replay_divergence += 1;
+        }
+
+        memcpy(p_data, g_replay_buf, (size_t)MIN((int)record.length, length));
+        retval = record.retval;
+exit:
+        pthread_mutex_unlock(&g_trace_mutex);
+        return retval;
+    }
+
+    if (BUS_OP_RMI_READ == op)
+        lseek(g_dev_file_descriptor, addr, SEEK_SET);
+
+    retval = (int) read(g_dev_file_descriptor, (void *)p_data, (size_t)length);
+
+    if (SYNA_BUS_RECORD == g_syna_bus_mode)
+        bus_record(op, addr, p_data, (retval > 0) ? retval : 0, retval);
+
+    return retval;
+}
+
+/*
+ * Function:  syna_bus_write
+ * --------------------
+ * write data to the device node, the rmi register is given by addr
+ *
+ * return: <0, fail to write
+ *         otherwise, bytes written
+ */
+int syna_bus_write(int op, unsigned short addr, unsigned char *p_data, int length)
+{
+    int retval;
+    struct syna_bus_record record;
+
+    if (SYNA_BUS_REPLAY == g_syna_bus_mode) {
+        pthread_mutex_lock(&g_trace_mutex);
+
+        retval = bus_replay_next(op, &record);
+        if (retval < 0)
+            goto exit;
+
+        if ((record.addr != addr) || ((int)record.length != length) ||
+            (memcmp(g_replay_buf, p_data, (size_t)length) != 0)) {
+            printf_e("%s error: record %d diverges, data written is different\n",
+                     __func__, g_replay_count);
+            g_replay_divergence += 1;
+        }
+
+        retval = record.retval;
+exit:
+        pthread_mutex_unlock(&g_trace_mutex);
+        return retval;
+    }
+
+    if (BUS_OP_RMI_WRITE == op)
+        lseek(g_dev_file_descriptor, addr, SEEK_SET);
+
+    retval = (int) write(g_dev_file_descriptor, p_data, (size_t)length);
+
+    if (SYNA_BUS_RECORD == g_syna_bus_mode)
+        bus_record(op, addr, p_data, length, retval);
+
+    return retval;
+}
+
+/*
+ * Function:  syna_bus_ioctl
+ * --------------------
+ * send the ioctl command to the device node
+ *
+ * return: result of ioctl()
+ */
+int syna_bus_ioctl(unsigned long request, int arg)
+{
+    int retval;
+    unsigned int param[2];
+    struct syna_bus_record record;
+
+    param[0] = (unsigned int)request;
+    param[1] = (unsigned int)arg;
+
+    if (SYNA_BUS_REPLAY == g_syna_bus_mode) {
+        pthread_mutex_lock(&g_trace_mutex);
+
+        retval = bus_replay_next(BUS_OP_IOCTL, &record);
+        if (retval < 0)
+            goto exit;
+
+        if ((record.length != sizeof(param)) || (memcmp(g_replay_buf, param, sizeof(param)) != 0)) {
+            printf_e("%s error: record %d diverges, ioctl 0x%lx is different\n",
+                     __func__, g_replay_count, request);
+            g_replay_divergence += 1;
+        }
+
+        retval = record.retval;
+exit:
+        pthread_mutex_unlock(&g_trace_mutex);
+        return retval;
+    }
+
+    retval = ioctl(g_dev_file_descriptor, request, arg);
+
+    if (SYNA_BUS_RECORD == g_syna_bus_mode)
+        bus_record(BUS_OP_IOCTL, 0, (unsigned char *)param, sizeof(param), retval);
+
+    return retval;
+}
+
+/*
+ * Function:  syna_bus_delay_us
+ * --------------------
+ * delay between the transactions, e.g. polling interval
+ * the delay is skipped during the replay, since the replay is paced by the
+ * time kept in the trace
+ *
+ * return: n/a
+ */
+void syna_bus_delay_us(unsigned int delay_us)
+{
+    if (SYNA_BUS_REPLAY == g_syna_bus_mode)
+        return;
+
+    usleep(delay_us);
+}
+
+/*
+ * Function:  syna_bus_record_start
+ * --------------------
+ * start to record all transactions into the trace file.
+ * to replay from the beginning, start the recording before the device is open.
+ *
+ * parameter
+ *  trace_path: path of the trace file
+ *  dev_type: 1, rmi device; 2, tcm device
+ *  dev_node: device node
+ *
+ * return: <0, fail to start
+ *         otherwise, 0
+ */
+int syna_bus_record_start(const char *trace_path, int dev_type, const char *dev_node)
+{
+    int retval = 0;
+    struct syna_bus_trace_header header;
+#ifdef SAVE_ERR_MSG
+    char err[MAX_ERR_STRING_LEN];
+#endif
+
+    if (!trace_path) {
+        printf_e("%s error: invalid parameter\n", __func__);
+        return -EINVAL;
+    }
+
+    pthread_mutex_lock(&g_trace_mutex);
+
+    if (SYNA_BUS_DIRECT != g_syna_bus_mode) {
+        printf_e("%s error: trace is running (mode = %d)\n", __func__, g_syna_bus_mode);
+        retval = -EBUSY;
+        goto exit;
+    }
+
+    g_record_buf = malloc(BUS_RECORD_BUF_SIZE);
+    if (!g_record_buf) {
+        printf_e("%s error: fail to allocate the buffer\n", __func__);
+        retval = -ENOMEM;
+        goto exit;
+    }
+
+    g_record_fp = fopen(trace_path, "wb");
+    if (!g_record_fp) {
+        printf_e("%s error: fail to create %s (err: %s)\n",
+                 __func__, trace_path, strerror(errno));
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: fail to create %s (err: %s)\n",
+                __func__, trace_path, strerror(errno));
+        add_error_msg(err);
+#endif
+        free(g_record_buf);
+        g_record_buf = NULL;
+        retval = -EIO;
+        goto exit;
+    }
+
+    memset(&header, 0x00, sizeof(header));
+    header.magic = SYNA_BUS_TRACE_MAGIC;
+    header.version = SYNA_BUS_TRACE_VERSION;
+    header.dev_type = (unsigned int)dev_type;
+    if (dev_node)
+        snprintf(header.dev_node, sizeof(header.dev_node), "%s", dev_node);
+
+    memcpy(g_record_buf, &header, sizeof(header));
+    g_record_used = (int)sizeof(header);
+    g_record_count = 0;
+    g_record_last_us = syna_get_time_ns() / 1000;
+
+    g_syna_bus_mode = SYNA_BUS_RECORD;
+
+    printf_i("%s info: recording to %s\n", __func__, trace_path);
+
+exit:
+    pthread_mutex_unlock(&g_trace_mutex);
+
+    return retval;
+}
+
+/*
+ * Function:  syna_bus_record_stop
+ * --------------------
+ * stop the recording and close the trace file
+ *
+ * return: <0, fail to write the trace
+ *         otherwise, number of records
+ */
+int syna_bus_record_stop(void)
+{
+    int retval;
+
+    pthread_mutex_lock(&g_trace_mutex);
+
+    if (SYNA_BUS_RECORD != g_syna_bus_mode) {
+        pthread_mutex_unlock(&g_trace_mutex);
+        return 0;
+    }
+
+    g_syna_bus_mode = SYNA_BUS_DIRECT;
+
+    retval = bus_record_flush();
+    if (fclose(g_record_fp) != 0)
+        retval = -EIO;
+
+    g_record_fp = NULL;
+    free(g_record_buf);
+    g_record_buf = NULL;
+
+    printf_i("%s info: %d records\n", __func__, g_record_count);
+
+    if (retval >= 0)
+        retval = g_record_count;
+
+    pthread_mutex_unlock(&g_trace_mutex);
+
+    return retval;
+}
+
+/*
+ * Function:  syna_bus_replay_start
+ * --------------------
+ * start to feed the transactions from the trace instead of the device
+ *
+ * parameter
+ *  trace_path: path of the trace file
+ *  time_scale: percent of the original timing, 0 to replay without delay
+ *  p_dev_type: device type recorded
+ *  p_dev_node: device node recorded
+ *  size_dev_node: size of p_dev_node
+ *
+ * return: <0, fail to start
+ *         otherwise, 0
+ */
+int syna_bus_replay_start(const char *trace_path, int time_scale,
+                          int *p_dev_type, char *p_dev_node, int size_dev_node)
+{
+    int retval = 0;
+    struct syna_bus_trace_header header;
+#ifdef SAVE_ERR_MSG
+    char err[MAX_ERR_STRING_LEN];
+#endif
+
+    if ((!trace_path) || (time_scale < 0)) {
+        printf_e("%s error: invalid parameter\n", __func__);
+        return -EINVAL;
+    }
+
+    pthread_mutex_lock(&g_trace_mutex);
+
+    if (SYNA_BUS_DIRECT != g_syna_bus_mode) {
+        printf_e("%s error: trace is running (mode = %d)\n", __func__, g_syna_bus_mode);
+        retval = -EBUSY;
+        goto exit;
+    }
+
+    g_replay_fp = fopen(trace_path, "rb");
+    if (!g_replay_fp) {
+        printf_e("%s error: fail to open %s (err: %s)\n",
+                 __func__, trace_path, strerror(errno));
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: fail to open %s (err: %s)\n",
+                __func__, trace_path, strerror(errno));
+        add_error_msg(err);
+#endif
+        retval = -ENOENT;
+        goto exit;
+    }
+
+    if ((fread(&header, sizeof(header), 1, g_replay_fp) != 1) ||
+        (header.magic != SYNA_BUS_TRACE_MAGIC) || (header.version != SYNA_BUS_TRACE_VERSION)) {
+        printf_e("%s error: %s is not a valid trace\n", __func__, trace_path);
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: %s is not a valid trace\n", __func__, trace_path);
+        add_error_msg(err);
+#endif
+        fclose(g_replay_fp);
+        g_replay_fp = NULL;
+        retval = -EINVAL;
+        goto exit;
+    }
+    header.dev_node[sizeof(header.dev_node) - 1] = '\0';
+
+    if (p_dev_type)
+        *p_dev_type = (int)header.dev_type;
+    if (p_dev_node)
+        snprintf(p_dev_node, (size_t)size_dev_node, "%s", header.dev_node);
+
+    g_replay_time_scale = time_scale;
+    g_replay_start_us = syna_get_time_ns() / 1000;
+    g_replay_trace_us = 0;
+    g_replay_count = 0;
+    g_replay_divergence = 0;
+
+    g_syna_bus_mode = SYNA_BUS_REPLAY;
+
+    printf_i("%s info: replaying %s (%s, time scale %d%%)\n",
+             __func__, trace_path, header.dev_node, time_scale);
+
+exit:
+    pthread_mutex_unlock(&g_trace_mutex);
+
+    return retval;
+}
+
+/*
+ * Function:  syna_bus_replay_stop
+ * --------------------
+ * stop the replay and close the trace file
+ *
+ * return: number of records diverging from the trace
+ */
+int syna_bus_replay_stop(void)
+{
+    int retval;
+
+    pthread_mutex_lock(&g_trace_mutex);
+
+    if (SYNA_BUS_REPLAY != g_syna_bus_mode) {
+        pthread_mutex_unlock(&g_trace_mutex);
+        return 0;
+    }
+
+    g_syna_bus_mode = SYNA_BUS_DIRECT;
+
+    fclose(g_replay_fp);
+    g_replay_fp = NULL;
+    if (g_replay_buf)
+        free(g_replay_buf);
+    g_replay_buf = NULL;
+    g_replay_buf_size = 0;
+
+    printf_i("%s info: %d records in %lld us (trace %lld us), %d divergences\n", __func__,
+             g_replay_count, (syna_get_time_ns() / 1000) - g_replay_start_us,
+             g_replay_trace_us, g_replay_divergence);
+
+    retval = g_replay_divergence;
+
+    pthread_mutex_unlock(&g_trace_mutex);
+
+    return retval;
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+
+#include <stdbool.h>
+
+#ifndef _SYNA_BUS_TRACE_H__
+#define _SYNA_BUS_TRACE_H__
+
+/*
+ * all transactions to the device node go through the helpers below, so that
+ * they can be recorded into a binary trace, and be fed back to the same code
+ * without the device, e.g. on the workstation.
+ *
+ * trace file:
+ *   struct syna_bus_trace_header
+ *   { struct syna_bus_record + payload } ...
+ *
+ * fields are in the host byte order, little-endian for both arm and x86.
+ */
+#define SYNA_BUS_TRACE_MAGIC    (0x31544253)    /* "SBT1" */
+#define SYNA_BUS_TRACE_VERSION  (1)
+
+/* time_scale of replay, in percent */
+#define SYNA_BUS_TIME_ORIGINAL  (100)
+#define SYNA_BUS_TIME_NO_DELAY  (0)
+
+enum syna_bus_mode {
+    SYNA_BUS_DIRECT = 0,
+    SYNA_BUS_RECORD,
+    SYNA_BUS_REPLAY,
+};
+
+enum syna_bus_op {
+    BUS_OP_RMI_READ = 1,
+    BUS_OP_RMI_WRITE,
+    BUS_OP_TCM_READ,
+    BUS_OP_TCM_WRITE,
+    BUS_OP_IOCTL,
+};
+
+struct syna_bus_trace_header {
+    unsigned int magic;
+    unsigned int version;
+    unsigned int dev_type;          /* 1: rmi, 2: tcm */
+    unsigned int reserved;
+    char dev_node[128];
+};
+
+struct syna_bus_record {
+    unsigned char op;
+    unsigned char reserved;
+    unsigned short addr;            /* rmi register */
+    unsigned int delta_us;          /* time since the previous record */
+    int retval;
+    unsigned int length;            /* bytes of the payload followed */
+};
+
+extern int g_syna_bus_mode;
+
+/* helper functions to access the device node */
+int syna_bus_open(const char *dev_node);
+int syna_bus_close(int fd);
+int syna_bus_read(int op, unsigned short addr, unsigned char *p_data, int length);
+int syna_bus_write(int op, unsigned short addr, unsigned char *p_data, int length);
+int syna_bus_ioctl(unsigned long request, int arg);
+void syna_bus_delay_us(unsigned int delay_us);
+
+/* helper functions to record and to replay the trace */
+int syna_bus_record_start(const char *trace_path, int dev_type, const char *dev_node);
+int syna_bus_record_stop(void);
+int syna_bus_replay_start(const char *trace_path, int time_scale,
+                          int *p_dev_type, char *p_dev_node, int size_dev_node);
+int syna_bus_replay_stop(void);
+
+#endif // _SYNA_BUS_TRACE_H__
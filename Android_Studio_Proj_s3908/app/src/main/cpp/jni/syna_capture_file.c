@@ -0,0 +1,760 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+
+#define _LARGEFILE64_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+
+#include "syna_dev_manager.h"
+#include "syna_capture_file.h"
+
+#ifdef SAVE_ERR_MSG
+#include "err_msg_ctrl.h"
+#endif
+
+#define CAPTURE_ALIGN(x) (((x) + 7) & ~7)
+
+#define CAPTURE_ENTRIES_STEP (1024)
+
+/* index entry with its stream, used before the index is grouped by stream */
+struct capture_entry {
+    struct syna_capture_index_entry entry;
+    unsigned int stream;
+};
+
+/* variables of the capture file being written */
+struct capture_writer {
+    bool is_opened;
+    int fd;
+    long long offset;
+    struct capture_entry *p_entries;
+    int num_entries;
+    int max_entries;
+    short *p_frame_buf;
+    int frame_buf_len;
+};
+static struct capture_writer g_capture;
+
+/*
+ * Function:  capture_is_stream_valid
+ * --------------------
+ * helper function to check the stream type
+ */
+static bool capture_is_stream_valid(int stream)
+{
+    return ((stream >= 0) && (stream < SYNA_CAPTURE_MAX_STREAMS));
+}
+/*
+ * Function:  capture_is_footer_valid
+ * --------------------
+ * helper function to check the streams of footer against the index,
+ * each stream should be within the index, and all entries are covered
+ */
+static bool capture_is_footer_valid(const struct syna_capture_footer *p_footer)
+{
+    int i;
+    unsigned long long total = 0;
+
+    for (i = 0; i < SYNA_CAPTURE_MAX_STREAMS; i++) {
+        if ((unsigned long long)p_footer->streams[i].first + p_footer->streams[i].count >
+                p_footer->num_entries)
+            return false;
+
+        total += p_footer->streams[i].count;
+    }
+
+    return (total == p_footer->num_entries);
+}
+/*
+ * Function:  capture_is_image_stream
+ * --------------------
+ * helper function to check whether the stream keeps 16-bit image data
+ */
+static bool capture_is_image_stream(int stream)
+{
+    return ((stream == CAPTURE_STREAM_DELTA) || (stream == CAPTURE_STREAM_RAW) ||
+            (stream == CAPTURE_STREAM_HYBRID_ABS));
+}
+/*
+ * Function:  capture_writev_all
+ * --------------------
+ * helper function to write all data in the io vectors
+ *
+ * return: <0, fail to write the data
+ *         otherwise, succeed
+ */
+static int capture_writev_all(int fd, struct iovec *p_iov, int iov_cnt)
+{
+    ssize_t retval;
+
+    while (iov_cnt > 0) {
+        retval = writev(fd, p_iov, iov_cnt);
+        if (retval < 0) {
+            if (errno == EINTR)
+                continue;
+            return -EIO;
+        }
+        /* skip the vectors which are completed */
+        while ((iov_cnt > 0) && ((size_t)retval >= p_iov->iov_len)) {
+            retval -= p_iov->iov_len;
+            p_iov++;
+            iov_cnt--;
+        }
+        if (iov_cnt > 0) {
+            p_iov->iov_base = (unsigned char *)p_iov->iov_base + retval;
+            p_iov->iov_len -= retval;
+        }
+    }
+    return 0;
+}
+/*
+ * Function:  capture_sort_index
+ * --------------------
+ * group the index entries by stream, the order in each stream is kept
+ * the first entry and the count of each stream are filled in the footer
+ */
+static void capture_sort_index(const struct capture_entry *p_in, int num,
+                               struct syna_capture_index_entry *p_out,
+                               struct syna_capture_footer *p_footer)
+{
+    int i;
+    unsigned int pos[SYNA_CAPTURE_MAX_STREAMS];
+    unsigned int first = 0;
+
+    memset(p_footer->streams, 0x00, sizeof(p_footer->streams));
+
+    for (i = 0; i < num; i++)
+        p_footer->streams[p_in[i].stream].count++;
+
+    for (i = 0; i < SYNA_CAPTURE_MAX_STREAMS; i++) {
+        p_footer->streams[i].first = first;
+        pos[i] = first;
+        first += p_footer->streams[i].count;
+    }
+
+    for (i = 0; i < num; i++)
+        p_out[pos[p_in[i].stream]++] = p_in[i].entry;
+
+    p_footer->num_entries = (unsigned int)num;
+    p_footer->num_streams = SYNA_CAPTURE_MAX_STREAMS;
+}
+/*
+ * Function:  syna_capture_open
+ * --------------------
+ * create a capture file and write the file header
+ *
+ * return: <0, fail to create the file
+ *         otherwise, succeed
+ */
+int syna_capture_open(const char *path, int image_rows, int image_cols)
+{
+    int retval = 0;
+    struct syna_capture_file_header header;
+    struct iovec iov;
+#ifdef SAVE_ERR_MSG
+    char err[MAX_ERR_STRING_LEN];
+#endif
+
+    if (!path) {
+        printf_e("%s error: invalid parameter\n", __func__);
+        return -EINVAL;
+    }
+    if (g_capture.is_opened) {
+        printf_e("%s error: capture file is already opened\n", __func__);
+        return -EBUSY;
+    }
+
+    memset(&g_capture, 0x00, sizeof(struct capture_writer));
+
+    g_capture.fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_LARGEFILE, 0666);
+    if (g_capture.fd < 0) {
+        printf_e("%s error: fail to create file, %s (err: %s)\n", __func__, path, strerror(errno));
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: fail to create file, %s (err: %s)\n", __func__, path, strerror(errno));
+        add_error_msg(err);
+#endif
+        return -EIO;
+    }
+
+    memset(&header, 0x00, sizeof(struct syna_capture_file_header));
+    memcpy(header.magic, SYNA_CAPTURE_MAGIC, sizeof(header.magic));
+    header.version = SYNA_CAPTURE_VERSION;
+    header.header_size = sizeof(struct syna_capture_file_header);
+    header.image_rows = (unsigned int)image_rows;
+    header.image_cols = (unsigned int)image_cols;
+    header.start_time = (long long)time(NULL);
+
+    iov.iov_base = &header;
+    iov.iov_len = sizeof(struct syna_capture_file_header);
+    retval = capture_writev_all(g_capture.fd, &iov, 1);
+    if (retval < 0) {
+        printf_e("%s error: fail to write the file header\n", __func__);
+        close(g_capture.fd);
+        return retval;
+    }
+
+    g_capture.offset = sizeof(struct syna_capture_file_header);
+    g_capture.is_opened = true;
+
+    printf_i("%s: capture file is created, %s\n", __func__, path);
+    return 0;
+}
+/*
+ * Function:  syna_capture_is_opened
+ * --------------------
+ * return true, if the capture file is opened for writing
+ */
+bool syna_capture_is_opened(void)
+{
+    return g_capture.is_opened;
+}
+/*
+ * Function:  syna_capture_append
+ * --------------------
+ * append one record to the specified stream
+ * record header and payload are written by one writev call
+ *
+ * return: <0, fail to append the record
+ *         otherwise, succeed
+ */
+int syna_capture_append(int stream, const void *p_data, int size)
+{
+    int retval;
+    struct syna_capture_record_header rec;
+    struct capture_entry *p_entries;
+    struct iovec iov[3];
+    unsigned char pad[8] = {0};
+    int iov_cnt = 0;
+    int size_padded;
+
+    if (!g_capture.is_opened) {
+        printf_e("%s error: capture file is not opened\n", __func__);
+        return -EINVAL;
+    }
+    if (!capture_is_stream_valid(stream) || (size < 0) || (!p_data && size > 0)) {
+        printf_e("%s error: invalid parameter (stream = %d, size = %d)\n", __func__, stream, size);
+        return -EINVAL;
+    }
+
+    /* extend the in-memory index */
+    if (g_capture.num_entries == g_capture.max_entries) {
+        p_entries = realloc(g_capture.p_entries, sizeof(struct capture_entry) *
+                            (g_capture.max_entries + CAPTURE_ENTRIES_STEP));
+        if (!p_entries) {
+            printf_e("%s error: fail to allocate the index\n", __func__);
+            return -ENOMEM;
+        }
+        g_capture.p_entries = p_entries;
+        g_capture.max_entries += CAPTURE_ENTRIES_STEP;
+    }
+
+    size_padded = CAPTURE_ALIGN(size);
+
+    rec.stream = (unsigned int)stream;
+    rec.size = (unsigned int)size;
+    rec.timestamp_us = syna_get_time_ns() / 1000;
+
+    iov[iov_cnt].iov_base = &rec;
+    iov[iov_cnt++].iov_len = sizeof(struct syna_capture_record_header);
+    if (size > 0) {
+        iov[iov_cnt].iov_base = (void *)p_data;
+        iov[iov_cnt++].iov_len = (size_t)size;
+    }
+    if (size_padded > size) {
+        iov[iov_cnt].iov_base = pad;
+        iov[iov_cnt++].iov_len = (size_t)(size_padded - size);
+    }
+
+    retval = capture_writev_all(g_capture.fd, iov, iov_cnt);
+    if (retval < 0) {
+        printf_e("%s error: fail to write the record (stream = %d, size = %d)\n",
+                 __func__, stream, size);
+        return retval;
+    }
+
+    p_entries = &g_capture.p_entries[g_capture.num_entries];
+    p_entries->entry.offset = g_capture.offset;
+    p_entries->entry.timestamp_us = rec.timestamp_us;
+    p_entries->entry.size = rec.size;
+    p_entries->entry.seq = (unsigned int)g_capture.num_entries;
+    p_entries->stream = rec.stream;
+
+    g_capture.num_entries += 1;
+    g_capture.offset += sizeof(struct syna_capture_record_header) + size_padded;
+
+    return 0;
+}
+/*
+ * Function:  syna_capture_append_values
+ * --------------------
+ * append the integer values from java layer to the specified stream
+ * the image streams are kept in 16-bit, others are kept in 32-bit
+ *
+ * return: <0, fail to append the record
+ *         otherwise, succeed
+ */
+int syna_capture_append_values(int stream, const int *p_data, int num)
+{
+    int i;
+    short *p_buf;
+
+    if (!p_data || (num <= 0)) {
+        printf_e("%s error: invalid parameter (num = %d)\n", __func__, num);
+        return -EINVAL;
+    }
+
+    if (!capture_is_image_stream(stream))
+        return syna_capture_append(stream, p_data, (int)(sizeof(int) * num));
+
+    if (g_capture.frame_buf_len < num) {
+        p_buf = realloc(g_capture.p_frame_buf, sizeof(short) * num);
+        if (!p_buf) {
+            printf_e("%s error: fail to allocate the frame buffer\n", __func__);
+            return -ENOMEM;
+        }
+        g_capture.p_frame_buf = p_buf;
+        g_capture.frame_buf_len = num;
+    }
+
+    for (i = 0; i < num; i++)
+        g_capture.p_frame_buf[i] = (short)p_data[i];
+
+    return syna_capture_append(stream, g_capture.p_frame_buf, (int)(sizeof(short) * num));
+}
+/*
+ * Function:  syna_capture_close
+ * --------------------
+ * write the index and footer at the end of capture file, then close it
+ *
+ * return: <0, fail to complete the capture file
+ *         otherwise, the number of records
+ */
+int syna_capture_close(void)
+{
+    int retval = 0;
+    struct syna_capture_index_entry *p_index = NULL;
+    struct syna_capture_footer footer;
+    struct iovec iov[2];
+
+    if (!g_capture.is_opened) {
+        printf_e("%s error: capture file is not opened\n", __func__);
+        return -EINVAL;
+    }
+
+    memset(&footer, 0x00, sizeof(struct syna_capture_footer));
+    memcpy(footer.magic, SYNA_CAPTURE_INDEX_MAGIC, sizeof(footer.magic));
+    footer.index_offset = g_capture.offset;
+
+    if (g_capture.num_entries > 0) {
+        p_index = malloc(sizeof(struct syna_capture_index_entry) * g_capture.num_entries);
+        if (!p_index) {
+            printf_e("%s error: fail to allocate the index\n", __func__);
+            retval = -ENOMEM;
+            goto exit;
+        }
+    }
+    capture_sort_index(g_capture.p_entries, g_capture.num_entries, p_index, &footer);
+
+    iov[0].iov_base = p_index;
+    iov[0].iov_len = sizeof(struct syna_capture_index_entry) * g_capture.num_entries;
+    iov[1].iov_base = &footer;
+    iov[1].iov_len = sizeof(struct syna_capture_footer);
+
+    retval = capture_writev_all(g_capture.fd, iov, 2);
+    if (retval < 0) {
+        printf_e("%s error: fail to write the index\n", __func__);
+        goto exit;
+    }
+
+    printf_i("%s: capture file is closed (records = %d)\n", __func__, g_capture.num_entries);
+    retval = g_capture.num_entries;
+
+exit:
+    close(g_capture.fd);
+
+    free(p_index);
+    free(g_capture.p_entries);
+    free(g_capture.p_frame_buf);
+    memset(&g_capture, 0x00, sizeof(struct capture_writer));
+
+    return retval;
+}
+/*
+ * Function:  capture_rebuild_index
+ * --------------------
+ * scan all records to rebuild the index
+ * it is used when the capture file is not closed properly
+ *
+ * return: <0, fail to rebuild the index
+ *         otherwise, the number of records found
+ */
+static int capture_rebuild_index(struct syna_capture_reader *p_reader)
+{
+    int retval = 0;
+    struct syna_capture_record_header rec;
+    struct capture_entry *p_entries = NULL;
+    struct capture_entry *p_tmp;
+    int num = 0;
+    int max = 0;
+    long long offset = p_reader->header.header_size;
+    long long end;
+
+    while (offset + (long long)sizeof(rec) <= p_reader->file_size) {
+        if (pread64(p_reader->fd, &rec, sizeof(rec), offset) != sizeof(rec))
+            break;
+
+        end = offset + sizeof(rec) + CAPTURE_ALIGN((long long)rec.size);
+        /* stop at the incomplete record */
+        if (!capture_is_stream_valid((int)rec.stream) || (end > p_reader->file_size))
+            break;
+
+        if (num == max) {
+            p_tmp = realloc(p_entries, sizeof(struct capture_entry) * (max + CAPTURE_ENTRIES_STEP));
+            if (!p_tmp) {
+                retval = -ENOMEM;
+                goto exit;
+            }
+            p_entries = p_tmp;
+            max += CAPTURE_ENTRIES_STEP;
+        }
+
+        p_entries[num].entry.offset = offset;
+        p_entries[num].entry.timestamp_us = rec.timestamp_us;
+        p_entries[num].entry.size = rec.size;
+        p_entries[num].entry.seq = (unsigned int)num;
+        p_entries[num].stream = rec.stream;
+        num++;
+
+        offset = end;
+    }
+
+    p_reader->p_index = malloc(sizeof(struct syna_capture_index_entry) * (num > 0 ? num : 1));
+    if (!p_reader->p_index) {
+        retval = -ENOMEM;
+        goto exit;
+    }
+
+    memcpy(p_reader->footer.magic, SYNA_CAPTURE_INDEX_MAGIC, sizeof(p_reader->footer.magic));
+    p_reader->footer.index_offset = offset;
+    capture_sort_index(p_entries, num, p_reader->p_index, &p_reader->footer);
+
+    printf_i("%s: index is rebuilt (records = %d)\n", __func__, num);
+    retval = num;
+
+exit:
+    free(p_entries);
+    return retval;
+}
+/*
+ * Function:  syna_capture_reader_open
+ * --------------------
+ * open the capture file for reading
+ * the trailing index is mapped into memory, records are mapped on demand
+ *
+ * return: <0, fail to open the capture file
+ *         otherwise, succeed
+ */
+int syna_capture_reader_open(const char *path, struct syna_capture_reader *p_reader)
+{
+    int retval = 0;
+    long long index_size;
+    long long map_offset;
+    long page_size = sysconf(_SC_PAGESIZE);
+#ifdef SAVE_ERR_MSG
+    char err[MAX_ERR_STRING_LEN];
+#endif
+
+    if (!path || !p_reader) {
+        printf_e("%s error: invalid parameter\n", __func__);
+        return -EINVAL;
+    }
+
+    memset(p_reader, 0x00, sizeof(struct syna_capture_reader));
+
+    p_reader->fd = open(path, O_RDONLY | O_LARGEFILE);
+    if (p_reader->fd < 0) {
+        printf_e("%s error: fail to open file, %s (err: %s)\n", __func__, path, strerror(errno));
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: fail to open file, %s (err: %s)\n", __func__, path, strerror(errno));
+        add_error_msg(err);
+#endif
+        return -EIO;
+    }
+
+    p_reader->file_size = lseek64(p_reader->fd, 0, SEEK_END);
+
+    if ((pread64(p_reader->fd, &p_reader->header, sizeof(struct syna_capture_file_header), 0) !=
+            sizeof(struct syna_capture_file_header)) ||
+        (memcmp(p_reader->header.magic, SYNA_CAPTURE_MAGIC, sizeof(p_reader->header.magic)) != 0) ||
+        (p_reader->header.version != SYNA_CAPTURE_VERSION) ||
+        (p_reader->header.header_size != sizeof(struct syna_capture_file_header))) {
+        printf_e("%s error: invalid capture file, %s\n", __func__, path);
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: invalid capture file, %s\n", __func__, path);
+        add_error_msg(err);
+#endif
+        retval = -EINVAL;
+        goto exit;
+    }
+
+    /* read the footer and check whether the index is completed */
+    if ((p_reader->file_size >= (long long)(p_reader->header.header_size + sizeof(struct syna_capture_footer))) &&
+        (pread64(p_reader->fd, &p_reader->footer, sizeof(struct syna_capture_footer),
+                 p_reader->file_size - sizeof(struct syna_capture_footer)) ==
+            sizeof(struct syna_capture_footer)) &&
+        (memcmp(p_reader->footer.magic, SYNA_CAPTURE_INDEX_MAGIC, sizeof(p_reader->footer.magic)) == 0)) {
+
+        index_size = (long long)sizeof(struct syna_capture_index_entry) * p_reader->footer.num_entries;
+        if ((p_reader->footer.index_offset + index_size + (long long)sizeof(struct syna_capture_footer) !=
+                p_reader->file_size) ||
+            (p_reader->footer.index_offset < (long long)p_reader->header.header_size) ||
+            (!capture_is_footer_valid(&p_reader->footer))) {
+            printf_e("%s error: invalid index (offset = %lld, entries = %d)\n", __func__,
+                     p_reader->footer.index_offset, p_reader->footer.num_entries);
+            retval = -EINVAL;
+            goto exit;
+        }
+
+        /* map the index, the offset of mmap must be aligned to the page size */
+        map_offset = p_reader->footer.index_offset & ~((long long)page_size - 1);
+        p_reader->index_map_size = (size_t)(p_reader->file_size - map_offset);
+        p_reader->p_index_map = mmap64(NULL, p_reader->index_map_size, PROT_READ, MAP_SHARED,
+                                       p_reader->fd, map_offset);
+        if (p_reader->p_index_map == MAP_FAILED) {
+            printf_e("%s error: fail to map the index (err: %s)\n", __func__, strerror(errno));
+            p_reader->p_index_map = NULL;
+            retval = -ENOMEM;
+            goto exit;
+        }
+        p_reader->p_index = (struct syna_capture_index_entry *)
+                ((unsigned char *)p_reader->p_index_map + (p_reader->footer.index_offset - map_offset));
+    }
+    else {
+        printf_i("%s: index is not found, %s\n", __func__, path);
+        retval = capture_rebuild_index(p_reader);
+        if (retval < 0) {
+            printf_e("%s error: fail to rebuild the index\n", __func__);
+            goto exit;
+        }
+        retval = 0;
+    }
+
+    printf_i("%s: capture file is opened, %s (records = %d)\n", __func__, path,
+             p_reader->footer.num_entries);
+
+exit:
+    if (retval < 0)
+        syna_capture_reader_close(p_reader);
+
+    return retval;
+}
+/*
+ * Function:  syna_capture_reader_close
+ * --------------------
+ * release all resources of the reader
+ */
+void syna_capture_reader_close(struct syna_capture_reader *p_reader)
+{
+    if (!p_reader)
+        return;
+
+    if (p_reader->p_window)
+        munmap(p_reader->p_window, p_reader->window_size);
+
+    if (p_reader->p_index_map)
+        munmap(p_reader->p_index_map, p_reader->index_map_size);
+    else
+        free(p_reader->p_index);
+
+    if (p_reader->fd >= 0)
+        close(p_reader->fd);
+
+    memset(p_reader, 0x00, sizeof(struct syna_capture_reader));
+    p_reader->fd = -1;
+}
+/*
+ * Function:  syna_capture_get_count
+ * --------------------
+ * return the number of records in the specified stream
+ */
+int syna_capture_get_count(struct syna_capture_reader *p_reader, int stream)
+{
+    if (!p_reader || !p_reader->p_index || !capture_is_stream_valid(stream))
+        return -EINVAL;
+
+    return (int)p_reader->footer.streams[stream].count;
+}
+/*
+ * Function:  syna_capture_get_record
+ * --------------------
+ * get the n-th record of the specified stream
+ * the data pointer is valid until the next call or the reader is closed
+ *
+ * return: <0, fail to get the record
+ *         otherwise, the size of payload
+ */
+int syna_capture_get_record(struct syna_capture_reader *p_reader, int stream, int n,
+                            const unsigned char **pp_data, long long *p_timestamp_us)
+{
+    struct syna_capture_index_entry *p_entry;
+    long long start;
+    long long end;
+    long long map_offset;
+    size_t map_size;
+    long page_size = sysconf(_SC_PAGESIZE);
+
+    if (!p_reader || !p_reader->p_index || !pp_data || !capture_is_stream_valid(stream))
+        return -EINVAL;
+
+    if ((n < 0) || (n >= (int)p_reader->footer.streams[stream].count)) {
+        printf_e("%s error: invalid record index %d (stream = %d, count = %d)\n", __func__,
+                 n, stream, p_reader->footer.streams[stream].count);
+        return -EINVAL;
+    }
+
+    p_entry = &p_reader->p_index[p_reader->footer.streams[stream].first + n];
+
+    start = p_entry->offset + sizeof(struct syna_capture_record_header);
+    end = start + p_entry->size;
+    if ((p_entry->offset < 0) || (end > p_reader->file_size)) {
+        printf_e("%s error: record is out of the file (offset = %lld, size = %d)\n", __func__,
+                 (long long)p_entry->offset, (int)p_entry->size);
+        return -EINVAL;
+    }
+
+    /* remap the window if the record is out of range */
+    if (!p_reader->p_window || (start < p_reader->window_offset) ||
+        (end > p_reader->window_offset + (long long)p_reader->window_size)) {
+
+        if (p_reader->p_window)
+            munmap(p_reader->p_window, p_reader->window_size);
+        p_reader->p_window = NULL;
+
+        map_offset = start & ~((long long)page_size - 1);
+        map_size = SYNA_CAPTURE_MAP_WINDOW;
+        if (end - map_offset > (long long)map_size)
+            map_size = (size_t)(end - map_offset);
+        if (map_offset + (long long)map_size > p_reader->file_size)
+            map_size = (size_t)(p_reader->file_size - map_offset);
+
+        p_reader->p_window = mmap64(NULL, map_size, PROT_READ, MAP_SHARED, p_reader->fd, map_offset);
+        if (p_reader->p_window == MAP_FAILED) {
+            printf_e("%s error: fail to map the record (offset = %lld, err: %s)\n", __func__,
+                     map_offset, strerror(errno));
+            p_reader->p_window = NULL;
+            return -ENOMEM;
+        }
+        p_reader->window_offset = map_offset;
+        p_reader->window_size = map_size;
+    }
+
+    *pp_data = p_reader->p_window + (start - p_reader->window_offset);
+    if (p_timestamp_us)
+        *p_timestamp_us = p_entry->timestamp_us;
+
+    return (int)p_entry->size;
+}
+/*
+ * Function:  syna_capture_read_values
+ * --------------------
+ * read the n-th record of the specified stream as integer values
+ * it is the reverse of syna_capture_append_values()
+ *
+ * return: <0, fail to read the record
+ *         otherwise, the number of values
+ */
+int syna_capture_read_values(struct syna_capture_reader *p_reader, int stream, int n,
+                             int *p_out, int size_out, long long *p_timestamp_us)
+{
+    int i;
+    int num;
+    int size;
+    const unsigned char *p_data;
+
+    if (!p_out) {
+        printf_e("%s error: invalid parameter\n", __func__);
+        return -EINVAL;
+    }
+
+    size = syna_capture_get_record(p_reader, stream, n, &p_data, p_timestamp_us);
+    if (size < 0)
+        return size;
+
+    if (capture_is_image_stream(stream)) {
+        num = MIN(size / (int)sizeof(short), size_out);
+        for (i = 0; i < num; i++)
+            p_out[i] = ((const short *)p_data)[i];
+    }
+    else {
+        num = MIN(size / (int)sizeof(int), size_out);
+        memcpy(p_out, p_data, sizeof(int) * num);
+    }
+
+    return num;
+}
+/*
+ * Function:  syna_capture_find_by_time
+ * --------------------
+ * binary search the first record at or after the specified time
+ *
+ * return: <0, invalid parameter
+ *         otherwise, the index of record in the stream,
+ *         equal to the count if all records are earlier
+ */
+int syna_capture_find_by_time(struct syna_capture_reader *p_reader, int stream,
+                              long long timestamp_us)
+{
+    struct syna_capture_index_entry *p_entries;
+    int low = 0;
+    int high;
+    int mid;
+
+    if (!p_reader || !p_reader->p_index || !capture_is_stream_valid(stream))
+        return -EINVAL;
+
+    p_entries = &p_reader->p_index[p_reader->footer.streams[stream].first];
+    high = (int)p_reader->footer.streams[stream].count;
+
+    while (low < high) {
+        mid = low + (high - low) / 2;
+        if (p_entries[mid].timestamp_us < timestamp_us)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return low;
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef _SYNA_CAPTURE_FILE_H__
+#define _SYNA_CAPTURE_FILE_H__
+
+#define SYNA_CAPTURE_MAGIC        "SYNACAPT"
+#define SYNA_CAPTURE_INDEX_MAGIC  "SYNAINDX"
+#define SYNA_CAPTURE_VERSION      (1)
+
+#define SYNA_CAPTURE_MAX_STREAMS  (16)
+
+/* size of the window mapped for record reading */
+#define SYNA_CAPTURE_MAP_WINDOW   (4*1024*1024)
+
+/*
+ * type of the streams kept in the capture file
+ * must be equivalent to the same id in java layer
+ */
+enum SYNA_CAPTURE_STREAM {
+    CAPTURE_STREAM_DELTA = 0,
+    CAPTURE_STREAM_RAW,
+    CAPTURE_STREAM_HYBRID_ABS,
+    CAPTURE_STREAM_TOUCH_REPORT,
+    CAPTURE_STREAM_GEAR_CHANGE,
+    CAPTURE_STREAM_TEST_RESULT,
+};
+
+/*
+ * layout of the capture file
+ *
+ *  [file header]
+ *  [record header][payload] ... records of all streams, in the order of appending
+ *  [index entries] ... grouped by stream, in the order of time in each stream
+ *  [footer]
+ *
+ * the payload is padded to 8 bytes.
+ * if the file is not closed properly, the index can be rebuilt from the records.
+ */
+struct syna_capture_file_header {
+    char magic[8];
+    unsigned int version;
+    unsigned int header_size;
+    unsigned int image_rows;
+    unsigned int image_cols;
+    long long start_time;         /* wall-clock time, in seconds */
+};
+
+struct syna_capture_record_header {
+    unsigned int stream;
+    unsigned int size;            /* size of payload, in bytes */
+    long long timestamp_us;       /* CLOCK_MONOTONIC, in micro-seconds */
+};
+
+struct syna_capture_index_entry {
+    long long offset;             /* offset of the record header */
+    long long timestamp_us;
+    unsigned int size;
+    unsigned int seq;             /* sequence number in the whole file */
+};
+
+struct syna_capture_stream_info {
+    unsigned int first;           /* first entry of this stream in the index */
+    unsigned int count;
+};
+
+struct syna_capture_footer {
+    char magic[8];
+    long long index_offset;
+    unsigned int num_entries;
+    unsigned int num_streams;
+    struct syna_capture_stream_info streams[SYNA_CAPTURE_MAX_STREAMS];
+};
+
+/* handle to read the capture file */
+struct syna_capture_reader {
+    int fd;
+    long long file_size;
+    struct syna_capture_file_header header;
+    struct syna_capture_footer footer;
+    struct syna_capture_index_entry *p_index;
+    void *p_index_map;            /* not null, if the index is mapped from the file */
+    size_t index_map_size;
+    unsigned char *p_window;      /* window mapped for record reading */
+    long long window_offset;
+    size_t window_size;
+};
+
+/* helper to write the capture file */
+int syna_capture_open(const char *path, int image_rows, int image_cols);
+int syna_capture_append(int stream, const void *p_data, int size);
+int syna_capture_append_values(int stream, const int *p_data, int num);
+int syna_capture_close(void);
+bool syna_capture_is_opened(void);
+
+/* helper to read the capture file */
+int syna_capture_reader_open(const char *path, struct syna_capture_reader *p_reader);
+void syna_capture_reader_close(struct syna_capture_reader *p_reader);
+int syna_capture_get_count(struct syna_capture_reader *p_reader, int stream);
+int syna_capture_get_record(struct syna_capture_reader *p_reader, int stream, int n,
+                            const unsigned char **pp_data, long long *p_timestamp_us);
+int syna_capture_read_values(struct syna_capture_reader *p_reader, int stream, int n,
+                             int *p_out, int size_out, long long *p_timestamp_us);
+int syna_capture_find_by_time(struct syna_capture_reader *p_reader, int stream,
+                              long long timestamp_us);
+
+#endif // _SYNA_CAPTURE_FILE_H__
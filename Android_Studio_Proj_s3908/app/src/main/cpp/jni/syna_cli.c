@@ -0,0 +1,656 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+
+/*
+ * standalone command-line runner, built from the same sources as libnative_syna
+ * so that the flows can be driven by adb or factory automation without the APK.
+ *
+ * the result of each operation is printed as one JSON object per line.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+#include "syna_dev_manager.h"
+#include "syna_limit_store.h"
+#include "syna_capture_file.h"
+#include "syna_raw_script.h"
+#include "syna_bus_trace.h"
+
+#define CLI_RAW_CMD_WRITE  0x11
+#define CLI_RAW_CMD_READ   0x12
+
+#define CLI_MAX_TESTS      (32)
+#define CLI_MAX_RAW_BYTES  (4096)
+
+/* range of test id, see enum TEST_ID in syna_dev_manager.c */
+#define CLI_RMI_TEST_FIRST (0x200)
+#define CLI_RMI_TEST_LAST  (0x20C)
+#define CLI_TCM_TEST_FIRST (0x300)
+#define CLI_TCM_TEST_LAST  (0x30B)
+
+/* destination of the JSON output */
+static FILE *g_out;
+
+/* layout of report image, in the orientation of the device */
+static int g_rows;
+static int g_cols;
+
+/*
+ * Function:  cli_print_string
+ * --------------------
+ * print the string as a JSON string value
+ */
+static void cli_print_string(const char *str)
+{
+    fputc('"', g_out);
+    while (str && *str) {
+        if ((*str == '"') || (*str == '\\'))
+            fprintf(g_out, "\\%c", *str);
+        else if (*str == '\n')
+            fprintf(g_out, "\\n");
+        else if ((unsigned char)*str < 0x20)
+            fprintf(g_out, "\\u%04x", (unsigned char)*str);
+        else
+            fputc(*str, g_out);
+        str++;
+    }
+    fputc('"', g_out);
+}
+/*
+ * Function:  cli_print_values
+ * --------------------
+ * print the integer array as a JSON array
+ */
+static void cli_print_values(const char *key, const int *p_data, int num)
+{
+    int i;
+
+    fprintf(g_out, ",\"%s\":[", key);
+    for (i = 0; i < num; i++)
+        fprintf(g_out, (i == 0) ? "%d" : ",%d", p_data[i]);
+    fprintf(g_out, "]");
+}
+
+/* callbacks of touch report, declared in native_syna_lib.h */
+void callback_finger_down(int index, int x_pos, int y_pos)
+{
+    fprintf(g_out, "{\"event\":\"finger_down\",\"index\":%d,\"x\":%d,\"y\":%d}\n",
+            index, x_pos, y_pos);
+}
+void callback_finger_up(int index)
+{
+    fprintf(g_out, "{\"event\":\"finger_up\",\"index\":%d}\n", index);
+}
+
+/*
+ * Function:  cli_do_identify
+ * --------------------
+ * identify the device, which is required to know the image layout
+ * the device information is printed if is_printed is true
+ *
+ * return: <0, fail to identify the device
+ *         otherwise, succeed
+ */
+static int cli_do_identify(bool is_printed)
+{
+    int retval;
+    char identify_info[MAX_STRING_LEN * 4] = {0};
+    long long time_us = syna_get_time_ns() / 1000;
+
+    retval = syna_do_identify(identify_info);
+    time_us = (syna_get_time_ns() / 1000) - time_us;
+    if (retval >= 0) {
+        g_rows = syna_get_image_rows(false);
+        g_cols = syna_get_image_cols(false);
+    }
+
+    if ((!is_printed) && (retval >= 0))
+        return retval;
+
+    fprintf(g_out, "{\"cmd\":\"identify\",\"ret\":%d,\"time_us\":%lld", retval, time_us);
+    if (retval >= 0) {
+        fprintf(g_out, ",\"device_id\":");
+        cli_print_string(syna_get_device_id());
+        fprintf(g_out, ",\"config_id\":");
+        cli_print_string(syna_get_config_id());
+        fprintf(g_out, ",\"fw_id\":%d,\"rows\":%d,\"cols\":%d,\"info\":",
+                syna_get_fw_id(), g_rows, g_cols);
+        cli_print_string(identify_info);
+    }
+    fprintf(g_out, "}\n");
+
+    return retval;
+}
+/*
+ * Function:  cli_do_test
+ * --------------------
+ * command "test", run the production tests with the limits in the limit store
+ * if no test id is given, all tests with limits defined are performed
+ *
+ * return: <0, error out
+ *         otherwise, number of failed tests
+ */
+static int cli_do_test(int *p_test_ids, int num_tests, bool is_scheduled, bool is_rmi)
+{
+    int retval;
+    int i, k;
+    int order[CLI_MAX_TESTS];
+    int test_id;
+    int first_id = (is_rmi) ? CLI_RMI_TEST_FIRST : CLI_TCM_TEST_FIRST;
+    int last_id = (is_rmi) ? CLI_RMI_TEST_LAST : CLI_TCM_TEST_LAST;
+    int *p_limit_min, *p_limit_max;
+    int size_min, size_max;
+    /* the test results are in landscape, the same as the java layer */
+    int rows = syna_get_image_rows(true);
+    int cols = syna_get_image_cols(true);
+    int size_result = rows * cols + MAX_STRING_LEN;
+    int *p_result;
+    int num_failed = 0;
+    long long time_us;
+
+    if (num_tests == 0) {
+        for (test_id = first_id; (test_id <= last_id) && (num_tests < CLI_MAX_TESTS); test_id++) {
+            if (syna_get_test_limit(test_id, &p_limit_min, &size_min, &p_limit_max, &size_max) == 0)
+                p_test_ids[num_tests++] = test_id;
+        }
+    }
+
+    p_result = calloc((size_t)size_result, sizeof(int));
+    if (!p_result) {
+        fprintf(stderr, "fail to allocate the result buffer\n");
+        return -ENOMEM;
+    }
+
+    if (is_scheduled) {
+        syna_plan_test_order(p_test_ids, num_tests, order);
+        syna_plan_begin();
+    }
+    else {
+        for (i = 0; i < num_tests; i++)
+            order[i] = i;
+    }
+
+    for (k = 0; k < num_tests; k++) {
+        test_id = p_test_ids[order[k]];
+
+        if (is_scheduled)
+            syna_plan_set_test(test_id, (k + 1 < num_tests) ? p_test_ids[order[k + 1]] : -1);
+
+        memset(p_result, 0x00, (size_t)size_result * sizeof(int));
+
+        time_us = syna_get_time_ns() / 1000;
+        retval = syna_run_test_entry(test_id, p_result, size_result, cols, rows,
+                                     NULL, 0, NULL, 0);
+        time_us = (syna_get_time_ns() / 1000) - time_us;
+
+        if (retval != 0)
+            num_failed += 1;
+
+        fprintf(g_out, "{\"cmd\":\"test\",\"id\":%d,\"ret\":%d,\"result\":\"%s\",\"time_us\":%lld",
+                test_id, retval, (retval == 0) ? "pass" : ((retval > 0) ? "fail" : "error"), time_us);
+        cli_print_values("data", p_result, rows * cols);
+        fprintf(g_out, "}\n");
+        fflush(g_out);
+    }
+
+    if (is_scheduled)
+        syna_plan_end();
+
+    free(p_result);
+
+    return num_failed;
+}
+/*
+ * Function:  cli_do_capture
+ * --------------------
+ * command "capture", read the report images
+ * the frames are printed, and appended to the capture file if given
+ *
+ * return: <0, error out
+ *         otherwise, number of frames captured
+ */
+static int cli_do_capture(unsigned char report_type, int num_frames,
+                          const char *capture_path, int stream)
+{
+    int retval;
+    int i;
+    int size = g_rows * g_cols;
+    int *p_image;
+    long long time_us;
+
+    p_image = calloc((size_t)size, sizeof(int));
+    if (!p_image) {
+        fprintf(stderr, "fail to allocate the image buffer\n");
+        return -ENOMEM;
+    }
+
+    if (capture_path) {
+        retval = syna_capture_open(capture_path, g_rows, g_cols);
+        if (retval < 0) {
+            fprintf(stderr, "fail to create the capture file, %s\n", capture_path);
+            free(p_image);
+            return retval;
+        }
+    }
+
+    retval = syna_start_image_stream(report_type, false, true, false);
+    if (retval < 0) {
+        fprintf(g_out, "{\"cmd\":\"capture\",\"ret\":%d}\n", retval);
+        goto exit;
+    }
+
+    for (i = 0; i < num_frames; i++) {
+        time_us = syna_get_time_ns() / 1000;
+        retval = syna_read_report_image_entry(report_type, p_image, size, g_cols, g_rows, false);
+        time_us = (syna_get_time_ns() / 1000) - time_us;
+
+        fprintf(g_out, "{\"cmd\":\"capture\",\"type\":%d,\"frame\":%d,\"ret\":%d,\"time_us\":%lld",
+                report_type, i, retval, time_us);
+        if (retval >= 0)
+            cli_print_values("data", p_image, size);
+        fprintf(g_out, "}\n");
+
+        if (retval < 0)
+            break;
+
+        if (capture_path)
+            syna_capture_append_values(stream, p_image, size);
+    }
+
+    syna_stop_image_stream(report_type);
+
+    retval = (retval < 0) ? retval : i;
+
+exit:
+    if (capture_path)
+        syna_capture_close();
+    free(p_image);
+
+    return retval;
+}
+/*
+ * Function:  cli_do_raw
+ * --------------------
+ * command "raw", send one raw command
+ *
+ * return: <0, error out
+ *         otherwise, bytes accessed
+ */
+static int cli_do_raw(unsigned char type, int cmd, unsigned char *p_data, int size_data, int size_resp)
+{
+    int retval;
+    int i;
+    unsigned char *p_resp = NULL;
+    long long time_us;
+
+    if (size_resp > 0) {
+        p_resp = calloc((size_t)size_resp, sizeof(unsigned char));
+        if (!p_resp)
+            return -ENOMEM;
+    }
+
+    time_us = syna_get_time_ns() / 1000;
+    retval = syna_run_raw_command(type, cmd, p_data, size_data, p_resp, size_resp);
+    time_us = (syna_get_time_ns() / 1000) - time_us;
+
+    fprintf(g_out, "{\"cmd\":\"raw\",\"type\":\"%s\",\"code\":%d,\"ret\":%d,\"time_us\":%lld,\"data\":\"",
+            (type == CLI_RAW_CMD_READ) ? "r" : "w", cmd, retval, time_us);
+    /* read is returned in the input buffer, write is returned in the response */
+    if (type == CLI_RAW_CMD_READ) {
+        for (i = 0; (retval > 0) && (i < MIN(retval, size_data)); i++)
+            fprintf(g_out, "%02x", p_data[i]);
+    }
+    else if (p_resp) {
+        for (i = 0; (retval > 0) && (i < MIN(retval, size_resp)); i++)
+            fprintf(g_out, "%02x", p_resp[i]);
+    }
+    fprintf(g_out, "\"}\n");
+
+    if (p_resp)
+        free(p_resp);
+
+    return retval;
+}
+
+/*
+ * Function:  cli_do_script
+ * --------------------
+ * command "script", execute the raw command script, see syna_raw_script.h
+ *
+ * return: <0, error out
+ *         otherwise, number of failures
+ */
+static int cli_do_script(const char *script_path, bool stop_on_fail, bool is_rmi)
+{
+    static const char *op_names[] = {"read", "write", "wait", "loop", "end", "expect"};
+    int retval;
+    int i;
+    struct syna_script script;
+    struct syna_script_op *p_op;
+
+    retval = syna_script_load(script_path, &script);
+    if (retval < 0) {
+        fprintf(g_out, "{\"cmd\":\"script\",\"ret\":%d}\n", retval);
+        return retval;
+    }
+
+    if (script.is_rmi != is_rmi) {
+        fprintf(stderr, "%s script doesn't match the device\n", (script.is_rmi) ? "rmi" : "tcm");
+        retval = -EINVAL;
+        goto exit;
+    }
+
+    retval = syna_script_run(&script, stop_on_fail);
+
+    for (i = 0; (retval >= 0) && (i < script.num_ops); i++) {
+        p_op = &script.p_ops[i];
+        if ((SCRIPT_OP_LOOP == p_op->type) || (SCRIPT_OP_END == p_op->type))
+            continue;
+
+        fprintf(g_out, "{\"cmd\":\"script\",\"line\":%d,\"op\":\"%s\",\"count\":%d,\"fail\":%d,"
+                "\"min_us\":%lld,\"avg_us\":%lld,\"max_us\":%lld}\n",
+                p_op->line, op_names[p_op->type], p_op->count, p_op->fail, p_op->min_us,
+                (p_op->count > 0) ? (p_op->total_us / p_op->count) : 0, p_op->max_us);
+    }
+    fprintf(g_out, "{\"cmd\":\"script\",\"ret\":%d,\"commands\":%d,\"failures\":%d,\"time_us\":%lld}\n",
+            retval, script.num_executed, script.num_failed, script.total_us);
+
+exit:
+    syna_script_release(&script);
+
+    return retval;
+}
+
+/*
+ * Function:  cli_do_program
+ * --------------------
+ * command "program", write the image file into the flash area of tcm device
+ * the area is verified by reading back after the writing
+ *
+ * return: <0, error out
+ *         otherwise, succeed
+ */
+static int cli_do_program(int area, const char *image_path, bool is_4byte_format, bool is_rmi)
+{
+    int retval;
+    int info[PROGRAM_INFO_SIZE] = {0};
+    FILE *fp;
+    long image_bytes;
+    unsigned char *p_image = NULL;
+
+    if (is_rmi) {
+        fprintf(stderr, "flash programming is supported on tcm device only\n");
+        return -ENOSYS;
+    }
+
+    fp = fopen(image_path, "rb");
+    if (!fp) {
+        fprintf(stderr, "fail to open %s (err: %s)\n", image_path, strerror(errno));
+        return -ENOENT;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    image_bytes = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    if (image_bytes > 0)
+        p_image = malloc((size_t)image_bytes);
+
+    if ((!p_image) || (fread(p_image, 1, (size_t)image_bytes, fp) != (size_t)image_bytes)) {
+        fprintf(stderr, "fail to read %s\n", image_path);
+        retval = -EIO;
+    }
+    else {
+        retval = syna_program_firmware_area(area, p_image, (int)image_bytes, is_4byte_format,
+                                            info, PROGRAM_INFO_SIZE);
+    }
+    fclose(fp);
+    free(p_image);
+
+    fprintf(g_out, "{\"cmd\":\"program\",\"area\":%d,\"ret\":%d,\"bytes\":%d,\"crc32\":\"%08x\","
+            "\"erase_us\":%d,\"write_us\":%d,\"verify_us\":%d,\"write_kbps\":%d}\n",
+            area, retval, info[PROGRAM_INFO_BYTES], (unsigned int)info[PROGRAM_INFO_CRC32],
+            info[PROGRAM_INFO_ERASE_TIME_US], info[PROGRAM_INFO_WRITE_TIME_US],
+            info[PROGRAM_INFO_VERIFY_TIME_US], info[PROGRAM_INFO_WRITE_KBPS]);
+
+    return retval;
+}
+
+static void cli_usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [-d <dev node>] [-o <output>] [-l <limit.ini> [-c <cache>]]\n"
+            "          [-r <trace> | -p <trace> [-t <percent>]] <command> [args]\n"
+            "  -r, record the bus transactions into the trace\n"
+            "  -p, replay the trace instead of the device, -t scales the timing (100: original, 0: no delay)\n"
+            "  identify\n"
+            "  test [-s] [<test id> ...]           run the tests, all tests with limits if no id\n"
+            "                                      -s, reorder the tests to skip redundant resets\n"
+            "  capture <report type> <frames> [<capture file> [<stream>]]\n"
+            "  raw w <cmd> [<hex byte> ...] [-n <resp size>]\n"
+            "  raw r <reg> <size>\n"
+            "  script [-x] <script file>           -x, stop at the first failure\n"
+            "  program [-4] <area> <image file>    write and verify the flash area (tcm only)\n"
+            "                                      area: 1 lcm, 2 oem, 3 ppdt, 4 force calibration\n"
+            "                                      -4, use the 4-byte format of erase command\n"
+            "output is one JSON object per line, exit code is 0 on pass, 1 on failure, 2 on error\n",
+            name);
+}
+
+int main(int argc, char *argv[])
+{
+    int retval = 0;
+    int opt;
+    char *dev_node = NULL;
+    char *out_path = NULL;
+    char *limit_path = NULL;
+    char *cache_path = NULL;
+    char *record_path = NULL;
+    char *replay_path = NULL;
+    int time_scale = SYNA_BUS_TIME_ORIGINAL;
+    int num_records;
+    char *cmd;
+    bool is_rmi;
+    int test_ids[CLI_MAX_TESTS];
+    int num_tests = 0;
+    bool is_scheduled = false;
+    unsigned char raw_data[CLI_MAX_RAW_BYTES];
+    int size_raw = 0;
+    int size_resp = 0;
+    int i;
+
+    g_out = stdout;
+
+    while ((opt = getopt(argc, argv, "+d:o:l:c:r:p:t:h")) != -1) {
+        switch (opt) {
+            case 'd': dev_node = optarg; break;
+            case 'o': out_path = optarg; break;
+            case 'l': limit_path = optarg; break;
+            case 'c': cache_path = optarg; break;
+            case 'r': record_path = optarg; break;
+            case 'p': replay_path = optarg; break;
+            case 't': time_scale = (int)strtol(optarg, NULL, 0); break;
+            default:
+                cli_usage(argv[0]);
+                return 2;
+        }
+    }
+    if (optind >= argc) {
+        cli_usage(argv[0]);
+        return 2;
+    }
+    cmd = argv[optind++];
+
+    if (out_path) {
+        g_out = fopen(out_path, "w");
+        if (!g_out) {
+            fprintf(stderr, "fail to create %s (err: %s)\n", out_path, strerror(errno));
+            return 2;
+        }
+    }
+
+    /* look for the device node, or restore it from the trace */
+    if (replay_path) {
+        retval = syna_start_bus_replay(replay_path, time_scale);
+        if (retval < 0) {
+            fprintf(stderr, "fail to replay %s\n", replay_path);
+            goto exit;
+        }
+    }
+    else if (dev_node) {
+        is_rmi = (NULL != strstr(dev_node, "rmi"));
+        if (!syna_set_dev(dev_node, is_rmi, !is_rmi)) {
+            fprintf(stderr, "invalid device node, %s\n", dev_node);
+            retval = -ENODEV;
+            goto exit;
+        }
+    }
+    else if (!syna_find_dev(g_dev_node)) {
+        fprintf(stderr, "no synaptics device is found\n");
+        retval = -ENODEV;
+        goto exit;
+    }
+    is_rmi = (NULL != strstr(g_dev_node, "rmi"));
+
+    if (limit_path) {
+        retval = syna_limit_store_load(limit_path, cache_path);
+        if (retval < 0) {
+            fprintf(stderr, "fail to load the test limits, %s\n", limit_path);
+            goto exit;
+        }
+    }
+
+    if (record_path && !replay_path) {
+        retval = syna_start_bus_trace(record_path);
+        if (retval < 0) {
+            fprintf(stderr, "fail to record %s\n", record_path);
+            goto exit;
+        }
+    }
+
+    retval = syna_open_dev(g_dev_node);
+    if (retval < 0) {
+        fprintf(stderr, "fail to open %s\n", g_dev_node);
+        goto exit;
+    }
+
+    retval = cli_do_identify(0 == strcmp(cmd, "identify"));
+    if (retval < 0) {
+        fprintf(stderr, "fail to identify the device\n");
+    }
+    else if (0 == strcmp(cmd, "identify")) {
+        retval = 0;
+    }
+    else if (0 == strcmp(cmd, "test")) {
+        for (i = optind; i < argc; i++) {
+            if (0 == strcmp(argv[i], "-s"))
+                is_scheduled = true;
+            else if (num_tests < CLI_MAX_TESTS)
+                test_ids[num_tests++] = (int)strtol(argv[i], NULL, 0);
+        }
+        if ((num_tests == 0) && !syna_limit_store_is_loaded()) {
+            fprintf(stderr, "no test is given, and no limit is loaded\n");
+            retval = -EINVAL;
+        }
+        else {
+            retval = cli_do_test(test_ids, num_tests, is_scheduled, is_rmi);
+        }
+    }
+    else if ((0 == strcmp(cmd, "capture")) && (argc - optind >= 2)) {
+        retval = cli_do_capture((unsigned char)strtol(argv[optind], NULL, 0),
+                                (int)strtol(argv[optind + 1], NULL, 0),
+                                (argc - optind >= 3) ? argv[optind + 2] : NULL,
+                                (argc - optind >= 4) ? (int)strtol(argv[optind + 3], NULL, 0) :
+                                CAPTURE_STREAM_RAW);
+        retval = (retval < 0) ? retval : 0;
+    }
+    else if ((0 == strcmp(cmd, "raw")) && (argc - optind >= 2)) {
+        if (0 == strcmp(argv[optind], "r")) {
+            size_raw = (argc - optind >= 3) ? (int)strtol(argv[optind + 2], NULL, 0) : 0;
+            size_raw = MIN(MAX(size_raw, 0), CLI_MAX_RAW_BYTES);
+            retval = cli_do_raw(CLI_RAW_CMD_READ, (int)strtol(argv[optind + 1], NULL, 0),
+                                raw_data, size_raw, 0);
+        }
+        else {
+            for (i = optind + 2; i < argc; i++) {
+                if ((0 == strcmp(argv[i], "-n")) && (i + 1 < argc))
+                    size_resp = (int)strtol(argv[++i], NULL, 0);
+                else if (size_raw < CLI_MAX_RAW_BYTES)
+                    raw_data[size_raw++] = (unsigned char)strtol(argv[i], NULL, 16);
+            }
+            retval = cli_do_raw(CLI_RAW_CMD_WRITE, (int)strtol(argv[optind + 1], NULL, 0),
+                                raw_data, size_raw, size_resp);
+        }
+        retval = (retval < 0) ? retval : 0;
+    }
+    else if ((0 == strcmp(cmd, "script")) && (argc - optind >= 1)) {
+        i = optind;
+        if ((0 == strcmp(argv[i], "-x")) && (i + 1 < argc))
+            i++;
+        retval = cli_do_script(argv[i], (i > optind), is_rmi);
+    }
+    else if ((0 == strcmp(cmd, "program")) && (argc - optind >= 2)) {
+        i = optind;
+        if ((0 == strcmp(argv[i], "-4")) && (argc - optind >= 3))
+            i++;
+        retval = cli_do_program((int)strtol(argv[i], NULL, 0), argv[i + 1], (i > optind), is_rmi);
+        retval = (retval < 0) ? retval : 0;
+    }
+    else {
+        cli_usage(argv[0]);
+        retval = -EINVAL;
+    }
+
+    syna_close_dev(g_dev_node);
+
+exit:
+    if (record_path && !replay_path) {
+        num_records = syna_stop_bus_trace();
+        fprintf(g_out, "{\"cmd\":\"trace\",\"records\":%d}\n", num_records);
+    }
+    if (replay_path) {
+        num_records = syna_stop_bus_replay();
+        fprintf(g_out, "{\"cmd\":\"replay\",\"divergences\":%d}\n", num_records);
+        if ((num_records > 0) && (retval == 0))
+            retval = 1;
+    }
+
+    syna_limit_store_release();
+
+    if (g_out != stdout)
+        fclose(g_out);
+
+    if (retval < 0)
+        return 2;
+    return (retval > 0) ? 1 : 0;
+}
@@ -0,0 +1,360 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "syna_dev_manager.h"
+#include "syna_config_diff.h"
+
+#ifdef SAVE_ERR_MSG
+#include "err_msg_ctrl.h"
+#endif
+
+/* the differing block is scanned with NEON, the word-wise code is the reference */
+#if !defined(SYNA_CONFIG_DIFF_NO_SIMD)
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CONFIG_DIFF_USE_NEON
+#endif
+#endif
+
+/* bytes compared at once by memcmp before the word-wise comparison */
+#define CONFIG_DIFF_BLOCK (64)
+
+#define CONFIG_FIELDS_STEP (64)
+#define CONFIG_LINE_LEN (256)
+
+/* variables used during the comparison */
+struct config_diff_ctx {
+    struct syna_config_span *p_spans;
+    int max_spans;
+    int num_spans;
+    int cur_start;                /* start of the pending span, -1 if none */
+    int cur_end;
+};
+
+/*
+ * Function:  config_diff_flush
+ * --------------------
+ * helper function to close the pending span
+ * once the span buffer is full, the last span is extended to cover the rest
+ */
+static void config_diff_flush(struct config_diff_ctx *p_ctx)
+{
+    struct syna_config_span *p_last;
+
+    if (p_ctx->cur_start < 0)
+        return;
+
+    if (p_ctx->num_spans < p_ctx->max_spans) {
+        p_ctx->p_spans[p_ctx->num_spans].offset = p_ctx->cur_start;
+        p_ctx->p_spans[p_ctx->num_spans].length = p_ctx->cur_end - p_ctx->cur_start;
+        p_ctx->num_spans += 1;
+    }
+    else {
+        p_last = &p_ctx->p_spans[p_ctx->max_spans - 1];
+        p_last->length = p_ctx->cur_end - p_last->offset;
+    }
+
+    p_ctx->cur_start = -1;
+}
+/*
+ * Function:  config_diff_mark
+ * --------------------
+ * helper function to mark the differing bytes, [offset, offset + length)
+ * the adjacent bytes are merged into one span
+ */
+static void config_diff_mark(struct config_diff_ctx *p_ctx, int offset, int length)
+{
+    if ((p_ctx->cur_start >= 0) && (offset == p_ctx->cur_end)) {
+        p_ctx->cur_end += length;
+        return;
+    }
+
+    config_diff_flush(p_ctx);
+
+    p_ctx->cur_start = offset;
+    p_ctx->cur_end = offset + length;
+}
+/*
+ * Function:  syna_config_diff
+ * --------------------
+ * compare the config with the golden image, and report the differing bytes
+ * as (offset, length) spans.
+ * the equal blocks are skipped by memcmp, which is vectorized in libc,
+ * and the differing block is scanned in 16-byte vectors with NEON, or in
+ * 64-bit words otherwise; only the differing vectors or words are checked
+ * byte by byte.
+ * the bytes beyond the shorter image are reported as one span.
+ *
+ * return: <0, invalid parameter
+ *         otherwise, number of spans, 0 if the config is identical
+ */
+int syna_config_diff(const unsigned char *p_config, int config_bytes,
+                     const unsigned char *p_golden, int golden_bytes,
+                     struct syna_config_span *p_spans, int max_spans)
+{
+    struct config_diff_ctx ctx;
+    int size = MIN(config_bytes, golden_bytes);
+    int offset;
+    int block;
+    int i, k;
+    unsigned long long word_config;
+    unsigned long long word_golden;
+#if defined(CONFIG_DIFF_USE_NEON)
+    unsigned char lane_eq[16];
+    uint8x16_t q_eq;
+    uint64x2_t q_eq64;
+#endif
+
+    if ((!p_config) || (!p_golden) || (!p_spans) || (max_spans <= 0) ||
+        (config_bytes < 0) || (golden_bytes < 0)) {
+        printf_e("%s error: invalid parameter\n", __func__);
+        return -EINVAL;
+    }
+
+    memset(&ctx, 0x00, sizeof(struct config_diff_ctx));
+    ctx.p_spans = p_spans;
+    ctx.max_spans = max_spans;
+    ctx.cur_start = -1;
+
+    for (offset = 0; offset < size; offset += block) {
+        block = MIN(CONFIG_DIFF_BLOCK, size - offset);
+
+        if (0 == memcmp(&p_config[offset], &p_golden[offset], (size_t)block))
+            continue;
+
+        i = 0;
+#if defined(CONFIG_DIFF_USE_NEON)
+        for (; i + 16 <= block; i += 16) {
+            q_eq = vceqq_u8(vld1q_u8(&p_config[offset + i]), vld1q_u8(&p_golden[offset + i]));
+            q_eq64 = vreinterpretq_u64_u8(q_eq);
+            if ((vgetq_lane_u64(q_eq64, 0) & vgetq_lane_u64(q_eq64, 1)) == ~0ULL)
+                continue;
+
+            vst1q_u8(lane_eq, q_eq);
+            for (k = 0; k < 16; k++) {
+                if (!lane_eq[k])
+                    config_diff_mark(&ctx, offset + i + k, 1);
+            }
+        }
+#endif
+        for (; i + (int)sizeof(word_config) <= block; i += (int)sizeof(word_config)) {
+            /* the image may not be aligned, load the words by memcpy */
+            memcpy(&word_config, &p_config[offset + i], sizeof(word_config));
+            memcpy(&word_golden, &p_golden[offset + i], sizeof(word_golden));
+            if (word_config == word_golden)
+                continue;
+
+            for (k = 0; k < (int)sizeof(word_config); k++) {
+                if (p_config[offset + i + k] != p_golden[offset + i + k])
+                    config_diff_mark(&ctx, offset + i + k, 1);
+            }
+        }
+        for (; i < block; i++) {
+            if (p_config[offset + i] != p_golden[offset + i])
+                config_diff_mark(&ctx, offset + i, 1);
+        }
+    }
+
+    if (config_bytes != golden_bytes)
+        config_diff_mark(&ctx, size, MAX(config_bytes, golden_bytes) - size);
+
+    config_diff_flush(&ctx);
+
+    return ctx.num_spans;
+}
+/*
+ * Function:  config_compare_field
+ * --------------------
+ * helper function to sort the fields by offset
+ */
+static int config_compare_field(const void *a, const void *b)
+{
+    const struct syna_config_field *p_a = (const struct syna_config_field *)a;
+    const struct syna_config_field *p_b = (const struct syna_config_field *)b;
+
+    return p_a->offset - p_b->offset;
+}
+/*
+ * Function:  syna_config_layout_load
+ * --------------------
+ * load the fields from the layout file, the fields are sorted by offset
+ * *pp_fields is allocated in this function, and should be released by caller
+ *
+ * return: <0, fail to load the layout file
+ *         otherwise, number of fields
+ */
+int syna_config_layout_load(const char *layout_path, struct syna_config_field **pp_fields)
+{
+    FILE *fp;
+    char line[CONFIG_LINE_LEN];
+    char *p_token;
+    char *p_save;
+    char *p_end;
+    struct syna_config_field field;
+    struct syna_config_field *p_fields = NULL;
+    struct syna_config_field *p_tmp;
+    int num_fields = 0;
+    int max_fields = 0;
+    int num_line = 0;
+#ifdef SAVE_ERR_MSG
+    char err[MAX_ERR_STRING_LEN];
+#endif
+
+    if ((!layout_path) || (!pp_fields)) {
+        printf_e("%s error: invalid parameter\n", __func__);
+        return -EINVAL;
+    }
+
+    fp = fopen(layout_path, "r");
+    if (!fp) {
+        printf_e("%s error: fail to open file, %s (err: %s)\n", __func__, layout_path, strerror(errno));
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: fail to open file, %s\n", __func__, layout_path);
+        add_error_msg(err);
+#endif
+        return -EIO;
+    }
+
+    while (fgets(line, sizeof(line), fp)) {
+        num_line += 1;
+
+        /* strip the comment */
+        p_end = strpbrk(line, "#;\r\n");
+        if (p_end)
+            *p_end = '\0';
+
+        memset(&field, 0x00, sizeof(struct syna_config_field));
+
+        p_token = strtok_r(line, " \t,", &p_save);
+        if (!p_token)
+            continue;
+        strncpy(field.name, p_token, SYNA_CONFIG_FIELD_NAME_LEN - 1);
+
+        p_token = strtok_r(NULL, " \t,", &p_save);
+        if (p_token)
+            field.offset = (int)strtol(p_token, &p_end, 0);
+        if ((!p_token) || (*p_end != '\0') || (field.offset < 0)) {
+            printf_e("%s error: invalid offset at line %d\n", __func__, num_line);
+            continue;
+        }
+
+        p_token = strtok_r(NULL, " \t,", &p_save);
+        if (p_token)
+            field.length = (int)strtol(p_token, &p_end, 0);
+        if ((!p_token) || (*p_end != '\0') || (field.length <= 0)) {
+            printf_e("%s error: invalid length at line %d\n", __func__, num_line);
+            continue;
+        }
+
+        if (num_fields == max_fields) {
+            p_tmp = realloc(p_fields, (size_t)(max_fields + CONFIG_FIELDS_STEP) * sizeof(struct syna_config_field));
+            if (!p_tmp) {
+                printf_e("%s error: can't allocate memory for fields\n", __func__);
+                free(p_fields);
+                fclose(fp);
+                return -ENOMEM;
+            }
+            p_fields = p_tmp;
+            max_fields += CONFIG_FIELDS_STEP;
+        }
+        memcpy(&p_fields[num_fields], &field, sizeof(struct syna_config_field));
+        num_fields += 1;
+    }
+    fclose(fp);
+
+    if (num_fields > 0)
+        qsort(p_fields, (size_t)num_fields, sizeof(struct syna_config_field), config_compare_field);
+
+    printf_i("%s info: %d fields are loaded, %s\n", __func__, num_fields, layout_path);
+
+    *pp_fields = p_fields;
+    return num_fields;
+}
+/*
+ * Function:  syna_config_diff_report
+ * --------------------
+ * format the spans as text, one span per line
+ *
+ *   <offset>,<length>[,<field>...]
+ *
+ * the fields overlapped with the span are listed if the layout is given
+ *
+ * return: length of the report
+ */
+int syna_config_diff_report(const struct syna_config_span *p_spans, int num_spans,
+                            const struct syna_config_field *p_fields, int num_fields,
+                            char *p_report, int size_report)
+{
+    int len = 0;
+    int i, j;
+    int span_end;
+
+    if ((!p_report) || (size_report <= 0))
+        return 0;
+
+    p_report[0] = '\0';
+
+    for (i = 0; i < num_spans; i++) {
+        span_end = p_spans[i].offset + p_spans[i].length;
+
+        len += snprintf(p_report + len, (size_t)(size_report - len), "0x%04x,%d",
+                        p_spans[i].offset, p_spans[i].length);
+        if (len >= size_report)
+            break;
+
+        for (j = 0; (p_fields) && (j < num_fields); j++) {
+            /* fields are sorted by offset */
+            if (p_fields[j].offset >= span_end)
+                break;
+            if (p_fields[j].offset + p_fields[j].length <= p_spans[i].offset)
+                continue;
+
+            len += snprintf(p_report + len, (size_t)(size_report - len), ",%s", p_fields[j].name);
+            if (len >= size_report)
+                break;
+        }
+        if (len >= size_report)
+            break;
+
+        len += snprintf(p_report + len, (size_t)(size_report - len), "\n");
+        if (len >= size_report)
+            break;
+    }
+
+    /* report is truncated */
+    if (len >= size_report)
+        len = size_report - 1;
+
+    return len;
+}
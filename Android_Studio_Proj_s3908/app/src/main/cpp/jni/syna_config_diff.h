@@ -0,0 +1,73 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+
+#include <stdbool.h>
+
+#ifndef _SYNA_CONFIG_DIFF_H__
+#define _SYNA_CONFIG_DIFF_H__
+
+/* max. length of the field name defined in layout file */
+#define SYNA_CONFIG_FIELD_NAME_LEN  (48)
+
+/* max. number of differing ranges being reported */
+#define SYNA_CONFIG_MAX_SPANS       (256)
+
+/* size of the text report */
+#define SYNA_CONFIG_REPORT_LEN      (16384)
+
+/* range of the differing bytes */
+struct syna_config_span {
+    int offset;
+    int length;
+};
+
+/*
+ * field of the config, defined in the layout file as
+ *
+ *   <name> <offset in bytes> <length in bytes>
+ *
+ * one field per line, '#' or ';' starts a comment
+ */
+struct syna_config_field {
+    char name[SYNA_CONFIG_FIELD_NAME_LEN];
+    int offset;
+    int length;
+};
+
+/* helper to compare the config with the golden image */
+int syna_config_diff(const unsigned char *p_config, int config_bytes,
+                     const unsigned char *p_golden, int golden_bytes,
+                     struct syna_config_span *p_spans, int max_spans);
+
+/* helper to map the differing ranges to the fields */
+int syna_config_layout_load(const char *layout_path, struct syna_config_field **pp_fields);
+int syna_config_diff_report(const struct syna_config_span *p_spans, int num_spans,
+                            const struct syna_config_field *p_fields, int num_fields,
+                            char *p_report, int size_report);
+
+#endif // _SYNA_CONFIG_DIFF_H__
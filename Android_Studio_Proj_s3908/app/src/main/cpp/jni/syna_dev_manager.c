@@ -34,10 +34,17 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <time.h>
 
 #include "syna_dev_manager.h"
 #include "rmi_control.h"
 #include "tcm_control.h"
+#include "syna_limit_store.h"
+#include "syna_ref_store.h"
+#include "syna_config_diff.h"
+#include "syna_raw_script.h"
+#include "syna_bus_trace.h"
 
 #ifdef SAVE_ERR_MSG
 #include "err_msg_ctrl.h"
@@ -92,11 +99,105 @@ enum TEST_ID {
     TEST_TCM_EX_HIGH_RESISTANCE_PID05 = 0x30B,
 };
 
+/*
+ * keys of the test limits defined in test configuration file
+ * must be equivalent to the keys used in java layer, TestCfgFileManager
+ */
+struct test_limit_keys {
+    int test_id;
+    const char *key_min;
+    const char *key_max;
+};
+static const struct test_limit_keys g_test_limit_keys[] = {
+    { TEST_RMI_NOISE_RT02,              NULL,                       "NOISE_TEST_LIMIT" },
+    { TEST_TCM_NOISE_PID0A,             NULL,                       "NOISE_TEST_LIMIT" },
+    { TEST_RMI_FULL_RAW_RT20,           "FULL_RAW_CAP_LIMIT_MIN",   "FULL_RAW_CAP_LIMIT_MAX" },
+    { TEST_RMI_FULL_RAW_TDDI_RT92,      "FULL_RAW_CAP_LIMIT_MIN",   "FULL_RAW_CAP_LIMIT_MAX" },
+    { TEST_RMI_ABS_OPEN_RT63,           "ABS_OPEN_LIMIT_MIN",       "ABS_OPEN_LIMIT_MAX" },
+    { TEST_RMI_ADC_RANGE_RT23,          "ADC_RANGE_LIMIT_MIN",      "ADC_RANGE_LIMIT_MAX" },
+    { TEST_RMI_SENSOR_SPEED_RT22,       "SENSOR_SPEED_LIMIT_MIN",   "SENSOR_SPEED_LIMIT_MAX" },
+    { TEST_RMI_TAGSMOISTURE_RT76,       NULL,                       "TAGSMOISTURE_TEST_LIMIT" },
+    { TEST_RMI_RT133,                   NULL,                       "RT133_TEST_LIMIT" },
+    { TEST_RMI_ABS_DELTA_RT59,          "ABS_DELTA_LIMIT_MIN",      "ABS_DELTA_LIMIT_MAX" },
+    { TEST_TCM_DRT_PID07,               "DRT_TEST_LIMIT_MIN",       "DRT_TEST_LIMIT_MAX" },
+    { TEST_TCM_FULL_RAW_PID05,          "FULLRAW_PT05_LIMIT_MIN",   "FULLRAW_PT05_LIMIT_MAX" },
+    { TEST_TCM_TRX_TRX_SHORT_PID01,     NULL,                       "TRX_TRX_SHORT_PT01_LIMIT" },
+    { TEST_TCM_TRX_GROUND_PID03,        NULL,                       "TRX_GROUND_PT03_LIMIT" },
+    { TEST_TCM_ADC_RANGE_PID11,         "ADC_RANGE_PT11_LIMIT_MIN", "ADC_RANGE_PT11_LIMIT_MAX" },
+    { TEST_TCM_ABS_RAWCAP_PID12,        "ABS_RAW_PT12_LIMIT_MIN",   "ABS_RAW_PT12_LIMIT_MAX" },
+    { TEST_TCM_HYBRID_ABS_NOISE_PID1D,  "ABS_NOISE_PT1D_LIMIT_MIN", "ABS_NOISE_PT1D_LIMIT_MAX" },
+};
+
+/*
+ * device state required before and left after each production test
+ * used by the test plan to order the tests and to skip the redundant transitions
+ *
+ * a test is marked as TEST_STATE_KEEP only if it is known not to change the
+ * device state; all others are marked as TEST_STATE_UNKNOWN, so the sw reset
+ * is always issued after them. tests not listed keep the submitted order and
+ * are always followed by the sw reset as well.
+ *
+ * evidence of the TEST_STATE_KEEP entries:
+ *  RT02  - rmi_do_test_noise_rt02() issues the get-report sequence of report
+ *          type 2 only (F54 data reg 0/1 and the F54 command), no F54 control
+ *          register or force update is written. report type 2 is the delta
+ *          image of the normal acquisition, and the test itself reads it
+ *          frame after frame with no reset in between.
+ *
+ * RT92, RT22, RT23, RT59, RT76 and RT133 select report types running special
+ * acquisition modes in the firmware, and RT20 disables cbc/cdm and rezeroes
+ * the baseline, so none of them is known to leave the device state untouched.
+ */
+struct test_state_desc {
+    int test_id;
+    int pre_state;
+    int post_state;
+};
+#define TEST_STATE_KEEP   (-1)  /* post_state, the device state is not changed */
+static const struct test_state_desc g_test_state_desc[] = {
+    { TEST_RMI_NOISE_RT02,          TEST_STATE_DEFAULT,        TEST_STATE_KEEP },
+    { TEST_RMI_FULL_RAW_TDDI_RT92,  TEST_STATE_DEFAULT,        TEST_STATE_UNKNOWN },
+    { TEST_RMI_SENSOR_SPEED_RT22,   TEST_STATE_DEFAULT,        TEST_STATE_UNKNOWN },
+    { TEST_RMI_ADC_RANGE_RT23,      TEST_STATE_DEFAULT,        TEST_STATE_UNKNOWN },
+    { TEST_RMI_ABS_DELTA_RT59,      TEST_STATE_DEFAULT,        TEST_STATE_UNKNOWN },
+    { TEST_RMI_TAGSMOISTURE_RT76,   TEST_STATE_DEFAULT,        TEST_STATE_UNKNOWN },
+    { TEST_RMI_RT133,               TEST_STATE_DEFAULT,        TEST_STATE_UNKNOWN },
+    { TEST_RMI_TRX_SHORT_RT26,      TEST_STATE_DEFAULT,        TEST_STATE_UNKNOWN },
+    { TEST_RMI_ABS_OPEN_RT63,       TEST_STATE_DEFAULT,        TEST_STATE_UNKNOWN },
+    { TEST_RMI_FULL_RAW_RT20,       TEST_STATE_CBC_DISABLED,   TEST_STATE_UNKNOWN },
+};
+
+/* variables of the running test plan */
+struct test_plan {
+    bool is_active;
+    int state;                  /* current device state, enum SYNA_TEST_STATE */
+    const struct test_state_desc *p_cur;
+    const struct test_state_desc *p_next;
+};
+static struct test_plan g_test_plan;
+
 /* global variables as a string of config id */
 static char g_str_config_id[MAX_STRING_LEN];
 static bool g_report_img_stream_en;
 static int g_finger_status[MAX_FINGER];
 
+/*
+ * Function:  syna_get_time_ns
+ * --------------------
+ * helper function to get the monotonic time in nano-seconds
+ * shared by all modules measuring the elapsed time or the deadline
+ *
+ * return: time in ns
+ */
+long long syna_get_time_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
 /*
  * Function:  syna_find_dev
  * --------------------
@@ -262,6 +363,84 @@ int syna_close_dev(const char *dev_node)
 
     return retval;
 }
+/*
+ * Function:  syna_start_bus_trace
+ * --------------------
+ * start to record the transactions of the device into a binary trace
+ *
+ * return: <0, fail to start
+ *         otherwise, 0
+ */
+int syna_start_bus_trace(const char *trace_path)
+{
+    if ((SYNA_RMI_DEV != g_syna_dev) && (SYNA_TCM_DEV != g_syna_dev)) {
+        printf_e("%s error: unknown device\n", __func__);
+        return -EINVAL;
+    }
+
+    return syna_bus_record_start(trace_path, (int)g_syna_dev, g_dev_node);
+}
+/*
+ * Function:  syna_stop_bus_trace
+ * --------------------
+ * stop the recording
+ *
+ * return: <0, fail to write the trace
+ *         otherwise, number of transactions recorded
+ */
+int syna_stop_bus_trace(void)
+{
+    return syna_bus_record_stop();
+}
+/*
+ * Function:  syna_start_bus_replay
+ * --------------------
+ * replay the trace instead of accessing the device,
+ * the device type and node are restored from the trace
+ *
+ * parameter
+ *  trace_path: path of the trace file
+ *  time_scale: percent of the original timing, 0 to replay without delay
+ *
+ * return: <0, fail to start
+ *         otherwise, 0
+ */
+int syna_start_bus_replay(const char *trace_path, int time_scale)
+{
+    int retval;
+    int dev_type = SYNA_DEV_NONE;
+
+    retval = syna_bus_replay_start(trace_path, time_scale, &dev_type,
+                                   g_dev_node, sizeof(g_dev_node));
+    if (retval < 0)
+        return retval;
+
+    switch (dev_type) {
+        case SYNA_RMI_DEV:
+            g_syna_dev = SYNA_RMI_DEV;
+            break;
+        case SYNA_TCM_DEV:
+            g_syna_dev = SYNA_TCM_DEV;
+            break;
+        default:
+            printf_e("%s error: unknown device type in trace, %d\n", __func__, dev_type);
+            syna_bus_replay_stop();
+            return -EINVAL;
+    }
+
+    return 0;
+}
+/*
+ * Function:  syna_stop_bus_replay
+ * --------------------
+ * stop the replay
+ *
+ * return: number of transactions diverging from the trace
+ */
+int syna_stop_bus_replay(void)
+{
+    return syna_bus_replay_stop();
+}
 /*
  * Function:  syna_get_device_id
  * --------------------
@@ -507,6 +686,10 @@ int syna_get_num_force_elecs(void)
 int syna_do_sw_reset()
 {
     int retval = -EINVAL;
+
+    /* all settings are restored by the reset */
+    g_test_plan.state = TEST_STATE_DEFAULT;
+
     switch (g_syna_dev) {
         case SYNA_RMI_DEV:
             retval = rmi_f01_sw_reset();
@@ -520,6 +703,31 @@ int syna_do_sw_reset()
     }
     return retval;
 }
+/*
+ * Function:  syna_get_reset_latency
+ * --------------------
+ * get the latency of the last sw reset, from the reset command to the device ready
+ * rmi device always waits for a fixed delay, so it is not measured
+ *
+ * return: <0, not available
+ *         otherwise, latency in micro-seconds
+ */
+int syna_get_reset_latency(void)
+{
+    int retval = -EINVAL;
+    switch (g_syna_dev) {
+        case SYNA_RMI_DEV:
+            retval = -ENOSYS;
+            break;
+        case SYNA_TCM_DEV:
+            retval = tcm_get_reset_latency();
+            break;
+        default:
+            printf_e("%s error: unknown device\n", __func__);
+            break;
+    }
+    return retval;
+}
 /*
  * Function:  syna_set_no_sleep
  * --------------------
@@ -1306,10 +1514,384 @@ int syna_run_tcm_test_entry(int test_id, int *p_result, int result_col, int resu
 
     return retval;
 }
+/*
+ * Function:  syna_get_test_limit
+ * --------------------
+ * get the test limits of the test item from the limit store
+ * the pointers refer to the limit store directly, no copy is made.
+ * pointer is NULL if the limit is not defined.
+ *
+ * return: <0, the limit store is not loaded or no limit is defined
+ *         otherwise, succeed
+ */
+int syna_get_test_limit(int test_id, int **pp_limit_min, int *p_size_min,
+                        int **pp_limit_max, int *p_size_max)
+{
+    int i;
+    int size;
+    const struct test_limit_keys *p_keys = NULL;
+
+    *pp_limit_min = NULL;
+    *pp_limit_max = NULL;
+    *p_size_min = 0;
+    *p_size_max = 0;
+
+    if (!syna_limit_store_is_loaded())
+        return -ENODEV;
+
+    for (i = 0; i < (int)(sizeof(g_test_limit_keys)/sizeof(g_test_limit_keys[0])); i++) {
+        if (g_test_limit_keys[i].test_id == test_id) {
+            p_keys = &g_test_limit_keys[i];
+            break;
+        }
+    }
+    if (!p_keys)
+        return -ENOENT;
+
+    if (p_keys->key_min) {
+        size = syna_limit_store_find(p_keys->key_min, pp_limit_min);
+        if (size > 0)
+            *p_size_min = size;
+        else
+            *pp_limit_min = NULL;
+    }
+    if (p_keys->key_max) {
+        size = syna_limit_store_find(p_keys->key_max, pp_limit_max);
+        if (size > 0)
+            *p_size_max = size;
+        else
+            *pp_limit_max = NULL;
+    }
+
+    if (!*pp_limit_min && !*pp_limit_max)
+        return -ENOENT;
+
+    return 0;
+}
+/*
+ * Function:  syna_get_ref_store_key
+ * --------------------
+ * helper function to get the product and config id of the device being used,
+ * which are the keys of the frames in the reference store
+ *
+ * return: <0, unknown device
+ *         otherwise, succeed
+ */
+static int syna_get_ref_store_key(char *p_product, char *p_config_id)
+{
+    char *p_str;
+
+    /* device id is not terminated if all 16 characters are used */
+    p_str = syna_get_device_id();
+    if (!p_str)
+        return -ENODEV;
+    snprintf(p_product, SYNA_REF_PRODUCT_LEN, "%.16s", p_str);
+
+    p_str = syna_get_config_id();
+    if (!p_str)
+        return -ENODEV;
+    snprintf(p_config_id, SYNA_REF_CONFIG_ID_LEN, "%s", p_str);
+
+    return 0;
+}
+/*
+ * Function:  syna_get_reference_frame
+ * --------------------
+ * get the frame of the test item for the device being used from the reference store
+ * the pointer refers to the reference store directly, no copy is made.
+ *
+ * return: <0, the reference store is not opened or no frame is found
+ *         otherwise, the number of data
+ */
+int syna_get_reference_frame(int test_id, int kind, int col, int row, short **pp_frame)
+{
+    int retval;
+    char product[SYNA_REF_PRODUCT_LEN];
+    char config_id[SYNA_REF_CONFIG_ID_LEN];
+
+    *pp_frame = NULL;
+
+    if (!syna_ref_store_is_opened())
+        return -ENODEV;
+
+    retval = syna_get_ref_store_key(product, config_id);
+    if (retval < 0)
+        return retval;
+
+    return syna_ref_store_find(product, config_id, test_id, kind, col, row, pp_frame);
+}
+/*
+ * Function:  syna_update_reference_frame
+ * --------------------
+ * update the frame of the test item for the device being used in the reference store
+ * the frame is the average of num_frames frames in p_frames, which are captured
+ *
+ * return: <0, fail to update the frame
+ *         otherwise, succeed
+ */
+int syna_update_reference_frame(int test_id, int kind, int col, int row,
+                                const int *p_frames, int num_frames)
+{
+    int retval;
+    char product[SYNA_REF_PRODUCT_LEN];
+    char config_id[SYNA_REF_CONFIG_ID_LEN];
+
+    retval = syna_get_ref_store_key(product, config_id);
+    if (retval < 0) {
+        printf_e("%s error: unknown device\n", __func__);
+        return retval;
+    }
+
+    return syna_ref_store_update(product, config_id, test_id, kind, col, row,
+                                 p_frames, num_frames, 0);
+}
+/*
+ * Function:  syna_import_reference_frame
+ * --------------------
+ * import the frame of the test item in the test config into the reference store
+ * the frame in the store is kept if it is averaged from the captures, or if it is
+ * imported from the same frame, which is identified by its crc32
+ *
+ * return: <0, fail to import the frame
+ *         0, the frame in the store is kept
+ *         1, the frame is imported
+ */
+int syna_import_reference_frame(int test_id, int kind, int col, int row, const int *p_frame)
+{
+    int retval;
+    char product[SYNA_REF_PRODUCT_LEN];
+    char config_id[SYNA_REF_CONFIG_ID_LEN];
+    unsigned int crc;
+    unsigned int source_crc;
+
+    if ((!p_frame) || (col <= 0) || (row <= 0)) {
+        printf_e("%s error: invalid parameter\n", __func__);
+        return -EINVAL;
+    }
+
+    retval = syna_get_ref_store_key(product, config_id);
+    if (retval < 0) {
+        printf_e("%s error: unknown device\n", __func__);
+        return retval;
+    }
+
+    crc = tcm_flash_crc32(0, (const unsigned char *)p_frame, col * row * (int)sizeof(int));
+
+    retval = syna_ref_store_get_source(product, config_id, test_id, kind, col, row, &source_crc);
+    if (retval >= 0) {
+        if (source_crc == 0) {
+            printf_i("%s info: test 0x%x, kind %d, keep the frame averaged from the captures\n",
+                     __func__, test_id, kind);
+            return 0;
+        }
+        if (source_crc == crc)
+            return 0;
+        if (source_crc == SYNA_REF_SOURCE_UNKNOWN) {
+            printf_i("%s info: test 0x%x, kind %d, source of the frame is unknown, import it\n",
+                     __func__, test_id, kind);
+        }
+        else {
+            printf_i("%s info: test 0x%x, kind %d, frame in the test config is changed (crc32 0x%08x -> 0x%08x)\n",
+                     __func__, test_id, kind, source_crc, crc);
+        }
+    }
+
+    retval = syna_ref_store_update(product, config_id, test_id, kind, col, row,
+                                   p_frame, 1, crc);
+    if (retval < 0)
+        return retval;
+
+    return 1;
+}
+/*
+ * Function:  syna_plan_find_desc
+ * --------------------
+ * helper function to find the device state of test item
+ *
+ * return: NULL, the test is not listed
+ *         otherwise, pointer to the descriptor
+ */
+static const struct test_state_desc *syna_plan_find_desc(int test_id)
+{
+    int i;
+
+    for (i = 0; i < (int)(sizeof(g_test_state_desc)/sizeof(g_test_state_desc[0])); i++) {
+        if (g_test_state_desc[i].test_id == test_id)
+            return &g_test_state_desc[i];
+    }
+    return NULL;
+}
+/*
+ * Function:  syna_plan_get_rank
+ * --------------------
+ * helper function to get the order of test item in the plan
+ *    0 - keep the default state, no reset is needed after it
+ *    1 - not listed, or reset is required after the test
+ *    2 - CBC/CDM disabled, run together at the end of the plan
+ */
+static int syna_plan_get_rank(int test_id)
+{
+    const struct test_state_desc *p_desc = syna_plan_find_desc(test_id);
+
+    if (!p_desc)
+        return 1;
+    if (p_desc->pre_state == TEST_STATE_CBC_DISABLED)
+        return 2;
+    if (p_desc->post_state == TEST_STATE_KEEP)
+        return 0;
+    return 1;
+}
+/*
+ * Function:  syna_plan_test_order
+ * --------------------
+ * determine the order to run the tests, so that the tests requiring
+ * the same device state are run together.
+ * the submitted order is kept within each group.
+ *
+ * p_order[k] is the index of the k-th test to run
+ *
+ * return: <0, invalid parameter
+ *         otherwise, succeed
+ */
+int syna_plan_test_order(const int *p_test_ids, int num_tests, int *p_order)
+{
+    int i, rank;
+    int k = 0;
+
+    if (!p_test_ids || !p_order || (num_tests <= 0))
+        return -EINVAL;
+
+    for (rank = 0; rank <= 2; rank++) {
+        for (i = 0; i < num_tests; i++) {
+            if (syna_plan_get_rank(p_test_ids[i]) == rank)
+                p_order[k++] = i;
+        }
+    }
+
+    return 0;
+}
+/*
+ * Function:  syna_plan_begin
+ * --------------------
+ * start a test plan, the device is assumed to be in the default state
+ * the transitions of the tests are controlled by the plan until syna_plan_end
+ */
+void syna_plan_begin(void)
+{
+    g_test_plan.is_active = true;
+    g_test_plan.state = TEST_STATE_DEFAULT;
+    g_test_plan.p_cur = NULL;
+    g_test_plan.p_next = NULL;
+}
+/*
+ * Function:  syna_plan_set_test
+ * --------------------
+ * notify the plan the test about to run, and the test after it
+ * next_test_id < 0 if it is the last one
+ */
+void syna_plan_set_test(int test_id, int next_test_id)
+{
+    if (!g_test_plan.is_active)
+        return;
+
+    g_test_plan.p_cur = syna_plan_find_desc(test_id);
+    g_test_plan.p_next = (next_test_id < 0) ? NULL : syna_plan_find_desc(next_test_id);
+}
+/*
+ * Function:  syna_plan_end
+ * --------------------
+ * complete the test plan
+ * a sw reset is issued if the device is not in the default state
+ */
+void syna_plan_end(void)
+{
+    if (!g_test_plan.is_active)
+        return;
+
+    g_test_plan.is_active = false;
+    g_test_plan.p_cur = NULL;
+    g_test_plan.p_next = NULL;
+
+    if (g_test_plan.state != TEST_STATE_DEFAULT)
+        syna_do_sw_reset();
+}
+/*
+ * Function:  syna_do_test_disable_cbc_cdm
+ * --------------------
+ * disable the cbc/cdm before the testing, e.g. RT20
+ * skipped if the plan has already disabled it
+ *
+ * return: <0, fail to disable cbc/cdm
+ *         otherwise, succeed
+ */
+int syna_do_test_disable_cbc_cdm(void)
+{
+    int retval;
+
+    if (g_test_plan.is_active && (g_test_plan.state == TEST_STATE_CBC_DISABLED)) {
+        printf_i("%s info: cbc/cdm is disabled already\n", __func__);
+        return 0;
+    }
+
+    retval = rmi_disable_cbc_cdm();
+    if (retval >= 0)
+        g_test_plan.state = TEST_STATE_CBC_DISABLED;
+
+    return retval;
+}
+/*
+ * Function:  syna_do_test_post_reset
+ * --------------------
+ * issue the sw reset at the end of testing
+ * skipped if the test plan knows the next test can run in the current state
+ *
+ * return: 0<, fail to issue sw reset
+ *         otherwise, succeed
+ */
+int syna_do_test_post_reset(void)
+{
+    int post_state;
+
+    if (g_test_plan.is_active && g_test_plan.p_cur && g_test_plan.p_next) {
+        post_state = g_test_plan.p_cur->post_state;
+        if (post_state == TEST_STATE_KEEP)
+            post_state = g_test_plan.state;
+
+        if ((post_state != TEST_STATE_UNKNOWN) &&
+            (post_state == g_test_plan.p_next->pre_state)) {
+            printf_i("%s info: skip the reset, next test 0x%x runs in state %d\n",
+                     __func__, g_test_plan.p_next->test_id, post_state);
+            g_test_plan.state = post_state;
+            return 0;
+        }
+    }
+
+    return syna_do_sw_reset();
+}
+/*
+ * Function:  syna_test_has_pins_result
+ * --------------------
+ * check whether the test stores the pin's result in param_1,
+ * param_1 of other tests is the limit minimum
+ *
+ * return: true, param_1 is the buffer of pin's result
+ */
+bool syna_test_has_pins_result(int test_id)
+{
+    switch (test_id) {
+        case TEST_RMI_TRX_SHORT_RT26:
+        case TEST_TCM_TRX_TRX_SHORT_PID01:
+        case TEST_TCM_TRX_GROUND_PID03:
+            return true;
+        default:
+            return false;
+    }
+}
 /*
  * Function:  syna_run_test_entry
  * --------------------
  * the entry function to run the requested production testing
+ * if the limit is not given by caller, the limit in the limit store is used
  *
  * return: =0, pass
  *         otherwise, fail
@@ -1318,6 +1900,10 @@ int syna_run_test_entry(int test_id, int *p_result, int size_result, int result_
                         int *p_param_1, int size_param_1, int *p_param_2, int size_param_2)
 {
     int retval = -1;
+    int *p_limit_min = NULL;
+    int *p_limit_max = NULL;
+    int size_limit_min = 0;
+    int size_limit_max = 0;
 #ifdef SAVE_ERR_MSG
     char err[MAX_ERR_STRING_LEN];
 #endif
@@ -1331,6 +1917,21 @@ int syna_run_test_entry(int test_id, int *p_result, int size_result, int result_
         return -EINVAL;
     }
 
+    /* use the test limits in the limit store, if the limit is not given */
+    if ((!p_param_1 && (size_param_1 == 0)) || (!p_param_2 && (size_param_2 == 0))) {
+        if (syna_get_test_limit(test_id, &p_limit_min, &size_limit_min,
+                                &p_limit_max, &size_limit_max) == 0) {
+            if (!p_param_1 && (size_param_1 == 0) && p_limit_min) {
+                p_param_1 = p_limit_min;
+                size_param_1 = size_limit_min;
+            }
+            if (!p_param_2 && (size_param_2 == 0) && p_limit_max) {
+                p_param_2 = p_limit_max;
+                size_param_2 = size_limit_max;
+            }
+        }
+    }
+
     if (SYNA_RMI_DEV == g_syna_dev) {
         retval = syna_run_rmi_test_entry(test_id, p_result, size_result, result_col, result_row,
                                          p_param_1, size_param_1, p_param_2, size_param_2);
@@ -1349,6 +1950,7 @@ int syna_run_test_entry(int test_id, int *p_result, int size_result, int result_
  * run the extended high resistance test
  * this function is separated from syna_run_test_entry
  * because the required parameters are different
+ * if ref_frame is NULL, the reference frame is taken from the reference store
  *
  * return: =0, pass
  *         otherwise, fail
@@ -1371,6 +1973,23 @@ int syna_run_test_ex_high_resistance_entry(int *p_result, int size_result,
     char err[MAX_ERR_STRING_LEN];
 #endif
 
+    /* use the reference frame in the store, no copy is made */
+    if (!ref_frame) {
+        retval = syna_get_reference_frame((SYNA_RMI_DEV == g_syna_dev) ?
+                                          TEST_RMI_EX_HIGH_RESISTANCE_RT20 :
+                                          TEST_TCM_EX_HIGH_RESISTANCE_PID05,
+                                          SYNA_REF_KIND_REFERENCE, col, row, &ref_frame);
+        if (retval != col * row) {
+            printf_e("%s error: no reference frame in the store (%d)\n", __func__, retval);
+#ifdef SAVE_ERR_MSG
+            sprintf(err, "%s error: no reference frame in the store (%d)\n", __func__, retval);
+            add_error_msg(err);
+#endif
+            retval = -EINVAL;
+            goto exit;
+        }
+    }
+
     testing_data_size = tx * rx;
 
     testing_data_frame = calloc((size_t)testing_data_size, sizeof(short));
@@ -1582,6 +2201,433 @@ int syna_get_firmware_config(unsigned char* buf, int size_buf)
     }
     return retval;
 }
+/*
+ * Function:  syna_stream_tcm_flash_area
+ * --------------------
+ * helper to stream the flash area of tcm device
+ * the location is queried in application mode, then the area is read
+ * in bootloader mode, and the application firmware is resumed at the end
+ *
+ * return: <0, fail to read the flash area
+ *         otherwise, result of tcm_flash_stream_end()
+ */
+static int syna_stream_tcm_flash_area(int area, struct tcm_flash_stream *p_stream)
+{
+    int retval;
+    int ret;
+    unsigned short start_in_blocks = 0;
+    unsigned short length_in_blocks = 0;
+
+    retval = tcm_get_data_location((unsigned char)area, &start_in_blocks, &length_in_blocks);
+    if (retval < 0)
+        return retval;
+
+    retval = tcm_run_bootloader();
+    if (retval < 0)
+        return retval;
+
+    retval = tcm_get_boot_info();
+    if (retval >= 0) {
+        retval = tcm_stream_flash_data(start_in_blocks,
+                                       length_in_blocks * g_tcm_handler.boot_info_report.write_block_size_words *
+                                       (int)sizeof(short),
+                                       p_stream);
+    }
+
+    ret = tcm_run_application();
+    if (ret < 0) {
+        printf_e("%s error: fail to resume the application firmware\n", __func__);
+        if (retval >= 0)
+            retval = ret;
+    }
+
+    return retval;
+}
+/*
+ * Function:  syna_stream_firmware_config
+ * --------------------
+ * read back the config or flash area in chunks, and stream them into out_path
+ * while the crc32 is computed and the data is compared with the golden image.
+ * the golden image is mapped rather than loaded, so there is no whole-image buffer.
+ *
+ * parameter
+ *  area: one of enum SYNA_STREAM_AREA
+ *  out_path: file to save the data, could be NULL
+ *  golden_path: golden image to compare, could be NULL
+ *  stop_on_mismatch: stop the streaming at the first mismatch
+ *  p_info: result of streaming, indexed by enum SYNA_STREAM_INFO
+ *
+ * return: <0, fail to stream the area
+ *          1, mismatch is found
+ *          0, otherwise
+ */
+int syna_stream_firmware_config(int area, const char *out_path, const char *golden_path,
+                                bool stop_on_mismatch, int *p_info, int size_info)
+{
+    int retval = 0;
+    int fd_out = -1;
+    int fd_golden = -1;
+    unsigned char *p_golden = NULL;
+    int golden_bytes = 0;
+    int size;
+    struct stat st;
+    struct tcm_flash_stream stream;
+#ifdef SAVE_ERR_MSG
+    char err[MAX_ERR_STRING_LEN];
+#endif
+
+    if (SYNA_TCM_DEV != g_syna_dev) {
+        printf_e("%s error: streaming readback is supported on tcm device only\n", __func__);
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: streaming readback is supported on tcm device only\n", __func__);
+        add_error_msg(err);
+#endif
+        return -ENOSYS;
+    }
+
+    if ((area < STREAM_AREA_STATIC_CONFIG) || (area > STREAM_AREA_FORCE_CALIBRATION_DATA)) {
+        printf_e("%s error: invalid area, %d\n", __func__, area);
+        return -EINVAL;
+    }
+
+    if (out_path) {
+        fd_out = open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+        if (fd_out < 0) {
+            printf_e("%s error: fail to create %s (err: %s)\n", __func__, out_path, strerror(errno));
+#ifdef SAVE_ERR_MSG
+            sprintf(err, "%s error: fail to create %s\n", __func__, out_path);
+            add_error_msg(err);
+#endif
+            retval = -EIO;
+            goto exit;
+        }
+    }
+
+    if (golden_path) {
+        fd_golden = open(golden_path, O_RDONLY);
+        if ((fd_golden < 0) || (fstat(fd_golden, &st) < 0)) {
+            printf_e("%s error: fail to open %s (err: %s)\n", __func__, golden_path, strerror(errno));
+#ifdef SAVE_ERR_MSG
+            sprintf(err, "%s error: fail to open %s\n", __func__, golden_path);
+            add_error_msg(err);
+#endif
+            retval = -EIO;
+            goto exit;
+        }
+
+        golden_bytes = (int)st.st_size;
+        if (golden_bytes > 0) {
+            p_golden = mmap(NULL, (size_t)golden_bytes, PROT_READ, MAP_PRIVATE, fd_golden, 0);
+            if (p_golden == MAP_FAILED) {
+                printf_e("%s error: fail to map %s (err: %s)\n", __func__, golden_path, strerror(errno));
+                p_golden = NULL;
+                retval = -EIO;
+                goto exit;
+            }
+            madvise(p_golden, (size_t)golden_bytes, MADV_SEQUENTIAL);
+        }
+    }
+
+    tcm_flash_stream_init(&stream, fd_out, p_golden, golden_bytes, stop_on_mismatch);
+    /* an empty golden image is still compared */
+    if (golden_path && !p_golden)
+        stream.p_golden = (const unsigned char *)"";
+
+    if (STREAM_AREA_STATIC_CONFIG == area) {
+        /* static config is returned in one response, stream it from the handler */
+        retval = tcm_get_static_config();
+        if (retval < 0) {
+            printf_e("%s error: fail to get the static config\n", __func__);
+            goto exit;
+        }
+
+        size = syna_get_firmware_config_size();
+        size = MIN(MAX(size, 0), TCM_MAX_STATIC_CONFIG_SIZE);
+
+        retval = tcm_flash_stream_put(&stream, g_tcm_handler.static_config, size);
+        if (retval >= 0)
+            retval = tcm_flash_stream_end(&stream);
+    }
+    else {
+        retval = syna_stream_tcm_flash_area(area, &stream);
+    }
+
+    if ((retval >= 0) && p_info) {
+        if (size_info > STREAM_INFO_BYTES)
+            p_info[STREAM_INFO_BYTES] = stream.bytes;
+        if (size_info > STREAM_INFO_CRC32)
+            p_info[STREAM_INFO_CRC32] = (int)stream.crc32;
+        if (size_info > STREAM_INFO_MISMATCH_OFFSET)
+            p_info[STREAM_INFO_MISMATCH_OFFSET] = stream.mismatch_offset;
+        if (size_info > STREAM_INFO_MISMATCH_BYTES)
+            p_info[STREAM_INFO_MISMATCH_BYTES] = stream.mismatch_bytes;
+    }
+
+exit:
+    if (p_golden)
+        munmap(p_golden, (size_t)golden_bytes);
+    if (fd_golden >= 0)
+        close(fd_golden);
+    if (fd_out >= 0)
+        close(fd_out);
+
+    return retval;
+}
+/*
+ * Function:  syna_map_file
+ * --------------------
+ * helper to map the file as read-only
+ *
+ * return: pointer to the mapped file, NULL if failed
+ */
+static unsigned char* syna_map_file(const char *path, int *p_size)
+{
+    int fd;
+    struct stat st;
+    unsigned char *p_map;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf_e("%s error: fail to open file, %s (err: %s)\n", __func__, path, strerror(errno));
+        return NULL;
+    }
+
+    if ((fstat(fd, &st) < 0) || (st.st_size <= 0)) {
+        printf_e("%s error: invalid file, %s\n", __func__, path);
+        close(fd);
+        return NULL;
+    }
+
+    p_map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p_map == MAP_FAILED) {
+        printf_e("%s error: fail to map file, %s (err: %s)\n", __func__, path, strerror(errno));
+        return NULL;
+    }
+
+    *p_size = (int)st.st_size;
+    return p_map;
+}
+/*
+ * Function:  syna_program_firmware_area
+ * --------------------
+ * program the image into the flash area of tcm device
+ * the location is queried in application mode, then the area is erased,
+ * written and verified in bootloader mode, and the application firmware
+ * is resumed at the end.
+ *
+ * parameter
+ *  area: one of the flash areas in enum tcm_data_area
+ *  p_image: image to program, no larger than the area
+ *  image_bytes: size of the image
+ *  is_4byte_format: format of CMD_ERASE_FLASH
+ *  p_info: result of programming, indexed by enum SYNA_PROGRAM_INFO
+ *
+ * return: <0, fail to program the area
+ *         otherwise, succeed
+ */
+int syna_program_firmware_area(int area, unsigned char *p_image, int image_bytes,
+                               bool is_4byte_format, int *p_info, int size_info)
+{
+    int retval;
+    int ret;
+    int area_bytes;
+    unsigned short start_in_blocks = 0;
+    unsigned short length_in_blocks = 0;
+    struct tcm_flash_stats stats;
+#ifdef SAVE_ERR_MSG
+    char err[MAX_ERR_STRING_LEN];
+#endif
+
+    memset(&stats, 0x00, sizeof(struct tcm_flash_stats));
+
+    if (SYNA_TCM_DEV != g_syna_dev) {
+        printf_e("%s error: flash programming is supported on tcm device only\n", __func__);
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: flash programming is supported on tcm device only\n", __func__);
+        add_error_msg(err);
+#endif
+        return -ENOSYS;
+    }
+
+    if ((area < TCM_LCM_DATA) || (area > TCM_FORCE_CALIBRATION_DATA) ||
+        (!p_image) || (image_bytes <= 0)) {
+        printf_e("%s error: invalid parameter, area = %d, image_bytes = %d\n",
+                 __func__, area, image_bytes);
+        return -EINVAL;
+    }
+
+    retval = tcm_get_data_location((unsigned char)area, &start_in_blocks, &length_in_blocks);
+    if (retval < 0)
+        return retval;
+
+    retval = tcm_run_bootloader();
+    if (retval < 0)
+        return retval;
+
+    retval = tcm_get_boot_info();
+    if (retval >= 0) {
+        area_bytes = length_in_blocks * g_tcm_handler.boot_info_report.write_block_size_words *
+                     (int)sizeof(short);
+        if (image_bytes > area_bytes) {
+            printf_e("%s error: image is larger than the area (%d > %d bytes)\n",
+                     __func__, image_bytes, area_bytes);
+#ifdef SAVE_ERR_MSG
+            sprintf(err, "%s error: image is larger than the area (%d > %d bytes)\n",
+                    __func__, image_bytes, area_bytes);
+            add_error_msg(err);
+#endif
+            retval = -EINVAL;
+        }
+        else {
+            retval = tcm_program_flash_data(start_in_blocks, p_image, image_bytes,
+                                            is_4byte_format, &stats);
+        }
+    }
+
+    ret = tcm_run_application();
+    if (ret < 0) {
+        printf_e("%s error: fail to resume the application firmware\n", __func__);
+        if (retval >= 0)
+            retval = ret;
+    }
+
+    if ((retval >= 0) && p_info) {
+        if (size_info > PROGRAM_INFO_BYTES)
+            p_info[PROGRAM_INFO_BYTES] = stats.bytes;
+        if (size_info > PROGRAM_INFO_CRC32)
+            p_info[PROGRAM_INFO_CRC32] = (int)stats.crc32;
+        if (size_info > PROGRAM_INFO_ERASE_TIME_US)
+            p_info[PROGRAM_INFO_ERASE_TIME_US] = stats.erase_time_us;
+        if (size_info > PROGRAM_INFO_WRITE_TIME_US)
+            p_info[PROGRAM_INFO_WRITE_TIME_US] = stats.write_time_us;
+        if (size_info > PROGRAM_INFO_VERIFY_TIME_US)
+            p_info[PROGRAM_INFO_VERIFY_TIME_US] = stats.verify_time_us;
+        if (size_info > PROGRAM_INFO_WRITE_KBPS)
+            p_info[PROGRAM_INFO_WRITE_KBPS] = stats.write_kbps;
+    }
+
+    return retval;
+}
+/*
+ * Function:  syna_diff_firmware_config
+ * --------------------
+ * compare the firmware config with the golden image, the differing ranges
+ * are reported as text, see syna_config_diff_report()
+ *
+ * parameter
+ *  config_path: config read back to file, or NULL to use the static config of device
+ *  golden_path: golden image, or the folder of golden images named as <config id>.bin
+ *  layout_path: layout file to map the ranges to field names, could be NULL
+ *  p_report: buffer of the report
+ *
+ * return: <0, fail to compare the config
+ *         otherwise, number of differing ranges, 0 if identical
+ */
+int syna_diff_firmware_config(const char *config_path, const char *golden_path,
+                              const char *layout_path, char *p_report, int size_report)
+{
+    int retval = 0;
+    unsigned char *p_config = NULL;
+    int config_bytes = 0;
+    bool is_config_mapped = false;
+    unsigned char *p_golden = NULL;
+    int golden_bytes = 0;
+    char golden_file[MAX_STRING_LEN];
+    char *p_config_id;
+    struct stat st;
+    struct syna_config_span spans[SYNA_CONFIG_MAX_SPANS];
+    int num_spans;
+    struct syna_config_field *p_fields = NULL;
+    int num_fields = 0;
+    long long start_us;
+#ifdef SAVE_ERR_MSG
+    char err[MAX_ERR_STRING_LEN];
+#endif
+
+    if ((!golden_path) || (!p_report) || (size_report <= 0)) {
+        printf_e("%s error: invalid parameter\n", __func__);
+        return -EINVAL;
+    }
+
+    /* look for the golden image of current config id */
+    if ((0 == stat(golden_path, &st)) && S_ISDIR(st.st_mode)) {
+        p_config_id = syna_get_config_id();
+        if (!p_config_id)
+            return -EINVAL;
+
+        snprintf(golden_file, sizeof(golden_file), "%s/%s.bin", golden_path, p_config_id);
+    }
+    else {
+        snprintf(golden_file, sizeof(golden_file), "%s", golden_path);
+    }
+
+    p_golden = syna_map_file(golden_file, &golden_bytes);
+    if (!p_golden) {
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: fail to load the golden image, %s\n", __func__, golden_file);
+        add_error_msg(err);
+#endif
+        return -EIO;
+    }
+
+    if (config_path) {
+        p_config = syna_map_file(config_path, &config_bytes);
+        if (!p_config) {
+            retval = -EIO;
+            goto exit;
+        }
+        is_config_mapped = true;
+    }
+    else if (SYNA_TCM_DEV == g_syna_dev) {
+        retval = tcm_get_static_config();
+        if (retval < 0) {
+            printf_e("%s error: fail to get the static config\n", __func__);
+            goto exit;
+        }
+        p_config = g_tcm_handler.static_config;
+        config_bytes = MIN(MAX(syna_get_firmware_config_size(), 0), TCM_MAX_STATIC_CONFIG_SIZE);
+    }
+    else {
+        printf_e("%s error: static config is supported on tcm device only\n", __func__);
+        retval = -ENOSYS;
+        goto exit;
+    }
+
+    if (layout_path) {
+        num_fields = syna_config_layout_load(layout_path, &p_fields);
+        if (num_fields < 0) {
+            retval = num_fields;
+            goto exit;
+        }
+    }
+
+    start_us = syna_get_time_ns() / 1000;
+
+    num_spans = syna_config_diff(p_config, config_bytes, p_golden, golden_bytes,
+                                 spans, SYNA_CONFIG_MAX_SPANS);
+    if (num_spans < 0) {
+        retval = num_spans;
+        goto exit;
+    }
+
+    syna_config_diff_report(spans, num_spans, p_fields, num_fields, p_report, size_report);
+
+    printf_i("%s info: %d bytes vs. %d bytes, %d ranges differ (%lld us)\n", __func__,
+             config_bytes, golden_bytes, num_spans,
+             (syna_get_time_ns() / 1000) - start_us);
+
+    retval = num_spans;
+
+exit:
+    if (p_fields)
+        free(p_fields);
+    if (is_config_mapped)
+        munmap(p_config, (size_t)config_bytes);
+    munmap(p_golden, (size_t)golden_bytes);
+
+    return retval;
+}
 
 
 /*
@@ -1710,6 +2756,71 @@ int syna_run_raw_command(unsigned char type, int cmd,
     }
 
 
+    return retval;
+}
+/*
+ * Function:  syna_run_raw_script
+ * --------------------
+ * execute the raw command script in one call, rather than one command
+ * per call as syna_run_raw_command(), see syna_raw_script.h for the format
+ *
+ * parameter
+ *  script_path: script file
+ *  stop_on_fail: stop at the first failure
+ *  p_report: report of the per-command timing
+ *  size_report: size of the report buffer
+ *
+ * return: <0, fail to execute the script
+ *         otherwise, number of failures
+ */
+int syna_run_raw_script(const char *script_path, bool stop_on_fail,
+                        char *p_report, int size_report)
+{
+    int retval = 0;
+    struct syna_script script;
+#ifdef SAVE_ERR_MSG
+    char err[MAX_ERR_STRING_LEN];
+#endif
+
+    if ((SYNA_RMI_DEV != g_syna_dev) && (SYNA_TCM_DEV != g_syna_dev)) {
+        printf_e("%s error: unknown device\n", __func__);
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: unknown device\n", __func__);
+        add_error_msg(err);
+#endif
+        return -EINVAL;
+    }
+
+    retval = syna_script_load(script_path, &script);
+    if (retval < 0) {
+        printf_e("%s error: fail to load script, %s\n", __func__, script_path);
+        return retval;
+    }
+
+    if (script.is_rmi != (SYNA_RMI_DEV == g_syna_dev)) {
+        printf_e("%s error: %s script doesn't match the device\n",
+                 __func__, (script.is_rmi)? "rmi" : "tcm");
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: %s script doesn't match the device\n",
+                __func__, (script.is_rmi)? "rmi" : "tcm");
+        add_error_msg(err);
+#endif
+        retval = -EINVAL;
+        goto exit;
+    }
+
+    retval = syna_script_run(&script, stop_on_fail);
+    if (retval < 0) {
+        printf_e("%s error: fail to run script, %s\n", __func__, script_path);
+        goto exit;
+    }
+
+    if (p_report)
+        syna_script_report(&script, p_report, size_report);
+
+exit:
+    syna_script_release(&script);
+
     return retval;
 }
 
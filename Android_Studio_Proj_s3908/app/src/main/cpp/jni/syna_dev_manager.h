@@ -92,6 +92,8 @@ static unsigned int cal_crc(unsigned short *config, int len)
     return (unsigned int)(sum2 << 16 | sum1);
 }
 
+/* helper function to get the monotonic time, in nano-seconds */
+long long syna_get_time_ns(void);
 
 /* basic functions to open/close synaptics device */
 bool syna_find_dev(char *dev_node);
@@ -99,9 +101,16 @@ bool syna_set_dev(const char *dev_node, bool is_rmi, bool is_tcm);
 int syna_open_dev(const char *dev_node);
 int syna_close_dev(const char *dev_node);
 
+/* helper functions to record and to replay the bus transactions */
+int syna_start_bus_trace(const char *trace_path);
+int syna_stop_bus_trace(void);
+int syna_start_bus_replay(const char *trace_path, int time_scale);
+int syna_stop_bus_replay(void);
+
 /* helper functions to perform the general control */
 int syna_do_identify(char *p_out);
 int syna_do_sw_reset(void);
+int syna_get_reset_latency(void);
 int syna_do_preparation(bool nosleep_en, bool rezero_en);
 
 /* helper functions to get the device information */
@@ -118,6 +127,39 @@ int syna_get_num_force_elecs(void);
 int syna_get_firmware_config_size(void);
 int syna_get_firmware_config(unsigned char* buf, int size_buf);
 
+/* area of the streaming readback, must be equivalent to STREAM_AREA_* in java */
+enum SYNA_STREAM_AREA {
+    STREAM_AREA_STATIC_CONFIG = 0,  /* static config of application firmware */
+    STREAM_AREA_LCM_DATA,           /* flash areas, same as enum tcm_data_area */
+    STREAM_AREA_OEM_DATA,
+    STREAM_AREA_PPDT_DATA,
+    STREAM_AREA_FORCE_CALIBRATION_DATA,
+};
+/* result of the streaming readback, must be equivalent to STREAM_INFO_* in java */
+enum SYNA_STREAM_INFO {
+    STREAM_INFO_BYTES = 0,
+    STREAM_INFO_CRC32,
+    STREAM_INFO_MISMATCH_OFFSET,
+    STREAM_INFO_MISMATCH_BYTES,
+    STREAM_INFO_SIZE
+};
+int syna_stream_firmware_config(int area, const char *out_path, const char *golden_path,
+                                bool stop_on_mismatch, int *p_info, int size_info);
+/* result of the flash programming, must be equivalent to PROGRAM_INFO_* in java */
+enum SYNA_PROGRAM_INFO {
+    PROGRAM_INFO_BYTES = 0,
+    PROGRAM_INFO_CRC32,
+    PROGRAM_INFO_ERASE_TIME_US,
+    PROGRAM_INFO_WRITE_TIME_US,
+    PROGRAM_INFO_VERIFY_TIME_US,
+    PROGRAM_INFO_WRITE_KBPS,
+    PROGRAM_INFO_SIZE
+};
+int syna_program_firmware_area(int area, unsigned char *p_image, int image_bytes,
+                               bool is_4byte_format, int *p_info, int size_info);
+int syna_diff_firmware_config(const char *config_path, const char *golden_path,
+                              const char *layout_path, char *p_report, int size_report);
+
 /* helper functions for report image logging */
 int syna_start_image_stream(unsigned char report_type, bool touch_en,
                             bool nosleep_en, bool rezero_en);
@@ -126,6 +168,13 @@ int syna_read_report_image_entry(unsigned char report_type, int *p_report_image,
                                  int image_col, int image_row, bool out_in_landscape);
 
 /* helper functions for production test */
+int syna_get_test_limit(int test_id, int **pp_limit_min, int *p_size_min,
+                        int **pp_limit_max, int *p_size_max);
+int syna_get_reference_frame(int test_id, int kind, int col, int row, short **pp_frame);
+int syna_update_reference_frame(int test_id, int kind, int col, int row,
+                                const int *p_frames, int num_frames);
+int syna_import_reference_frame(int test_id, int kind, int col, int row, const int *p_frame);
+bool syna_test_has_pins_result(int test_id);
 int syna_run_test_entry(int test_id, int *p_result, int size_result, int result_col, int result_row,
                         int *p_param_1, int size_param_1, int *p_param_2, int size_param_2);
 int syna_run_test_ex_high_resistance_entry(int *p_result, int size_result,
@@ -139,9 +188,26 @@ int syna_run_test_ex_trx_short_entry(int *p_result_data, int size_result_data,
                                      int *p_limit_1, int size_limit_1,
                                      int *p_limit_2, int size_limit_2);
 
+/* device state around the production tests, used by the test plan */
+enum SYNA_TEST_STATE {
+    TEST_STATE_DEFAULT = 0,     /* default settings, e.g. after the sw reset */
+    TEST_STATE_CBC_DISABLED,    /* cbc/cdm is disabled */
+    TEST_STATE_UNKNOWN,         /* settings are changed, sw reset is required */
+};
+
+/* helper functions to run the production tests as a plan */
+int syna_plan_test_order(const int *p_test_ids, int num_tests, int *p_order);
+void syna_plan_begin(void);
+void syna_plan_set_test(int test_id, int next_test_id);
+void syna_plan_end(void);
+int syna_do_test_disable_cbc_cdm(void);
+int syna_do_test_post_reset(void);
+
 /* helper functions to perform the raw command operation */
 int syna_run_raw_command(unsigned char type, int cmd,
                          unsigned char* in, int size_in, unsigned char* resp, int size_resp);
+int syna_run_raw_script(const char *script_path, bool stop_on_fail,
+                        char *p_report, int size_report);
 
 /* helper functions to get the touch response */
 int syna_query_touch_response_entry(int max_fingers_to_process);
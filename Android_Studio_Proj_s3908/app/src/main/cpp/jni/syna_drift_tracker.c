@@ -0,0 +1,647 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "syna_dev_manager.h"
+#include "syna_drift_tracker.h"
+
+#ifdef SAVE_ERR_MSG
+#include "err_msg_ctrl.h"
+#endif
+
+/*
+ * variables of the drift tracker
+ *
+ * each frame updates the exponentially weighted mean of every tixel at
+ * all time constants, the weight is derived from the actual frame
+ * interval, so the time constants hold even if the frame rate varies.
+ * the memory is allocated once at start, and the snapshots are kept in
+ * a ring, so the footprint is constant over the long run.
+ */
+struct drift_tracker {
+    bool is_running;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+
+    int col;
+    int row;
+    int num_tixels;
+    int num_tau;
+    double tau_ms[SYNA_DRIFT_MAX_TAU];
+    double *p_mean;             /* num_tau planes of num_tixels */
+    double *p_origin;
+    double *p_warmup;           /* sum of the warm-up frames, released after the warm-up */
+    int warmup_frames;
+    int warmup_count;
+
+    long long start_ns;
+    long long last_ns;
+    long long next_snapshot_ns;
+    int snapshot_interval_ms;
+    int frames;
+
+    /* drift event */
+    double threshold;
+    int event_tau;
+    bool is_event_armed;
+    bool is_event_pending;
+    int events;
+    int event_info[DRIFT_EVENT_INFO_SIZE];
+
+    /* snapshot ring */
+    int *p_snapshots;
+    int snapshot_size;
+    int head;
+    int count;
+
+    FILE *p_log;
+};
+static struct drift_tracker g_drift = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+};
+
+/*
+ * Function:  drift_wait
+ * --------------------
+ * wait for the signal of the tracker until the deadline
+ * the caller should hold the mutex
+ *
+ * return: false, the deadline is passed
+ */
+static bool drift_wait(long long deadline_ns)
+{
+    struct timespec ts;
+    long long remain_ns = deadline_ns - syna_get_time_ns();
+
+    if (remain_ns <= 0)
+        return false;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += (time_t)(remain_ns / 1000000000LL);
+    ts.tv_nsec += (long)(remain_ns % 1000000000LL);
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec += 1;
+        ts.tv_nsec -= 1000000000L;
+    }
+
+    pthread_cond_timedwait(&g_drift.cond, &g_drift.mutex, &ts);
+    return true;
+}
+/*
+ * Function:  drift_to_fixed
+ * --------------------
+ * helper function to convert the drift in counts to the fixed-point value
+ */
+static int drift_to_fixed(double drift)
+{
+    return (int)lround(drift * SYNA_DRIFT_SCALE);
+}
+/*
+ * Function:  drift_free_buffers
+ * --------------------
+ * release the buffers of the tracker
+ * the caller should hold the mutex
+ *
+ * return: n/a
+ */
+static void drift_free_buffers(void)
+{
+    struct drift_tracker *p = &g_drift;
+
+    free(p->p_mean);
+    free(p->p_origin);
+    free(p->p_warmup);
+    free(p->p_snapshots);
+
+    p->p_mean = NULL;
+    p->p_origin = NULL;
+    p->p_warmup = NULL;
+    p->p_snapshots = NULL;
+    p->head = 0;
+    p->count = 0;
+
+    if (p->p_log) {
+        fclose(p->p_log);
+        p->p_log = NULL;
+    }
+}
+/*
+ * Function:  drift_take_snapshot
+ * --------------------
+ * summarize the drift of every time constant into the snapshot ring,
+ * the oldest snapshot is overwritten if the ring is full.
+ * the snapshot is also appended to the log file, one line per snapshot.
+ * the caller should hold the mutex
+ *
+ * return: n/a
+ */
+static void drift_take_snapshot(long long now)
+{
+    struct drift_tracker *p = &g_drift;
+    int *p_snapshot;
+    int *p_stat;
+    double *p_mean;
+    double drift, min, max, peak;
+    double sum;
+    int peak_tixel;
+    int i, k;
+
+    if (p->count == SYNA_DRIFT_SNAPSHOT_DEPTH) {
+        p->head = (p->head + 1) % SYNA_DRIFT_SNAPSHOT_DEPTH;
+        p->count -= 1;
+    }
+    p_snapshot = p->p_snapshots +
+                 (size_t)((p->head + p->count) % SYNA_DRIFT_SNAPSHOT_DEPTH) * p->snapshot_size;
+    p->count += 1;
+
+    p_snapshot[DRIFT_SNAPSHOT_TIME_MS] = (int)((now - p->start_ns) / 1000000LL);
+    p_snapshot[DRIFT_SNAPSHOT_FRAMES] = p->frames;
+    p_snapshot[DRIFT_SNAPSHOT_EVENTS] = p->events;
+
+    if (p->p_log)
+        fprintf(p->p_log, "%d,%d,%d", p_snapshot[DRIFT_SNAPSHOT_TIME_MS], p->frames, p->events);
+
+    for (k = 0; k < p->num_tau; k++) {
+        p_mean = p->p_mean + (size_t)k * p->num_tixels;
+        p_stat = p_snapshot + DRIFT_SNAPSHOT_HEADER_SIZE + k * DRIFT_TAU_STAT_SIZE;
+
+        min = max = peak = p_mean[0] - p->p_origin[0];
+        peak_tixel = 0;
+        sum = 0;
+        for (i = 0; i < p->num_tixels; i++) {
+            drift = p_mean[i] - p->p_origin[i];
+            sum += drift;
+            if (drift < min)
+                min = drift;
+            if (drift > max)
+                max = drift;
+            if (fabs(drift) > fabs(peak)) {
+                peak = drift;
+                peak_tixel = i;
+            }
+        }
+
+        p_stat[DRIFT_TAU_MIN] = drift_to_fixed(min);
+        p_stat[DRIFT_TAU_MAX] = drift_to_fixed(max);
+        p_stat[DRIFT_TAU_MEAN] = drift_to_fixed(sum / p->num_tixels);
+        p_stat[DRIFT_TAU_PEAK_TIXEL] = peak_tixel;
+
+        if (p->p_log)
+            fprintf(p->p_log, ",%.2f,%.2f,%.2f,%d", min, max, sum / p->num_tixels, peak_tixel);
+    }
+
+    if (p->p_log) {
+        fprintf(p->p_log, "\n");
+        fflush(p->p_log);
+    }
+
+    pthread_cond_broadcast(&p->cond);
+}
+/*
+ * Function:  drift_check_event
+ * --------------------
+ * raise the event if the largest drift at the event time constant exceeds
+ * the threshold. the event is re-armed once the drift falls below 3/4 of
+ * the threshold, so a tixel staying around the threshold is reported once.
+ * the caller should hold the mutex
+ *
+ * return: n/a
+ */
+static void drift_check_event(long long now, double peak, int peak_tixel)
+{
+    struct drift_tracker *p = &g_drift;
+
+    if (p->is_event_armed && (fabs(peak) > p->threshold)) {
+        p->is_event_armed = false;
+        p->events += 1;
+
+        p->event_info[DRIFT_EVENT_TIME_MS] = (int)((now - p->start_ns) / 1000000LL);
+        p->event_info[DRIFT_EVENT_TAU_INDEX] = p->event_tau;
+        p->event_info[DRIFT_EVENT_TIXEL] = peak_tixel;
+        p->event_info[DRIFT_EVENT_DRIFT] = drift_to_fixed(peak);
+        p->event_info[DRIFT_EVENT_COUNT] = p->events;
+        p->is_event_pending = true;
+
+        printf_i("%s: drift of tixel %d is %.2f at tau %d ms\n", __func__,
+                 peak_tixel, peak, (int)p->tau_ms[p->event_tau]);
+
+        pthread_cond_broadcast(&p->cond);
+    }
+    else if (!p->is_event_armed && (fabs(peak) < p->threshold * 0.75)) {
+        p->is_event_armed = true;
+    }
+}
+/*
+ * Function:  syna_drift_feed
+ * --------------------
+ * feed one raw frame to the drift tracker, the frame could be larger than
+ * the image, e.g. with the hybrid data, only the image is tracked.
+ * the first warm-up frames are averaged to be the origin of drift.
+ *
+ * return: n/a
+ */
+void syna_drift_feed(const int *p_frame, int size)
+{
+    struct drift_tracker *p = &g_drift;
+    long long now;
+    double alpha[SYNA_DRIFT_MAX_TAU];
+    double dt_ms;
+    double x, drift;
+    double peak = 0;
+    int peak_tixel = 0;
+    double *p_mean;
+    double *p_event;
+    int i, k;
+
+    if ((!p_frame) || (size < p->num_tixels))
+        return;
+
+    pthread_mutex_lock(&p->mutex);
+
+    if (!p->is_running)
+        goto exit;
+
+    now = syna_get_time_ns();
+    p->frames += 1;
+
+    /* average the warm-up frames to be the origin */
+    if (p->warmup_count < p->warmup_frames) {
+        for (i = 0; i < p->num_tixels; i++)
+            p->p_warmup[i] += p_frame[i];
+
+        p->warmup_count += 1;
+        if (p->warmup_count == p->warmup_frames) {
+            for (i = 0; i < p->num_tixels; i++)
+                p->p_origin[i] = p->p_warmup[i] / p->warmup_frames;
+            for (k = 0; k < p->num_tau; k++)
+                memcpy(p->p_mean + (size_t)k * p->num_tixels, p->p_origin,
+                       (size_t)p->num_tixels * sizeof(double));
+
+            free(p->p_warmup);
+            p->p_warmup = NULL;
+
+            p->next_snapshot_ns = now + (long long)p->snapshot_interval_ms * 1000000LL;
+        }
+        p->last_ns = now;
+        goto exit;
+    }
+
+    /* weight of the new frame, 1 - exp(-dt / tau) */
+    /* the means are in double, as the weight at a long tau is too small for */
+    /* the float updates to accumulate; expm1 keeps the precision of the small weight */
+    dt_ms = (double)(now - p->last_ns) / 1000000.0;
+    p->last_ns = now;
+    for (k = 0; k < p->num_tau; k++)
+        alpha[k] = -expm1(-dt_ms / p->tau_ms[k]);
+
+    for (k = 0; k < p->num_tau; k++) {
+        p_mean = p->p_mean + (size_t)k * p->num_tixels;
+        for (i = 0; i < p->num_tixels; i++) {
+            x = (double)p_frame[i];
+            p_mean[i] += alpha[k] * (x - p_mean[i]);
+        }
+    }
+
+    /* the largest drift at the event time constant */
+    if (p->threshold > 0) {
+        p_event = p->p_mean + (size_t)p->event_tau * p->num_tixels;
+        for (i = 0; i < p->num_tixels; i++) {
+            drift = p_event[i] - p->p_origin[i];
+            if (fabs(drift) > fabs(peak)) {
+                peak = drift;
+                peak_tixel = i;
+            }
+        }
+        drift_check_event(now, peak, peak_tixel);
+    }
+
+    if (now >= p->next_snapshot_ns) {
+        drift_take_snapshot(now);
+
+        p->next_snapshot_ns += (long long)p->snapshot_interval_ms * 1000000LL;
+        if (p->next_snapshot_ns <= now)
+            p->next_snapshot_ns = now + (long long)p->snapshot_interval_ms * 1000000LL;
+    }
+
+exit:
+    pthread_mutex_unlock(&p->mutex);
+}
+/*
+ * Function:  syna_drift_start
+ * --------------------
+ * start to track the baseline drift, the frames are fed by syna_drift_feed
+ *   p_tau_ms             : time constants of the weighted means, up to SYNA_DRIFT_MAX_TAU
+ *   warmup_frames        : number of frames averaged to be the origin of drift
+ *   snapshot_interval_ms : period to take the drift snapshot
+ *   threshold            : drift in counts to raise the event, 0 to disable the event
+ *   event_tau_index      : time constant being checked for the event
+ *   log_path             : file to append the snapshots, could be NULL
+ *
+ * return: <0, fail to start the tracker
+ *         otherwise, succeed
+ */
+int syna_drift_start(int col, int row, const int *p_tau_ms, int num_tau, int warmup_frames,
+                     int snapshot_interval_ms, int threshold, int event_tau_index,
+                     const char *log_path)
+{
+    struct drift_tracker *p = &g_drift;
+    int retval = 0;
+    int k;
+#ifdef SAVE_ERR_MSG
+    char err[MAX_ERR_STRING_LEN];
+#endif
+
+    if ((col <= 0) || (row <= 0) || (!p_tau_ms) || (num_tau <= 0) ||
+        (num_tau > SYNA_DRIFT_MAX_TAU) || (warmup_frames <= 0) || (snapshot_interval_ms <= 0) ||
+        (threshold < 0) || (event_tau_index < 0) || (event_tau_index >= num_tau)) {
+        printf_e("%s error: invalid parameter\n", __func__);
+        return -EINVAL;
+    }
+    for (k = 0; k < num_tau; k++) {
+        if (p_tau_ms[k] <= 0) {
+            printf_e("%s error: invalid time constant (%d ms)\n", __func__, p_tau_ms[k]);
+            return -EINVAL;
+        }
+    }
+
+    pthread_mutex_lock(&p->mutex);
+
+    if (p->is_running) {
+        printf_e("%s error: drift tracker is running\n", __func__);
+        retval = -EBUSY;
+        goto exit;
+    }
+
+    p->col = col;
+    p->row = row;
+    p->num_tixels = col * row;
+    p->num_tau = num_tau;
+    for (k = 0; k < num_tau; k++)
+        p->tau_ms[k] = (double)p_tau_ms[k];
+    p->warmup_frames = warmup_frames;
+    p->warmup_count = 0;
+    p->snapshot_interval_ms = snapshot_interval_ms;
+    p->snapshot_size = SYNA_DRIFT_SNAPSHOT_SIZE(num_tau);
+    p->frames = 0;
+    p->threshold = (double)threshold;
+    p->event_tau = event_tau_index;
+    p->is_event_armed = true;
+    p->is_event_pending = false;
+    p->events = 0;
+    p->head = 0;
+    p->count = 0;
+
+    p->p_mean = calloc((size_t)num_tau * p->num_tixels, sizeof(double));
+    p->p_origin = calloc((size_t)p->num_tixels, sizeof(double));
+    p->p_warmup = calloc((size_t)p->num_tixels, sizeof(double));
+    p->p_snapshots = calloc((size_t)SYNA_DRIFT_SNAPSHOT_DEPTH * p->snapshot_size, sizeof(int));
+    if ((!p->p_mean) || (!p->p_origin) || (!p->p_warmup) || (!p->p_snapshots)) {
+        printf_e("%s error: can't allocate memory for the tracker\n", __func__);
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: can't allocate memory for the tracker\n", __func__);
+        add_error_msg(err);
+#endif
+        retval = -ENOMEM;
+        goto exit;
+    }
+
+    if (log_path) {
+        p->p_log = fopen(log_path, "a");
+        if (!p->p_log) {
+            printf_e("%s error: fail to open file, %s (err: %s)\n", __func__, log_path, strerror(errno));
+#ifdef SAVE_ERR_MSG
+            sprintf(err, "%s error: fail to open file, %s (err: %s)\n", __func__, log_path, strerror(errno));
+            add_error_msg(err);
+#endif
+            retval = -EIO;
+            goto exit;
+        }
+
+        fprintf(p->p_log, "# drift snapshot, (col, row) = (%d, %d), warm-up = %d frames\n",
+                col, row, warmup_frames);
+        fprintf(p->p_log, "time_ms,frames,events");
+        for (k = 0; k < num_tau; k++)
+            fprintf(p->p_log, ",min_%d,max_%d,mean_%d,peak_%d",
+                    p_tau_ms[k], p_tau_ms[k], p_tau_ms[k], p_tau_ms[k]);
+        fprintf(p->p_log, "\n");
+        fflush(p->p_log);
+    }
+
+    p->start_ns = syna_get_time_ns();
+    p->last_ns = p->start_ns;
+    p->is_running = true;
+
+    printf_i("%s: (col, row) = (%d, %d), %d time constants, snapshot every %d ms\n", __func__,
+             col, row, num_tau, snapshot_interval_ms);
+
+exit:
+    if (retval < 0)
+        drift_free_buffers();
+
+    pthread_mutex_unlock(&p->mutex);
+
+    return retval;
+}
+/*
+ * Function:  syna_drift_stop
+ * --------------------
+ * stop the drift tracker, the snapshots not read yet are dropped
+ *
+ * return: <0, the tracker is not running
+ *         otherwise, the number of frames fed
+ */
+int syna_drift_stop(void)
+{
+    struct drift_tracker *p = &g_drift;
+    int retval;
+
+    pthread_mutex_lock(&p->mutex);
+
+    if (!p->is_running) {
+        retval = -ENODEV;
+        goto exit;
+    }
+
+    p->is_running = false;
+    retval = p->frames;
+
+    drift_free_buffers();
+    pthread_cond_broadcast(&p->cond);
+
+    printf_i("%s: %d frames, %d events\n", __func__, p->frames, p->events);
+
+exit:
+    pthread_mutex_unlock(&p->mutex);
+
+    return retval;
+}
+/*
+ * Function:  syna_drift_is_running
+ * --------------------
+ * return: true, the drift tracker is running
+ */
+bool syna_drift_is_running(void)
+{
+    return g_drift.is_running;
+}
+/*
+ * Function:  syna_drift_read_snapshot
+ * --------------------
+ * take the oldest drift snapshot, wait for up to timeout_ms if no snapshot
+ * is available. the size of snapshot is SYNA_DRIFT_SNAPSHOT_SIZE(num_tau).
+ *
+ * return: -ETIMEDOUT, no snapshot is available in time
+ *         -ENODATA, the tracker is stopped
+ *         otherwise, the number of data copied
+ */
+int syna_drift_read_snapshot(int *p_snapshot, int size, int timeout_ms)
+{
+    struct drift_tracker *p = &g_drift;
+    long long deadline = syna_get_time_ns() + (long long)timeout_ms * 1000000LL;
+    int retval;
+
+    if ((!p_snapshot) || (size <= 0))
+        return -EINVAL;
+
+    pthread_mutex_lock(&p->mutex);
+
+    while (p->count == 0) {
+        if (!p->is_running) {
+            retval = -ENODATA;
+            goto exit;
+        }
+        if (!drift_wait(deadline)) {
+            retval = -ETIMEDOUT;
+            goto exit;
+        }
+    }
+
+    retval = MIN(size, p->snapshot_size);
+    memcpy(p_snapshot, p->p_snapshots + (size_t)p->head * p->snapshot_size,
+           (size_t)retval * sizeof(int));
+    p->head = (p->head + 1) % SYNA_DRIFT_SNAPSHOT_DEPTH;
+    p->count -= 1;
+
+exit:
+    pthread_mutex_unlock(&p->mutex);
+
+    return retval;
+}
+/*
+ * Function:  syna_drift_wait_event
+ * --------------------
+ * wait for up to timeout_ms for the drift event, see enum SYNA_DRIFT_EVENT
+ * only the latest event is kept if the events are not taken in time.
+ *
+ * return: -ETIMEDOUT, no event in time
+ *         -ENODATA, the tracker is stopped
+ *         otherwise, the number of data copied
+ */
+int syna_drift_wait_event(int *p_info, int size, int timeout_ms)
+{
+    struct drift_tracker *p = &g_drift;
+    long long deadline = syna_get_time_ns() + (long long)timeout_ms * 1000000LL;
+    int retval;
+
+    if ((!p_info) || (size <= 0))
+        return -EINVAL;
+
+    pthread_mutex_lock(&p->mutex);
+
+    while (!p->is_event_pending) {
+        if (!p->is_running) {
+            retval = -ENODATA;
+            goto exit;
+        }
+        if (!drift_wait(deadline)) {
+            retval = -ETIMEDOUT;
+            goto exit;
+        }
+    }
+
+    retval = MIN(size, DRIFT_EVENT_INFO_SIZE);
+    memcpy(p_info, p->event_info, (size_t)retval * sizeof(int));
+    p->is_event_pending = false;
+
+exit:
+    pthread_mutex_unlock(&p->mutex);
+
+    return retval;
+}
+/*
+ * Function:  syna_drift_get_frame
+ * --------------------
+ * copy the current drift of every tixel at the time constant,
+ * in fixed-point, see SYNA_DRIFT_SCALE
+ *
+ * return: -EAGAIN, the warm-up is not completed
+ *         <0, the tracker is not running or invalid parameter
+ *         otherwise, the number of data copied
+ */
+int syna_drift_get_frame(int tau_index, int *p_drift, int size)
+{
+    struct drift_tracker *p = &g_drift;
+    double *p_mean;
+    int retval;
+    int i;
+
+    if ((!p_drift) || (size <= 0))
+        return -EINVAL;
+
+    pthread_mutex_lock(&p->mutex);
+
+    if (!p->is_running) {
+        retval = -ENODEV;
+        goto exit;
+    }
+    if ((tau_index < 0) || (tau_index >= p->num_tau)) {
+        retval = -EINVAL;
+        goto exit;
+    }
+    if (p->warmup_count < p->warmup_frames) {
+        retval = -EAGAIN;
+        goto exit;
+    }
+
+    retval = MIN(size, p->num_tixels);
+    p_mean = p->p_mean + (size_t)tau_index * p->num_tixels;
+    for (i = 0; i < retval; i++)
+        p_drift[i] = drift_to_fixed(p_mean[i] - p->p_origin[i]);
+
+exit:
+    pthread_mutex_unlock(&p->mutex);
+
+    return retval;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+#include <stdbool.h>
+
+#ifndef _SYNA_DRIFT_TRACKER_H__
+#define _SYNA_DRIFT_TRACKER_H__
+
+/* max. number of time constants being tracked */
+#define SYNA_DRIFT_MAX_TAU          (4)
+
+/* number of snapshots kept for the reader */
+#define SYNA_DRIFT_SNAPSHOT_DEPTH   (64)
+
+/* drift values are reported in fixed-point, 1/16 of a count */
+#define SYNA_DRIFT_SCALE            (16)
+
+/*
+ * layout of one drift snapshot
+ * must be equivalent to the same id in java layer
+ *
+ *  [DRIFT_SNAPSHOT_HEADER_SIZE header data]
+ *  [DRIFT_TAU_STAT_SIZE data] ... for each time constant
+ *
+ * drift is the difference between the exponentially weighted mean
+ * and the origin, which is the mean of the warm-up frames
+ */
+enum SYNA_DRIFT_SNAPSHOT {
+    DRIFT_SNAPSHOT_TIME_MS = 0,     /* time since the tracker is started */
+    DRIFT_SNAPSHOT_FRAMES,          /* frames fed since the tracker is started */
+    DRIFT_SNAPSHOT_EVENTS,          /* events raised since the tracker is started */
+    DRIFT_SNAPSHOT_HEADER_SIZE,
+};
+enum SYNA_DRIFT_TAU_STAT {
+    DRIFT_TAU_MIN = 0,              /* min. drift of all tixels */
+    DRIFT_TAU_MAX,                  /* max. drift of all tixels */
+    DRIFT_TAU_MEAN,                 /* mean drift of all tixels */
+    DRIFT_TAU_PEAK_TIXEL,           /* index of the tixel with the largest absolute drift */
+    DRIFT_TAU_STAT_SIZE,
+};
+#define SYNA_DRIFT_SNAPSHOT_SIZE(num_tau) \
+    (DRIFT_SNAPSHOT_HEADER_SIZE + (num_tau) * DRIFT_TAU_STAT_SIZE)
+
+/*
+ * information of the drift event
+ * must be equivalent to the same id in java layer
+ */
+enum SYNA_DRIFT_EVENT {
+    DRIFT_EVENT_TIME_MS = 0,        /* time since the tracker is started */
+    DRIFT_EVENT_TAU_INDEX,          /* time constant exceeding the threshold */
+    DRIFT_EVENT_TIXEL,              /* index of tixel exceeding the threshold */
+    DRIFT_EVENT_DRIFT,              /* drift of the tixel */
+    DRIFT_EVENT_COUNT,              /* events raised since the tracker is started */
+    DRIFT_EVENT_INFO_SIZE,
+};
+
+/* helper to track the baseline drift of the raw report images */
+int syna_drift_start(int col, int row, const int *p_tau_ms, int num_tau, int warmup_frames,
+                     int snapshot_interval_ms, int threshold, int event_tau_index,
+                     const char *log_path);
+int syna_drift_stop(void);
+bool syna_drift_is_running(void);
+void syna_drift_feed(const int *p_frame, int size);
+
+/* helper for the consumers of the drift tracker */
+int syna_drift_read_snapshot(int *p_snapshot, int size, int timeout_ms);
+int syna_drift_wait_event(int *p_info, int size, int timeout_ms);
+int syna_drift_get_frame(int tau_index, int *p_drift, int size);
+
+#endif // _SYNA_DRIFT_TRACKER_H__
@@ -0,0 +1,442 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "syna_dev_manager.h"
+#include "syna_capture_file.h"
+#include "syna_frame_codec.h"
+
+#ifdef SAVE_ERR_MSG
+#include "err_msg_ctrl.h"
+#endif
+
+/* zigzag mapping, small magnitude of residual becomes small unsigned value */
+#define CODEC_ZIGZAG(r)   ((unsigned int)(((r) << 1) ^ ((r) >> 31)))
+#define CODEC_UNZIGZAG(z) ((int)((z) >> 1) ^ -(int)((z) & 1))
+
+/*
+ * Function:  codec_put_varint
+ * --------------------
+ * helper function to write an unsigned value as varint, 7 bits per byte
+ */
+static inline unsigned char *codec_put_varint(unsigned char *p, unsigned int value)
+{
+    while (value >= 0x80) {
+        *p++ = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    *p++ = (unsigned char)value;
+    return p;
+}
+/*
+ * Function:  codec_get_varint
+ * --------------------
+ * helper function to read a varint
+ *
+ * return: NULL, if the data is incomplete
+ *         otherwise, the position after the varint
+ */
+static inline const unsigned char *codec_get_varint(const unsigned char *p, const unsigned char *p_end,
+                                                    unsigned int *p_value)
+{
+    unsigned int value = 0;
+    int shift = 0;
+
+    while (p < p_end) {
+        value |= (unsigned int)(*p & 0x7f) << shift;
+        if (!(*p++ & 0x80)) {
+            *p_value = value;
+            return p;
+        }
+        shift += 7;
+        if (shift > 28)
+            break;
+    }
+    return NULL;
+}
+/*
+ * Function:  syna_codec_init
+ * --------------------
+ * initialize the codec context
+ * keyframe_interval is 0 to encode the keyframe only at the first frame
+ *
+ * return: <0, fail to initialize
+ *         otherwise, succeed
+ */
+int syna_codec_init(struct syna_frame_codec *p_codec, int num, bool use_rle, int keyframe_interval)
+{
+    if (!p_codec || (num <= 0)) {
+        printf_e("%s error: invalid parameter (num = %d)\n", __func__, num);
+        return -EINVAL;
+    }
+
+    memset(p_codec, 0x00, sizeof(struct syna_frame_codec));
+
+    p_codec->p_prev = calloc((size_t)num, sizeof(short));
+    if (!p_codec->p_prev) {
+        printf_e("%s error: fail to allocate the buffer (num = %d)\n", __func__, num);
+        return -ENOMEM;
+    }
+
+    p_codec->num = num;
+    p_codec->use_rle = use_rle;
+    p_codec->keyframe_interval = keyframe_interval;
+
+    return 0;
+}
+/*
+ * Function:  syna_codec_release
+ * --------------------
+ * release the codec context
+ */
+void syna_codec_release(struct syna_frame_codec *p_codec)
+{
+    if (!p_codec)
+        return;
+
+    free(p_codec->p_prev);
+    memset(p_codec, 0x00, sizeof(struct syna_frame_codec));
+}
+/*
+ * Function:  syna_codec_reset
+ * --------------------
+ * drop the previous frame, the next frame will be a keyframe
+ */
+void syna_codec_reset(struct syna_frame_codec *p_codec)
+{
+    if (!p_codec)
+        return;
+
+    p_codec->has_prev = false;
+    p_codec->frame_cnt = 0;
+}
+/*
+ * Function:  syna_codec_max_encoded_size
+ * --------------------
+ * return the size of buffer which is enough for one encoded frame
+ * one flag byte, and up to 3 bytes varint per tixel
+ */
+int syna_codec_max_encoded_size(int num)
+{
+    return 1 + 3 * num;
+}
+/*
+ * Function:  syna_codec_encode
+ * --------------------
+ * encode one frame
+ *
+ * return: <0, fail to encode
+ *         otherwise, the size of encoded data
+ */
+int syna_codec_encode(struct syna_frame_codec *p_codec, const short *p_frame,
+                      unsigned char *p_out, int size_out)
+{
+    int i;
+    int num;
+    int residual;
+    int zero_run = 0;
+    bool is_keyframe;
+    unsigned char *p;
+    const short *p_prev;
+
+    if (!p_codec || !p_codec->p_prev || !p_frame || !p_out) {
+        printf_e("%s error: invalid parameter\n", __func__);
+        return -EINVAL;
+    }
+
+    num = p_codec->num;
+    if (size_out < syna_codec_max_encoded_size(num)) {
+        printf_e("%s error: output buffer is too small (%d)\n", __func__, size_out);
+        return -EINVAL;
+    }
+
+    is_keyframe = (!p_codec->has_prev) ||
+                  ((p_codec->keyframe_interval > 0) &&
+                   (p_codec->frame_cnt % p_codec->keyframe_interval == 0));
+
+    p = p_out;
+    *p++ = (unsigned char)((is_keyframe ? CODEC_FLAG_KEYFRAME : 0) |
+                           (p_codec->use_rle ? CODEC_FLAG_RLE : 0));
+
+    p_prev = p_codec->p_prev;
+
+    for (i = 0; i < num; i++) {
+        /* 16-bit wrap-around keeps the residual in short */
+        if (is_keyframe)
+            residual = p_frame[i];
+        else
+            residual = (short)(p_frame[i] - p_prev[i]);
+
+        if (p_codec->use_rle && (residual == 0)) {
+            zero_run++;
+            continue;
+        }
+        if (zero_run > 0) {
+            p = codec_put_varint(p, ((unsigned int)(zero_run - 1) << 1) | 1);
+            zero_run = 0;
+        }
+        p = codec_put_varint(p, CODEC_ZIGZAG(residual) << 1);
+    }
+    if (zero_run > 0)
+        p = codec_put_varint(p, ((unsigned int)(zero_run - 1) << 1) | 1);
+
+    memcpy(p_codec->p_prev, p_frame, sizeof(short) * num);
+    p_codec->has_prev = true;
+    p_codec->frame_cnt++;
+
+    return (int)(p - p_out);
+}
+/*
+ * Function:  syna_codec_decode
+ * --------------------
+ * decode one frame, the frames must be decoded in the order of encoding
+ * starting from a keyframe
+ *
+ * return: <0, fail to decode
+ *         otherwise, the size of data consumed
+ */
+int syna_codec_decode(struct syna_frame_codec *p_codec, const unsigned char *p_in, int size_in,
+                      short *p_frame)
+{
+    int i = 0;
+    int num;
+    int run;
+    bool is_keyframe;
+    unsigned int token;
+    const unsigned char *p;
+    const unsigned char *p_end;
+    const short *p_prev;
+
+    if (!p_codec || !p_codec->p_prev || !p_in || !p_frame || (size_in < 1)) {
+        printf_e("%s error: invalid parameter\n", __func__);
+        return -EINVAL;
+    }
+
+    num = p_codec->num;
+    p = p_in;
+    p_end = p_in + size_in;
+
+    is_keyframe = (*p++ & CODEC_FLAG_KEYFRAME) != 0;
+    if (!is_keyframe && !p_codec->has_prev) {
+        printf_e("%s error: no previous frame to predict\n", __func__);
+        return -EINVAL;
+    }
+
+    p_prev = p_codec->p_prev;
+
+    while (i < num) {
+        p = codec_get_varint(p, p_end, &token);
+        if (!p) {
+            printf_e("%s error: incomplete data at tixel %d\n", __func__, i);
+            return -EINVAL;
+        }
+
+        if (token & 1) {
+            run = (int)(token >> 1) + 1;
+            if (i + run > num) {
+                printf_e("%s error: invalid zero run %d at tixel %d\n", __func__, run, i);
+                return -EINVAL;
+            }
+            if (is_keyframe)
+                memset(&p_frame[i], 0x00, sizeof(short) * run);
+            else
+                memcpy(&p_frame[i], &p_prev[i], sizeof(short) * run);
+            i += run;
+        }
+        else {
+            if (is_keyframe)
+                p_frame[i] = (short)CODEC_UNZIGZAG(token >> 1);
+            else
+                p_frame[i] = (short)(p_prev[i] + CODEC_UNZIGZAG(token >> 1));
+            i++;
+        }
+    }
+
+    memcpy(p_codec->p_prev, p_frame, sizeof(short) * num);
+    p_codec->has_prev = true;
+    p_codec->frame_cnt++;
+
+    return (int)(p - p_in);
+}
+/*
+ * Function:  syna_codec_benchmark
+ * --------------------
+ * encode and decode all frames of one stream in the capture file,
+ * with and without rle. the decoded frames are compared with the source.
+ * compression ratio and throughput (MB/s of raw data) are written
+ * to the report string
+ *
+ * return: <0, fail to run the benchmark or data mismatch
+ *         otherwise, succeed
+ */
+int syna_codec_benchmark(const char *capture_path, int stream, char *p_report, int size_report)
+{
+    int retval = 0;
+    int pass;
+    int n;
+    int count;
+    int size;
+    int num;
+    int len = 0;
+    int enc_size;
+    struct syna_capture_reader reader;
+    struct syna_frame_codec encoder;
+    struct syna_frame_codec decoder;
+    const unsigned char *p_data;
+    unsigned char *p_enc = NULL;
+    short *p_dec = NULL;
+    long long t_start;
+    long long t_enc;
+    long long t_dec;
+    long long total_raw;
+    long long total_enc;
+#ifdef SAVE_ERR_MSG
+    char err[MAX_ERR_STRING_LEN];
+#endif
+
+    if (!capture_path || !p_report || (size_report <= 0)) {
+        printf_e("%s error: invalid parameter\n", __func__);
+        return -EINVAL;
+    }
+    p_report[0] = '\0';
+
+    retval = syna_capture_reader_open(capture_path, &reader);
+    if (retval < 0)
+        return retval;
+
+    count = syna_capture_get_count(&reader, stream);
+    if (count <= 0) {
+        printf_e("%s error: no record in stream %d\n", __func__, stream);
+        retval = -EINVAL;
+        goto exit;
+    }
+
+    size = syna_capture_get_record(&reader, stream, 0, &p_data, NULL);
+    num = size / (int)sizeof(short);
+    if (num <= 0) {
+        printf_e("%s error: invalid frame size %d\n", __func__, size);
+        retval = -EINVAL;
+        goto exit;
+    }
+
+    p_enc = malloc((size_t)syna_codec_max_encoded_size(num));
+    p_dec = malloc(sizeof(short) * num);
+    if (!p_enc || !p_dec) {
+        printf_e("%s error: fail to allocate the buffer\n", __func__);
+        retval = -ENOMEM;
+        goto exit;
+    }
+
+    len += snprintf(p_report + len, size_report - len,
+                    "frames = %d, tixels = %d\n", count, num);
+
+    for (pass = 0; pass < 2; pass++) {
+
+        retval = syna_codec_init(&encoder, num, (pass == 1), CODEC_KEYFRAME_INTERVAL);
+        if (retval < 0)
+            goto exit;
+        retval = syna_codec_init(&decoder, num, (pass == 1), CODEC_KEYFRAME_INTERVAL);
+        if (retval < 0) {
+            syna_codec_release(&encoder);
+            goto exit;
+        }
+
+        t_enc = 0;
+        t_dec = 0;
+        total_raw = 0;
+        total_enc = 0;
+
+        for (n = 0; n < count; n++) {
+            size = syna_capture_get_record(&reader, stream, n, &p_data, NULL);
+            if (size != num * (int)sizeof(short)) {
+                printf_e("%s error: frame %d size mismatch (%d)\n", __func__, n, size);
+                retval = -EINVAL;
+                break;
+            }
+
+            t_start = syna_get_time_ns();
+            enc_size = syna_codec_encode(&encoder, (const short *)p_data, p_enc,
+                                         syna_codec_max_encoded_size(num));
+            t_enc += syna_get_time_ns() - t_start;
+            if (enc_size < 0) {
+                retval = enc_size;
+                break;
+            }
+
+            t_start = syna_get_time_ns();
+            retval = syna_codec_decode(&decoder, p_enc, enc_size, p_dec);
+            t_dec += syna_get_time_ns() - t_start;
+            if (retval < 0)
+                break;
+
+            if (memcmp(p_dec, p_data, (size_t)size) != 0) {
+                printf_e("%s error: decoded frame %d is mismatched\n", __func__, n);
+#ifdef SAVE_ERR_MSG
+                sprintf(err, "%s error: decoded frame %d is mismatched\n", __func__, n);
+                add_error_msg(err);
+#endif
+                retval = -EIO;
+                break;
+            }
+
+            total_raw += size;
+            total_enc += enc_size;
+        }
+
+        syna_codec_release(&encoder);
+        syna_codec_release(&decoder);
+
+        if (retval < 0)
+            goto exit;
+
+        len += snprintf(p_report + len, size_report - len,
+                        "[%s] raw = %lld bytes, encoded = %lld bytes, ratio = %.2f, "
+                        "encode = %.1f MB/s, decode = %.1f MB/s\n",
+                        (pass == 1) ? "varint + rle" : "varint",
+                        total_raw, total_enc,
+                        (total_enc > 0) ? (double)total_raw / total_enc : 0.0,
+                        (t_enc > 0) ? ((double)total_raw / 1048576) / ((double)t_enc / 1000000000) : 0.0,
+                        (t_dec > 0) ? ((double)total_raw / 1048576) / ((double)t_dec / 1000000000) : 0.0);
+        if (len >= size_report)
+            len = size_report - 1;
+    }
+
+    printf_i("%s: %s", __func__, p_report);
+    retval = 0;
+
+exit:
+    free(p_enc);
+    free(p_dec);
+    syna_capture_reader_close(&reader);
+
+    return retval;
+}
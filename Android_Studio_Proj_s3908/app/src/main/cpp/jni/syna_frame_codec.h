@@ -0,0 +1,69 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+#include <stdbool.h>
+
+#ifndef _SYNA_FRAME_CODEC_H__
+#define _SYNA_FRAME_CODEC_H__
+
+/* flags in the first byte of encoded frame */
+#define CODEC_FLAG_KEYFRAME     (0x01)  /* residual is the frame itself */
+#define CODEC_FLAG_RLE          (0x02)  /* runs of zero residual are collapsed */
+
+/* default interval of keyframe, to limit the decoding from a random frame */
+#define CODEC_KEYFRAME_INTERVAL (64)
+
+/*
+ * context of the lossless frame codec
+ *
+ * each frame is predicted by the previous one, the residual is
+ * zigzag mapped and written as varint. if rle is enabled, a run of
+ * zero residual is written as one varint.
+ * encoder and decoder must use their own context.
+ */
+struct syna_frame_codec {
+    int num;                    /* number of tixels in one frame */
+    short *p_prev;
+    bool has_prev;
+    bool use_rle;
+    int keyframe_interval;
+    int frame_cnt;
+};
+
+int syna_codec_init(struct syna_frame_codec *p_codec, int num, bool use_rle, int keyframe_interval);
+void syna_codec_release(struct syna_frame_codec *p_codec);
+void syna_codec_reset(struct syna_frame_codec *p_codec);
+int syna_codec_max_encoded_size(int num);
+int syna_codec_encode(struct syna_frame_codec *p_codec, const short *p_frame,
+                      unsigned char *p_out, int size_out);
+int syna_codec_decode(struct syna_frame_codec *p_codec, const unsigned char *p_in, int size_in,
+                      short *p_frame);
+
+/* benchmark with the frames in a capture file */
+int syna_codec_benchmark(const char *capture_path, int stream, char *p_report, int size_report);
+
+#endif // _SYNA_FRAME_CODEC_H__
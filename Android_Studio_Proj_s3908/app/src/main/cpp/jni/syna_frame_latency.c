@@ -0,0 +1,327 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "syna_dev_manager.h"
+#include "syna_frame_latency.h"
+
+/* variables of the frame latency tracing */
+struct frame_latency {
+    /* time stamps of the frame in progress, in nano-seconds */
+    bool is_open;
+    unsigned int marked;               /* bit mask of the marked stamps */
+    long long stamps[FRAME_STAMP_NUM];
+    long long last_request;
+
+    /* latency of the latest frames, in micro-seconds */
+    int count;                         /* number of frames in the history */
+    int next;                          /* next slot to fill */
+    unsigned int history[FRAME_LATENCY_NUM][SYNA_FRAME_LATENCY_HISTORY];
+
+    pthread_mutex_t mutex;
+};
+static struct frame_latency g_frame_latency = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static const char *g_frame_latency_name[FRAME_LATENCY_NUM] = {
+    "firmware",
+    "bus",
+    "parse",
+    "deliver",
+    "total",
+    "period",
+};
+
+/*
+ * Function:  frame_latency_to_us
+ * --------------------
+ * helper function to convert the interval of two stamps into micro-seconds
+ */
+static unsigned int frame_latency_to_us(long long start, long long end)
+{
+    if (end <= start)
+        return 0;
+
+    return (unsigned int)((end - start) / 1000);
+}
+/*
+ * Function:  frame_latency_compare
+ * --------------------
+ * comparison of qsort
+ */
+static int frame_latency_compare(const void *a, const void *b)
+{
+    unsigned int x = *(const unsigned int *)a;
+    unsigned int y = *(const unsigned int *)b;
+
+    return (x > y) - (x < y);
+}
+/*
+ * Function:  syna_frame_latency_begin
+ * --------------------
+ * start to tag a new frame, the frame in progress will be dropped
+ * if it is not ended
+ *
+ * return: n/a
+ */
+void syna_frame_latency_begin(void)
+{
+    struct frame_latency *p = &g_frame_latency;
+
+    pthread_mutex_lock(&p->mutex);
+
+    p->is_open = true;
+    p->marked = 0;
+    p->stamps[FRAME_STAMP_REQUEST] = syna_get_time_ns();
+    p->marked |= (1u << FRAME_STAMP_REQUEST);
+
+    pthread_mutex_unlock(&p->mutex);
+}
+/*
+ * Function:  syna_frame_latency_mark
+ * --------------------
+ * save the time stamp of the frame in progress
+ * nothing is saved if no frame is begun, for example, the report is
+ * read by the production test or the touch explorer
+ *
+ * return: n/a
+ */
+void syna_frame_latency_mark(enum syna_frame_stamp stamp)
+{
+    struct frame_latency *p = &g_frame_latency;
+
+    if ((stamp <= FRAME_STAMP_REQUEST) || (stamp >= FRAME_STAMP_NUM))
+        return;
+
+    pthread_mutex_lock(&p->mutex);
+
+    if (p->is_open) {
+        p->stamps[stamp] = syna_get_time_ns();
+        p->marked |= (1u << stamp);
+    }
+
+    pthread_mutex_unlock(&p->mutex);
+}
+/*
+ * Function:  syna_frame_latency_end
+ * --------------------
+ * end the frame in progress, and add its latency into the history
+ * the frame is dropped if any time stamp is missing, which means the
+ * frame is failed to read
+ *
+ * return: n/a
+ */
+void syna_frame_latency_end(void)
+{
+    struct frame_latency *p = &g_frame_latency;
+    long long *t = p->stamps;
+    int slot;
+
+    pthread_mutex_lock(&p->mutex);
+
+    if (!p->is_open)
+        goto exit;
+
+    p->stamps[FRAME_STAMP_DELIVER] = syna_get_time_ns();
+    p->marked |= (1u << FRAME_STAMP_DELIVER);
+    p->is_open = false;
+
+    if (p->marked != ((1u << FRAME_STAMP_NUM) - 1)) {
+        p->last_request = 0;
+        goto exit;
+    }
+
+    slot = p->next;
+    p->history[FRAME_LATENCY_FIRMWARE][slot] =
+            frame_latency_to_us(t[FRAME_STAMP_REQUEST], t[FRAME_STAMP_HEADER]);
+    p->history[FRAME_LATENCY_BUS][slot] =
+            frame_latency_to_us(t[FRAME_STAMP_HEADER], t[FRAME_STAMP_PAYLOAD]);
+    p->history[FRAME_LATENCY_PARSE][slot] =
+            frame_latency_to_us(t[FRAME_STAMP_PAYLOAD], t[FRAME_STAMP_REORDER]);
+    p->history[FRAME_LATENCY_DELIVER][slot] =
+            frame_latency_to_us(t[FRAME_STAMP_REORDER], t[FRAME_STAMP_DELIVER]);
+    p->history[FRAME_LATENCY_TOTAL][slot] =
+            frame_latency_to_us(t[FRAME_STAMP_REQUEST], t[FRAME_STAMP_DELIVER]);
+    /* the period of the first frame is unknown, use its total latency */
+    p->history[FRAME_LATENCY_PERIOD][slot] = (p->last_request > 0) ?
+            frame_latency_to_us(p->last_request, t[FRAME_STAMP_REQUEST]) :
+            p->history[FRAME_LATENCY_TOTAL][slot];
+
+    p->last_request = t[FRAME_STAMP_REQUEST];
+    p->next = (p->next + 1) % SYNA_FRAME_LATENCY_HISTORY;
+    if (p->count < SYNA_FRAME_LATENCY_HISTORY)
+        p->count += 1;
+
+exit:
+    pthread_mutex_unlock(&p->mutex);
+}
+/*
+ * Function:  syna_frame_latency_reset
+ * --------------------
+ * clear the history, called when a new streaming starts
+ *
+ * return: n/a
+ */
+void syna_frame_latency_reset(void)
+{
+    struct frame_latency *p = &g_frame_latency;
+
+    pthread_mutex_lock(&p->mutex);
+
+    p->is_open = false;
+    p->marked = 0;
+    p->last_request = 0;
+    p->count = 0;
+    p->next = 0;
+
+    pthread_mutex_unlock(&p->mutex);
+}
+/*
+ * Function:  syna_frame_latency_get_count
+ * --------------------
+ * get the number of frames in the history
+ *
+ * return: number of frames
+ */
+int syna_frame_latency_get_count(void)
+{
+    int count;
+
+    pthread_mutex_lock(&g_frame_latency.mutex);
+    count = g_frame_latency.count;
+    pthread_mutex_unlock(&g_frame_latency.mutex);
+
+    return count;
+}
+/*
+ * Function:  frame_latency_sort
+ * --------------------
+ * copy the history of the requested latency and sort it
+ * the caller should hold the mutex
+ *
+ * return: number of frames sorted
+ */
+static int frame_latency_sort(enum syna_frame_latency latency, unsigned int *p_sorted)
+{
+    struct frame_latency *p = &g_frame_latency;
+
+    if (p->count == 0)
+        return 0;
+
+    memcpy(p_sorted, p->history[latency], (size_t)p->count * sizeof(unsigned int));
+    qsort(p_sorted, (size_t)p->count, sizeof(unsigned int), frame_latency_compare);
+
+    return p->count;
+}
+/*
+ * Function:  syna_frame_latency_get_percentile
+ * --------------------
+ * get the percentile of the requested latency over the latest frames
+ *
+ * parameter
+ *  latency: one of enum syna_frame_latency
+ *  percent: 0 - 100, 50 for the median, 100 for the max.
+ *
+ * return: <0, invalid parameter or no frame is traced
+ *         otherwise, the latency in micro-seconds
+ */
+int syna_frame_latency_get_percentile(enum syna_frame_latency latency, int percent)
+{
+    unsigned int sorted[SYNA_FRAME_LATENCY_HISTORY];
+    int count;
+    int retval;
+
+    if ((latency < FRAME_LATENCY_FIRMWARE) || (latency >= FRAME_LATENCY_NUM) ||
+        (percent < 0) || (percent > 100)) {
+        printf_e("%s error: invalid parameter (latency = %d, percent = %d)\n",
+                 __func__, latency, percent);
+        return -EINVAL;
+    }
+
+    pthread_mutex_lock(&g_frame_latency.mutex);
+    count = frame_latency_sort(latency, sorted);
+    pthread_mutex_unlock(&g_frame_latency.mutex);
+
+    if (count == 0)
+        return -ENODATA;
+
+    retval = (int)sorted[((count - 1) * percent) / 100];
+
+    return retval;
+}
+/*
+ * Function:  syna_frame_latency_report
+ * --------------------
+ * write the statistics of all latency into a text report,
+ * one latency per line
+ *   <name>,<frames>,<p50_us>,<p90_us>,<p99_us>,<max_us>
+ *
+ * return: <0, fail to write the report
+ *         otherwise, number of frames in the statistics
+ */
+int syna_frame_latency_report(char *p_report, int size)
+{
+    unsigned int sorted[SYNA_FRAME_LATENCY_HISTORY];
+    int count = 0;
+    int len = 0;
+    int i;
+
+    if ((!p_report) || (size <= 0)) {
+        printf_e("%s error: invalid parameter\n", __func__);
+        return -EINVAL;
+    }
+    p_report[0] = '\0';
+
+    pthread_mutex_lock(&g_frame_latency.mutex);
+
+    for (i = 0; i < FRAME_LATENCY_NUM; i++) {
+        count = frame_latency_sort((enum syna_frame_latency)i, sorted);
+        if (count == 0)
+            break;
+
+        len += snprintf(p_report + len, (size_t)(size - len), "%s,%d,%u,%u,%u,%u\n",
+                        g_frame_latency_name[i], count,
+                        sorted[((count - 1) * 50) / 100], sorted[((count - 1) * 90) / 100],
+                        sorted[((count - 1) * 99) / 100], sorted[count - 1]);
+        if (len >= size) {
+            printf_e("%s error: report buffer is too small (size = %d)\n", __func__, size);
+            count = -ENOMEM;
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&g_frame_latency.mutex);
+
+    return count;
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+
+#include <stdbool.h>
+
+#ifndef _SYNA_FRAME_LATENCY_H__
+#define _SYNA_FRAME_LATENCY_H__
+
+/* number of the latest frames kept for the statistics */
+#define SYNA_FRAME_LATENCY_HISTORY     (512)
+
+/* size of the text report */
+#define SYNA_FRAME_LATENCY_REPORT_LEN  (1024)
+
+/*
+ * time stamps of one report frame, marked along the streaming path
+ *
+ *   FRAME_STAMP_REQUEST : frame is requested, requestReportImageJNI is called
+ *   FRAME_STAMP_HEADER  : header of the requested report arrives (tcm),
+ *                         or the get report flag is cleared (rmi)
+ *   FRAME_STAMP_PAYLOAD : payload is completely read from the bus
+ *   FRAME_STAMP_REORDER : frame is reordered into the output layout
+ *   FRAME_STAMP_DELIVER : frame is handed off to its consumer, the java array
+ *                         of requestReportImageJNI, or the recorder queue and
+ *                         the preview of the image stream
+ */
+enum syna_frame_stamp {
+    FRAME_STAMP_REQUEST = 0,
+    FRAME_STAMP_HEADER,
+    FRAME_STAMP_PAYLOAD,
+    FRAME_STAMP_REORDER,
+    FRAME_STAMP_DELIVER,
+    FRAME_STAMP_NUM,
+};
+
+/*
+ * latency derived from the time stamps
+ *
+ *   FRAME_LATENCY_FIRMWARE : REQUEST -> HEADER, waiting for the firmware frame
+ *   FRAME_LATENCY_BUS      : HEADER -> PAYLOAD, transfer of the payload
+ *   FRAME_LATENCY_PARSE    : PAYLOAD -> REORDER, parsing in the host
+ *   FRAME_LATENCY_DELIVER  : REORDER -> DELIVER, hand-off to the consumer
+ *   FRAME_LATENCY_TOTAL    : REQUEST -> DELIVER
+ *   FRAME_LATENCY_PERIOD   : REQUEST of the previous frame -> REQUEST
+ */
+enum syna_frame_latency {
+    FRAME_LATENCY_FIRMWARE = 0,
+    FRAME_LATENCY_BUS,
+    FRAME_LATENCY_PARSE,
+    FRAME_LATENCY_DELIVER,
+    FRAME_LATENCY_TOTAL,
+    FRAME_LATENCY_PERIOD,
+    FRAME_LATENCY_NUM,
+};
+
+/* helper to tag the frame along the streaming path */
+void syna_frame_latency_begin(void);
+void syna_frame_latency_mark(enum syna_frame_stamp stamp);
+void syna_frame_latency_end(void);
+
+/* helper to query the statistics of the latest frames, in micro-seconds */
+void syna_frame_latency_reset(void);
+int syna_frame_latency_get_count(void);
+int syna_frame_latency_get_percentile(enum syna_frame_latency latency, int percent);
+int syna_frame_latency_report(char *p_report, int size);
+
+#endif // _SYNA_FRAME_LATENCY_H__
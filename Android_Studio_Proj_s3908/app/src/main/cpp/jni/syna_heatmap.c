@@ -0,0 +1,524 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "syna_heatmap.h"
+
+/* the kernels are vectorized with NEON or SSE2, the scalar code is the reference */
+#if !defined(SYNA_HEATMAP_NO_SIMD)
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define HEATMAP_USE_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define HEATMAP_USE_SSE2
+#endif
+#endif
+
+#define HEATMAP_ONE         (1 << SYNA_HEATMAP_FRAC_BITS)
+#define HEATMAP_ROUND_2D    (1 << (2 * SYNA_HEATMAP_FRAC_BITS - 1))
+
+/*
+ * Function:  heatmap_clamp_color
+ * --------------------
+ * helper function to convert the color component from [0, 1] into [0, 255]
+ */
+static unsigned int heatmap_clamp_color(float c)
+{
+    if (c <= 0.0f)
+        return 0;
+    if (c >= 1.0f)
+        return 255;
+
+    return (unsigned int)(c * 255.0f + 0.5f);
+}
+/*
+ * Function:  heatmap_build_lut
+ * --------------------
+ * fill the colormap look-up table
+ *
+ * return: <0, unknown colormap or format
+ *         otherwise, 0
+ */
+static int heatmap_build_lut(unsigned int *p_lut, int colormap, int format)
+{
+    unsigned int r, g, b;
+    unsigned int a = 0xff;
+    float t;
+    int i;
+
+    for (i = 0; i < SYNA_HEATMAP_LUT_SIZE; i++) {
+        t = (float)i / (float)(SYNA_HEATMAP_LUT_SIZE - 1);
+
+        switch (colormap) {
+            case HEATMAP_COLORMAP_JET:
+                r = heatmap_clamp_color(1.5f - ((4.0f * t - 3.0f) < 0 ? -(4.0f * t - 3.0f) : (4.0f * t - 3.0f)));
+                g = heatmap_clamp_color(1.5f - ((4.0f * t - 2.0f) < 0 ? -(4.0f * t - 2.0f) : (4.0f * t - 2.0f)));
+                b = heatmap_clamp_color(1.5f - ((4.0f * t - 1.0f) < 0 ? -(4.0f * t - 1.0f) : (4.0f * t - 1.0f)));
+                break;
+            case HEATMAP_COLORMAP_GRAY:
+                r = g = b = (unsigned int)i;
+                break;
+            case HEATMAP_COLORMAP_BWR:
+                if (t < 0.5f) {
+                    r = g = heatmap_clamp_color(2.0f * t);
+                    b = 255;
+                }
+                else {
+                    r = 255;
+                    g = b = heatmap_clamp_color(2.0f - 2.0f * t);
+                }
+                break;
+            default:
+                return -EINVAL;
+        }
+
+        if (format == HEATMAP_FORMAT_RGBA)
+            p_lut[i] = r | (g << 8) | (b << 16) | (a << 24);
+        else if (format == HEATMAP_FORMAT_ARGB_INT)
+            p_lut[i] = (a << 24) | (r << 16) | (g << 8) | b;
+        else
+            return -EINVAL;
+    }
+
+    return 0;
+}
+/*
+ * Function:  syna_heatmap_init
+ * --------------------
+ * initialize the heatmap renderer, auto range is used by default
+ *
+ * return: <0, invalid parameter
+ *         otherwise, 0
+ */
+int syna_heatmap_init(struct syna_heatmap *p_heatmap, int colormap, int format, int scaling)
+{
+    int retval;
+
+    if (!p_heatmap)
+        return -EINVAL;
+
+    if ((scaling != HEATMAP_SCALING_NEAREST) && (scaling != HEATMAP_SCALING_BILINEAR))
+        return -EINVAL;
+
+    memset(p_heatmap, 0x00, sizeof(struct syna_heatmap));
+
+    retval = heatmap_build_lut(p_heatmap->lut, colormap, format);
+    if (retval < 0)
+        return retval;
+
+    p_heatmap->scaling = scaling;
+    p_heatmap->is_auto_range = true;
+
+    return 0;
+}
+/*
+ * Function:  syna_heatmap_release
+ * --------------------
+ * release the working buffers
+ *
+ * return: n/a
+ */
+void syna_heatmap_release(struct syna_heatmap *p_heatmap)
+{
+    if (!p_heatmap)
+        return;
+
+    free(p_heatmap->p_values);
+    free(p_heatmap->p_blend);
+    free(p_heatmap->p_index);
+    free(p_heatmap->p_colors);
+    free(p_heatmap->p_x0);
+    free(p_heatmap->p_fx);
+
+    p_heatmap->p_values = NULL;
+    p_heatmap->p_blend = NULL;
+    p_heatmap->p_index = NULL;
+    p_heatmap->p_colors = NULL;
+    p_heatmap->p_x0 = NULL;
+    p_heatmap->p_fx = NULL;
+    p_heatmap->size_cols = 0;
+    p_heatmap->size_width = 0;
+}
+/*
+ * Function:  syna_heatmap_set_range
+ * --------------------
+ * set the value range mapped to the colormap
+ * if is_auto is true, the min. and max. of each frame are used instead
+ *
+ * return: n/a
+ */
+void syna_heatmap_set_range(struct syna_heatmap *p_heatmap, bool is_auto, int range_min, int range_max)
+{
+    if (!p_heatmap)
+        return;
+
+    p_heatmap->is_auto_range = is_auto || (range_max <= range_min);
+    p_heatmap->range_min = range_min;
+    p_heatmap->range_max = range_max;
+}
+/*
+ * Function:  heatmap_alloc_buffers
+ * --------------------
+ * make sure the working buffers are large enough
+ *
+ * return: <0, fail to allocate the memory
+ *         otherwise, 0
+ */
+static int heatmap_alloc_buffers(struct syna_heatmap *p_heatmap, int cols, int width)
+{
+    int size;
+
+    if ((cols <= p_heatmap->size_cols) && (width <= p_heatmap->size_width))
+        return 0;
+
+    syna_heatmap_release(p_heatmap);
+
+    size = (cols > width) ? cols : width;
+
+    p_heatmap->p_values = calloc((size_t)size, sizeof(int));
+    /* one more column is padded for the bilinear scaling */
+    p_heatmap->p_blend = calloc((size_t)(cols + 1), sizeof(int));
+    p_heatmap->p_index = calloc((size_t)size, sizeof(unsigned char));
+    p_heatmap->p_colors = calloc((size_t)cols, sizeof(unsigned int));
+    p_heatmap->p_x0 = calloc((size_t)width, sizeof(int));
+    p_heatmap->p_fx = calloc((size_t)width, sizeof(int));
+    if ((!p_heatmap->p_values) || (!p_heatmap->p_blend) || (!p_heatmap->p_index) || (!p_heatmap->p_colors) ||
+        (!p_heatmap->p_x0) || (!p_heatmap->p_fx)) {
+        syna_heatmap_release(p_heatmap);
+        return -ENOMEM;
+    }
+
+    p_heatmap->size_cols = cols;
+    p_heatmap->size_width = width;
+
+    return 0;
+}
+/*
+ * Function:  heatmap_find_range
+ * --------------------
+ * find the min. and max. of the frame
+ *
+ * return: n/a
+ */
+static void heatmap_find_range(const short *p_frame, int num, int *p_min, int *p_max)
+{
+    int i = 0;
+    int v_min = p_frame[0];
+    int v_max = p_frame[0];
+#if defined(HEATMAP_USE_NEON) || defined(HEATMAP_USE_SSE2)
+    short lane_min[8];
+    short lane_max[8];
+    int j;
+#endif
+
+#if defined(HEATMAP_USE_NEON)
+    if (num >= 8) {
+        int16x8_t q_min = vld1q_s16(p_frame);
+        int16x8_t q_max = q_min;
+
+        for (i = 8; i + 8 <= num; i += 8) {
+            int16x8_t q = vld1q_s16(p_frame + i);
+            q_min = vminq_s16(q_min, q);
+            q_max = vmaxq_s16(q_max, q);
+        }
+        vst1q_s16(lane_min, q_min);
+        vst1q_s16(lane_max, q_max);
+        for (j = 0; j < 8; j++) {
+            v_min = (lane_min[j] < v_min) ? lane_min[j] : v_min;
+            v_max = (lane_max[j] > v_max) ? lane_max[j] : v_max;
+        }
+    }
+#elif defined(HEATMAP_USE_SSE2)
+    if (num >= 8) {
+        __m128i q_min = _mm_loadu_si128((const __m128i *)p_frame);
+        __m128i q_max = q_min;
+
+        for (i = 8; i + 8 <= num; i += 8) {
+            __m128i q = _mm_loadu_si128((const __m128i *)(p_frame + i));
+            q_min = _mm_min_epi16(q_min, q);
+            q_max = _mm_max_epi16(q_max, q);
+        }
+        _mm_storeu_si128((__m128i *)lane_min, q_min);
+        _mm_storeu_si128((__m128i *)lane_max, q_max);
+        for (j = 0; j < 8; j++) {
+            v_min = (lane_min[j] < v_min) ? lane_min[j] : v_min;
+            v_max = (lane_max[j] > v_max) ? lane_max[j] : v_max;
+        }
+    }
+#endif
+
+    for (; i < num; i++) {
+        v_min = (p_frame[i] < v_min) ? p_frame[i] : v_min;
+        v_max = (p_frame[i] > v_max) ? p_frame[i] : v_max;
+    }
+
+    *p_min = v_min;
+    *p_max = v_max;
+}
+/*
+ * Function:  heatmap_map_index
+ * --------------------
+ * map the values to the LUT index, the range [v_min, v_max] is divided
+ * into SYNA_HEATMAP_LUT_SIZE bins evenly, and the values out of range
+ * are saturated
+ *
+ * return: n/a
+ */
+static void heatmap_map_index(const int *p_values, int num, int v_min, float scale,
+                              unsigned char *p_index)
+{
+    int i = 0;
+    float f;
+
+#if defined(HEATMAP_USE_NEON)
+    int32x4_t q_min = vdupq_n_s32(v_min);
+    float32x4_t q_scale = vdupq_n_f32(scale);
+
+    for (; i + 8 <= num; i += 8) {
+        int32x4_t lo = vsubq_s32(vld1q_s32(p_values + i), q_min);
+        int32x4_t hi = vsubq_s32(vld1q_s32(p_values + i + 4), q_min);
+
+        lo = vcvtq_s32_f32(vmulq_f32(vcvtq_f32_s32(lo), q_scale));
+        hi = vcvtq_s32_f32(vmulq_f32(vcvtq_f32_s32(hi), q_scale));
+        /* saturating narrow into [0, 255] */
+        vst1_u8(p_index + i, vqmovun_s16(vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi))));
+    }
+#elif defined(HEATMAP_USE_SSE2)
+    __m128i q_min = _mm_set1_epi32(v_min);
+    __m128 q_scale = _mm_set1_ps(scale);
+
+    for (; i + 8 <= num; i += 8) {
+        __m128i lo = _mm_sub_epi32(_mm_loadu_si128((const __m128i *)(p_values + i)), q_min);
+        __m128i hi = _mm_sub_epi32(_mm_loadu_si128((const __m128i *)(p_values + i + 4)), q_min);
+
+        lo = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(lo), q_scale));
+        hi = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(hi), q_scale));
+        /* saturating pack into [0, 255] */
+        lo = _mm_packs_epi32(lo, hi);
+        _mm_storel_epi64((__m128i *)(p_index + i), _mm_packus_epi16(lo, lo));
+    }
+#endif
+
+    for (; i < num; i++) {
+        f = (float)(p_values[i] - v_min) * scale;
+        if (f <= 0.0f)
+            p_index[i] = 0;
+        else if (f >= (float)(SYNA_HEATMAP_LUT_SIZE - 1))
+            p_index[i] = SYNA_HEATMAP_LUT_SIZE - 1;
+        else
+            p_index[i] = (unsigned char)f;
+    }
+}
+/*
+ * Function:  heatmap_blend_rows
+ * --------------------
+ * interpolate two source rows vertically,
+ * the output is scaled by HEATMAP_ONE
+ *
+ * return: n/a
+ */
+static void heatmap_blend_rows(const short *p_row0, const short *p_row1, int cols, int fy,
+                               int *p_out)
+{
+    int i = 0;
+
+#if defined(HEATMAP_USE_NEON)
+    int16x4_t w0 = vdup_n_s16((short)(HEATMAP_ONE - fy));
+    int16x4_t w1 = vdup_n_s16((short)fy);
+
+    for (; i + 8 <= cols; i += 8) {
+        int16x8_t a = vld1q_s16(p_row0 + i);
+        int16x8_t b = vld1q_s16(p_row1 + i);
+        int32x4_t lo = vmlal_s16(vmull_s16(vget_low_s16(a), w0), vget_low_s16(b), w1);
+        int32x4_t hi = vmlal_s16(vmull_s16(vget_high_s16(a), w0), vget_high_s16(b), w1);
+
+        vst1q_s32(p_out + i, lo);
+        vst1q_s32(p_out + i + 4, hi);
+    }
+#elif defined(HEATMAP_USE_SSE2)
+    /* weight pairs for _mm_madd_epi16, (1 - fy) in the low half, fy in the high half */
+    __m128i w = _mm_set1_epi32((fy << 16) | (HEATMAP_ONE - fy));
+
+    for (; i + 8 <= cols; i += 8) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(p_row0 + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(p_row1 + i));
+
+        _mm_storeu_si128((__m128i *)(p_out + i), _mm_madd_epi16(_mm_unpacklo_epi16(a, b), w));
+        _mm_storeu_si128((__m128i *)(p_out + i + 4), _mm_madd_epi16(_mm_unpackhi_epi16(a, b), w));
+    }
+#endif
+
+    for (; i < cols; i++)
+        p_out[i] = p_row0[i] * (HEATMAP_ONE - fy) + p_row1[i] * fy;
+}
+/*
+ * Function:  heatmap_prepare_columns
+ * --------------------
+ * calculate the source column of each pixel
+ * for the bilinear scaling, the pixel centers are aligned to the tixel
+ * centers, and the weight of the next column is saved in p_fx
+ *
+ * return: n/a
+ */
+static void heatmap_prepare_columns(struct syna_heatmap *p_heatmap, int cols, int width)
+{
+    int x;
+    int sx;
+
+    for (x = 0; x < width; x++) {
+        if (p_heatmap->scaling == HEATMAP_SCALING_NEAREST) {
+            p_heatmap->p_x0[x] = (int)(((long long)x * cols) / width);
+            p_heatmap->p_fx[x] = 0;
+            continue;
+        }
+
+        /* position in the source, in units of 1/HEATMAP_ONE tixel */
+        sx = (int)((((long long)(2 * x + 1) * cols * HEATMAP_ONE) / (2 * width)) - (HEATMAP_ONE / 2));
+        if (sx < 0)
+            sx = 0;
+        if (sx >= (cols - 1) * HEATMAP_ONE) {
+            p_heatmap->p_x0[x] = cols - 1;
+            p_heatmap->p_fx[x] = 0;
+        }
+        else {
+            p_heatmap->p_x0[x] = sx >> SYNA_HEATMAP_FRAC_BITS;
+            p_heatmap->p_fx[x] = sx & (HEATMAP_ONE - 1);
+        }
+    }
+}
+/*
+ * Function:  syna_heatmap_render
+ * --------------------
+ * render one frame into the pixel buffer
+ *
+ * parameter
+ *  p_frame: frame data, rows x cols, in row-major order
+ *  p_pixels: pixel buffer provided by the caller, at least stride x height
+ *  width, height: size of the heatmap in pixels
+ *  stride: pixels of one row in the pixel buffer
+ *
+ * return: <0, fail to render
+ *         otherwise, 0
+ */
+int syna_heatmap_render(struct syna_heatmap *p_heatmap, const short *p_frame, int cols, int rows,
+                        unsigned int *p_pixels, int width, int height, int stride)
+{
+    int retval;
+    int v_min, v_max;
+    float scale;
+    int x, y;
+    int sy, y0, y1, fy;
+    int last_y0 = -1;
+    int *p_values;
+    int *p_blend;
+    unsigned char *p_index;
+    unsigned int *p_colors;
+    unsigned int *p_out;
+    const int *p_x0;
+    const int *p_fx;
+
+    if ((!p_heatmap) || (!p_frame) || (!p_pixels) || (cols <= 0) || (rows <= 0) ||
+        (width <= 0) || (height <= 0) || (stride < width))
+        return -EINVAL;
+
+    retval = heatmap_alloc_buffers(p_heatmap, cols, width);
+    if (retval < 0)
+        return retval;
+
+    p_values = p_heatmap->p_values;
+    p_blend = p_heatmap->p_blend;
+    p_index = p_heatmap->p_index;
+    p_colors = p_heatmap->p_colors;
+    p_x0 = p_heatmap->p_x0;
+    p_fx = p_heatmap->p_fx;
+
+    /* value range mapped to the colormap */
+    if (p_heatmap->is_auto_range) {
+        heatmap_find_range(p_frame, cols * rows, &v_min, &v_max);
+    }
+    else {
+        v_min = p_heatmap->range_min;
+        v_max = p_heatmap->range_max;
+    }
+    scale = (float)SYNA_HEATMAP_LUT_SIZE / (float)(v_max - v_min + 1);
+
+    heatmap_prepare_columns(p_heatmap, cols, width);
+
+    for (y = 0; y < height; y++) {
+        p_out = p_pixels + (size_t)y * (size_t)stride;
+
+        /* nearest, the colors of one source row are shared by the pixel rows */
+        if (p_heatmap->scaling == HEATMAP_SCALING_NEAREST) {
+            y0 = (int)(((long long)y * rows) / height);
+            if (y0 != last_y0) {
+                for (x = 0; x < cols; x++)
+                    p_values[x] = p_frame[y0 * cols + x];
+                heatmap_map_index(p_values, cols, v_min, scale, p_index);
+                for (x = 0; x < cols; x++)
+                    p_colors[x] = p_heatmap->lut[p_index[x]];
+
+                last_y0 = y0;
+            }
+            for (x = 0; x < width; x++)
+                p_out[x] = p_colors[p_x0[x]];
+
+            continue;
+        }
+
+        /* bilinear, blend the source rows, then the columns */
+        sy = (int)((((long long)(2 * y + 1) * rows * HEATMAP_ONE) / (2 * height)) - (HEATMAP_ONE / 2));
+        if (sy < 0)
+            sy = 0;
+        y0 = sy >> SYNA_HEATMAP_FRAC_BITS;
+        fy = sy & (HEATMAP_ONE - 1);
+        if (y0 >= rows - 1) {
+            y0 = rows - 1;
+            fy = 0;
+        }
+        y1 = (y0 + 1 < rows) ? (y0 + 1) : y0;
+
+        heatmap_blend_rows(p_frame + y0 * cols, p_frame + y1 * cols, cols, fy, p_blend);
+        /* pad the last column, whose weight is always 0 */
+        p_blend[cols] = p_blend[cols - 1];
+
+        for (x = 0; x < width; x++)
+            p_values[x] = (p_blend[p_x0[x]] * (HEATMAP_ONE - p_fx[x]) +
+                           p_blend[p_x0[x] + 1] * p_fx[x] + HEATMAP_ROUND_2D) >>
+                          (2 * SYNA_HEATMAP_FRAC_BITS);
+
+        heatmap_map_index(p_values, width, v_min, scale, p_index);
+        for (x = 0; x < width; x++)
+            p_out[x] = p_heatmap->lut[p_index[x]];
+    }
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+#include <stdbool.h>
+
+#ifndef _SYNA_HEATMAP_H__
+#define _SYNA_HEATMAP_H__
+
+/* entries of the colormap look-up table */
+#define SYNA_HEATMAP_LUT_SIZE   (256)
+
+/* precision of the bilinear weights */
+#define SYNA_HEATMAP_FRAC_BITS  (7)
+
+enum syna_heatmap_colormap {
+    HEATMAP_COLORMAP_JET = 0,   /* blue - cyan - yellow - red */
+    HEATMAP_COLORMAP_GRAY,      /* black - white */
+    HEATMAP_COLORMAP_BWR,       /* blue - white - red, for the signed delta */
+};
+
+enum syna_heatmap_format {
+    HEATMAP_FORMAT_RGBA = 0,    /* bytes in R, G, B, A order, as ANDROID_BITMAP_FORMAT_RGBA_8888 */
+    HEATMAP_FORMAT_ARGB_INT,    /* 0xAARRGGBB int, as android.graphics.Color */
+};
+
+enum syna_heatmap_scaling {
+    HEATMAP_SCALING_NEAREST = 0,
+    HEATMAP_SCALING_BILINEAR,
+};
+
+/*
+ * context of the heatmap renderer
+ *
+ * the frame is mapped to the LUT index by the value range, either the
+ * fixed range or the min./max. of each frame, and upscaled to the pixel
+ * buffer provided by the caller.
+ * the renderer only depends on libc, so it can be built and verified on
+ * the host as well.
+ */
+struct syna_heatmap {
+    unsigned int lut[SYNA_HEATMAP_LUT_SIZE];
+    int scaling;
+    bool is_auto_range;
+    int range_min;
+    int range_max;
+
+    /* working buffers, reallocated once the frame or pixel size grows */
+    int size_cols;
+    int size_width;
+    int *p_values;              /* values of one row to be mapped */
+    int *p_blend;               /* source rows blended vertically, bilinear scaling */
+    unsigned char *p_index;     /* LUT index of one row */
+    unsigned int *p_colors;     /* colors of one source row, nearest scaling */
+    int *p_x0;                  /* source column of each pixel */
+    int *p_fx;                  /* weight of the next source column, bilinear scaling */
+};
+
+int syna_heatmap_init(struct syna_heatmap *p_heatmap, int colormap, int format, int scaling);
+void syna_heatmap_release(struct syna_heatmap *p_heatmap);
+void syna_heatmap_set_range(struct syna_heatmap *p_heatmap, bool is_auto, int range_min, int range_max);
+int syna_heatmap_render(struct syna_heatmap *p_heatmap, const short *p_frame, int cols, int rows,
+                        unsigned int *p_pixels, int width, int height, int stride);
+
+#endif // _SYNA_HEATMAP_H__
@@ -0,0 +1,641 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "syna_dev_manager.h"
+#include "syna_capture_file.h"
+#include "syna_drift_tracker.h"
+#include "syna_frame_latency.h"
+#include "syna_image_stream.h"
+
+#ifdef SAVE_ERR_MSG
+#include "err_msg_ctrl.h"
+#endif
+
+/*
+ * variables of the image stream
+ *
+ * one thread keeps reading the report images at the full rate, and hands
+ * each frame to the consumers under the mutex:
+ *   - the drift tracker, if it is running
+ *   - the capture file, if the capture stream is set and the file is opened
+ *   - the recorder queue, every frame in order
+ *   - the preview, the latest frame or the aggregate, taken at its own rate
+ * so a slow consumer never slows down the acquisition, the frames it
+ * misses are counted instead.
+ */
+struct image_stream {
+    bool is_thread_created;
+    bool is_running;            /* acquisition thread is alive */
+    volatile bool is_stop;
+    int error;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+
+    unsigned char report_type;
+    int col;
+    int row;
+    int frame_size;
+    int capture_stream;         /* <0, not to append into the capture file */
+    int *p_frame;               /* frame being acquired */
+
+    /* recorder queue */
+    int *p_queue;
+    int depth;
+    int head;
+    int count;
+
+    /* preview */
+    int preview_mode;
+    int preview_frames;         /* 0, aggregate all frames since the last preview */
+    int preview_interval_ms;
+    long long *p_acc;
+    int acc_count;
+    int *p_preview;
+    int preview_count;          /* frames represented by p_preview, 0 if taken */
+    long long last_preview_ns;
+
+    int stats[IMAGE_STREAM_STAT_SIZE];
+};
+static struct image_stream g_stream = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+};
+
+/*
+ * Function:  stream_wait
+ * --------------------
+ * wait for the signal of the stream for up to wait_ms
+ * the caller should hold the mutex
+ *
+ * return: n/a
+ */
+static void stream_wait(int wait_ms)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += wait_ms / 1000;
+    ts.tv_nsec += (long)(wait_ms % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec += 1;
+        ts.tv_nsec -= 1000000000L;
+    }
+
+    pthread_cond_timedwait(&g_stream.cond, &g_stream.mutex, &ts);
+}
+/*
+ * Function:  stream_publish_preview
+ * --------------------
+ * move the aggregated frames to the preview
+ * the caller should hold the mutex
+ *
+ * return: n/a
+ */
+static void stream_publish_preview(void)
+{
+    struct image_stream *p = &g_stream;
+    int i;
+
+    if (p->acc_count == 0)
+        return;
+
+    /* the previous preview is not taken */
+    if (p->preview_count > 0)
+        p->stats[IMAGE_STREAM_PREVIEW_DROPPED] += p->preview_count;
+
+    for (i = 0; i < p->frame_size; i++) {
+        if (p->preview_mode == PREVIEW_MODE_MEAN)
+            p->p_preview[i] = (int)(p->p_acc[i] / p->acc_count);
+        else
+            p->p_preview[i] = (int)p->p_acc[i];
+    }
+
+    p->preview_count = p->acc_count;
+    p->acc_count = 0;
+}
+/*
+ * Function:  stream_feed_preview
+ * --------------------
+ * add one frame to the preview
+ * the caller should hold the mutex
+ *
+ * return: n/a
+ */
+static void stream_feed_preview(const int *p_frame)
+{
+    struct image_stream *p = &g_stream;
+    int i;
+
+    if (p->preview_mode == PREVIEW_MODE_LATEST) {
+        if (p->preview_count > 0)
+            p->stats[IMAGE_STREAM_PREVIEW_DROPPED] += p->preview_count;
+
+        memcpy(p->p_preview, p_frame, (size_t)p->frame_size * sizeof(int));
+        p->preview_count = 1;
+        return;
+    }
+
+    if (p->acc_count == 0) {
+        for (i = 0; i < p->frame_size; i++)
+            p->p_acc[i] = p_frame[i];
+    }
+    else {
+        switch (p->preview_mode) {
+            case PREVIEW_MODE_MAX:
+                for (i = 0; i < p->frame_size; i++)
+                    p->p_acc[i] = (p_frame[i] > p->p_acc[i]) ? p_frame[i] : p->p_acc[i];
+                break;
+            case PREVIEW_MODE_MIN:
+                for (i = 0; i < p->frame_size; i++)
+                    p->p_acc[i] = (p_frame[i] < p->p_acc[i]) ? p_frame[i] : p->p_acc[i];
+                break;
+            default:    /* PREVIEW_MODE_MEAN */
+                for (i = 0; i < p->frame_size; i++)
+                    p->p_acc[i] += p_frame[i];
+                break;
+        }
+    }
+    p->acc_count += 1;
+
+    if ((p->preview_frames > 0) && (p->acc_count >= p->preview_frames))
+        stream_publish_preview();
+}
+/*
+ * Function:  stream_thread
+ * --------------------
+ * thread to acquire the report images until the stream is stopped
+ * or a frame is failed to read
+ */
+static void *stream_thread(void *arg)
+{
+    struct image_stream *p = &g_stream;
+    int retval;
+    bool is_captured;
+
+    (void)arg;
+
+    while (!p->is_stop) {
+
+        syna_frame_latency_begin();
+
+        retval = syna_read_report_image_entry(p->report_type, p->p_frame, p->frame_size,
+                                              p->col, p->row, true);
+        if (retval < 0) {
+            printf_e("%s error: fail to read the report image (retval = %d)\n", __func__, retval);
+            pthread_mutex_lock(&p->mutex);
+            p->error = retval;
+            p->stats[IMAGE_STREAM_ERRORS] += 1;
+            pthread_mutex_unlock(&p->mutex);
+            break;
+        }
+
+        /* the drift tracker and the capture file have their own locking and buffering, */
+        /* so they are done out of the mutex */
+        if (syna_drift_is_running())
+            syna_drift_feed(p->p_frame, p->frame_size);
+
+        is_captured = false;
+        if ((p->capture_stream >= 0) && syna_capture_is_opened())
+            is_captured = (syna_capture_append_values(p->capture_stream, p->p_frame,
+                                                      p->frame_size) >= 0);
+
+        pthread_mutex_lock(&p->mutex);
+
+        p->stats[IMAGE_STREAM_ACQUIRED] += 1;
+        if (is_captured)
+            p->stats[IMAGE_STREAM_CAPTURED] += 1;
+
+        if (p->depth > 0) {
+            if (p->count < p->depth) {
+                memcpy(p->p_queue + (size_t)((p->head + p->count) % p->depth) * p->frame_size,
+                       p->p_frame, (size_t)p->frame_size * sizeof(int));
+                p->count += 1;
+            }
+            else {
+                p->stats[IMAGE_STREAM_RECORDER_DROPPED] += 1;
+            }
+        }
+
+        stream_feed_preview(p->p_frame);
+
+        pthread_cond_broadcast(&p->cond);
+        pthread_mutex_unlock(&p->mutex);
+
+        /* the frame is handed off to the consumers */
+        syna_frame_latency_end();
+    }
+
+    pthread_mutex_lock(&p->mutex);
+    p->is_running = false;
+    pthread_cond_broadcast(&p->cond);
+    pthread_mutex_unlock(&p->mutex);
+
+    return NULL;
+}
+/*
+ * Function:  stream_free_buffers
+ * --------------------
+ * release the buffers of the acquisition and the preview
+ * the caller should hold the mutex
+ *
+ * return: n/a
+ */
+static void stream_free_buffers(void)
+{
+    struct image_stream *p = &g_stream;
+
+    free(p->p_frame);
+    free(p->p_acc);
+    free(p->p_preview);
+
+    p->p_frame = NULL;
+    p->p_acc = NULL;
+    p->p_preview = NULL;
+    p->acc_count = 0;
+    p->preview_count = 0;
+}
+/*
+ * Function:  stream_free_queue
+ * --------------------
+ * release the recorder queue, the frames not taken yet are dropped
+ * the caller should hold the mutex
+ *
+ * return: n/a
+ */
+static void stream_free_queue(void)
+{
+    struct image_stream *p = &g_stream;
+
+    free(p->p_queue);
+
+    p->p_queue = NULL;
+    p->depth = 0;
+    p->head = 0;
+    p->count = 0;
+}
+/*
+ * Function:  syna_image_stream_start
+ * --------------------
+ * start a thread to acquire the report images continuously
+ * this function should be called after syna_start_image_stream
+ *
+ * parameter
+ *  report_type: report type requested
+ *  col, row: size of the image, in the landscape layout
+ *  frame_size: number of data in one frame, including the hybrid data
+ *  recorder_depth: frames queued for the recorder, 0 to disable the recorder
+ *  capture_stream: stream of the capture file to append every frame,
+ *                  -1 to disable
+ *
+ * return: <0, fail to start the stream
+ *         otherwise, succeed
+ */
+int syna_image_stream_start(unsigned char report_type, int col, int row, int frame_size,
+                            int recorder_depth, int capture_stream)
+{
+    struct image_stream *p = &g_stream;
+    int retval = 0;
+#ifdef SAVE_ERR_MSG
+    char err[MAX_ERR_STRING_LEN];
+#endif
+
+    if ((col <= 0) || (row <= 0) || (frame_size <= 0) || (recorder_depth < 0)) {
+        printf_e("%s error: invalid parameter (col = %d, row = %d, frame_size = %d, depth = %d)\n",
+                 __func__, col, row, frame_size, recorder_depth);
+        return -EINVAL;
+    }
+
+    if (p->is_thread_created) {
+        printf_e("%s error: image stream is running\n", __func__);
+        return -EBUSY;
+    }
+
+    pthread_mutex_lock(&p->mutex);
+
+    /* frames of the previous stream which are never drained */
+    stream_free_queue();
+
+    p->report_type = report_type;
+    p->col = col;
+    p->row = row;
+    p->frame_size = frame_size;
+    p->capture_stream = capture_stream;
+    p->error = 0;
+    p->is_stop = false;
+    memset(p->stats, 0x00, sizeof(p->stats));
+
+    p->p_frame = calloc((size_t)frame_size, sizeof(int));
+    p->p_acc = calloc((size_t)frame_size, sizeof(long long));
+    p->p_preview = calloc((size_t)frame_size, sizeof(int));
+    if (recorder_depth > 0)
+        p->p_queue = calloc((size_t)recorder_depth * (size_t)frame_size, sizeof(int));
+    if ((!p->p_frame) || (!p->p_acc) || (!p->p_preview) || ((recorder_depth > 0) && (!p->p_queue))) {
+        printf_e("%s error: can't allocate memory for the stream buffers\n", __func__);
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: can't allocate memory for the stream buffers\n", __func__);
+        add_error_msg(err);
+#endif
+        stream_free_buffers();
+        stream_free_queue();
+        retval = -ENOMEM;
+        goto exit;
+    }
+    p->depth = recorder_depth;
+    p->head = 0;
+    p->count = 0;
+    p->acc_count = 0;
+    p->preview_count = 0;
+    p->last_preview_ns = 0;
+
+    p->is_running = true;
+    retval = pthread_create(&p->thread, NULL, stream_thread, NULL);
+    if (retval != 0) {
+        printf_e("%s error: fail to create the stream thread (err: %d)\n", __func__, retval);
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: fail to create the stream thread (err: %d)\n", __func__, retval);
+        add_error_msg(err);
+#endif
+        p->is_running = false;
+        stream_free_buffers();
+        stream_free_queue();
+        retval = -EIO;
+        goto exit;
+    }
+    p->is_thread_created = true;
+
+exit:
+    pthread_mutex_unlock(&p->mutex);
+
+    return retval;
+}
+/*
+ * Function:  syna_image_stream_stop
+ * --------------------
+ * stop the acquisition thread, and release the buffers
+ * the frames in the recorder queue are kept, so the recorder can still
+ * drain them; the queue is released once it is empty, or at the next start
+ * the statistics are kept until the next start
+ *
+ * return: <0, the acquisition was stopped by an error
+ *         otherwise, the number of frames acquired
+ */
+int syna_image_stream_stop(void)
+{
+    struct image_stream *p = &g_stream;
+    int retval;
+
+    if (!p->is_thread_created)
+        return -EINVAL;
+
+    p->is_stop = true;
+    pthread_join(p->thread, NULL);
+    p->is_thread_created = false;
+
+    pthread_mutex_lock(&p->mutex);
+
+    stream_free_buffers();
+    if (p->count == 0)
+        stream_free_queue();
+    /* wake up the consumers still waiting */
+    pthread_cond_broadcast(&p->cond);
+
+    retval = (p->error < 0) ? p->error : p->stats[IMAGE_STREAM_ACQUIRED];
+
+    pthread_mutex_unlock(&p->mutex);
+
+    printf_i("%s info: acquired = %d, recorded = %d, recorder dropped = %d, previews = %d, preview dropped = %d\n",
+             __func__, p->stats[IMAGE_STREAM_ACQUIRED], p->stats[IMAGE_STREAM_RECORDED],
+             p->stats[IMAGE_STREAM_RECORDER_DROPPED], p->stats[IMAGE_STREAM_PREVIEWS],
+             p->stats[IMAGE_STREAM_PREVIEW_DROPPED]);
+
+    return retval;
+}
+/*
+ * Function:  syna_image_stream_is_running
+ * --------------------
+ * check whether the acquisition thread is still running
+ *
+ * return: true, if running
+ */
+bool syna_image_stream_is_running(void)
+{
+    bool is_running;
+
+    pthread_mutex_lock(&g_stream.mutex);
+    is_running = g_stream.is_running;
+    pthread_mutex_unlock(&g_stream.mutex);
+
+    return is_running;
+}
+/*
+ * Function:  syna_image_stream_set_preview
+ * --------------------
+ * configure the frame handed to the preview consumer
+ *
+ * parameter
+ *  mode: one of enum SYNA_PREVIEW_MODE
+ *  num_frames: frames of one aggregate, 0 for all frames since the last preview
+ *  interval_ms: min. interval between two previews
+ *
+ * return: <0, invalid parameter
+ *         otherwise, succeed
+ */
+int syna_image_stream_set_preview(int mode, int num_frames, int interval_ms)
+{
+    struct image_stream *p = &g_stream;
+
+    if ((mode < PREVIEW_MODE_LATEST) || (mode > PREVIEW_MODE_MEAN) ||
+        (num_frames < 0) || (interval_ms < 0)) {
+        printf_e("%s error: invalid parameter (mode = %d, frames = %d, interval = %d)\n",
+                 __func__, mode, num_frames, interval_ms);
+        return -EINVAL;
+    }
+
+    pthread_mutex_lock(&p->mutex);
+
+    /* restart the aggregation in the new mode */
+    if (mode != p->preview_mode)
+        p->acc_count = 0;
+
+    p->preview_mode = mode;
+    p->preview_frames = num_frames;
+    p->preview_interval_ms = interval_ms;
+
+    pthread_mutex_unlock(&p->mutex);
+
+    return 0;
+}
+/*
+ * Function:  syna_image_stream_read_recorder
+ * --------------------
+ * take the oldest frame in the recorder queue,
+ * wait for up to timeout_ms if the queue is empty
+ * after the stream is stopped, the frames left in the queue are still
+ * taken in order until it is empty
+ *
+ * return: -ETIMEDOUT, no frame is available in time
+ *         -ENODATA, the stream is stopped and all frames are taken
+ *         <0, the stream is stopped by the error
+ *         otherwise, the number of data copied
+ */
+int syna_image_stream_read_recorder(int *p_frame, int size, int timeout_ms)
+{
+    struct image_stream *p = &g_stream;
+    long long deadline = syna_get_time_ns() + (long long)timeout_ms * 1000000LL;
+    long long remain_ms;
+    int retval;
+
+    if ((!p_frame) || (size <= 0))
+        return -EINVAL;
+
+    pthread_mutex_lock(&p->mutex);
+
+    while (p->count == 0) {
+        if (!p->is_running) {
+            retval = (p->error < 0) ? p->error : -ENODATA;
+            goto exit;
+        }
+        remain_ms = (deadline - syna_get_time_ns()) / 1000000LL;
+        if (remain_ms <= 0) {
+            retval = -ETIMEDOUT;
+            goto exit;
+        }
+        stream_wait((int)remain_ms);
+    }
+
+    retval = MIN(size, p->frame_size);
+    memcpy(p_frame, p->p_queue + (size_t)p->head * p->frame_size, (size_t)retval * sizeof(int));
+    p->head = (p->head + 1) % p->depth;
+    p->count -= 1;
+    p->stats[IMAGE_STREAM_RECORDED] += 1;
+
+    /* the stream is stopped and drained */
+    if ((p->count == 0) && (!p->is_thread_created))
+        stream_free_queue();
+
+exit:
+    pthread_mutex_unlock(&p->mutex);
+
+    return retval;
+}
+/*
+ * Function:  syna_image_stream_read_preview
+ * --------------------
+ * take the preview frame, not earlier than the interval after the last
+ * preview, wait for up to timeout_ms if it is not available
+ *
+ * return: -ETIMEDOUT, no preview is available in time
+ *         -ENODATA, the stream is stopped
+ *         <0, the stream is stopped by the error
+ *         otherwise, the number of frames represented by the preview
+ */
+int syna_image_stream_read_preview(int *p_frame, int size, int timeout_ms)
+{
+    struct image_stream *p = &g_stream;
+    long long now = syna_get_time_ns();
+    long long deadline = now + (long long)timeout_ms * 1000000LL;
+    long long next;
+    long long wait_ns;
+    int retval;
+
+    if ((!p_frame) || (size <= 0))
+        return -EINVAL;
+
+    pthread_mutex_lock(&p->mutex);
+
+    while (1) {
+        if (!p->is_running) {
+            retval = (p->error < 0) ? p->error : -ENODATA;
+            goto exit;
+        }
+
+        now = syna_get_time_ns();
+        next = p->last_preview_ns + (long long)p->preview_interval_ms * 1000000LL;
+        if (now >= next) {
+            /* aggregate of all frames since the last preview */
+            if ((p->preview_mode != PREVIEW_MODE_LATEST) && (p->preview_frames == 0))
+                stream_publish_preview();
+
+            if (p->preview_count > 0)
+                break;
+        }
+
+        if (now >= deadline) {
+            retval = -ETIMEDOUT;
+            goto exit;
+        }
+        wait_ns = deadline - now;
+        if ((now < next) && (next - now < wait_ns))
+            wait_ns = next - now;
+        stream_wait((int)(wait_ns / 1000000LL) + 1);
+    }
+
+    memcpy(p_frame, p->p_preview, (size_t)MIN(size, p->frame_size) * sizeof(int));
+    retval = p->preview_count;
+
+    p->stats[IMAGE_STREAM_PREVIEWS] += 1;
+    p->stats[IMAGE_STREAM_PREVIEW_FRAMES] += p->preview_count;
+    p->preview_count = 0;
+    p->last_preview_ns = now;
+
+exit:
+    pthread_mutex_unlock(&p->mutex);
+
+    return retval;
+}
+/*
+ * Function:  syna_image_stream_get_stats
+ * --------------------
+ * copy the counters of the image stream, see enum SYNA_IMAGE_STREAM_STAT
+ *
+ * return: <0, invalid parameter
+ *         otherwise, the number of counters copied
+ */
+int syna_image_stream_get_stats(int *p_stats, int size)
+{
+    int num;
+
+    if ((!p_stats) || (size <= 0))
+        return -EINVAL;
+
+    num = MIN(size, IMAGE_STREAM_STAT_SIZE);
+
+    pthread_mutex_lock(&g_stream.mutex);
+    memcpy(p_stats, g_stream.stats, (size_t)num * sizeof(int));
+    pthread_mutex_unlock(&g_stream.mutex);
+
+    return num;
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+#include <stdbool.h>
+
+#ifndef _SYNA_IMAGE_STREAM_H__
+#define _SYNA_IMAGE_STREAM_H__
+
+/* default number of frames queued for the recorder */
+#define SYNA_IMAGE_STREAM_RECORDER_DEPTH  (256)
+
+/*
+ * frame handed to the preview consumer
+ * must be equivalent to the same id in java layer
+ *
+ *   PREVIEW_MODE_LATEST : the latest frame
+ *   PREVIEW_MODE_MAX    : max. of each tixel over the aggregated frames
+ *   PREVIEW_MODE_MIN    : min. of each tixel over the aggregated frames
+ *   PREVIEW_MODE_MEAN   : mean of each tixel over the aggregated frames
+ *
+ * the frames are aggregated in blocks of num_frames, or all frames since
+ * the last preview if num_frames is 0.
+ */
+enum SYNA_PREVIEW_MODE {
+    PREVIEW_MODE_LATEST = 0,
+    PREVIEW_MODE_MAX,
+    PREVIEW_MODE_MIN,
+    PREVIEW_MODE_MEAN,
+};
+
+/*
+ * counters of the image stream, used by syna_image_stream_get_stats
+ * must be equivalent to the same id in java layer
+ */
+enum SYNA_IMAGE_STREAM_STAT {
+    IMAGE_STREAM_ACQUIRED = 0,      /* frames read from the device */
+    IMAGE_STREAM_RECORDED,          /* frames taken by the recorder */
+    IMAGE_STREAM_RECORDER_DROPPED,  /* frames dropped as the recorder queue is full */
+    IMAGE_STREAM_CAPTURED,          /* frames appended to the capture file */
+    IMAGE_STREAM_PREVIEWS,          /* previews taken by the preview consumer */
+    IMAGE_STREAM_PREVIEW_FRAMES,    /* frames represented by the previews */
+    IMAGE_STREAM_PREVIEW_DROPPED,   /* frames never shown in any preview */
+    IMAGE_STREAM_ERRORS,
+    IMAGE_STREAM_STAT_SIZE,
+};
+
+/* helper to acquire the report images in a background thread */
+int syna_image_stream_start(unsigned char report_type, int col, int row, int frame_size,
+                            int recorder_depth, int capture_stream);
+int syna_image_stream_stop(void);
+bool syna_image_stream_is_running(void);
+
+/* helper for the consumers of the image stream */
+int syna_image_stream_set_preview(int mode, int num_frames, int interval_ms);
+int syna_image_stream_read_recorder(int *p_frame, int size, int timeout_ms);
+int syna_image_stream_read_preview(int *p_frame, int size, int timeout_ms);
+int syna_image_stream_get_stats(int *p_stats, int size);
+
+#endif // _SYNA_IMAGE_STREAM_H__
@@ -0,0 +1,730 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "syna_dev_manager.h"
+#include "syna_limit_store.h"
+
+#ifdef SAVE_ERR_MSG
+#include "err_msg_ctrl.h"
+#endif
+
+#define LIMIT_ALIGN(x) (((x) + 7) & ~7)
+
+#define LIMIT_KEYS_STEP (64)
+#define LIMIT_DATA_STEP (4096)
+
+/* variables of the limit store being used */
+struct limit_store {
+    bool is_loaded;
+    bool is_mapped;               /* true, if the image is mapped from the cache file */
+    unsigned char *p_image;
+    size_t image_size;
+    struct syna_limit_cache_header *p_header;
+    struct syna_limit_key_entry *p_keys;
+    int *p_data;
+};
+static struct limit_store g_limit_store;
+
+/* variables used during the compilation of .ini file */
+struct limit_compiler {
+    struct syna_limit_key_entry *p_keys;
+    int num_keys;
+    int max_keys;
+    int *p_data;
+    int num_data;
+    int max_data;
+    struct syna_limit_key_entry *p_cur;  /* key being parsed */
+    bool is_cur_valid;
+    char value[SYNA_LIMIT_VALUE_LEN];
+    int value_len;
+};
+
+/*
+ * Function:  limit_hash
+ * --------------------
+ * helper function to calculate the FNV-1a hash of the .ini file
+ */
+static unsigned long long limit_hash(const unsigned char *p_buf, size_t size)
+{
+    unsigned long long hash = 0xcbf29ce484222325ULL;
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        hash ^= p_buf[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+/*
+ * Function:  limit_flush_value
+ * --------------------
+ * helper function to convert the pending value string, and add it to the current key
+ * the value is in decimal, or in hex if "0x" is found
+ *
+ * return: <0, fail to allocate the buffer
+ *         otherwise, succeed
+ */
+static int limit_flush_value(struct limit_compiler *p_comp)
+{
+    char *p_end;
+    long value;
+    int *p_tmp;
+
+    if (p_comp->value_len == 0)
+        return 0;
+
+    p_comp->value[p_comp->value_len] = '\0';
+    p_comp->value_len = 0;
+
+    /* data without key, or the key is already invalid */
+    if (!p_comp->p_cur || !p_comp->is_cur_valid)
+        return 0;
+
+    value = strtol(p_comp->value, &p_end, (strstr(p_comp->value, "0x")) ? 16 : 10);
+    if ((p_end == p_comp->value) || (*p_end != '\0')) {
+        printf_i("%s: %s is not numeric (%s), skip it\n", __func__,
+                 p_comp->p_cur->name, p_comp->value);
+        p_comp->is_cur_valid = false;
+        return 0;
+    }
+
+    if (p_comp->num_data >= p_comp->max_data) {
+        p_tmp = realloc(p_comp->p_data, sizeof(int) * (p_comp->max_data + LIMIT_DATA_STEP));
+        if (!p_tmp) {
+            printf_e("%s error: fail to allocate the data buffer\n", __func__);
+            return -ENOMEM;
+        }
+        p_comp->p_data = p_tmp;
+        p_comp->max_data += LIMIT_DATA_STEP;
+    }
+
+    p_comp->p_data[p_comp->num_data++] = (int)value;
+    p_comp->p_cur->count += 1;
+
+    return 0;
+}
+/*
+ * Function:  limit_close_key
+ * --------------------
+ * helper function to complete the current key
+ * the data of invalid key is dropped
+ */
+static void limit_close_key(struct limit_compiler *p_comp)
+{
+    if (!p_comp->p_cur)
+        return;
+
+    if (!p_comp->is_cur_valid) {
+        p_comp->num_data = p_comp->p_cur->offset;
+        p_comp->p_cur->count = 0;
+    }
+    p_comp->p_cur = NULL;
+}
+/*
+ * Function:  limit_open_key
+ * --------------------
+ * helper function to start a new key
+ * if the key is defined twice, each definition is kept as one entry here,
+ * and the data are appended to the first one in limit_merge_keys()
+ *
+ * return: <0, fail to allocate the buffer
+ *         otherwise, succeed
+ */
+static int limit_open_key(struct limit_compiler *p_comp, const char *p_name, int len)
+{
+    struct syna_limit_key_entry *p_tmp;
+
+    if (len >= SYNA_LIMIT_KEY_LEN) {
+        printf_i("%s: key is too long, %.*s\n", __func__, len, p_name);
+        return 0;
+    }
+
+    if (p_comp->num_keys >= p_comp->max_keys) {
+        p_tmp = realloc(p_comp->p_keys,
+                        sizeof(struct syna_limit_key_entry) * (p_comp->max_keys + LIMIT_KEYS_STEP));
+        if (!p_tmp) {
+            printf_e("%s error: fail to allocate the key buffer\n", __func__);
+            return -ENOMEM;
+        }
+        p_comp->p_keys = p_tmp;
+        p_comp->max_keys += LIMIT_KEYS_STEP;
+    }
+
+    p_comp->p_cur = &p_comp->p_keys[p_comp->num_keys++];
+    memset(p_comp->p_cur, 0x00, sizeof(struct syna_limit_key_entry));
+    memcpy(p_comp->p_cur->name, p_name, len);
+    p_comp->p_cur->offset = (unsigned int)p_comp->num_data;
+    p_comp->is_cur_valid = true;
+
+    return 0;
+}
+/*
+ * Function:  limit_parse_line
+ * --------------------
+ * helper function to parse one line of .ini file,
+ * the same rules as TestCfgFileManager in java layer
+ *  1. all blanking characters are ignored
+ *  2. skip the line if '#' existed, or the length <= 1
+ *  3. the string before the last '=' is the key, following data belongs to this key
+ *
+ * return: <0, fail to parse
+ *         otherwise, succeed
+ */
+static int limit_parse_line(struct limit_compiler *p_comp, const char *p_line, int len)
+{
+    int retval;
+    int i;
+    int visible = 0;
+    int equal_sign = -1;
+    int key_start = -1;
+    int key_len = 0;
+    char c;
+
+    for (i = 0; i < len; i++) {
+        c = p_line[i];
+        if (c == '#')
+            return 0;
+        if (isspace((unsigned char)c))
+            continue;
+        if (c == '=')
+            equal_sign = i;
+        visible += 1;
+    }
+    if (visible <= 1)
+        return 0;
+
+    i = 0;
+    if (equal_sign >= 0) {
+        /* key is the visible characters before the last '=' */
+        for (; i < equal_sign; i++) {
+            c = p_line[i];
+            if (isspace((unsigned char)c))
+                continue;
+            if (key_start < 0)
+                key_start = i;
+            key_len = i - key_start + 1;
+        }
+
+        if (key_start >= 0) {
+            retval = limit_flush_value(p_comp);
+            if (retval < 0)
+                return retval;
+
+            limit_close_key(p_comp);
+
+            retval = limit_open_key(p_comp, p_line + key_start, key_len);
+            if (retval < 0)
+                return retval;
+        }
+        i = equal_sign + 1;
+    }
+
+    /* data, lines are concatenated as the java layer does */
+    for (; i < len; i++) {
+        c = p_line[i];
+        if (isspace((unsigned char)c))
+            continue;
+
+        if (c == ',') {
+            retval = limit_flush_value(p_comp);
+            if (retval < 0)
+                return retval;
+            continue;
+        }
+
+        if (p_comp->value_len < SYNA_LIMIT_VALUE_LEN - 1)
+            p_comp->value[p_comp->value_len++] = c;
+        else
+            p_comp->is_cur_valid = false;
+    }
+
+    return 0;
+}
+/*
+ * Function:  limit_compare_key
+ * --------------------
+ * helper function to sort the key entries by name
+ */
+static int limit_compare_key(const void *a, const void *b)
+{
+    return strcmp(((const struct syna_limit_key_entry *)a)->name,
+                  ((const struct syna_limit_key_entry *)b)->name);
+}
+/*
+ * Function:  limit_compare_key_order
+ * --------------------
+ * helper function to sort the key entries by name,
+ * and by the order of definition if the key is defined twice
+ */
+static int limit_compare_key_order(const void *a, const void *b)
+{
+    const struct syna_limit_key_entry *p_a = a;
+    const struct syna_limit_key_entry *p_b = b;
+    int retval;
+
+    retval = strcmp(p_a->name, p_b->name);
+    if (retval != 0)
+        return retval;
+
+    return (p_a->offset > p_b->offset) - (p_a->offset < p_b->offset);
+}
+/*
+ * Function:  limit_merge_keys
+ * --------------------
+ * helper function to sort the key entries, and merge the keys defined twice
+ * the data of all definitions are appended in the order of the .ini file,
+ * which is the same as getTestCfgData() in java layer
+ *
+ * return: <0, fail to allocate the buffer
+ *         otherwise, succeed
+ */
+static int limit_merge_keys(struct limit_compiler *p_comp)
+{
+    int i, j;
+    int num_keys = 0;
+    int num_data = 0;
+    int *p_data;
+
+    if (p_comp->num_keys <= 0)
+        return 0;
+
+    qsort(p_comp->p_keys, (size_t)p_comp->num_keys, sizeof(struct syna_limit_key_entry),
+          limit_compare_key_order);
+
+    p_data = malloc(sizeof(int) * (p_comp->num_data + 1));
+    if (!p_data) {
+        printf_e("%s error: fail to allocate the data buffer\n", __func__);
+        return -ENOMEM;
+    }
+
+    for (i = 0; i < p_comp->num_keys; i = j) {
+        struct syna_limit_key_entry entry = p_comp->p_keys[i];
+
+        entry.offset = (unsigned int)num_data;
+        entry.count = 0;
+
+        for (j = i; (j < p_comp->num_keys) &&
+                    (strcmp(p_comp->p_keys[j].name, p_comp->p_keys[i].name) == 0); j++) {
+            memcpy(p_data + num_data, p_comp->p_data + p_comp->p_keys[j].offset,
+                   sizeof(int) * p_comp->p_keys[j].count);
+            num_data += (int)p_comp->p_keys[j].count;
+            entry.count += p_comp->p_keys[j].count;
+        }
+
+        if (j - i > 1)
+            printf_i("%s: %s is defined %d times, data are appended\n", __func__, entry.name, j - i);
+
+        p_comp->p_keys[num_keys++] = entry;
+    }
+
+    free(p_comp->p_data);
+    p_comp->p_data = p_data;
+    p_comp->num_data = num_data;
+    p_comp->max_data = num_data + 1;
+    p_comp->num_keys = num_keys;
+
+    return 0;
+}
+/*
+ * Function:  limit_compile
+ * --------------------
+ * helper function to parse the .ini file, and create the compiled image
+ *
+ * return: <0, fail to compile
+ *         otherwise, succeed
+ */
+static int limit_compile(const unsigned char *p_ini, size_t ini_size, unsigned long long hash,
+                         unsigned char **pp_image, size_t *p_image_size)
+{
+    int retval = 0;
+    struct limit_compiler comp;
+    struct syna_limit_cache_header *p_header;
+    unsigned char *p_image = NULL;
+    size_t key_offset;
+    size_t data_offset;
+    size_t total_size;
+    size_t start = 0;
+    size_t i;
+
+    memset(&comp, 0x00, sizeof(struct limit_compiler));
+
+    for (i = 0; i <= ini_size; i++) {
+        if ((i == ini_size) || (p_ini[i] == '\n')) {
+            retval = limit_parse_line(&comp, (const char *)(p_ini + start), (int)(i - start));
+            if (retval < 0)
+                goto exit;
+            start = i + 1;
+        }
+    }
+
+    retval = limit_flush_value(&comp);
+    if (retval < 0)
+        goto exit;
+
+    limit_close_key(&comp);
+
+    retval = limit_merge_keys(&comp);
+    if (retval < 0)
+        goto exit;
+
+    key_offset = LIMIT_ALIGN(sizeof(struct syna_limit_cache_header));
+    data_offset = LIMIT_ALIGN(key_offset + sizeof(struct syna_limit_key_entry) * comp.num_keys);
+    total_size = data_offset + sizeof(int) * comp.num_data;
+
+    p_image = calloc(1, total_size);
+    if (!p_image) {
+        printf_e("%s error: fail to allocate the image (size = %d)\n", __func__, (int)total_size);
+        retval = -ENOMEM;
+        goto exit;
+    }
+
+    p_header = (struct syna_limit_cache_header *)p_image;
+    memcpy(p_header->magic, SYNA_LIMIT_CACHE_MAGIC, sizeof(p_header->magic));
+    p_header->version = SYNA_LIMIT_CACHE_VERSION;
+    p_header->header_size = sizeof(struct syna_limit_cache_header);
+    p_header->ini_hash = hash;
+    p_header->ini_size = (unsigned int)ini_size;
+    p_header->num_keys = (unsigned int)comp.num_keys;
+    p_header->key_offset = (unsigned int)key_offset;
+    p_header->data_offset = (unsigned int)data_offset;
+    p_header->data_count = (unsigned int)comp.num_data;
+    p_header->total_size = (unsigned int)total_size;
+
+    if (comp.num_keys > 0)
+        memcpy(p_image + key_offset, comp.p_keys,
+               sizeof(struct syna_limit_key_entry) * comp.num_keys);
+    if (comp.num_data > 0)
+        memcpy(p_image + data_offset, comp.p_data, sizeof(int) * comp.num_data);
+
+    *pp_image = p_image;
+    *p_image_size = total_size;
+
+    printf_i("%s: %d keys, %d values are compiled\n", __func__, comp.num_keys, comp.num_data);
+
+exit:
+    free(comp.p_keys);
+    free(comp.p_data);
+
+    return retval;
+}
+/*
+ * Function:  limit_check_image
+ * --------------------
+ * helper function to confirm the compiled image is valid for the .ini file
+ *
+ * return: true, the image is valid
+ */
+static bool limit_check_image(const unsigned char *p_image, size_t size,
+                              unsigned long long hash, size_t ini_size)
+{
+    const struct syna_limit_cache_header *p_header;
+    const struct syna_limit_key_entry *p_keys;
+    unsigned int i;
+
+    if (size < sizeof(struct syna_limit_cache_header))
+        return false;
+
+    p_header = (const struct syna_limit_cache_header *)p_image;
+    if ((memcmp(p_header->magic, SYNA_LIMIT_CACHE_MAGIC, sizeof(p_header->magic)) != 0) ||
+        (p_header->version != SYNA_LIMIT_CACHE_VERSION) ||
+        (p_header->header_size != sizeof(struct syna_limit_cache_header)))
+        return false;
+
+    if ((p_header->ini_hash != hash) || (p_header->ini_size != ini_size))
+        return false;
+
+    if ((p_header->total_size != size) ||
+        (p_header->key_offset + (size_t)p_header->num_keys * sizeof(struct syna_limit_key_entry) >
+         p_header->data_offset) ||
+        (p_header->data_offset + (size_t)p_header->data_count * sizeof(int) > size))
+        return false;
+
+    p_keys = (const struct syna_limit_key_entry *)(p_image + p_header->key_offset);
+    for (i = 0; i < p_header->num_keys; i++) {
+        if ((p_keys[i].name[SYNA_LIMIT_KEY_LEN - 1] != '\0') ||
+            ((size_t)p_keys[i].offset + p_keys[i].count > p_header->data_count))
+            return false;
+    }
+
+    return true;
+}
+/*
+ * Function:  limit_write_cache
+ * --------------------
+ * helper function to save the compiled image to the cache file
+ * the image is written to a temporary file, and then renamed
+ *
+ * return: <0, fail to write the cache
+ *         otherwise, succeed
+ */
+static int limit_write_cache(const char *cache_path, const unsigned char *p_image, size_t size)
+{
+    int fd;
+    ssize_t written;
+    size_t offset = 0;
+    char tmp_path[MAX_STRING_LEN];
+
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", cache_path);
+
+    fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0) {
+        printf_e("%s error: fail to create file, %s (err: %s)\n", __func__, tmp_path, strerror(errno));
+        return -EIO;
+    }
+
+    while (offset < size) {
+        written = write(fd, p_image + offset, size - offset);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            printf_e("%s error: fail to write file, %s (err: %s)\n", __func__, tmp_path, strerror(errno));
+            close(fd);
+            unlink(tmp_path);
+            return -EIO;
+        }
+        offset += (size_t)written;
+    }
+    close(fd);
+
+    if (rename(tmp_path, cache_path) < 0) {
+        printf_e("%s error: fail to rename file, %s (err: %s)\n", __func__, cache_path, strerror(errno));
+        unlink(tmp_path);
+        return -EIO;
+    }
+
+    return 0;
+}
+/*
+ * Function:  limit_map_cache
+ * --------------------
+ * helper function to map the cache file, if it is valid for the .ini file
+ * the mapping is private, the file is never modified
+ *
+ * return: true, the cache is mapped
+ */
+static bool limit_map_cache(const char *cache_path, unsigned long long hash, size_t ini_size)
+{
+    int fd;
+    struct stat st;
+    void *p_map;
+
+    fd = open(cache_path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    if ((fstat(fd, &st) < 0) || (st.st_size < (off_t)sizeof(struct syna_limit_cache_header))) {
+        close(fd);
+        return false;
+    }
+
+    p_map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p_map == MAP_FAILED) {
+        printf_e("%s error: fail to map the cache, %s (err: %s)\n", __func__, cache_path, strerror(errno));
+        return false;
+    }
+
+    if (!limit_check_image(p_map, (size_t)st.st_size, hash, ini_size)) {
+        printf_i("%s: cache is out of date, %s\n", __func__, cache_path);
+        munmap(p_map, (size_t)st.st_size);
+        return false;
+    }
+
+    g_limit_store.p_image = p_map;
+    g_limit_store.image_size = (size_t)st.st_size;
+    g_limit_store.is_mapped = true;
+
+    return true;
+}
+/*
+ * Function:  syna_limit_store_release
+ * --------------------
+ * release the limit store
+ * pointers returned by syna_limit_store_find are invalid after calling
+ */
+void syna_limit_store_release(void)
+{
+    if (g_limit_store.p_image) {
+        if (g_limit_store.is_mapped)
+            munmap(g_limit_store.p_image, g_limit_store.image_size);
+        else
+            free(g_limit_store.p_image);
+    }
+
+    memset(&g_limit_store, 0x00, sizeof(struct limit_store));
+}
+/*
+ * Function:  syna_limit_store_load
+ * --------------------
+ * load the test limits from the test configuration (.ini) file
+ * if the cache file is valid for the .ini file, the cache is mapped and used directly;
+ * otherwise, the .ini file is parsed and the compiled image is saved to the cache file.
+ * cache_path could be NULL, the cache is not used then.
+ *
+ * return: <0, fail to load the test limits
+ *         0, the .ini file is parsed
+ *         1, the cache file is used
+ */
+int syna_limit_store_load(const char *ini_path, const char *cache_path)
+{
+    int retval = 0;
+    int fd;
+    struct stat st;
+    unsigned char *p_ini = NULL;
+    size_t ini_size = 0;
+    unsigned long long hash;
+    unsigned char *p_image = NULL;
+    size_t image_size = 0;
+#ifdef SAVE_ERR_MSG
+    char err[MAX_ERR_STRING_LEN];
+#endif
+
+    if (!ini_path) {
+        printf_e("%s error: invalid parameter\n", __func__);
+        return -EINVAL;
+    }
+
+    syna_limit_store_release();
+
+    fd = open(ini_path, O_RDONLY);
+    if (fd < 0) {
+        printf_e("%s error: fail to open file, %s (err: %s)\n", __func__, ini_path, strerror(errno));
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: fail to open file, %s (err: %s)\n", __func__, ini_path, strerror(errno));
+        add_error_msg(err);
+#endif
+        return -EIO;
+    }
+
+    if ((fstat(fd, &st) < 0) || (st.st_size <= 0)) {
+        printf_e("%s error: invalid file, %s\n", __func__, ini_path);
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: invalid file, %s\n", __func__, ini_path);
+        add_error_msg(err);
+#endif
+        close(fd);
+        return -EINVAL;
+    }
+    ini_size = (size_t)st.st_size;
+
+    p_ini = mmap(NULL, ini_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p_ini == MAP_FAILED) {
+        printf_e("%s error: fail to map file, %s (err: %s)\n", __func__, ini_path, strerror(errno));
+        return -EIO;
+    }
+
+    hash = limit_hash(p_ini, ini_size);
+
+    /* use the cache directly, if it is compiled from the same .ini file */
+    if (cache_path && limit_map_cache(cache_path, hash, ini_size)) {
+        printf_i("%s: use the cache, %s\n", __func__, cache_path);
+        retval = 1;
+        goto done;
+    }
+
+    retval = limit_compile(p_ini, ini_size, hash, &p_image, &image_size);
+    if (retval < 0) {
+        printf_e("%s error: fail to parse file, %s\n", __func__, ini_path);
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: fail to parse file, %s\n", __func__, ini_path);
+        add_error_msg(err);
+#endif
+        goto exit;
+    }
+
+    /* the image is still usable even if the cache can't be saved */
+    if (cache_path)
+        limit_write_cache(cache_path, p_image, image_size);
+
+    g_limit_store.p_image = p_image;
+    g_limit_store.image_size = image_size;
+    g_limit_store.is_mapped = false;
+
+done:
+    g_limit_store.p_header = (struct syna_limit_cache_header *)g_limit_store.p_image;
+    g_limit_store.p_keys = (struct syna_limit_key_entry *)
+            (g_limit_store.p_image + g_limit_store.p_header->key_offset);
+    g_limit_store.p_data = (int *)(g_limit_store.p_image + g_limit_store.p_header->data_offset);
+    g_limit_store.is_loaded = true;
+
+exit:
+    munmap(p_ini, ini_size);
+
+    return retval;
+}
+/*
+ * Function:  syna_limit_store_is_loaded
+ * --------------------
+ * return: true, the test limits are loaded
+ */
+bool syna_limit_store_is_loaded(void)
+{
+    return g_limit_store.is_loaded;
+}
+/*
+ * Function:  syna_limit_store_find
+ * --------------------
+ * find the data of the key
+ * pp_data points to the data in the limit store, no copy is made
+ *
+ * return: <0, the key is not found
+ *         otherwise, the number of data, 0 if the content of key is invalid
+ */
+int syna_limit_store_find(const char *key, int **pp_data)
+{
+    struct syna_limit_key_entry *p_entry;
+    struct syna_limit_key_entry target;
+
+    if (!g_limit_store.is_loaded || !key || !pp_data)
+        return -EINVAL;
+
+    if (strlen(key) >= SYNA_LIMIT_KEY_LEN)
+        return -ENOENT;
+
+    memset(&target, 0x00, sizeof(struct syna_limit_key_entry));
+    strcpy(target.name, key);
+
+    p_entry = bsearch(&target, g_limit_store.p_keys, g_limit_store.p_header->num_keys,
+                      sizeof(struct syna_limit_key_entry), limit_compare_key);
+    if (!p_entry)
+        return -ENOENT;
+
+    *pp_data = g_limit_store.p_data + p_entry->offset;
+
+    return (int)p_entry->count;
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+#include <stdbool.h>
+
+#ifndef _SYNA_LIMIT_STORE_H__
+#define _SYNA_LIMIT_STORE_H__
+
+#define SYNA_LIMIT_CACHE_MAGIC    "SYNALMIT"
+#define SYNA_LIMIT_CACHE_VERSION  (2)
+
+/* max. length of the key defined in test configuration file */
+#define SYNA_LIMIT_KEY_LEN        (48)
+
+/* max. length of one value in test configuration file */
+#define SYNA_LIMIT_VALUE_LEN      (24)
+
+/*
+ * layout of the compiled limit store, which is the same as the cache file
+ *
+ *  [header]
+ *  [key entries] ... sorted by name
+ *  [int data]    ... values of all keys
+ *
+ * the cache is valid only if the hash and size of .ini file are matched.
+ */
+struct syna_limit_cache_header {
+    char magic[8];
+    unsigned int version;
+    unsigned int header_size;
+    unsigned long long ini_hash;  /* FNV-1a hash of the .ini file */
+    unsigned int ini_size;
+    unsigned int num_keys;
+    unsigned int key_offset;      /* offset of key entries, in bytes */
+    unsigned int data_offset;     /* offset of int data, in bytes */
+    unsigned int data_count;      /* number of int data */
+    unsigned int total_size;
+};
+
+struct syna_limit_key_entry {
+    char name[SYNA_LIMIT_KEY_LEN];
+    unsigned int offset;          /* index of the first value in int data */
+    unsigned int count;           /* 0, if the content is invalid */
+};
+
+/* helper to load the test limits from the test configuration file */
+int syna_limit_store_load(const char *ini_path, const char *cache_path);
+void syna_limit_store_release(void);
+bool syna_limit_store_is_loaded(void);
+int syna_limit_store_find(const char *key, int **pp_data);
+
+#endif // _SYNA_LIMIT_STORE_H__
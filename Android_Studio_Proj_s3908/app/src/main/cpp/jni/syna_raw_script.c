@@ -0,0 +1,723 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "syna_dev_manager.h"
+#include "rmi_control.h"
+#include "tcm_control.h"
+#include "syna_test_job.h"
+#include "syna_bus_trace.h"
+#include "syna_raw_script.h"
+
+#ifdef SAVE_ERR_MSG
+#include "err_msg_ctrl.h"
+#endif
+
+#define SCRIPT_LINE_LEN (2048)
+#define SCRIPT_POOL_STEP (4096)
+
+/* max. size of a tcm packet, 2-byte header + 65535-byte payload + 1-byte ending */
+#define SCRIPT_TCM_MAX_PACKET (65535 + 3)
+
+/*
+ * Function:  script_add_op
+ * --------------------
+ * helper function to append one operation
+ *
+ * return: pointer of the operation, or NULL if the script is full
+ */
+static struct syna_script_op *script_add_op(struct syna_script *p_script,
+                                            int type, int line)
+{
+    struct syna_script_op *p_op;
+
+    if (p_script->num_ops >= SYNA_SCRIPT_MAX_OPS)
+        return NULL;
+
+    p_op = &p_script->p_ops[p_script->num_ops++];
+    memset(p_op, 0x00, sizeof(struct syna_script_op));
+    p_op->type = type;
+    p_op->line = line;
+    p_op->offset = p_script->pool_used;
+
+    return p_op;
+}
+
+/*
+ * Function:  script_put_byte
+ * --------------------
+ * helper function to append one byte to the data pool
+ *
+ * return: <0, fail to enlarge the pool
+ *         otherwise, 0
+ */
+static int script_put_byte(struct syna_script *p_script,
+                           unsigned char data, unsigned char mask)
+{
+    unsigned char *p_pool;
+    unsigned char *p_mask;
+    int size;
+
+    if (p_script->pool_used >= p_script->pool_size) {
+        size = p_script->pool_size + SCRIPT_POOL_STEP;
+
+        p_pool = realloc(p_script->p_pool, (size_t)size);
+        if (!p_pool)
+            return -ENOMEM;
+        p_script->p_pool = p_pool;
+
+        p_mask = realloc(p_script->p_mask, (size_t)size);
+        if (!p_mask)
+            return -ENOMEM;
+        p_script->p_mask = p_mask;
+
+        p_script->pool_size = size;
+    }
+
+    p_script->p_pool[p_script->pool_used] = data;
+    p_script->p_mask[p_script->pool_used] = mask;
+    p_script->pool_used += 1;
+
+    return 0;
+}
+
+/*
+ * Function:  script_parse_hex
+ * --------------------
+ * helper function to parse the hex string, "0x" is optional
+ *
+ * return: <0, not a hex string
+ *         otherwise, the value
+ */
+static long script_parse_hex(const char *p_str)
+{
+    char *p_end;
+    long value;
+
+    value = strtol(p_str, &p_end, 16);
+    if ((p_end == p_str) || (*p_end != '\0') || (value < 0))
+        return -1;
+
+    return value;
+}
+
+/*
+ * Function:  script_parse_dec
+ * --------------------
+ * helper function to parse the decimal string
+ *
+ * return: <0, not a decimal string
+ *         otherwise, the value
+ */
+static long script_parse_dec(const char *p_str)
+{
+    char *p_end;
+    long value;
+
+    value = strtol(p_str, &p_end, 10);
+    if ((p_end == p_str) || (*p_end != '\0') || (value < 0))
+        return -1;
+
+    return value;
+}
+
+/*
+ * Function:  script_parse_line
+ * --------------------
+ * helper function to compile one line of the script
+ *
+ * return: <0, syntax error
+ *         otherwise, 0
+ */
+static int script_parse_line(struct syna_script *p_script, char *p_line, int line,
+                             int *p_loops, int *p_depth)
+{
+    struct syna_script_op *p_op = NULL;
+    char *p_tok;
+    char *p_save = NULL;
+    long value;
+    int type;
+
+    p_tok = strtok_r(p_line, " \t\r\n", &p_save);
+    if (!p_tok)
+        return 0;
+
+    if (0 == strcmp(p_tok, "read"))
+        type = SCRIPT_OP_READ;
+    else if (0 == strcmp(p_tok, "write"))
+        type = SCRIPT_OP_WRITE;
+    else if (0 == strcmp(p_tok, "wait"))
+        type = SCRIPT_OP_WAIT;
+    else if (0 == strcmp(p_tok, "loop"))
+        type = SCRIPT_OP_LOOP;
+    else if (0 == strcmp(p_tok, "end"))
+        type = SCRIPT_OP_END;
+    else if (0 == strcmp(p_tok, "expect"))
+        type = SCRIPT_OP_EXPECT;
+    else
+        return -EINVAL;
+
+    p_op = script_add_op(p_script, type, line);
+    if (!p_op)
+        return -E2BIG;
+
+    switch (type) {
+        case SCRIPT_OP_READ:
+            /* rmi: read <hex reg> <len>,  tcm: read <len> */
+            if (p_script->is_rmi) {
+                p_tok = strtok_r(NULL, " \t\r\n", &p_save);
+                if (!p_tok || ((value = script_parse_hex(p_tok)) < 0) || (value > 0xffff))
+                    return -EINVAL;
+                p_op->code = (int)value;
+            }
+            p_tok = strtok_r(NULL, " \t\r\n", &p_save);
+            if (!p_tok || ((value = script_parse_dec(p_tok)) <= 0) ||
+                (value > SCRIPT_TCM_MAX_PACKET))
+                return -EINVAL;
+            p_op->length = (int)value;
+            p_script->max_read = MAX(p_script->max_read, p_op->length);
+            break;
+
+        case SCRIPT_OP_WRITE:
+        case SCRIPT_OP_EXPECT:
+            /* write <hex reg/cmd> <hex data> ...,  expect <hex data> ... */
+            if (SCRIPT_OP_WRITE == type) {
+                p_tok = strtok_r(NULL, " \t\r\n", &p_save);
+                if (!p_tok || ((value = script_parse_hex(p_tok)) < 0) ||
+                    (value > (p_script->is_rmi ? 0xffff : 0xff)))
+                    return -EINVAL;
+                p_op->code = (int)value;
+            }
+            while ((p_tok = strtok_r(NULL, " \t\r\n", &p_save)) != NULL) {
+                if ((SCRIPT_OP_EXPECT == type) &&
+                    ((0 == strcmp(p_tok, "xx")) || (0 == strcmp(p_tok, "??")))) {
+                    if (script_put_byte(p_script, 0x00, 0x00) < 0)
+                        return -ENOMEM;
+                }
+                else {
+                    value = script_parse_hex(p_tok);
+                    if ((value < 0) || (value > 0xff))
+                        return -EINVAL;
+                    if (script_put_byte(p_script, (unsigned char)value, 0xff) < 0)
+                        return -ENOMEM;
+                }
+                p_op->length += 1;
+            }
+            if ((SCRIPT_OP_EXPECT == type) && (p_op->length == 0))
+                return -EINVAL;
+            if ((SCRIPT_OP_WRITE == type) && (p_script->is_rmi) && (p_op->length == 0))
+                return -EINVAL;
+            if ((SCRIPT_OP_WRITE == type) && (p_op->length > 0xffff))
+                return -E2BIG;
+            if (SCRIPT_OP_WRITE == type)
+                p_script->max_write = MAX(p_script->max_write, p_op->length);
+            break;
+
+        case SCRIPT_OP_WAIT:
+        case SCRIPT_OP_LOOP:
+            /* wait <ms>,  loop <count> */
+            p_tok = strtok_r(NULL, " \t\r\n", &p_save);
+            if (!p_tok || ((value = script_parse_dec(p_tok)) < 0) || (value > 0x7fffffff))
+                return -EINVAL;
+            p_op->code = (int)value;
+
+            if (SCRIPT_OP_LOOP == type) {
+                if (*p_depth >= SYNA_SCRIPT_MAX_LOOP_DEPTH)
+                    return -E2BIG;
+                p_loops[(*p_depth)++] = p_script->num_ops - 1;
+            }
+            break;
+
+        case SCRIPT_OP_END:
+            if (*p_depth <= 0)
+                return -EINVAL;
+            p_op->code = p_loops[--(*p_depth)];
+            break;
+
+        default:
+            break;
+    }
+
+    return 0;
+}
+
+/*
+ * Function:  syna_script_load
+ * --------------------
+ * parse the script file and compile the operations
+ *
+ * return: <0, fail to parse the script
+ *         otherwise, number of operations
+ */
+int syna_script_load(const char *script_path, struct syna_script *p_script)
+{
+    int retval = 0;
+    FILE *fp = NULL;
+    char *p_line = NULL;
+    char *p_comment;
+    int line = 0;
+    int loops[SYNA_SCRIPT_MAX_LOOP_DEPTH];
+    int depth = 0;
+    int i;
+#ifdef SAVE_ERR_MSG
+    char err[MAX_ERR_STRING_LEN];
+#endif
+
+    if ((!script_path) || (!p_script)) {
+        printf_e("%s error: invalid parameter\n", __func__);
+        return -EINVAL;
+    }
+
+    memset(p_script, 0x00, sizeof(struct syna_script));
+
+    fp = fopen(script_path, "r");
+    if (!fp) {
+        printf_e("%s error: fail to open %s\n", __func__, script_path);
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: fail to open %s\n", __func__, script_path);
+        add_error_msg(err);
+#endif
+        return -ENOENT;
+    }
+
+    p_line = malloc(SCRIPT_LINE_LEN);
+    p_script->p_ops = calloc(SYNA_SCRIPT_MAX_OPS, sizeof(struct syna_script_op));
+    if ((!p_line) || (!p_script->p_ops)) {
+        printf_e("%s error: fail to allocate the buffer\n", __func__);
+        retval = -ENOMEM;
+        goto exit;
+    }
+
+    /* the first line is the device type */
+    if (!fgets(p_line, SCRIPT_LINE_LEN, fp)) {
+        retval = -EINVAL;
+        goto exit;
+    }
+    line += 1;
+    for (i = 0; p_line[i] != '\0'; i++)
+        p_line[i] = (char)tolower((unsigned char)p_line[i]);
+
+    if (strstr(p_line, "rmi")) {
+        p_script->is_rmi = true;
+    }
+    else if (strstr(p_line, "tcm")) {
+        p_script->is_rmi = false;
+    }
+    else {
+        printf_e("%s error: unknown script type, %s\n", __func__, p_line);
+        retval = -EINVAL;
+        goto exit;
+    }
+
+    while (fgets(p_line, SCRIPT_LINE_LEN, fp)) {
+        line += 1;
+
+        p_comment = strchr(p_line, '#');
+        if (p_comment)
+            *p_comment = '\0';
+
+        for (i = 0; p_line[i] != '\0'; i++)
+            p_line[i] = (char)tolower((unsigned char)p_line[i]);
+
+        retval = script_parse_line(p_script, p_line, line, loops, &depth);
+        if (retval < 0) {
+            printf_e("%s error: syntax error at line %d (%d)\n", __func__, line, retval);
+#ifdef SAVE_ERR_MSG
+            sprintf(err, "%s error: syntax error at line %d\n", __func__, line);
+            add_error_msg(err);
+#endif
+            goto exit;
+        }
+    }
+
+    if (depth != 0) {
+        printf_e("%s error: loop at line %d is not closed\n",
+                 __func__, p_script->p_ops[loops[depth - 1]].line);
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: loop at line %d is not closed\n",
+                __func__, p_script->p_ops[loops[depth - 1]].line);
+        add_error_msg(err);
+#endif
+        retval = -EINVAL;
+        goto exit;
+    }
+
+    printf_i("%s info: %d operations, %d bytes data (%s)\n", __func__,
+             p_script->num_ops, p_script->pool_used, (p_script->is_rmi)? "rmi" : "tcm");
+
+    retval = p_script->num_ops;
+
+exit:
+    if (p_line)
+        free(p_line);
+    fclose(fp);
+
+    if (retval < 0)
+        syna_script_release(p_script);
+
+    return retval;
+}
+
+/*
+ * Function:  syna_script_release
+ * --------------------
+ * release the compiled script
+ *
+ * return: n/a
+ */
+void syna_script_release(struct syna_script *p_script)
+{
+    if (!p_script)
+        return;
+
+    if (p_script->p_ops)
+        free(p_script->p_ops);
+    if (p_script->p_pool)
+        free(p_script->p_pool);
+    if (p_script->p_mask)
+        free(p_script->p_mask);
+
+    memset(p_script, 0x00, sizeof(struct syna_script));
+}
+
+/*
+ * Function:  script_do_access
+ * --------------------
+ * helper function to perform one read/write operation.
+ * the packet and the response buffers are allocated once by the caller
+ * and reused by all operations.
+ *
+ * return: <0, fail to access the device
+ *         otherwise, bytes of the response kept in *pp_resp
+ */
+static int script_do_access(struct syna_script *p_script, struct syna_script_op *p_op,
+                            unsigned char *p_xfer, unsigned char *p_rx,
+                            unsigned char **pp_resp)
+{
+    int retval;
+    struct tcm_message_header header;
+    int payload_size;
+
+    *pp_resp = p_rx;
+
+    if (p_script->is_rmi) {
+        if (SCRIPT_OP_READ == p_op->type)
+            retval = rmi_read_reg((unsigned short)p_op->code, p_rx, p_op->length);
+        else
+            retval = rmi_write_reg((unsigned short)p_op->code,
+                                   &p_script->p_pool[p_op->offset], p_op->length);
+        if (retval < 0)
+            return retval;
+
+        return (SCRIPT_OP_READ == p_op->type) ? p_op->length : 0;
+    }
+
+    if (SCRIPT_OP_READ == p_op->type) {
+        retval = tcm_read_message(p_rx, (unsigned int)p_op->length);
+        if (retval < 0)
+            return retval;
+
+        return p_op->length;
+    }
+
+    p_xfer[0] = (unsigned char)p_op->code;
+    p_xfer[1] = (unsigned char)(p_op->length & 0xff);
+    p_xfer[2] = (unsigned char)((p_op->length >> 8) & 0xff);
+    if (p_op->length > 0)
+        memcpy(&p_xfer[3], &p_script->p_pool[p_op->offset], (size_t)p_op->length);
+
+    retval = tcm_write_message(p_xfer, (unsigned int)(p_op->length + 3));
+    if (retval < 0)
+        return retval;
+
+    payload_size = tcm_wait_for_response(SYNA_SCRIPT_TIMEOUT_MS, &header);
+    if (payload_size < 0)
+        return payload_size;
+
+    /* the payload is re-sent with the 2-byte header, 0xa5 STATUS_CONTINUED_READ,
+     * put the status code at the second byte, then the response starts at p_rx[1]
+     */
+    if (payload_size > 0) {
+        retval = tcm_read_message(p_rx, (unsigned int)(payload_size + 3));
+        if (retval < 0)
+            return retval;
+    }
+    p_rx[1] = header.code;
+    *pp_resp = &p_rx[1];
+
+    return payload_size + 1;
+}
+
+/*
+ * Function:  script_update_stats
+ * --------------------
+ * helper function to accumulate the execution time of one operation
+ *
+ * return: n/a
+ */
+static void script_update_stats(struct syna_script_op *p_op, long long time_us, bool is_failed)
+{
+    if ((p_op->count == 0) || (time_us < p_op->min_us))
+        p_op->min_us = time_us;
+    if ((p_op->count == 0) || (time_us > p_op->max_us))
+        p_op->max_us = time_us;
+
+    p_op->total_us += time_us;
+    p_op->count += 1;
+    if (is_failed)
+        p_op->fail += 1;
+}
+
+/*
+ * Function:  syna_script_run
+ * --------------------
+ * execute the compiled script, the time of each operation is recorded.
+ * a tcm write is failed if the status code is not STATUS_OK, unless it is
+ * followed by an "expect" which makes the decision.
+ *
+ * parameter
+ *  p_script: compiled script
+ *  stop_on_fail: stop at the first failure
+ *
+ * return: <0, fail to execute the script
+ *         otherwise, number of failures
+ */
+int syna_script_run(struct syna_script *p_script, bool stop_on_fail)
+{
+    int retval = 0;
+    unsigned char *p_xfer = NULL;
+    unsigned char *p_rx = NULL;
+    unsigned char *p_resp = NULL;
+    int resp_bytes = -1;
+    int loop_remaining[SYNA_SCRIPT_MAX_LOOP_DEPTH];
+    int loop_index[SYNA_SCRIPT_MAX_LOOP_DEPTH];
+    int depth = 0;
+    int pc;
+    int i;
+    bool is_failed;
+    bool is_expected;
+    long long start_us;
+    long long begin_us;
+    struct syna_script_op *p_op;
+    int rx_size;
+
+    if ((!p_script) || (!p_script->p_ops)) {
+        printf_e("%s error: invalid parameter\n", __func__);
+        return -EINVAL;
+    }
+
+    for (i = 0; i < p_script->num_ops; i++) {
+        p_op = &p_script->p_ops[i];
+        p_op->count = 0;
+        p_op->fail = 0;
+        p_op->min_us = p_op->max_us = p_op->total_us = 0;
+    }
+    p_script->num_executed = 0;
+    p_script->num_failed = 0;
+    p_script->total_us = 0;
+
+    /* buffers are allocated once and reused by all operations */
+    rx_size = MAX(p_script->max_read, 4);
+    if (!p_script->is_rmi)
+        rx_size = MAX(rx_size, SCRIPT_TCM_MAX_PACKET);
+
+    p_xfer = malloc((size_t)(p_script->max_write + 3));
+    p_rx = malloc((size_t)rx_size);
+    if ((!p_xfer) || (!p_rx)) {
+        printf_e("%s error: fail to allocate the buffer\n", __func__);
+        retval = -ENOMEM;
+        goto exit;
+    }
+
+    begin_us = syna_get_time_ns() / 1000;
+
+    pc = 0;
+    while (pc < p_script->num_ops) {
+        p_op = &p_script->p_ops[pc];
+        is_failed = false;
+
+        switch (p_op->type) {
+            case SCRIPT_OP_READ:
+            case SCRIPT_OP_WRITE:
+                start_us = syna_get_time_ns() / 1000;
+                resp_bytes = script_do_access(p_script, p_op, p_xfer, p_rx, &p_resp);
+                is_failed = (resp_bytes < 0);
+
+                /* status of tcm write is checked here only if no expect follows */
+                is_expected = ((pc + 1 < p_script->num_ops) &&
+                               (SCRIPT_OP_EXPECT == p_script->p_ops[pc + 1].type));
+                if ((!is_failed) && (!p_script->is_rmi) &&
+                    (SCRIPT_OP_WRITE == p_op->type) && (!is_expected))
+                    is_failed = (STATUS_OK != p_resp[0]);
+
+                script_update_stats(p_op, (syna_get_time_ns() / 1000) - start_us, is_failed);
+                if (is_failed)
+                    printf_e("%s error: line %d is failed (%d)\n",
+                             __func__, p_op->line, resp_bytes);
+                break;
+
+            case SCRIPT_OP_EXPECT:
+                if (resp_bytes < p_op->length) {
+                    is_failed = true;
+                }
+                else {
+                    for (i = 0; i < p_op->length; i++) {
+                        if ((p_resp[i] ^ p_script->p_pool[p_op->offset + i]) &
+                            p_script->p_mask[p_op->offset + i]) {
+                            is_failed = true;
+                            break;
+                        }
+                    }
+                }
+                script_update_stats(p_op, 0, is_failed);
+                if (is_failed)
+                    printf_e("%s error: line %d, unexpected response\n", __func__, p_op->line);
+                break;
+
+            case SCRIPT_OP_WAIT:
+                start_us = syna_get_time_ns() / 1000;
+                if (p_op->code > 0)
+                    syna_bus_delay_us((unsigned int)p_op->code * 1000);
+                script_update_stats(p_op, (syna_get_time_ns() / 1000) - start_us, false);
+                break;
+
+            case SCRIPT_OP_LOOP:
+                script_update_stats(p_op, 0, false);
+                if (p_op->code == 0) {
+                    /* skip the whole block */
+                    for (i = pc + 1; i < p_script->num_ops; i++) {
+                        if ((SCRIPT_OP_END == p_script->p_ops[i].type) &&
+                            (p_script->p_ops[i].code == pc))
+                            break;
+                    }
+                    pc = i + 1;
+                    continue;
+                }
+                loop_index[depth] = pc;
+                loop_remaining[depth] = p_op->code;
+                depth += 1;
+                break;
+
+            case SCRIPT_OP_END:
+                loop_remaining[depth - 1] -= 1;
+                if (loop_remaining[depth - 1] > 0) {
+                    pc = loop_index[depth - 1] + 1;
+                    continue;
+                }
+                depth -= 1;
+                break;
+
+            default:
+                break;
+        }
+
+        if ((SCRIPT_OP_READ == p_op->type) || (SCRIPT_OP_WRITE == p_op->type))
+            p_script->num_executed += 1;
+
+        if (is_failed) {
+            p_script->num_failed += 1;
+            if (stop_on_fail)
+                break;
+        }
+
+        /* stop once the test job is cancelled */
+        if (syna_job_check_abort() < 0) {
+            printf_i("%s info: script is aborted at line %d\n", __func__, p_op->line);
+            break;
+        }
+
+        pc += 1;
+    }
+
+    p_script->total_us = (syna_get_time_ns() / 1000) - begin_us;
+
+    printf_i("%s info: %d commands in %lld us, %d failures\n", __func__,
+             p_script->num_executed, p_script->total_us, p_script->num_failed);
+
+    retval = p_script->num_failed;
+
+exit:
+    if (p_xfer)
+        free(p_xfer);
+    if (p_rx)
+        free(p_rx);
+
+    return retval;
+}
+
+/*
+ * Function:  syna_script_report
+ * --------------------
+ * output the timing of each operation, one line per operation
+ *
+ *   line,op,count,fail,min_us,avg_us,max_us
+ *
+ * return: <0, fail to output
+ *         otherwise, length of the report
+ */
+int syna_script_report(const struct syna_script *p_script, char *p_report, int size_report)
+{
+    static const char *op_names[] = {"read", "write", "wait", "loop", "end", "expect"};
+    const struct syna_script_op *p_op;
+    int len = 0;
+    int i;
+
+    if ((!p_script) || (!p_report) || (size_report <= 0))
+        return -EINVAL;
+
+    len += snprintf(p_report + len, (size_t)(size_report - len),
+                    "commands=%d,failures=%d,total_us=%lld\n"
+                    "line,op,count,fail,min_us,avg_us,max_us\n",
+                    p_script->num_executed, p_script->num_failed, p_script->total_us);
+
+    for (i = 0; (i < p_script->num_ops) && (len < size_report); i++) {
+        p_op = &p_script->p_ops[i];
+        if ((SCRIPT_OP_LOOP == p_op->type) || (SCRIPT_OP_END == p_op->type))
+            continue;
+
+        len += snprintf(p_report + len, (size_t)(size_report - len),
+                        "%d,%s,%d,%d,%lld,%lld,%lld\n",
+                        p_op->line, op_names[p_op->type], p_op->count, p_op->fail,
+                        p_op->min_us,
+                        (p_op->count > 0) ? (p_op->total_us / p_op->count) : 0,
+                        p_op->max_us);
+    }
+
+    if (len >= size_report) {
+        printf_i("%s info: report is truncated\n", __func__);
+        len = size_report - 1;
+    }
+
+    return len;
+}
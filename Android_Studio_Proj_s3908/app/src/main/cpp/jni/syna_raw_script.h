@@ -0,0 +1,112 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+
+#include <stdbool.h>
+
+#ifndef _SYNA_RAW_SCRIPT_H__
+#define _SYNA_RAW_SCRIPT_H__
+
+/* max. number of operations in one script */
+#define SYNA_SCRIPT_MAX_OPS         (4096)
+
+/* max. nesting of the loop blocks */
+#define SYNA_SCRIPT_MAX_LOOP_DEPTH  (8)
+
+/* deadline of one tcm command */
+#define SYNA_SCRIPT_TIMEOUT_MS      (1000)
+
+/* size of the text report */
+#define SYNA_SCRIPT_REPORT_LEN      (65536)
+
+/*
+ * operations of the script, the file is compatible with the one used by
+ * the raw command page; the first line is "rmi" or "tcm", and '#' starts
+ * a comment
+ *
+ *   rmi:  read <hex reg> <len>
+ *         write <hex reg> <hex data> ...
+ *   tcm:  read <len>
+ *         write <hex cmd> <hex data> ...
+ *   both: wait <ms>
+ *         loop <count>  ...  end
+ *         expect <hex data> ...
+ *
+ * "expect" asserts the response of the previous read/write, "xx" matches
+ * any byte. the response of tcm write is the status code followed by the
+ * payload, for example, "expect 01" for a command completed with STATUS_OK.
+ */
+enum syna_script_op_type {
+    SCRIPT_OP_READ = 0,
+    SCRIPT_OP_WRITE,
+    SCRIPT_OP_WAIT,
+    SCRIPT_OP_LOOP,
+    SCRIPT_OP_END,
+    SCRIPT_OP_EXPECT,
+};
+
+struct syna_script_op {
+    int type;
+    int line;             /* line number in the script file */
+    int code;             /* rmi reg, tcm command, wait time, loop count,
+                             or the index of the loop for SCRIPT_OP_END */
+    int offset;           /* offset of the data in the pool */
+    int length;           /* bytes to read, write or compare */
+    /* statistics of the execution */
+    int count;
+    int fail;
+    long long min_us;
+    long long max_us;
+    long long total_us;
+};
+
+struct syna_script {
+    bool is_rmi;
+    int num_ops;
+    struct syna_script_op *p_ops;
+    unsigned char *p_pool;        /* data to write and to compare */
+    unsigned char *p_mask;        /* 0 for the wildcard of expect */
+    int pool_size;
+    int pool_used;
+    int max_write;
+    int max_read;
+    long long total_us;
+    int num_executed;
+    int num_failed;
+};
+
+/* helper to parse the script file */
+int syna_script_load(const char *script_path, struct syna_script *p_script);
+void syna_script_release(struct syna_script *p_script);
+
+/* helper to execute the script */
+int syna_script_run(struct syna_script *p_script, bool stop_on_fail);
+
+/* helper to output the per-command timing */
+int syna_script_report(const struct syna_script *p_script, char *p_report, int size_report);
+
+#endif // _SYNA_RAW_SCRIPT_H__
@@ -0,0 +1,700 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "syna_dev_manager.h"
+#include "syna_ref_store.h"
+
+#ifdef SAVE_ERR_MSG
+#include "err_msg_ctrl.h"
+#endif
+
+#define REF_ALIGN(x) (((x) + 7) & ~7)
+
+#define REF_ENTRIES_STEP (16)
+
+/* variables of the reference store being used */
+struct ref_store {
+    bool is_opened;
+    char path[MAX_STRING_LEN];
+    unsigned char *p_image;       /* mapped from the store file */
+    size_t image_size;
+    struct syna_ref_store_header *p_header;
+    struct syna_ref_frame_entry *p_entries;
+};
+static struct ref_store g_ref_store;
+
+/*
+ * Function:  ref_check_image
+ * --------------------
+ * helper function to confirm the image of store file is valid
+ *
+ * return: true, the image is valid
+ */
+static bool ref_check_image(const unsigned char *p_image, size_t size)
+{
+    const struct syna_ref_store_header *p_header;
+    const struct syna_ref_frame_entry *p_entries;
+    unsigned int i;
+
+    if (size < sizeof(struct syna_ref_store_header))
+        return false;
+
+    p_header = (const struct syna_ref_store_header *)p_image;
+    if ((memcmp(p_header->magic, SYNA_REF_STORE_MAGIC, sizeof(p_header->magic)) != 0) ||
+        ((p_header->version != SYNA_REF_STORE_VERSION) &&
+         (p_header->version != SYNA_REF_STORE_VERSION_1)) ||
+        (p_header->header_size != sizeof(struct syna_ref_store_header)))
+        return false;
+
+    if ((p_header->total_size != size) || (p_header->num_entries > p_header->max_entries) ||
+        (p_header->entry_offset + (size_t)p_header->max_entries * sizeof(struct syna_ref_frame_entry) >
+         p_header->data_offset) ||
+        ((size_t)p_header->data_offset + p_header->data_size > size))
+        return false;
+
+    p_entries = (const struct syna_ref_frame_entry *)(p_image + p_header->entry_offset);
+    for (i = 0; i < p_header->num_entries; i++) {
+        if ((p_entries[i].product[SYNA_REF_PRODUCT_LEN - 1] != '\0') ||
+            (p_entries[i].config_id[SYNA_REF_CONFIG_ID_LEN - 1] != '\0') ||
+            (p_entries[i].offset % sizeof(short) != 0) ||
+            ((size_t)p_entries[i].offset + (size_t)p_entries[i].count * sizeof(short) >
+             p_header->data_size))
+            return false;
+    }
+
+    return true;
+}
+/*
+ * Function:  ref_build_image
+ * --------------------
+ * helper function to create a new image with the frames in the current store,
+ * plus the room of one more frame
+ * the frame data are packed, the frame skip_index is dropped if it is not negative
+ *
+ * return: <0, fail to allocate the image
+ *         otherwise, succeed
+ */
+static int ref_build_image(unsigned int max_entries, int skip_index, size_t extra_size,
+                           unsigned char **pp_image, size_t *p_image_size)
+{
+    struct syna_ref_store_header *p_header;
+    struct syna_ref_frame_entry *p_entries;
+    struct syna_ref_frame_entry *p_old;
+    unsigned char *p_image;
+    unsigned int num_entries = 0;
+    size_t entry_offset;
+    size_t data_offset;
+    size_t data_size = 0;
+    size_t frame_size;
+    size_t total_size;
+    unsigned int i;
+
+    /* size of frames being kept */
+    if (g_ref_store.is_opened) {
+        for (i = 0; i < g_ref_store.p_header->num_entries; i++) {
+            if ((int)i == skip_index)
+                continue;
+            data_size += REF_ALIGN(g_ref_store.p_entries[i].count * sizeof(short));
+        }
+    }
+
+    entry_offset = REF_ALIGN(sizeof(struct syna_ref_store_header));
+    data_offset = REF_ALIGN(entry_offset + sizeof(struct syna_ref_frame_entry) * max_entries);
+    total_size = data_offset + data_size + REF_ALIGN(extra_size);
+
+    p_image = calloc(1, total_size);
+    if (!p_image) {
+        printf_e("%s error: fail to allocate the image (size = %d)\n", __func__, (int)total_size);
+        return -ENOMEM;
+    }
+
+    p_entries = (struct syna_ref_frame_entry *)(p_image + entry_offset);
+
+    data_size = 0;
+    if (g_ref_store.is_opened) {
+        for (i = 0; i < g_ref_store.p_header->num_entries; i++) {
+            if ((int)i == skip_index)
+                continue;
+
+            p_old = &g_ref_store.p_entries[i];
+            frame_size = p_old->count * sizeof(short);
+
+            memcpy(&p_entries[num_entries], p_old, sizeof(struct syna_ref_frame_entry));
+            p_entries[num_entries].offset = (unsigned int)data_size;
+            memcpy(p_image + data_offset + data_size,
+                   g_ref_store.p_image + g_ref_store.p_header->data_offset + p_old->offset,
+                   frame_size);
+
+            data_size += REF_ALIGN(frame_size);
+            num_entries += 1;
+        }
+    }
+
+    p_header = (struct syna_ref_store_header *)p_image;
+    memcpy(p_header->magic, SYNA_REF_STORE_MAGIC, sizeof(p_header->magic));
+    p_header->version = SYNA_REF_STORE_VERSION;
+    p_header->header_size = sizeof(struct syna_ref_store_header);
+    p_header->num_entries = num_entries;
+    p_header->max_entries = max_entries;
+    p_header->entry_offset = (unsigned int)entry_offset;
+    p_header->data_offset = (unsigned int)data_offset;
+    p_header->data_size = (unsigned int)data_size;
+    p_header->total_size = (unsigned int)total_size;
+
+    *pp_image = p_image;
+    *p_image_size = total_size;
+
+    return 0;
+}
+/*
+ * Function:  ref_write_file
+ * --------------------
+ * helper function to save the image to the store file
+ * the image is written to a temporary file, and then renamed
+ *
+ * return: <0, fail to write the file
+ *         otherwise, succeed
+ */
+static int ref_write_file(const char *path, const unsigned char *p_image, size_t size)
+{
+    int fd;
+    ssize_t written;
+    size_t offset = 0;
+    char tmp_path[MAX_STRING_LEN + 4];
+
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+
+    fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0) {
+        printf_e("%s error: fail to create file, %s (err: %s)\n", __func__, tmp_path, strerror(errno));
+        return -EIO;
+    }
+
+    while (offset < size) {
+        written = write(fd, p_image + offset, size - offset);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            printf_e("%s error: fail to write file, %s (err: %s)\n", __func__, tmp_path, strerror(errno));
+            close(fd);
+            unlink(tmp_path);
+            return -EIO;
+        }
+        offset += (size_t)written;
+    }
+
+    if (fsync(fd) < 0) {
+        printf_e("%s error: fail to sync file, %s (err: %s)\n", __func__, tmp_path, strerror(errno));
+        close(fd);
+        unlink(tmp_path);
+        return -EIO;
+    }
+    close(fd);
+
+    if (rename(tmp_path, path) < 0) {
+        printf_e("%s error: fail to rename file, %s (err: %s)\n", __func__, path, strerror(errno));
+        unlink(tmp_path);
+        return -EIO;
+    }
+
+    return 0;
+}
+/*
+ * Function:  ref_map_file
+ * --------------------
+ * helper function to map the store file
+ * the mapping is shared, so the update in place is written back to the file
+ *
+ * return: -ENOENT, the file doesn't exist
+ *         -EINVAL, the file is not a valid store
+ *         <0, fail to open or map the file
+ *         otherwise, succeed
+ */
+static int ref_map_file(const char *path)
+{
+    int fd;
+    int err;
+    struct stat st;
+    void *p_map;
+
+    fd = open(path, O_RDWR);
+    if (fd < 0) {
+        err = errno;
+        if (err != ENOENT)
+            printf_e("%s error: fail to open the file, %s (err: %s)\n", __func__, path, strerror(err));
+        return -err;
+    }
+
+    if ((fstat(fd, &st) < 0) || (st.st_size < (off_t)sizeof(struct syna_ref_store_header))) {
+        close(fd);
+        return -EINVAL;
+    }
+
+    p_map = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p_map == MAP_FAILED) {
+        printf_e("%s error: fail to map the file, %s (err: %s)\n", __func__, path, strerror(errno));
+        return -EIO;
+    }
+
+    if (!ref_check_image(p_map, (size_t)st.st_size)) {
+        printf_e("%s error: invalid store file, %s\n", __func__, path);
+        munmap(p_map, (size_t)st.st_size);
+        return -EINVAL;
+    }
+
+    g_ref_store.p_image = p_map;
+    g_ref_store.image_size = (size_t)st.st_size;
+    g_ref_store.p_header = (struct syna_ref_store_header *)g_ref_store.p_image;
+    g_ref_store.p_entries = (struct syna_ref_frame_entry *)
+            (g_ref_store.p_image + g_ref_store.p_header->entry_offset);
+    g_ref_store.is_opened = true;
+
+    return 0;
+}
+/*
+ * Function:  ref_replace_file
+ * --------------------
+ * helper function to save the new image as the store file, and map it again
+ * pointers returned by syna_ref_store_find are invalid after calling
+ *
+ * return: <0, fail to replace the store file
+ *         otherwise, succeed
+ */
+static int ref_replace_file(unsigned char *p_image, size_t image_size)
+{
+    int retval;
+
+    retval = ref_write_file(g_ref_store.path, p_image, image_size);
+    if (retval < 0)
+        return retval;
+
+    if (g_ref_store.p_image)
+        munmap(g_ref_store.p_image, g_ref_store.image_size);
+
+    g_ref_store.p_image = NULL;
+    g_ref_store.p_header = NULL;
+    g_ref_store.p_entries = NULL;
+    g_ref_store.is_opened = false;
+
+    return ref_map_file(g_ref_store.path);
+}
+/*
+ * Function:  ref_migrate_v1
+ * --------------------
+ * helper function to convert the store of version 1 being mapped
+ * frames averaged from several captures are kept as captured ones; the source
+ * of a single frame is unknown, it was imported or captured once, so it is
+ * replaced if the test config has a frame of the test item
+ *
+ * return: <0, fail to convert the store file
+ *         otherwise, succeed
+ */
+static int ref_migrate_v1(void)
+{
+    int retval;
+    unsigned char *p_image = NULL;
+    size_t image_size = 0;
+    struct syna_ref_store_header *p_header;
+    struct syna_ref_frame_entry *p_entries;
+    unsigned int i;
+
+    retval = ref_build_image(g_ref_store.p_header->max_entries, -1, 0, &p_image, &image_size);
+    if (retval < 0)
+        return retval;
+
+    p_header = (struct syna_ref_store_header *)p_image;
+    p_entries = (struct syna_ref_frame_entry *)(p_image + p_header->entry_offset);
+    for (i = 0; i < p_header->num_entries; i++) {
+        p_entries[i].source_crc = (p_entries[i].num_averaged > 1) ?
+                0 : SYNA_REF_SOURCE_UNKNOWN;
+    }
+
+    retval = ref_replace_file(p_image, image_size);
+    free(p_image);
+
+    return retval;
+}
+/*
+ * Function:  ref_find_entry
+ * --------------------
+ * helper function to find the frame of the product, config id, test and kind
+ *
+ * return: <0, the frame is not found
+ *         otherwise, index of the frame entry
+ */
+static int ref_find_entry(const char *product, const char *config_id, int test_id, int kind)
+{
+    unsigned int i;
+    struct syna_ref_frame_entry *p_entry;
+
+    for (i = 0; i < g_ref_store.p_header->num_entries; i++) {
+        p_entry = &g_ref_store.p_entries[i];
+
+        if ((p_entry->test_id == test_id) && (p_entry->kind == kind) &&
+            (strcmp(p_entry->product, product) == 0) &&
+            (strcmp(p_entry->config_id, config_id) == 0))
+            return (int)i;
+    }
+    return -ENOENT;
+}
+/*
+ * Function:  syna_ref_store_close
+ * --------------------
+ * close the reference store
+ * pointers returned by syna_ref_store_find are invalid after calling
+ */
+void syna_ref_store_close(void)
+{
+    if (g_ref_store.p_image)
+        munmap(g_ref_store.p_image, g_ref_store.image_size);
+
+    memset(&g_ref_store, 0x00, sizeof(struct ref_store));
+}
+/*
+ * Function:  syna_ref_store_open
+ * --------------------
+ * open the reference store file, an empty store is created if the file
+ * doesn't exist; a store of version 1 is converted; an invalid file is
+ * renamed to <path>.bad and reported, then an empty store is created
+ *
+ * return: <0, fail to open the reference store
+ *         otherwise, the number of frames in the store
+ */
+int syna_ref_store_open(const char *path)
+{
+    int retval;
+    unsigned char *p_image = NULL;
+    size_t image_size = 0;
+    char bad_path[MAX_STRING_LEN + 4];
+#ifdef SAVE_ERR_MSG
+    char err[MAX_ERR_STRING_LEN];
+#endif
+
+    if ((!path) || (strlen(path) >= MAX_STRING_LEN - 4)) {
+        printf_e("%s error: invalid parameter\n", __func__);
+        return -EINVAL;
+    }
+
+    syna_ref_store_close();
+
+    strcpy(g_ref_store.path, path);
+
+    retval = ref_map_file(path);
+    if ((retval >= 0) && (g_ref_store.p_header->version == SYNA_REF_STORE_VERSION_1)) {
+        printf_i("%s: convert the store of version 1, %s\n", __func__, path);
+        retval = ref_migrate_v1();
+        if (retval < 0) {
+            printf_e("%s error: fail to convert the store file, %s\n", __func__, path);
+#ifdef SAVE_ERR_MSG
+            sprintf(err, "%s error: fail to convert the store file, %s\n", __func__, path);
+            add_error_msg(err);
+#endif
+            goto exit;
+        }
+    }
+    if (retval >= 0) {
+        printf_i("%s: %d frames in the store, %s\n", __func__,
+                 g_ref_store.p_header->num_entries, path);
+        return (int)g_ref_store.p_header->num_entries;
+    }
+
+    if (retval == -EINVAL) {
+        /* keep the invalid file aside rather than dropping its frames */
+        snprintf(bad_path, sizeof(bad_path), "%s.bad", path);
+        if (rename(path, bad_path) < 0) {
+            printf_e("%s error: fail to rename the invalid store file, %s (err: %s)\n",
+                     __func__, path, strerror(errno));
+            goto exit;
+        }
+        printf_e("%s error: invalid store file, renamed to %s\n", __func__, bad_path);
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: invalid store file, renamed to %s\n", __func__, bad_path);
+        add_error_msg(err);
+#endif
+    }
+    else if (retval != -ENOENT) {
+        printf_e("%s error: fail to open the store file, %s (%d)\n", __func__, path, retval);
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: fail to open the store file, %s (%d)\n", __func__, path, retval);
+        add_error_msg(err);
+#endif
+        goto exit;
+    }
+
+    /* create an empty store */
+    retval = ref_build_image(REF_ENTRIES_STEP, -1, 0, &p_image, &image_size);
+    if (retval < 0)
+        goto exit;
+
+    retval = ref_replace_file(p_image, image_size);
+    if (retval < 0) {
+        printf_e("%s error: fail to create the store file, %s\n", __func__, path);
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: fail to create the store file, %s\n", __func__, path);
+        add_error_msg(err);
+#endif
+        goto exit;
+    }
+
+    printf_i("%s: create an empty store, %s\n", __func__, path);
+
+exit:
+    free(p_image);
+
+    if (retval < 0)
+        syna_ref_store_close();
+
+    return retval;
+}
+/*
+ * Function:  syna_ref_store_is_opened
+ * --------------------
+ * return: true, the reference store is opened
+ */
+bool syna_ref_store_is_opened(void)
+{
+    return g_ref_store.is_opened;
+}
+/*
+ * Function:  syna_ref_store_find
+ * --------------------
+ * find the frame of the product, config id, test and kind
+ * pp_frame points to the frame in the mapped store, no copy is made.
+ * the pointer is valid until the store is closed or a frame is added.
+ *
+ * return: <0, the frame is not found, or the size is mismatched
+ *         otherwise, the number of data
+ */
+int syna_ref_store_find(const char *product, const char *config_id, int test_id, int kind,
+                        int col, int row, short **pp_frame)
+{
+    int index;
+    struct syna_ref_frame_entry *p_entry;
+
+    if (!g_ref_store.is_opened || !product || !config_id || !pp_frame)
+        return -EINVAL;
+
+    index = ref_find_entry(product, config_id, test_id, kind);
+    if (index < 0)
+        return index;
+
+    p_entry = &g_ref_store.p_entries[index];
+    if ((p_entry->col != col) || (p_entry->row != row)) {
+        printf_e("%s error: size is mismatched, (%d, %d) in the store, (%d, %d) requested\n",
+                 __func__, p_entry->col, p_entry->row, col, row);
+        return -EINVAL;
+    }
+
+    *pp_frame = (short *)(g_ref_store.p_image + g_ref_store.p_header->data_offset +
+                          p_entry->offset);
+
+    return (int)p_entry->count;
+}
+/*
+ * Function:  syna_ref_store_get_source
+ * --------------------
+ * get the source of the frame of the product, config id, test and kind,
+ * the crc32 of the frame imported from the test config, or 0 if the frame
+ * is averaged from the captures
+ *
+ * return: <0, the frame is not found, or the size is mismatched
+ *         otherwise, succeed
+ */
+int syna_ref_store_get_source(const char *product, const char *config_id, int test_id, int kind,
+                              int col, int row, unsigned int *p_source_crc)
+{
+    int index;
+    struct syna_ref_frame_entry *p_entry;
+
+    if (!g_ref_store.is_opened || !product || !config_id || !p_source_crc)
+        return -EINVAL;
+
+    index = ref_find_entry(product, config_id, test_id, kind);
+    if (index < 0)
+        return index;
+
+    p_entry = &g_ref_store.p_entries[index];
+    if ((p_entry->col != col) || (p_entry->row != row))
+        return -EINVAL;
+
+    *p_source_crc = p_entry->source_crc;
+
+    return 0;
+}
+/*
+ * Function:  syna_ref_store_update
+ * --------------------
+ * update the frame of the product, config id, test and kind with the average of
+ * num_frames frames, p_frames is an array of (col * row * num_frames) data.
+ * import a frame by passing num_frames = 1, and the crc32 of the frame in
+ * the test config as source_crc; pass 0 if the frames are captured.
+ *
+ * the frame is overwritten in place if the size is not changed; otherwise,
+ * the store file is re-created, pointers returned by syna_ref_store_find are
+ * invalid then.
+ *
+ * return: <0, fail to update the frame
+ *         otherwise, succeed
+ */
+int syna_ref_store_update(const char *product, const char *config_id, int test_id, int kind,
+                          int col, int row, const int *p_frames, int num_frames,
+                          unsigned int source_crc)
+{
+    int retval = 0;
+    int index;
+    int i, n;
+    int count = col * row;
+    long long sum;
+    short *p_frame = NULL;
+    unsigned char *p_image = NULL;
+    size_t image_size = 0;
+    unsigned int max_entries;
+    struct syna_ref_store_header *p_new_header;
+    struct syna_ref_frame_entry *p_entry;
+#ifdef SAVE_ERR_MSG
+    char err[MAX_ERR_STRING_LEN];
+#endif
+
+    if (!g_ref_store.is_opened) {
+        printf_e("%s error: reference store is not opened\n", __func__);
+        return -ENODEV;
+    }
+
+    if ((!product) || (!config_id) || (!p_frames) || (col <= 0) || (row <= 0) || (num_frames <= 0) ||
+        (strlen(product) >= SYNA_REF_PRODUCT_LEN) || (strlen(config_id) >= SYNA_REF_CONFIG_ID_LEN)) {
+        printf_e("%s error: invalid parameter\n", __func__);
+        return -EINVAL;
+    }
+
+    p_frame = calloc((size_t)count, sizeof(short));
+    if (!p_frame) {
+        printf_e("%s error: can't allocate memory for the frame\n", __func__);
+        return -ENOMEM;
+    }
+
+    /* average the frames, rounding to the nearest */
+    for (i = 0; i < count; i++) {
+        sum = 0;
+        for (n = 0; n < num_frames; n++)
+            sum += p_frames[n * count + i];
+
+        if (sum >= 0)
+            sum = (sum + num_frames / 2) / num_frames;
+        else
+            sum = -((-sum + num_frames / 2) / num_frames);
+
+        if (sum > 32767)
+            sum = 32767;
+        else if (sum < -32768)
+            sum = -32768;
+
+        p_frame[i] = (short)sum;
+    }
+
+    index = ref_find_entry(product, config_id, test_id, kind);
+
+    /* overwrite in place */
+    if ((index >= 0) && (g_ref_store.p_entries[index].count == (unsigned int)count)) {
+        p_entry = &g_ref_store.p_entries[index];
+    }
+    /* add the frame to a re-created store file */
+    else {
+        max_entries = g_ref_store.p_header->max_entries;
+        if ((index < 0) && (g_ref_store.p_header->num_entries >= max_entries))
+            max_entries += REF_ENTRIES_STEP;
+
+        retval = ref_build_image(max_entries, index, (size_t)count * sizeof(short),
+                                 &p_image, &image_size);
+        if (retval < 0)
+            goto exit;
+
+        /* append the new entry, the frame data is filled after mapping */
+        p_new_header = (struct syna_ref_store_header *)p_image;
+        p_entry = (struct syna_ref_frame_entry *)(p_image + p_new_header->entry_offset) +
+                  p_new_header->num_entries;
+        memset(p_entry, 0x00, sizeof(struct syna_ref_frame_entry));
+        strcpy(p_entry->product, product);
+        strcpy(p_entry->config_id, config_id);
+        p_entry->test_id = test_id;
+        p_entry->kind = kind;
+        p_entry->offset = p_new_header->data_size;
+        p_entry->count = (unsigned int)count;
+
+        p_new_header->num_entries += 1;
+        p_new_header->data_size += (unsigned int)REF_ALIGN((size_t)count * sizeof(short));
+
+        retval = ref_replace_file(p_image, image_size);
+        if (retval < 0) {
+            printf_e("%s error: fail to save the store file, %s\n", __func__, g_ref_store.path);
+#ifdef SAVE_ERR_MSG
+            sprintf(err, "%s error: fail to save the store file, %s\n", __func__, g_ref_store.path);
+            add_error_msg(err);
+#endif
+            goto exit;
+        }
+
+        index = ref_find_entry(product, config_id, test_id, kind);
+        if (index < 0) {
+            retval = -EIO;
+            goto exit;
+        }
+        p_entry = &g_ref_store.p_entries[index];
+    }
+
+    p_entry->col = col;
+    p_entry->row = row;
+    p_entry->num_averaged = (unsigned int)num_frames;
+    p_entry->source_crc = source_crc;
+    memcpy(g_ref_store.p_image + g_ref_store.p_header->data_offset + p_entry->offset,
+           p_frame, (size_t)count * sizeof(short));
+
+    if (msync(g_ref_store.p_image, g_ref_store.image_size, MS_SYNC) < 0) {
+        printf_e("%s error: fail to sync the store file, %s (err: %s)\n", __func__,
+                 g_ref_store.path, strerror(errno));
+        retval = -EIO;
+        goto exit;
+    }
+
+    printf_i("%s: test 0x%x, kind %d, (%d, %d) is updated with %d frames\n", __func__,
+             test_id, kind, col, row, num_frames);
+
+exit:
+    free(p_frame);
+    free(p_image);
+
+    return retval;
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+#include <stdbool.h>
+
+#ifndef _SYNA_REF_STORE_H__
+#define _SYNA_REF_STORE_H__
+
+#define SYNA_REF_STORE_MAGIC     "SYNAREFS"
+#define SYNA_REF_STORE_VERSION   (2)
+
+/* version 1 is the same layout, but the source_crc was reserved */
+#define SYNA_REF_STORE_VERSION_1 (1)
+
+/* source_crc of the frame migrated from version 1, whose source is unknown */
+#define SYNA_REF_SOURCE_UNKNOWN  (0xFFFFFFFFu)
+
+/* max. length of the product, the device id */
+#define SYNA_REF_PRODUCT_LEN     (32)
+
+/* max. length of the config id string, e.g. "00-11-22-..." */
+#define SYNA_REF_CONFIG_ID_LEN   (200)
+
+/* kind of the frame kept in the store */
+enum SYNA_REF_KIND {
+    SYNA_REF_KIND_REFERENCE = 0,
+    SYNA_REF_KIND_BASELINE = 1,
+};
+
+/*
+ * layout of the reference store, which is the same as the file
+ *
+ *  [header]
+ *  [frame entries] ... max_entries slots, num_entries are used
+ *  [frame data]    ... short data of all frames
+ *
+ * the file is mapped shared, so the frames updated in place
+ * are written back without any copy to the caller.
+ */
+struct syna_ref_store_header {
+    char magic[8];
+    unsigned int version;
+    unsigned int header_size;
+    unsigned int num_entries;
+    unsigned int max_entries;
+    unsigned int entry_offset;    /* offset of frame entries, in bytes */
+    unsigned int data_offset;     /* offset of frame data, in bytes */
+    unsigned int data_size;       /* size of frame data being used, in bytes */
+    unsigned int total_size;
+};
+
+struct syna_ref_frame_entry {
+    char product[SYNA_REF_PRODUCT_LEN];
+    char config_id[SYNA_REF_CONFIG_ID_LEN];
+    int test_id;
+    int kind;                     /* enum SYNA_REF_KIND */
+    int col;
+    int row;
+    unsigned int offset;          /* offset of the frame in frame data, in bytes */
+    unsigned int count;           /* number of short data */
+    unsigned int num_averaged;    /* number of frames averaged, 1 if it is imported */
+    unsigned int source_crc;      /* crc32 of the frame imported from the test config, */
+                                  /* 0 if it is averaged from the captures */
+};
+
+/* helper to keep the reference frames of the production tests */
+int syna_ref_store_open(const char *path);
+void syna_ref_store_close(void);
+bool syna_ref_store_is_opened(void);
+int syna_ref_store_find(const char *product, const char *config_id, int test_id, int kind,
+                        int col, int row, short **pp_frame);
+int syna_ref_store_get_source(const char *product, const char *config_id, int test_id, int kind,
+                              int col, int row, unsigned int *p_source_crc);
+int syna_ref_store_update(const char *product, const char *config_id, int test_id, int kind,
+                          int col, int row, const int *p_frames, int num_frames,
+                          unsigned int source_crc);
+
+#endif // _SYNA_REF_STORE_H__
@@ -0,0 +1,532 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "syna_dev_manager.h"
+#include "syna_test_job.h"
+
+#ifdef SAVE_ERR_MSG
+#include "err_msg_ctrl.h"
+#endif
+
+/* variables of the test job */
+struct test_job {
+    int handle;
+    int state;
+    int col;
+    int row;
+    int num_tests;
+    int current;
+    int completed;
+    bool is_scheduled;
+    int order[SYNA_JOB_MAX_TESTS];  /* index of the test to run in order */
+    struct syna_job_test tests[SYNA_JOB_MAX_TESTS];
+
+    bool is_thread_created;
+    pthread_t thread;
+    pthread_t thread_self;      /* saved by the job thread itself */
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+
+    /* abort control, checked by the polling loops in the job thread */
+    volatile bool is_cancel;
+    volatile bool is_abort_enabled;
+    volatile long long deadline_ns;
+    volatile int abort_code;
+};
+static struct test_job g_job = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+};
+static int g_job_next_handle = 1;
+
+/*
+ * Function:  job_free_tests
+ * --------------------
+ * helper function to release the buffers of all tests
+ */
+static void job_free_tests(void)
+{
+    int i;
+
+    for (i = 0; i < SYNA_JOB_MAX_TESTS; i++) {
+        free(g_job.tests[i].p_result);
+        free(g_job.tests[i].p_aux);
+    }
+    memset(g_job.tests, 0x00, sizeof(g_job.tests));
+}
+/*
+ * Function:  syna_job_check_abort
+ * --------------------
+ * check whether the test being run should be stopped
+ * only the job thread is affected, the calls from other threads always continue
+ *
+ * return: -ECANCELED, the job is cancelled
+ *         -ETIMEDOUT, the test is over its deadline
+ *         0, continue
+ */
+int syna_job_check_abort(void)
+{
+    long long deadline_ns;
+
+    if (!g_job.is_abort_enabled)
+        return 0;
+
+    if (!pthread_equal(pthread_self(), g_job.thread_self))
+        return 0;
+
+    if (g_job.is_cancel) {
+        g_job.abort_code = -ECANCELED;
+        return -ECANCELED;
+    }
+
+    deadline_ns = g_job.deadline_ns;
+    if ((deadline_ns > 0) && (syna_get_time_ns() > deadline_ns)) {
+        g_job.abort_code = -ETIMEDOUT;
+        return -ETIMEDOUT;
+    }
+
+    return 0;
+}
+/*
+ * Function:  syna_job_is_running
+ * --------------------
+ * check whether the job thread is running the tests
+ *
+ * return: true, if running
+ */
+bool syna_job_is_running(void)
+{
+    bool is_running;
+
+    pthread_mutex_lock(&g_job.mutex);
+    is_running = (g_job.state == JOB_STATE_RUNNING);
+    pthread_mutex_unlock(&g_job.mutex);
+
+    return is_running;
+}
+/*
+ * Function:  job_thread
+ * --------------------
+ * the job thread to run all tests in order
+ * the limits of each test are taken from the limit store
+ * if the job is scheduled, the device transitions between tests are controlled by the test plan
+ */
+static void *job_thread(void *arg)
+{
+    int i, k;
+    int retval;
+    int next_test_id;
+    long long start_ns;
+    struct syna_job_test *p_test;
+
+    g_job.thread_self = pthread_self();
+
+    if (g_job.is_scheduled)
+        syna_plan_begin();
+
+    for (k = 0; k < g_job.num_tests; k++) {
+        i = g_job.order[k];
+        p_test = &g_job.tests[i];
+
+        pthread_mutex_lock(&g_job.mutex);
+        if (g_job.is_cancel) {
+            pthread_mutex_unlock(&g_job.mutex);
+            break;
+        }
+        g_job.current = i;
+        p_test->state = JOB_TEST_RUNNING;
+        pthread_mutex_unlock(&g_job.mutex);
+
+        printf_i("%s: test 0x%x (%d/%d), deadline = %d ms\n", __func__,
+                 p_test->test_id, i + 1, g_job.num_tests, p_test->deadline_ms);
+
+        start_ns = syna_get_time_ns();
+
+        g_job.abort_code = 0;
+        g_job.deadline_ns = (p_test->deadline_ms > 0) ?
+                start_ns + (long long)p_test->deadline_ms * 1000000LL : 0;
+        g_job.is_abort_enabled = true;
+
+        if (g_job.is_scheduled) {
+            next_test_id = (k + 1 < g_job.num_tests) ?
+                    g_job.tests[g_job.order[k + 1]].test_id : -1;
+            syna_plan_set_test(p_test->test_id, next_test_id);
+        }
+
+        /* the limit minimum is taken from the limit store, if the test has no pin's result */
+        if (syna_test_has_pins_result(p_test->test_id))
+            retval = syna_run_test_entry(p_test->test_id, p_test->p_result, p_test->size_result,
+                                         g_job.col, g_job.row,
+                                         p_test->p_aux, p_test->size_aux, NULL, 0);
+        else
+            retval = syna_run_test_entry(p_test->test_id, p_test->p_result, p_test->size_result,
+                                         g_job.col, g_job.row, NULL, 0, NULL, 0);
+
+        g_job.is_abort_enabled = false;
+        g_job.deadline_ns = 0;
+
+        pthread_mutex_lock(&g_job.mutex);
+        p_test->retval = retval;
+        p_test->elapsed_ms = (int)((syna_get_time_ns() - start_ns) / 1000000LL);
+
+        if (g_job.abort_code == -ECANCELED)
+            p_test->state = JOB_TEST_CANCELLED;
+        else if (g_job.abort_code == -ETIMEDOUT)
+            p_test->state = JOB_TEST_TIMEOUT;
+        else if (retval < 0)
+            p_test->state = JOB_TEST_ERROR;
+        else
+            p_test->state = (retval == 0) ? JOB_TEST_PASS : JOB_TEST_FAIL;
+
+        g_job.completed = k + 1;
+        pthread_mutex_unlock(&g_job.mutex);
+
+        printf_i("%s: test 0x%x done, state = %d, retval = %d, %d ms\n", __func__,
+                 p_test->test_id, p_test->state, retval, p_test->elapsed_ms);
+
+        /* command may be still in progress, reset to bring the device back */
+        /* in the test plan, the skipped reset is also unsafe if the test failed */
+        if ((g_job.abort_code < 0) || (g_job.is_scheduled && (retval < 0)))
+            syna_do_sw_reset();
+    }
+
+    if (g_job.is_scheduled)
+        syna_plan_end();
+
+    pthread_mutex_lock(&g_job.mutex);
+    for (i = 0; i < g_job.num_tests; i++) {
+        if (g_job.tests[i].state == JOB_TEST_PENDING)
+            g_job.tests[i].state = JOB_TEST_CANCELLED;
+    }
+    g_job.state = (g_job.is_cancel) ? JOB_STATE_CANCELLED : JOB_STATE_DONE;
+    pthread_cond_broadcast(&g_job.cond);
+    pthread_mutex_unlock(&g_job.mutex);
+
+    return NULL;
+}
+/*
+ * Function:  syna_job_submit
+ * --------------------
+ * submit a list of production tests, which are run in a background thread
+ * the test limits are taken from the limit store
+ * the device should be opened and prepared, and must not be accessed until the job is done
+ * if is_scheduled is true, the tests are re-ordered by the test plan to reduce
+ * the resets and the mode switches; the results are kept in the submitted order
+ *
+ * return: <0, fail to submit the job
+ *         otherwise, the handle of job
+ */
+int syna_job_submit(const int *p_test_ids, const int *p_deadlines_ms,
+                    const int *p_result_sizes, const int *p_aux_sizes, int num_tests,
+                    int col, int row, bool is_scheduled)
+{
+    int retval;
+    int i;
+    struct syna_job_test *p_test;
+#ifdef SAVE_ERR_MSG
+    char err[MAX_ERR_STRING_LEN];
+#endif
+
+    if (!p_test_ids || !p_result_sizes || (num_tests <= 0) || (num_tests > SYNA_JOB_MAX_TESTS)) {
+        printf_e("%s error: invalid parameter (num_tests = %d)\n", __func__, num_tests);
+        return -EINVAL;
+    }
+
+    pthread_mutex_lock(&g_job.mutex);
+    if (g_job.state == JOB_STATE_RUNNING) {
+        pthread_mutex_unlock(&g_job.mutex);
+        printf_e("%s error: job %d is still running\n", __func__, g_job.handle);
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: job %d is still running\n", __func__, g_job.handle);
+        add_error_msg(err);
+#endif
+        return -EBUSY;
+    }
+    pthread_mutex_unlock(&g_job.mutex);
+
+    /* join the previous job thread and release its results */
+    if (g_job.is_thread_created) {
+        pthread_join(g_job.thread, NULL);
+        g_job.is_thread_created = false;
+    }
+    job_free_tests();
+
+    for (i = 0; i < num_tests; i++) {
+        p_test = &g_job.tests[i];
+        p_test->test_id = p_test_ids[i];
+        p_test->deadline_ms = (p_deadlines_ms) ? p_deadlines_ms[i] : 0;
+        p_test->state = JOB_TEST_PENDING;
+        p_test->size_result = p_result_sizes[i];
+        p_test->size_aux = (p_aux_sizes) ? p_aux_sizes[i] : 0;
+
+        if (p_test->size_result > 0)
+            p_test->p_result = calloc((size_t)p_test->size_result, sizeof(int));
+        if (p_test->size_aux > 0)
+            p_test->p_aux = calloc((size_t)p_test->size_aux, sizeof(int));
+
+        if (((p_test->size_result > 0) && !p_test->p_result) ||
+            ((p_test->size_aux > 0) && !p_test->p_aux)) {
+            printf_e("%s error: fail to allocate the buffer of test 0x%x\n", __func__, p_test->test_id);
+            job_free_tests();
+            return -ENOMEM;
+        }
+    }
+
+    if (is_scheduled) {
+        syna_plan_test_order(p_test_ids, num_tests, g_job.order);
+    }
+    else {
+        for (i = 0; i < num_tests; i++)
+            g_job.order[i] = i;
+    }
+
+    g_job.handle = g_job_next_handle++;
+    g_job.num_tests = num_tests;
+    g_job.col = col;
+    g_job.row = row;
+    g_job.current = 0;
+    g_job.completed = 0;
+    g_job.is_scheduled = is_scheduled;
+    g_job.is_cancel = false;
+    g_job.is_abort_enabled = false;
+    g_job.deadline_ns = 0;
+    g_job.abort_code = 0;
+    g_job.state = JOB_STATE_RUNNING;
+
+    retval = pthread_create(&g_job.thread, NULL, job_thread, NULL);
+    if (retval != 0) {
+        printf_e("%s error: fail to create the job thread (err: %d)\n", __func__, retval);
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: fail to create the job thread (err: %d)\n", __func__, retval);
+        add_error_msg(err);
+#endif
+        g_job.state = JOB_STATE_IDLE;
+        job_free_tests();
+        return -retval;
+    }
+    g_job.is_thread_created = true;
+
+    printf_i("%s: job %d is submitted, %d tests\n", __func__, g_job.handle, num_tests);
+
+    return g_job.handle;
+}
+/*
+ * Function:  syna_job_cancel
+ * --------------------
+ * request to cancel the job
+ * the test being run stops at the next polling, the remaining tests are skipped
+ *
+ * return: <0, invalid handle
+ *         otherwise, succeed
+ */
+int syna_job_cancel(int handle)
+{
+    if ((handle <= 0) || (handle != g_job.handle))
+        return -EINVAL;
+
+    pthread_mutex_lock(&g_job.mutex);
+    if (g_job.state == JOB_STATE_RUNNING)
+        g_job.is_cancel = true;
+    pthread_mutex_unlock(&g_job.mutex);
+
+    return 0;
+}
+/*
+ * Function:  syna_job_wait
+ * --------------------
+ * wait for the job completion
+ * timeout_ms <= 0 means waiting forever
+ *
+ * return: <0, invalid handle or timeout
+ *         otherwise, the state of job
+ */
+int syna_job_wait(int handle, int timeout_ms)
+{
+    int retval = 0;
+    int state;
+    struct timespec ts;
+
+    if ((handle <= 0) || (handle != g_job.handle))
+        return -EINVAL;
+
+    if (timeout_ms > 0) {
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_sec += timeout_ms / 1000;
+        ts.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+        if (ts.tv_nsec >= 1000000000L) {
+            ts.tv_sec += 1;
+            ts.tv_nsec -= 1000000000L;
+        }
+    }
+
+    pthread_mutex_lock(&g_job.mutex);
+    while ((g_job.state == JOB_STATE_RUNNING) && (retval == 0)) {
+        if (timeout_ms > 0)
+            retval = pthread_cond_timedwait(&g_job.cond, &g_job.mutex, &ts);
+        else
+            retval = pthread_cond_wait(&g_job.cond, &g_job.mutex);
+    }
+    state = g_job.state;
+    pthread_mutex_unlock(&g_job.mutex);
+
+    if (state == JOB_STATE_RUNNING)
+        return -ETIMEDOUT;
+
+    return state;
+}
+/*
+ * Function:  syna_job_release
+ * --------------------
+ * cancel the job if it is running, and release all its resources
+ *
+ * return: <0, invalid handle
+ *         otherwise, succeed
+ */
+int syna_job_release(int handle)
+{
+    if ((handle <= 0) || (handle != g_job.handle))
+        return -EINVAL;
+
+    syna_job_cancel(handle);
+
+    if (g_job.is_thread_created) {
+        pthread_join(g_job.thread, NULL);
+        g_job.is_thread_created = false;
+    }
+
+    pthread_mutex_lock(&g_job.mutex);
+    job_free_tests();
+    g_job.num_tests = 0;
+    g_job.state = JOB_STATE_IDLE;
+    g_job.handle = 0;
+    pthread_mutex_unlock(&g_job.mutex);
+
+    return 0;
+}
+/*
+ * Function:  syna_job_get_progress
+ * --------------------
+ * get the progress of the job
+ * the order of values follows enum SYNA_JOB_PROGRESS_INFO
+ *
+ * return: <0, invalid parameter
+ *         otherwise, the number of values
+ */
+int syna_job_get_progress(int handle, int *p_info, int size)
+{
+    int info[JOB_INFO_MAX];
+
+    if ((handle <= 0) || (handle != g_job.handle) || !p_info)
+        return -EINVAL;
+
+    pthread_mutex_lock(&g_job.mutex);
+    info[JOB_INFO_STATE] = g_job.state;
+    info[JOB_INFO_CURRENT] = g_job.current;
+    info[JOB_INFO_COMPLETED] = g_job.completed;
+    info[JOB_INFO_NUM_TESTS] = g_job.num_tests;
+    pthread_mutex_unlock(&g_job.mutex);
+
+    size = MIN(size, JOB_INFO_MAX);
+    memcpy(p_info, info, sizeof(int) * size);
+
+    return size;
+}
+/*
+ * Function:  syna_job_get_test_info
+ * --------------------
+ * get the state of the test in the job
+ * the order of values follows enum SYNA_JOB_TEST_INFO
+ *
+ * return: <0, invalid parameter
+ *         otherwise, the number of values
+ */
+int syna_job_get_test_info(int handle, int index, int *p_info, int size)
+{
+    int info[JOB_TEST_INFO_MAX];
+    struct syna_job_test *p_test;
+
+    if ((handle <= 0) || (handle != g_job.handle) || !p_info ||
+        (index < 0) || (index >= g_job.num_tests))
+        return -EINVAL;
+
+    pthread_mutex_lock(&g_job.mutex);
+    p_test = &g_job.tests[index];
+    info[JOB_TEST_INFO_ID] = p_test->test_id;
+    info[JOB_TEST_INFO_STATE] = p_test->state;
+    info[JOB_TEST_INFO_RETVAL] = p_test->retval;
+    info[JOB_TEST_INFO_ELAPSED_MS] = p_test->elapsed_ms;
+    pthread_mutex_unlock(&g_job.mutex);
+
+    size = MIN(size, JOB_TEST_INFO_MAX);
+    memcpy(p_info, info, sizeof(int) * size);
+
+    return size;
+}
+/*
+ * Function:  syna_job_get_test_result
+ * --------------------
+ * copy the result data of the completed test
+ * if is_aux is true, the auxiliary buffer is copied, e.g. the pin's result
+ *
+ * return: <0, invalid parameter or the test is not completed
+ *         otherwise, the number of data copied
+ */
+int syna_job_get_test_result(int handle, int index, bool is_aux, int *p_out, int size)
+{
+    int retval;
+    struct syna_job_test *p_test;
+
+    if ((handle <= 0) || (handle != g_job.handle) || !p_out ||
+        (index < 0) || (index >= g_job.num_tests))
+        return -EINVAL;
+
+    pthread_mutex_lock(&g_job.mutex);
+    p_test = &g_job.tests[index];
+    if ((p_test->state == JOB_TEST_PENDING) || (p_test->state == JOB_TEST_RUNNING)) {
+        retval = -EBUSY;
+    }
+    else if (is_aux) {
+        retval = MIN(size, p_test->size_aux);
+        if (retval > 0)
+            memcpy(p_out, p_test->p_aux, sizeof(int) * retval);
+    }
+    else {
+        retval = MIN(size, p_test->size_result);
+        if (retval > 0)
+            memcpy(p_out, p_test->p_result, sizeof(int) * retval);
+    }
+    pthread_mutex_unlock(&g_job.mutex);
+
+    return retval;
+}
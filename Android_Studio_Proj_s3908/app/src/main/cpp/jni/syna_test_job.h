@@ -0,0 +1,106 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+#include <stdbool.h>
+
+#ifndef _SYNA_TEST_JOB_H__
+#define _SYNA_TEST_JOB_H__
+
+#define SYNA_JOB_MAX_TESTS  (32)
+
+/*
+ * state of the test job
+ * must be equivalent to the same id in java layer
+ */
+enum SYNA_JOB_STATE {
+    JOB_STATE_IDLE = 0,
+    JOB_STATE_RUNNING,
+    JOB_STATE_DONE,
+    JOB_STATE_CANCELLED,
+};
+
+/*
+ * state of each test in the job
+ * must be equivalent to the same id in java layer
+ */
+enum SYNA_JOB_TEST_STATE {
+    JOB_TEST_PENDING = 0,
+    JOB_TEST_RUNNING,
+    JOB_TEST_PASS,
+    JOB_TEST_FAIL,
+    JOB_TEST_ERROR,
+    JOB_TEST_CANCELLED,
+    JOB_TEST_TIMEOUT,
+};
+
+/* order of the job progress, used by syna_job_get_progress */
+enum SYNA_JOB_PROGRESS_INFO {
+    JOB_INFO_STATE = 0,
+    JOB_INFO_CURRENT,           /* index of the test being run */
+    JOB_INFO_COMPLETED,         /* number of tests completed */
+    JOB_INFO_NUM_TESTS,
+    JOB_INFO_MAX,
+};
+
+/* order of the test information, used by syna_job_get_test_info */
+enum SYNA_JOB_TEST_INFO {
+    JOB_TEST_INFO_ID = 0,
+    JOB_TEST_INFO_STATE,
+    JOB_TEST_INFO_RETVAL,
+    JOB_TEST_INFO_ELAPSED_MS,
+    JOB_TEST_INFO_MAX,
+};
+
+/* one test in the job */
+struct syna_job_test {
+    int test_id;
+    int deadline_ms;            /* 0, no deadline */
+    int state;
+    int retval;
+    int elapsed_ms;
+    int *p_result;
+    int size_result;
+    int *p_aux;                 /* pin's result, passed as limit_1 to the trx short tests only */
+    int size_aux;
+};
+
+/* helper to run the production tests in a background thread */
+int syna_job_submit(const int *p_test_ids, const int *p_deadlines_ms,
+                    const int *p_result_sizes, const int *p_aux_sizes, int num_tests,
+                    int col, int row, bool is_scheduled);
+int syna_job_cancel(int handle);
+int syna_job_wait(int handle, int timeout_ms);
+int syna_job_release(int handle);
+int syna_job_get_progress(int handle, int *p_info, int size);
+int syna_job_get_test_info(int handle, int index, int *p_info, int size);
+int syna_job_get_test_result(int handle, int index, bool is_aux, int *p_out, int size);
+bool syna_job_is_running(void);
+
+/* called by the polling loops, to stop waiting once the job is cancelled or over the deadline */
+int syna_job_check_abort(void);
+
+#endif // _SYNA_TEST_JOB_H__
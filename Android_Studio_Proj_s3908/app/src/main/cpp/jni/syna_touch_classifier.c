@@ -0,0 +1,325 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "syna_dev_manager.h"
+#include "syna_touch_classifier.h"
+
+/* touch threshold if it is learned from the noise */
+#define TOUCH_MIN_THRESHOLD   (30)
+#define TOUCH_NOISE_FACTOR    (5)
+#define TOUCH_NOISE_FRAMES    (8)
+
+#define TOUCH_ABS(x) (((x) < 0) ? -(x) : (x))
+
+/*
+ * variables of the touch classifier
+ *
+ * the frames are classified by the max. delta and the centroid around it.
+ * a contact is stable once the peak and centroid stay close to the values
+ * at the start of the run for stable_frames frames; any larger change
+ * restarts the run. the lift-off is detected at half of the threshold,
+ * and the panel should keep quiet for settle_frames before the frames
+ * are taken as untouched again.
+ */
+struct touch_classifier {
+    bool is_initialized;
+    int col;
+    int row;
+    int num_tixels;
+
+    int threshold;              /* 0, learned from the peak noise of untouched frames */
+    int stable_frames;
+    int stable_distance;
+    int stable_percent;
+    int settle_frames;
+
+    int state;                  /* enum SYNA_TOUCH_CLASS */
+    int stable_count;
+    int quiet_count;
+    int noise_x16;              /* weighted mean of the peak noise, in 1/16 count */
+    int noise_frames;
+
+    /* contact at the start of the steady run */
+    int ref_peak;
+    int ref_x;
+    int ref_y;
+};
+static struct touch_classifier g_classifier;
+
+/*
+ * Function:  touch_get_threshold
+ * --------------------
+ * helper function to get the touch threshold being used
+ */
+static int touch_get_threshold(void)
+{
+    struct touch_classifier *p = &g_classifier;
+    int threshold;
+
+    if (p->threshold > 0)
+        return p->threshold;
+
+    threshold = TOUCH_NOISE_FACTOR * p->noise_x16 / 16;
+    return (threshold > TOUCH_MIN_THRESHOLD) ? threshold : TOUCH_MIN_THRESHOLD;
+}
+/*
+ * Function:  touch_update_noise
+ * --------------------
+ * helper function to learn the peak noise from the quiet frames
+ */
+static void touch_update_noise(int peak)
+{
+    struct touch_classifier *p = &g_classifier;
+
+    if (p->noise_frames == 0)
+        p->noise_x16 = peak * 16;
+    else
+        p->noise_x16 += (peak * 16 - p->noise_x16) / 8;
+
+    if (p->noise_frames < TOUCH_NOISE_FRAMES)
+        p->noise_frames += 1;
+}
+/*
+ * Function:  touch_find_contact
+ * --------------------
+ * helper function to find the max. delta, and the weighted centroid of the
+ * positive delta in the 3x3 tixels around it
+ * the frame is in landscape, index = x * row + y
+ *
+ * return: the max. delta
+ */
+static int touch_find_contact(const int *p_frame, int *p_peak_tixel, int *p_x, int *p_y)
+{
+    struct touch_classifier *p = &g_classifier;
+    int i;
+    int x, y;
+    int peak_x, peak_y;
+    int peak = p_frame[0];
+    int peak_tixel = 0;
+    int value;
+    long long sum = 0;
+    long long sum_x = 0;
+    long long sum_y = 0;
+
+    for (i = 1; i < p->num_tixels; i++) {
+        if (p_frame[i] > peak) {
+            peak = p_frame[i];
+            peak_tixel = i;
+        }
+    }
+
+    peak_x = peak_tixel / p->row;
+    peak_y = peak_tixel % p->row;
+
+    for (x = peak_x - 1; x <= peak_x + 1; x++) {
+        if ((x < 0) || (x >= p->col))
+            continue;
+        for (y = peak_y - 1; y <= peak_y + 1; y++) {
+            if ((y < 0) || (y >= p->row))
+                continue;
+
+            value = p_frame[x * p->row + y];
+            if (value <= 0)
+                continue;
+
+            sum += value;
+            sum_x += (long long)value * x;
+            sum_y += (long long)value * y;
+        }
+    }
+
+    if (sum > 0) {
+        *p_x = (int)(sum_x * SYNA_TOUCH_CENTROID_SCALE / sum);
+        *p_y = (int)(sum_y * SYNA_TOUCH_CENTROID_SCALE / sum);
+    }
+    else {
+        *p_x = peak_x * SYNA_TOUCH_CENTROID_SCALE;
+        *p_y = peak_y * SYNA_TOUCH_CENTROID_SCALE;
+    }
+    *p_peak_tixel = peak_tixel;
+
+    return peak;
+}
+/*
+ * Function:  touch_start_run
+ * --------------------
+ * helper function to start a steady run with the current contact
+ */
+static void touch_start_run(int peak, int x, int y)
+{
+    struct touch_classifier *p = &g_classifier;
+
+    p->ref_peak = peak;
+    p->ref_x = x;
+    p->ref_y = y;
+    p->stable_count = 1;
+}
+/*
+ * Function:  syna_touch_classifier_init
+ * --------------------
+ * initialize the touch classifier, the classifier starts in lift-off to
+ * learn the noise and wait for the panel to settle
+ *   threshold       : max. delta to detect the touch, 0 to learn from the noise
+ *   stable_frames   : frames to confirm a stable contact
+ *   stable_distance : max. centroid movement in a stable contact, in 1/16 tixel
+ *   stable_percent  : max. peak variation in a stable contact, in percent
+ *   settle_frames   : quiet frames after the lift-off
+ *
+ * return: <0, invalid parameter
+ *         otherwise, succeed
+ */
+int syna_touch_classifier_init(int col, int row, int threshold, int stable_frames,
+                               int stable_distance, int stable_percent, int settle_frames)
+{
+    struct touch_classifier *p = &g_classifier;
+
+    if ((col <= 0) || (row <= 0) || (threshold < 0) || (stable_frames <= 0) ||
+        (stable_distance < 0) || (stable_percent < 0) || (settle_frames < 0)) {
+        printf_e("%s error: invalid parameter\n", __func__);
+        return -EINVAL;
+    }
+
+    memset(p, 0x00, sizeof(struct touch_classifier));
+
+    p->col = col;
+    p->row = row;
+    p->num_tixels = col * row;
+    p->threshold = threshold;
+    p->stable_frames = stable_frames;
+    p->stable_distance = stable_distance;
+    p->stable_percent = stable_percent;
+    p->settle_frames = settle_frames;
+    p->state = TOUCH_CLASS_LIFTOFF;
+    p->is_initialized = true;
+
+    printf_i("%s: (col, row) = (%d, %d), threshold = %d, stable %d frames, settle %d frames\n",
+             __func__, col, row, threshold, stable_frames, settle_frames);
+
+    return 0;
+}
+/*
+ * Function:  syna_touch_classifier_classify
+ * --------------------
+ * classify one delta frame, the frame could be larger than the image,
+ * e.g. with the hybrid data, only the image is used.
+ * the information of frame is copied to p_info, which could be NULL
+ *
+ * return: <0, classifier is not initialized or invalid parameter
+ *         otherwise, the class of frame, see enum SYNA_TOUCH_CLASS
+ */
+int syna_touch_classifier_classify(const int *p_frame, int size, int *p_info, int info_size)
+{
+    struct touch_classifier *p = &g_classifier;
+    int info[TOUCH_INFO_SIZE];
+    int peak, peak_tixel;
+    int x, y;
+    int threshold;
+    bool is_learning;
+    bool is_steady;
+
+    if (!p->is_initialized)
+        return -ENODEV;
+
+    if ((!p_frame) || (size < p->num_tixels))
+        return -EINVAL;
+
+    peak = touch_find_contact(p_frame, &peak_tixel, &x, &y);
+    threshold = touch_get_threshold();
+    is_learning = (p->threshold == 0) && (p->noise_frames < TOUCH_NOISE_FRAMES);
+
+    switch (p->state) {
+        case TOUCH_CLASS_UNTOUCHED:
+            if (peak > threshold) {
+                p->state = TOUCH_CLASS_ONSET;
+                touch_start_run(peak, x, y);
+            }
+            else {
+                touch_update_noise(TOUCH_ABS(peak));
+            }
+            break;
+
+        case TOUCH_CLASS_ONSET:
+        case TOUCH_CLASS_STABLE:
+            if (peak < threshold / 2) {
+                p->state = TOUCH_CLASS_LIFTOFF;
+                p->quiet_count = 1;
+                p->stable_count = 0;
+                break;
+            }
+
+            /* compare with the contact at the start of the run */
+            is_steady = (TOUCH_ABS(x - p->ref_x) <= p->stable_distance) &&
+                        (TOUCH_ABS(y - p->ref_y) <= p->stable_distance) &&
+                        (TOUCH_ABS(peak - p->ref_peak) * 100 <= p->ref_peak * p->stable_percent);
+            if (is_steady) {
+                p->stable_count += 1;
+                if (p->stable_count >= p->stable_frames)
+                    p->state = TOUCH_CLASS_STABLE;
+            }
+            else {
+                p->state = TOUCH_CLASS_ONSET;
+                touch_start_run(peak, x, y);
+            }
+            break;
+
+        case TOUCH_CLASS_LIFTOFF:
+        default:
+            if ((peak > threshold) && !is_learning) {
+                p->state = TOUCH_CLASS_ONSET;
+                touch_start_run(peak, x, y);
+                break;
+            }
+
+            if ((peak < threshold / 2) || is_learning)
+                touch_update_noise(TOUCH_ABS(peak));
+
+            p->quiet_count += 1;
+            if ((p->quiet_count >= p->settle_frames) && !is_learning)
+                p->state = TOUCH_CLASS_UNTOUCHED;
+            break;
+    }
+
+    if ((p_info) && (info_size > 0)) {
+        info[TOUCH_INFO_CLASS] = p->state;
+        info[TOUCH_INFO_PEAK] = peak;
+        info[TOUCH_INFO_PEAK_TIXEL] = peak_tixel;
+        info[TOUCH_INFO_CENTROID_X] = x;
+        info[TOUCH_INFO_CENTROID_Y] = y;
+        info[TOUCH_INFO_THRESHOLD] = touch_get_threshold();
+        info[TOUCH_INFO_STABLE_COUNT] = p->stable_count;
+
+        memcpy(p_info, info, (size_t)MIN(info_size, TOUCH_INFO_SIZE) * sizeof(int));
+    }
+
+    return p->state;
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+#ifndef _SYNA_TOUCH_CLASSIFIER_H__
+#define _SYNA_TOUCH_CLASSIFIER_H__
+
+/* default parameters of the touch classifier */
+#define SYNA_TOUCH_STABLE_FRAMES      (5)   /* frames to confirm a stable contact */
+#define SYNA_TOUCH_STABLE_DISTANCE    (8)   /* max. centroid movement, in 1/16 tixel */
+#define SYNA_TOUCH_STABLE_PERCENT     (10)  /* max. peak variation, in percent */
+#define SYNA_TOUCH_SETTLE_FRAMES      (5)   /* quiet frames after lift-off */
+
+/* the centroid is reported in fixed-point, 1/16 of a tixel */
+#define SYNA_TOUCH_CENTROID_SCALE     (16)
+
+/*
+ * class of the delta frame
+ * must be equivalent to the same id in java layer
+ *
+ *   TOUCH_CLASS_UNTOUCHED : no touch, and the panel is settled
+ *   TOUCH_CLASS_ONSET     : touch is detected, but the contact is not stable yet
+ *   TOUCH_CLASS_STABLE    : peak and centroid are stable for the stable frames
+ *   TOUCH_CLASS_LIFTOFF   : touch is lifted, waiting for the panel to settle;
+ *                           also the class of the first frames learning the noise
+ */
+enum SYNA_TOUCH_CLASS {
+    TOUCH_CLASS_UNTOUCHED = 0,
+    TOUCH_CLASS_ONSET,
+    TOUCH_CLASS_STABLE,
+    TOUCH_CLASS_LIFTOFF,
+};
+
+/*
+ * information of the classified frame
+ * must be equivalent to the same id in java layer
+ */
+enum SYNA_TOUCH_INFO {
+    TOUCH_INFO_CLASS = 0,
+    TOUCH_INFO_PEAK,                /* max. delta of the frame */
+    TOUCH_INFO_PEAK_TIXEL,          /* index of the tixel with the max. delta */
+    TOUCH_INFO_CENTROID_X,          /* centroid around the peak, in 1/16 tixel */
+    TOUCH_INFO_CENTROID_Y,
+    TOUCH_INFO_THRESHOLD,           /* touch threshold being used */
+    TOUCH_INFO_STABLE_COUNT,        /* frames since the contact is steady */
+    TOUCH_INFO_SIZE,
+};
+
+/* helper to classify the delta frames into untouched and stable touched */
+int syna_touch_classifier_init(int col, int row, int threshold, int stable_frames,
+                               int stable_distance, int stable_percent, int settle_frames);
+int syna_touch_classifier_classify(const int *p_frame, int size, int *p_info, int info_size);
+
+#endif // _SYNA_TOUCH_CLASSIFIER_H__
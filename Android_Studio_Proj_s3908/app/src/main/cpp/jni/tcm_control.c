@@ -38,6 +38,8 @@
 
 #include "syna_dev_manager.h"
 #include "tcm_control.h"
+#include "syna_test_job.h"
+#include "syna_bus_trace.h"
 
 #ifdef SAVE_ERR_MSG
 #include "err_msg_ctrl.h"
@@ -54,6 +56,9 @@
 
 int tcm_enable_raw_mode(bool enable);
 
+/* latency from the reset command to the identify report, in micro-seconds */
+static int g_tcm_reset_latency_us = -1;
+
 /*
  * Function:  tcm_find_dev
  * --------------------
@@ -108,7 +113,7 @@ int tcm_open_dev(const char *dev_node)
         return 0;
     }
 
-    g_dev_file_descriptor = open(dev_node, O_RDWR, S_IRWXU | S_IRWXG | S_IRWXO);
+    g_dev_file_descriptor = syna_bus_open(dev_node);
     if (g_dev_file_descriptor < 0) {
         printf_e("%s error: fail to open %s (err: %s)\n",
                  __func__, dev_node, strerror(errno));
@@ -131,7 +136,7 @@ int tcm_open_dev(const char *dev_node)
         sprintf(err, "%s error: fail to config the tcm device to raw mode\n", __func__);
         add_error_msg(err);
 #endif
-        close(g_dev_file_descriptor);
+        syna_bus_close(g_dev_file_descriptor);
         return -EIO;
     }
     /* to get the touch config */
@@ -179,16 +184,16 @@ int tcm_close_dev(const char *dev_node)
 
     /* do reset after IRQ mode is enabled,  */
     /* the reason is to let driver perform its initialization process */
-    retval = ioctl(g_dev_file_descriptor, DEVICE_IOC_RESET);
+    retval = syna_bus_ioctl(DEVICE_IOC_RESET, 0);
     if (retval < 0) {
         printf_e("%s error: fail to send the DEVICE_IOC_RESET command to %s\n",
                  __func__, g_dev_node);
     }
 
-    usleep(TCM_RESET_DELAY_MS * 1000);
+    syna_bus_delay_us(TCM_RESET_DELAY_MS * 1000);
 
     /* close the device node */
-    close(g_dev_file_descriptor);
+    syna_bus_close(g_dev_file_descriptor);
 
     g_dev_file_descriptor = 0;
 
@@ -219,14 +224,14 @@ int tcm_enable_raw_mode(bool enable)
     }
 
     if (enable) {
-        retval = ioctl(g_dev_file_descriptor, DEVICE_IOC_RAW, true);
+        retval = syna_bus_ioctl(DEVICE_IOC_RAW, true);
         if (retval < 0) {
             printf_e("%s error: fail to enable the IOC_RAW ioctl command to %s\n",
                      __func__, g_dev_node);
             retval = -EINVAL;
             goto exit;
         }
-        retval = ioctl(g_dev_file_descriptor, DEVICE_IOC_IRQ, false);
+        retval = syna_bus_ioctl(DEVICE_IOC_IRQ, false);
         if (retval < 0) {
             printf_e("%s error: fail to disable the IOC_IRQ ioctl command to %s\n",
                      __func__, g_dev_node);
@@ -236,14 +241,14 @@ int tcm_enable_raw_mode(bool enable)
         printf_i("%s info: set to RAW mode\n", __func__);
     }
     else {
-        retval = ioctl(g_dev_file_descriptor, DEVICE_IOC_RAW, false);
+        retval = syna_bus_ioctl(DEVICE_IOC_RAW, false);
         if (retval < 0) {
             printf_e("%s error: fail to disable the IOC_RAW ioctl command to %s\n",
                      __func__, g_dev_node);
             retval = -EINVAL;
             goto exit;
         }
-        retval = ioctl(g_dev_file_descriptor, DEVICE_IOC_IRQ, true);
+        retval = syna_bus_ioctl(DEVICE_IOC_IRQ, true);
         if (retval < 0) {
             printf_e("%s error: fail to enable the IOC_IRQ ioctl command to %s\n",
                      __func__, g_dev_node);
@@ -284,7 +289,7 @@ int tcm_read_message(unsigned char *p_rd_data, unsigned int bytes_to_read)
         return (-EINVAL);
     }
 
-    retval = (int) read(g_dev_file_descriptor, p_rd_data, bytes_to_read);
+    retval = syna_bus_read(BUS_OP_TCM_READ, 0, p_rd_data, (int)bytes_to_read);
     if (retval < 0)  {
         printf_e("%s error: fail to read data from %s, bytes_to_read= %d (retval = %d)\n",
                  __func__, g_dev_node, bytes_to_read, retval);
@@ -324,7 +329,7 @@ int tcm_write_message(unsigned char *p_wr_data, unsigned int bytes_to_write)
         return (-EINVAL);
     }
 
-    retval = (int) write(g_dev_file_descriptor, p_wr_data, bytes_to_write);
+    retval = syna_bus_write(BUS_OP_TCM_WRITE, 0, p_wr_data, (int)bytes_to_write);
     if (retval < 0)  {
         printf_e("%s error: fail to write data to %s, bytes_to_write= %d, data: ",
                  __func__, g_dev_node, bytes_to_write);
@@ -388,7 +393,12 @@ int tcm_wait_for_command_ready(void)
 #endif
 
     do {
-        usleep(TCM_POLLING_DELAY_MS * 1000);
+        syna_bus_delay_us(TCM_POLLING_DELAY_MS * 1000);
+
+        /* stop waiting once the test job is cancelled or over its deadline */
+        retval = syna_job_check_abort();
+        if (retval < 0)
+            return retval;
 
         retval = tcm_read_message((unsigned char *)&header, (unsigned int) size);
         if (retval < 0) {
@@ -432,7 +442,126 @@ int tcm_wait_for_command_ready(void)
     size = convert_uc_to_short(header.length[0], header.length[1]);
     return size;
 }
+/*
+ * Function:  tcm_wait_for_response
+ * --------------------
+ * function to wait for the command response with a backoff polling,
+ * used by the commands whose execution time varies, such as flash erase/write.
+ * the first poll is issued after TCM_FLASH_POLLING_MIN_US, and the polling
+ * interval is doubled until TCM_FLASH_POLLING_MAX_US, so the caller returns as
+ * soon as the device completes the command instead of a fixed delay.
+ * the reports arriving in the meantime are dropped.
+ *
+ * parameter
+ *  timeout_ms: deadline to wait
+ *  p_header: header of the response, the status code is kept in p_header->code
+ *
+ * return: <0, error out
+ *         otherwise, the size of response payload
+ */
+int tcm_wait_for_response(int timeout_ms, struct tcm_message_header *p_header)
+{
+    int retval = 0;
+    bool is_responded = false;
+    struct tcm_message_header header;
+    int payload_size;
+    int delay_us = TCM_FLASH_POLLING_MIN_US;
+    long long deadline_us = (syna_get_time_ns() / 1000) + (long long)timeout_ms * 1000;
+#ifdef SAVE_ERR_MSG
+    char err[MAX_ERR_STRING_LEN];
+#endif
+
+    do {
+        syna_bus_delay_us((unsigned int)delay_us);
+
+        /* stop waiting once the test job is cancelled or over its deadline */
+        retval = syna_job_check_abort();
+        if (retval < 0)
+            return retval;
+
+        retval = tcm_read_message((unsigned char *)&header, sizeof(struct tcm_message_header));
+        if (retval < 0) {
+            printf_e("%s error: fail to read header from tcm device\n", __func__);
+            return retval;
+        }
+
+        if ( 0xA5 == header.marker) {
+            /* if the return code belongs to report, drop this report */
+            if ((header.code & 0x10) == 0x10) {
+                payload_size = header.length[0] | (header.length[1] << 8);
+                tcm_drop_package(payload_size);
+                continue;
+            }
+            /* STATUS_BUSY and STATUS_IDLE are not the response of command */
+            if ((STATUS_IDLE != header.code) && (STATUS_BUSY != header.code) &&
+                (STATUS_INVALID != header.code)) {
+                is_responded = true;
+                break;
+            }
+        }
+
+        delay_us = MIN(delay_us * 2, TCM_FLASH_POLLING_MAX_US);
 
+    } while ((syna_get_time_ns() / 1000) < deadline_us);
+
+    if (!is_responded) {
+        printf_e("%s error: command timeout (%d ms)\n", __func__, timeout_ms);
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: command timeout (%d ms)\n", __func__, timeout_ms);
+        add_error_msg(err);
+#endif
+        return (-ETIMEDOUT);
+    }
+
+    if (p_header)
+        memcpy(p_header, &header, sizeof(struct tcm_message_header));
+
+    return (unsigned short)convert_uc_to_short(header.length[0], header.length[1]);
+}
+/*
+ * Function:  tcm_wait_for_command_completion
+ * --------------------
+ * function to wait for the successful command response, see tcm_wait_for_response
+ *
+ * return: <0, error out, or the command is failed
+ *         otherwise, the size of response payload
+ */
+int tcm_wait_for_command_completion(int timeout_ms)
+{
+    int retval;
+    struct tcm_message_header header;
+#ifdef SAVE_ERR_MSG
+    char err[MAX_ERR_STRING_LEN];
+#endif
+
+    retval = tcm_wait_for_response(timeout_ms, &header);
+    if (retval < 0)
+        return retval;
+
+    if (STATUS_OK == header.code)
+        return retval;
+
+    /* drop the payload of the failed command */
+    if (retval > 0)
+        tcm_drop_package(retval);
+
+    if (STATUS_COMMAND_NOT_IMPLEMENTED == header.code) {
+        printf_e("%s error: command is not implemented\n", __func__);
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s: error: command is not implemented, status code: 0x%x\n",
+                __func__, header.code);
+        add_error_msg(err);
+#endif
+        return (-ENOSYS);
+    }
+
+    printf_e("%s error: command is failed, status code: 0x%x\n", __func__, header.code);
+#ifdef SAVE_ERR_MSG
+    sprintf(err, "%s error: command is failed, status code: 0x%x\n", __func__, header.code);
+    add_error_msg(err);
+#endif
+    return (-EIO);
+}
 
 /*
  * Function:  tcm_get_payload
@@ -500,22 +629,20 @@ exit:
 }
 
 /*
- * Function:  tcm_do_reset
+ * Function:  tcm_do_reset_ioctl
  * --------------------
- * helper to send a sw reset
+ * helper to send a reset through the driver, and wait for a fixed delay
  *
  * return: <0, fail to do reset
  *         otherwise, succeed
  */
-int tcm_do_reset()
+static int tcm_do_reset_ioctl(void)
 {
     int retval = 0;
 #ifdef SAVE_ERR_MSG
     char err[MAX_ERR_STRING_LEN];
 #endif
 
-    printf_i("%s info: do reset", __func__);
-
     /* first, configure the into the IRQ mode */
     retval = tcm_enable_raw_mode(false);
     if (retval < 0) {
@@ -528,7 +655,7 @@ int tcm_do_reset()
     }
 
     /* perform a reset via the IOCTL */
-    retval = ioctl(g_dev_file_descriptor, DEVICE_IOC_RESET);
+    retval = syna_bus_ioctl(DEVICE_IOC_RESET, 0);
     if (retval < 0) {
         printf_e("%s error: fail to send the DEVICE_IOC_RESET command to %s\n",
                  __func__, g_dev_node);
@@ -539,7 +666,7 @@ int tcm_do_reset()
 #endif
     }
 
-    usleep(TCM_RESET_DELAY_MS * 1000);
+    syna_bus_delay_us(TCM_RESET_DELAY_MS * 1000);
 
     /* at the end, switch back to the raw mode */
     retval = tcm_enable_raw_mode(true);
@@ -553,6 +680,71 @@ int tcm_do_reset()
 
     return retval;
 }
+/*
+ * Function:  tcm_do_reset
+ * --------------------
+ * helper to send a sw reset
+ * the reset command is sent in the raw mode, and it completes once
+ * the identify report arrives. the driver reset with a fixed delay is
+ * the fallback if the device does not respond in time, or the bus fails.
+ * no fallback if the test job is cancelled or over its deadline.
+ *
+ * return: -ECANCELED or -ETIMEDOUT, the test job is aborted
+ *         <0, fail to do reset
+ *         otherwise, succeed
+ */
+int tcm_do_reset()
+{
+    int retval = 0;
+    unsigned char cmd_packet[3] = {CMD_RESET, 0, 0};
+    long long start_us;
+    int abort_code;
+
+    printf_i("%s info: do reset", __func__);
+
+    start_us = syna_get_time_ns() / 1000;
+
+    retval = tcm_write_message(cmd_packet, sizeof(cmd_packet));
+    if (retval >= 0)
+        retval = tcm_wait_for_identify(TCM_RESET_TIMEOUT_MS, NULL);
+
+    if (retval < 0) {
+        /* the test job is cancelled or over its deadline, no fallback */
+        abort_code = syna_job_check_abort();
+        if (abort_code < 0) {
+            printf_e("%s error: reset is aborted (%d)\n", __func__, abort_code);
+            return abort_code;
+        }
+        /* fall back only on the bus error or the device timeout */
+        if (retval == -ENOMEM)
+            return retval;
+
+        printf_e("%s error: no identify report after CMD_RESET (retval = %d), reset by driver\n",
+                 __func__, retval);
+
+        start_us = syna_get_time_ns() / 1000;
+        retval = tcm_do_reset_ioctl();
+        if (retval < 0)
+            return retval;
+    }
+
+    g_tcm_reset_latency_us = (int)((syna_get_time_ns() / 1000) - start_us);
+    printf_i("%s info: reset is completed in %d us\n", __func__, g_tcm_reset_latency_us);
+
+    return 0;
+}
+/*
+ * Function:  tcm_get_reset_latency
+ * --------------------
+ * get the latency of the last reset, from the reset command to the device ready
+ *
+ * return: <0, no reset is performed
+ *         otherwise, latency in micro-seconds
+ */
+int tcm_get_reset_latency(void)
+{
+    return g_tcm_reset_latency_us;
+}
 
 /*
  * Function:  tcm_get_static_config
@@ -818,7 +1010,7 @@ int tcm_raw_control(unsigned char* p_in, int size_in,
     }
     /* wait for the command completion */
     do {
-        usleep(TCM_POLLING_DELAY_MS * 1000);
+        syna_bus_delay_us(TCM_POLLING_DELAY_MS * 1000);
 
         retval = tcm_read_message((unsigned char *)&header, sizeof(struct tcm_message_header));
         if (retval < 0) {
@@ -868,55 +1060,69 @@ int tcm_raw_control(unsigned char* p_in, int size_in,
 }
 
 /*
- * Function:  tcm_wait_for_mode_switch
+ * Function:  tcm_wait_for_identify
  * --------------------
- * function to wait for the firmware mode change (app/bootloader)
+ * function to wait for the identify report, which is sent once the device
+ * completes the reset or the mode switch (app/bootloader).
+ * the attention is checked every TCM_IDENTIFY_POLLING_DELAY_US until the deadline,
+ * the bus error is tolerated as the device may not respond during the reset.
+ *
+ * parameter
+ *  timeout_ms: deadline to wait
+ *  p_report: buffer for the identify report, could be NULL
  *
  * return: <0, error out
- *         otherwise, return the payload length
+ *         otherwise, the firmware mode
  */
-int tcm_wait_for_mode_switch(void)
+int tcm_wait_for_identify(int timeout_ms, struct tcm_identify_report *p_report)
 {
     int retval = 0;
     bool is_ready = false;
-    int timeout_cnt = 0;
     struct tcm_message_header header;
     struct tcm_identify_report identify_report;
+    unsigned char *buf = NULL;
     int size_payload;
+    long long deadline_us = (syna_get_time_ns() / 1000) + (long long)timeout_ms * 1000;
 #ifdef SAVE_ERR_MSG
     char err[MAX_ERR_STRING_LEN];
 #endif
 
     do {
-        usleep(TCM_POLLING_DELAY_MS * 1000);
-
-        retval = tcm_read_message((unsigned char *)&header, sizeof(struct tcm_message_header));
-        if (retval < 0) {
-            printf_e("%s error: fail to read header from tcm device\n", __func__);
+        /* stop waiting once the test job is cancelled or over its deadline */
+        retval = syna_job_check_abort();
+        if (retval < 0)
             return retval;
-        }
 
-        if ( 0xA5 == header.marker) {
+        retval = tcm_read_message((unsigned char *)&header, sizeof(struct tcm_message_header));
+        if ((retval >= 0) && (0xA5 == header.marker)) {
             /* device will return an identify report */
             if ( TCM_REPORT_IDENTIFY == header.code) {
                 is_ready = true;
+                break;
             }
         }
-        timeout_cnt += 1;
 
-    } while( (!is_ready) && (timeout_cnt < TCM_POLLING_TIMOUT) );
+        syna_bus_delay_us(TCM_IDENTIFY_POLLING_DELAY_US);
+
+    } while ((syna_get_time_ns() / 1000) < deadline_us);
 
     if (!is_ready) {
-        printf_e("%s error: command timeout\n", __func__);
+        printf_e("%s error: command timeout (%d ms)\n", __func__, timeout_ms);
 #ifdef SAVE_ERR_MSG
-        sprintf(err, "%s error: command timeout\n", __func__);
+        sprintf(err, "%s error: command timeout (%d ms)\n", __func__, timeout_ms);
         add_error_msg(err);
 #endif
         return (-ETIMEDOUT);
     }
 
     size_payload = convert_uc_to_short(header.length[0], header.length[1]);
-    retval = tcm_get_payload((unsigned char *)&identify_report, size_payload);
+    buf = calloc((size_t)MAX(size_payload, (int)sizeof(identify_report)), sizeof(unsigned char));
+    if (!buf) {
+        printf_e("%s error: can't allocate memory for buf\n", __func__);
+        return (-ENOMEM);
+    }
+
+    retval = tcm_get_payload(buf, size_payload);
     if (retval < 0) {
         printf_e("%s error: fail to get the identify report (size = %d)\n",
                  __func__, size_payload);
@@ -925,9 +1131,14 @@ int tcm_wait_for_mode_switch(void)
                 __func__, size_payload);
         add_error_msg(err);
 #endif
+        free(buf);
         return (-EIO);
     }
+    memcpy(&identify_report, buf, sizeof(identify_report));
+    free(buf);
 
+    if (p_report)
+        memcpy(p_report, &identify_report, sizeof(identify_report));
 
     if (identify_report.mode == MODE_APPLICATION)
         retval = MODE_APPLICATION;
@@ -940,6 +1151,18 @@ int tcm_wait_for_mode_switch(void)
 
     return retval;
 }
+/*
+ * Function:  tcm_wait_for_mode_switch
+ * --------------------
+ * function to wait for the firmware mode change (app/bootloader)
+ *
+ * return: <0, error out
+ *         otherwise, return the firmware mode
+ */
+int tcm_wait_for_mode_switch(void)
+{
+    return tcm_wait_for_identify(TCM_POLLING_DELAY_MS * TCM_POLLING_TIMOUT, NULL);
+}
 
 /*
  * Function:  tcm_run_bootloader
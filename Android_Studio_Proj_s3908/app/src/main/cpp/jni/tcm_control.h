@@ -32,8 +32,13 @@
 #define TCM_POLLING_DELAY_MS (20)
 #define TCM_POLLING_TIMOUT (150)  /* 20 (ms) * 150 = 3000 ms = 3s */
 #define TCM_RESET_DELAY_MS (250)
-#define TCM_ERASE_FLASH_DELAY_MS (500)
-#define TCM_WRITE_FLASH_DELAY_MS (200)
+#define TCM_RESET_TIMEOUT_MS (1000)
+#define TCM_IDENTIFY_POLLING_DELAY_US (2000)
+#define TCM_FLASH_POLLING_MIN_US (500)
+#define TCM_FLASH_POLLING_MAX_US (16000)
+#define TCM_ERASE_FLASH_TIMEOUT_MS (5000)
+#define TCM_WRITE_FLASH_TIMEOUT_MS (1000)
+#define TCM_READ_FLASH_TIMEOUT_MS (1000)
 
 #define TCM_TOUCH_CONFIG_SIZE 256
 #define TCM_MAX_STATIC_CONFIG_SIZE 7680
@@ -242,6 +247,30 @@ struct tcm_handler {
 
 struct tcm_handler g_tcm_handler;
 
+/* statistics of one flash programming */
+struct tcm_flash_stats {
+    int bytes;
+    int chunk_bytes;        /* size of each CMD_WRITE_FLASH transfer */
+    int num_chunks;
+    unsigned int crc32;     /* crc32 of the data read back */
+    int erase_time_us;
+    int write_time_us;
+    int verify_time_us;
+    int write_kbps;         /* write throughput, in KB/s */
+};
+
+/* sink of the streaming flash readback */
+struct tcm_flash_stream {
+    int fd;                         /* file to save the data, or <0 */
+    const unsigned char *p_golden;  /* golden image to compare, or NULL */
+    int golden_bytes;
+    bool stop_on_mismatch;
+    int bytes;                      /* bytes streamed */
+    unsigned int crc32;             /* crc32 of the streamed bytes */
+    int mismatch_offset;            /* first mismatched byte, -1 if none */
+    int mismatch_bytes;
+};
+
 
 /* helper to detect the valid tcm device node */
 bool tcm_find_dev(char *dev_node);
@@ -253,6 +282,8 @@ int tcm_read_message(unsigned char *p_rd_data, unsigned int bytes_to_read);
 int tcm_get_payload(unsigned char *p_rd_data, int payload_size);
 int tcm_write_message(unsigned char *p_wr_data, unsigned int  bytes_to_write);
 int tcm_wait_for_command_ready(void);
+int tcm_wait_for_response(int timeout_ms, struct tcm_message_header *p_header);
+int tcm_wait_for_command_completion(int timeout_ms);
 int tcm_drop_package(int payload_size);
 int tcm_do_reset();
 int tcm_set_no_sleep(int state);
@@ -261,6 +292,29 @@ int tcm_set_rezero();
 /* helper to change the firmware mode */
 int tcm_run_bootloader(void);
 int tcm_run_application(void);
+int tcm_wait_for_identify(int timeout_ms, struct tcm_identify_report *p_report);
+int tcm_get_reset_latency(void);
+
+/* helper to access the flash, device should be in bootloader mode */
+int tcm_get_boot_info(void);
+int tcm_get_data_location(unsigned char tcm_data_code,
+                          unsigned short* start_addr_in_blocks, unsigned short* length_in_blocks);
+int tcm_erase_flash_data(unsigned short start_address_in_blocks, unsigned short length_in_blocks,
+                         bool is_4byte_format);
+int tcm_write_flash_data(unsigned short start_address_in_blocks,
+                         unsigned char *wr_data, int wr_data_bytes);
+int tcm_read_flash_data(unsigned short start_address_in_blocks,
+                        unsigned char *rd_data, int rd_data_bytes);
+int tcm_program_flash_data(unsigned short start_address_in_blocks,
+                           unsigned char *data, int data_bytes, bool is_4byte_format,
+                           struct tcm_flash_stats *p_stats);
+unsigned int tcm_flash_crc32(unsigned int crc, const unsigned char *p_data, int bytes);
+void tcm_flash_stream_init(struct tcm_flash_stream *p_stream, int fd,
+                           const unsigned char *p_golden, int golden_bytes, bool stop_on_mismatch);
+int tcm_flash_stream_put(struct tcm_flash_stream *p_stream, const unsigned char *p_data, int bytes);
+int tcm_flash_stream_end(struct tcm_flash_stream *p_stream);
+int tcm_stream_flash_data(unsigned short start_address_in_blocks, int data_bytes,
+                          struct tcm_flash_stream *p_stream);
 
 /* helper to perform device identify */
 int tcm_get_identify_info(char *p_buf);
@@ -246,8 +246,8 @@ int tcm_erase_flash_data(unsigned short start_address_in_blocks, unsigned short
 
     /* the first erase page = ( address_in_blocks * block size ) / erase page size */
     first_erase_page = (start_address_in_blocks * block_size_words) / erase_page_size_words;
-    /* number of erase page = ( length in blocks * block size ) / erase page size */
-    num_erase_page = (length_in_blocks * block_size_words) / erase_page_size_words;
+    /* number of erase page = ( length in blocks * block size ) / erase page size, rounded up */
+    num_erase_page = (length_in_blocks * block_size_words + erase_page_size_words - 1) / erase_page_size_words;
     if (num_erase_page == 0)
         num_erase_page = 1; /* the minimum size should be 1 erase page */
 
@@ -290,10 +290,8 @@ int tcm_erase_flash_data(unsigned short start_address_in_blocks, unsigned short
         return retval;
     }
 
-    usleep(TCM_ERASE_FLASH_DELAY_MS * 1000);
-
     /* wait for the command completion */
-    retval = tcm_wait_for_command_ready();
+    retval = tcm_wait_for_command_completion(TCM_ERASE_FLASH_TIMEOUT_MS);
     if ( retval < 0) {
         printf_e("%s error: fail to erase data in the flash, address in blocks= 0x%4x, length in blocks= 0x%4x\n",
                  __func__, start_address_in_blocks, length_in_blocks);
@@ -309,110 +307,107 @@ int tcm_erase_flash_data(unsigned short start_address_in_blocks, unsigned short
     return retval;
 }
 /*
- * Function:  tcm_write_flash_data
+ * Function:  tcm_send_write_flash
  * --------------------
- * function to write data into flash
+ * helper to send one CMD_WRITE_FLASH and wait for its completion
+ * xfer_buf is the transfer buffer prepared by caller, which should be
+ * able to keep the 5-byte command header plus wr_data_bytes.
+ * the buffer is reused across the chunks, so there is no allocation per write.
  *
  * return: <0, fail to write data into flash
  *         otherwise, succeed
  */
-int tcm_write_flash_data(unsigned short start_address_in_blocks,
-                         unsigned char *wr_data, int wr_data_bytes)
+static int tcm_send_write_flash(unsigned char *xfer_buf, unsigned short start_address_in_blocks,
+                                unsigned char *wr_data, int wr_data_bytes)
 {
     int retval = 0;
-    unsigned char *cmd_packet = NULL;
-    unsigned char *data_buf = NULL;
 #ifdef SAVE_ERR_MSG
     char err[MAX_ERR_STRING_LEN];
 #endif
 
-    if (!wr_data) {
-        printf_e("%s error: invalid parameter, wr_data is null\n", __func__);
-#ifdef SAVE_ERR_MSG
-        sprintf(err, "%s error: invalid parameter, wr_data is null\n", __func__);
-        add_error_msg(err);
-#endif
-        return -EIO;
-    }
-
-    cmd_packet = calloc((size_t)(wr_data_bytes + 5), sizeof(unsigned char));
-    if (!cmd_packet) {
-        printf_e("%s error: can't allocate memory for command packet\n", __func__);
-#ifdef SAVE_ERR_MSG
-        sprintf(err, "%s error: can't allocate memory for command packet\n", __func__);
-        add_error_msg(err);
-#endif
-        retval = -ENOMEM;
-        goto exit;
-    }
-
-    cmd_packet[0] = CMD_WRITE_FLASH;
-    cmd_packet[1] = (unsigned char)((wr_data_bytes + 2) & 0xff);
-    cmd_packet[2] = (unsigned char)((wr_data_bytes + 2) >> 8);
-    cmd_packet[3] = (unsigned char)(start_address_in_blocks & 0xff);
-    cmd_packet[4] = (unsigned char)(start_address_in_blocks >> 8);
-    memcpy(&cmd_packet[5], wr_data, (size_t)wr_data_bytes);
+    xfer_buf[0] = CMD_WRITE_FLASH;
+    xfer_buf[1] = (unsigned char)((wr_data_bytes + 2) & 0xff);
+    xfer_buf[2] = (unsigned char)((wr_data_bytes + 2) >> 8);
+    xfer_buf[3] = (unsigned char)(start_address_in_blocks & 0xff);
+    xfer_buf[4] = (unsigned char)(start_address_in_blocks >> 8);
+    memcpy(&xfer_buf[5], wr_data, (size_t)wr_data_bytes);
 
     /* send command to write data into flash */
-    retval = tcm_write_message(cmd_packet, (unsigned int)(wr_data_bytes + 5));
+    retval = tcm_write_message(xfer_buf, (unsigned int)(wr_data_bytes + 5));
     if (retval < 0) {
         printf_e("%s error: fail to send command, CMD_WRITE_FLASH 0x%02x 0x%02x 0x%02x 0x%02x\n",
-                 __func__, cmd_packet[1], cmd_packet[2], cmd_packet[3], cmd_packet[4]);
-        retval = -EINVAL;
+                 __func__, xfer_buf[1], xfer_buf[2], xfer_buf[3], xfer_buf[4]);
 #ifdef SAVE_ERR_MSG
         sprintf(err, "%s error: fail to send command, CMD_WRITE_FLASH 0x%02x 0x%02x 0x%02x 0x%02x\n",
-                __func__, cmd_packet[1], cmd_packet[2], cmd_packet[3], cmd_packet[4]);
+                __func__, xfer_buf[1], xfer_buf[2], xfer_buf[3], xfer_buf[4]);
         add_error_msg(err);
 #endif
-        goto exit;
+        return -EINVAL;
     }
 
-    usleep(TCM_WRITE_FLASH_DELAY_MS * 1000);
-
     /* wait for the command completion */
-    retval = tcm_wait_for_command_ready();
-    if ( retval < 0) {
-        printf_e("%s error: fail to write data to the flash\n", __func__);
-        retval = -EIO;
+    retval = tcm_wait_for_command_completion(TCM_WRITE_FLASH_TIMEOUT_MS);
+    if (retval < 0) {
+        printf_e("%s error: fail to write data to the flash, address in blocks= 0x%04x\n",
+                 __func__, start_address_in_blocks);
 #ifdef SAVE_ERR_MSG
-        sprintf(err, "%s error: fail to write data to the flash\n", __func__);
+        sprintf(err, "%s error: fail to write data to the flash, address in blocks= 0x%04x\n",
+                __func__, start_address_in_blocks);
         add_error_msg(err);
 #endif
-        goto exit;
+        return -EIO;
     }
 
-    /* retrieve the response payload */
+    /* the response payload is not used, drop it */
     if (retval > 0) {
-        data_buf = calloc((size_t)(retval + 3), sizeof(unsigned char));
-        if (!data_buf) {
-            printf_e("%s error: fail to allocate data_buf\n", __func__);
+        retval = tcm_drop_package(retval);
+        if (retval < 0)
+            return -EINVAL;
+    }
+
+    return 0;
+}
+/*
+ * Function:  tcm_write_flash_data
+ * --------------------
+ * function to write data into flash
+ *
+ * return: <0, fail to write data into flash
+ *         otherwise, succeed
+ */
+int tcm_write_flash_data(unsigned short start_address_in_blocks,
+                         unsigned char *wr_data, int wr_data_bytes)
+{
+    int retval = 0;
+    unsigned char *xfer_buf = NULL;
 #ifdef SAVE_ERR_MSG
-            sprintf(err, "%s error: fail to allocate data_buf\n", __func__);
-            add_error_msg(err);
+    char err[MAX_ERR_STRING_LEN];
 #endif
-            retval = -EIO;
-            goto exit;
-        }
 
-        retval = tcm_get_payload(data_buf, (unsigned int)retval);
-        if (retval < 0) {
-            printf_e("%s error: fail to get the payload\n", __func__);
+    if (!wr_data) {
+        printf_e("%s error: invalid parameter, wr_data is null\n", __func__);
 #ifdef SAVE_ERR_MSG
-            sprintf(err, "%s error: fail to get the payload\n", __func__);
-            add_error_msg(err);
+        sprintf(err, "%s error: invalid parameter, wr_data is null\n", __func__);
+        add_error_msg(err);
 #endif
-            retval = -EINVAL;
-            goto exit;
-        }
+        return -EIO;
     }
 
-    printf_i("%s info: done", __func__);
+    xfer_buf = calloc((size_t)(wr_data_bytes + 5), sizeof(unsigned char));
+    if (!xfer_buf) {
+        printf_e("%s error: can't allocate memory for command packet\n", __func__);
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: can't allocate memory for command packet\n", __func__);
+        add_error_msg(err);
+#endif
+        return -ENOMEM;
+    }
 
-exit:
-    if (cmd_packet)
-        free(cmd_packet);
-    if (data_buf)
-        free(data_buf);
+    retval = tcm_send_write_flash(xfer_buf, start_address_in_blocks, wr_data, wr_data_bytes);
+    if (retval >= 0)
+        printf_i("%s info: done", __func__);
+
+    free(xfer_buf);
 
     return retval;
 }
@@ -420,9 +415,11 @@ exit:
  * Function:  tcm_read_flash_data
  * --------------------
  * function to read UPP data
+ * the payload returned could be shorter than rd_data_bytes, the caller
+ * must check the number of bytes being read
  *
  * return: <0, fail to read the upp data
- *         otherwise, succeed
+ *         otherwise, number of bytes copied into rd_data
  */
 int tcm_read_flash_data(unsigned short start_address_in_blocks,
                         unsigned char *rd_data, int rd_data_bytes)
@@ -431,9 +428,9 @@ int tcm_read_flash_data(unsigned short start_address_in_blocks,
     struct tcm_boot_info* boot_info = &g_tcm_handler.boot_info_report;
     unsigned short block_size_words = boot_info->write_block_size_words;
     unsigned int address_in_words;
-    unsigned int length_in_words = rd_data_bytes / sizeof(short);
+    unsigned int length_in_words = (rd_data_bytes + 1) / sizeof(short);
     unsigned char cmd_packet[9] = {0};
-    unsigned char *temp_buf;
+    unsigned char *temp_buf = NULL;
     int payload_len;
 #ifdef SAVE_ERR_MSG
     char err[MAX_ERR_STRING_LEN];
@@ -477,7 +474,7 @@ int tcm_read_flash_data(unsigned short start_address_in_blocks,
     }
 
     /* wait for the command completion */
-    payload_len = tcm_wait_for_command_ready();
+    payload_len = tcm_wait_for_command_completion(TCM_READ_FLASH_TIMEOUT_MS);
     if ( payload_len < 0) {
         printf_e("%s error: fail to read upp data\n", __func__);
         retval = -EIO;
@@ -508,7 +505,7 @@ int tcm_read_flash_data(unsigned short start_address_in_blocks,
         sprintf(err, "%s error: fail to get data payload \n", __func__);
         add_error_msg(err);
 #endif
-        return retval;
+        goto exit;
     }
 
     rd_data_bytes = (rd_data_bytes < payload_len)? rd_data_bytes : payload_len;
@@ -516,10 +513,420 @@ int tcm_read_flash_data(unsigned short start_address_in_blocks,
 
     printf_i("%s info: done", __func__);
 
+    retval = rd_data_bytes;
+
 exit:
     if (temp_buf)
         free(temp_buf);
 
     return retval;
 }
+/*
+ * Function:  tcm_flash_crc32
+ * --------------------
+ * calculate the crc32 (ieee 802.3) of the given data
+ * the crc could be accumulated over several calls, starting from 0,
+ * crc32(crc32(0, a), b) equals crc32(0, a + b)
+ *
+ * return: the updated crc
+ */
+unsigned int tcm_flash_crc32(unsigned int crc, const unsigned char *p_data, int bytes)
+{
+    static unsigned int crc_table[256];
+    static bool is_table_ready = false;
+    unsigned int c;
+    int i, k;
+
+    if (!is_table_ready) {
+        for (i = 0; i < 256; i++) {
+            c = (unsigned int)i;
+            for (k = 0; k < 8; k++)
+                c = (c & 1) ? (0xEDB88320 ^ (c >> 1)) : (c >> 1);
+            crc_table[i] = c;
+        }
+        is_table_ready = true;
+    }
+
+    crc = ~crc;
+    for (i = 0; i < bytes; i++)
+        crc = crc_table[(crc ^ p_data[i]) & 0xff] ^ (crc >> 8);
+
+    return ~crc;
+}
+/*
+ * Function:  tcm_get_flash_chunk_size
+ * --------------------
+ * determine the size of each CMD_WRITE_FLASH transfer,
+ * which is limited by the max. write size in identify report and
+ * the max. write payload in boot info, and aligned to the write block.
+ * if no limitation is reported, the whole data is written at once.
+ *
+ * return: size of one transfer in bytes
+ */
+static int tcm_get_flash_chunk_size(int data_bytes, int block_bytes)
+{
+    int chunk_bytes = 0;
+    int max_write_size = (unsigned short)convert_uc_to_short(
+            g_tcm_handler.identify_report.max_write_size[0],
+            g_tcm_handler.identify_report.max_write_size[1]);
+    int max_payload_size = (unsigned short)convert_uc_to_short(
+            g_tcm_handler.boot_info_report.max_write_payload_size_bytes[0],
+            g_tcm_handler.boot_info_report.max_write_payload_size_bytes[1]);
+
+    /* 5-byte command header, code + length + address */
+    if (max_write_size > 5)
+        chunk_bytes = max_write_size - 5;
+    /* 2-byte address is a part of the payload */
+    if (max_payload_size > 2)
+        chunk_bytes = (chunk_bytes > 0) ? MIN(chunk_bytes, max_payload_size - 2) : max_payload_size - 2;
+
+    /* align to the write block, the data is written at once if no limitation */
+    if (chunk_bytes > 0)
+        chunk_bytes = MAX((chunk_bytes / block_bytes) * block_bytes, block_bytes);
+    else
+        chunk_bytes = data_bytes;
+
+    return MIN(chunk_bytes, ((data_bytes + block_bytes - 1) / block_bytes) * block_bytes);
+}
+/*
+ * Function:  tcm_program_flash_data
+ * --------------------
+ * function to program the appointed flash area, such as UPP or config area
+ * the area is erased, written in transfer-sized chunks, and then read back
+ * to verify the crc32 of each chunk.
+ * the completion of each command is polled with a backoff, so the programming
+ * takes as long as the flash needs.
+ *
+ * parameter
+ *  start_address_in_blocks: start address, in write blocks
+ *  data: data to program
+ *  data_bytes: size of data in bytes
+ *  is_4byte_format: format of CMD_ERASE_FLASH
+ *  p_stats: statistics of the programming, could be NULL
+ *
+ * return: <0, fail to program the flash
+ *         otherwise, succeed
+ */
+int tcm_program_flash_data(unsigned short start_address_in_blocks,
+                           unsigned char *data, int data_bytes, bool is_4byte_format,
+                           struct tcm_flash_stats *p_stats)
+{
+    int retval = 0;
+    struct tcm_boot_info* boot_info = &g_tcm_handler.boot_info_report;
+    struct tcm_flash_stats stats;
+    unsigned char *xfer_buf = NULL;
+    unsigned char *rd_buf = NULL;
+    unsigned short address_in_blocks;
+    int block_bytes;
+    int offset;
+    int xfer_bytes;
+    long long time_us;
+#ifdef SAVE_ERR_MSG
+    char err[MAX_ERR_STRING_LEN];
+#endif
+
+    memset(&stats, 0x00, sizeof(struct tcm_flash_stats));
+
+    if ((!data) || (data_bytes <= 0)) {
+        printf_e("%s error: invalid parameter, data = %p, data_bytes = %d\n",
+                 __func__, data, data_bytes);
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: invalid parameter, data_bytes = %d\n", __func__, data_bytes);
+        add_error_msg(err);
+#endif
+        return -EINVAL;
+    }
+
+    /* boot info is required to know the write block size */
+    if (0 == boot_info->write_block_size_words) {
+        retval = tcm_get_boot_info();
+        if ((retval < 0) || (0 == boot_info->write_block_size_words)) {
+            printf_e("%s error: fail to get the write block size\n", __func__);
+#ifdef SAVE_ERR_MSG
+            sprintf(err, "%s error: fail to get the write block size\n", __func__);
+            add_error_msg(err);
+#endif
+            return -EINVAL;
+        }
+    }
+    block_bytes = boot_info->write_block_size_words * (int)sizeof(short);
+
+    stats.bytes = data_bytes;
+    stats.chunk_bytes = tcm_get_flash_chunk_size(data_bytes, block_bytes);
+
+    xfer_buf = calloc((size_t)(stats.chunk_bytes + 5), sizeof(unsigned char));
+    rd_buf = calloc((size_t)stats.chunk_bytes, sizeof(unsigned char));
+    if ((!xfer_buf) || (!rd_buf)) {
+        printf_e("%s error: can't allocate memory for transfer buffer (%d bytes)\n",
+                 __func__, stats.chunk_bytes);
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: can't allocate memory for transfer buffer (%d bytes)\n",
+                __func__, stats.chunk_bytes);
+        add_error_msg(err);
+#endif
+        retval = -ENOMEM;
+        goto exit;
+    }
+
+    /* erase the area */
+    time_us = syna_get_time_ns() / 1000;
+    retval = tcm_erase_flash_data(start_address_in_blocks,
+                                  (unsigned short)((data_bytes + block_bytes - 1) / block_bytes),
+                                  is_4byte_format);
+    if (retval < 0)
+        goto exit;
+    stats.erase_time_us = (int)((syna_get_time_ns() / 1000) - time_us);
+
+    /* write the data chunk by chunk */
+    time_us = syna_get_time_ns() / 1000;
+    for (offset = 0; offset < data_bytes; offset += stats.chunk_bytes) {
+        xfer_bytes = MIN(stats.chunk_bytes, data_bytes - offset);
+        address_in_blocks = (unsigned short)(start_address_in_blocks + offset / block_bytes);
+
+        retval = tcm_send_write_flash(xfer_buf, address_in_blocks, &data[offset], xfer_bytes);
+        if (retval < 0)
+            goto exit;
+
+        stats.num_chunks += 1;
+    }
+    stats.write_time_us = (int)((syna_get_time_ns() / 1000) - time_us);
+
+    /* read back and verify the crc of each chunk */
+    time_us = syna_get_time_ns() / 1000;
+    for (offset = 0; offset < data_bytes; offset += stats.chunk_bytes) {
+        xfer_bytes = MIN(stats.chunk_bytes, data_bytes - offset);
+        address_in_blocks = (unsigned short)(start_address_in_blocks + offset / block_bytes);
+
+        retval = tcm_read_flash_data(address_in_blocks, rd_buf, xfer_bytes);
+        if (retval < 0)
+            goto exit;
+        if (retval < xfer_bytes) {
+            printf_e("%s error: short read, address in blocks= 0x%04x, %d of %d bytes\n",
+                     __func__, address_in_blocks, retval, xfer_bytes);
+#ifdef SAVE_ERR_MSG
+            sprintf(err, "%s error: short read, address in blocks= 0x%04x, %d of %d bytes\n",
+                    __func__, address_in_blocks, retval, xfer_bytes);
+            add_error_msg(err);
+#endif
+            retval = -EIO;
+            goto exit;
+        }
+
+        if (tcm_flash_crc32(0, rd_buf, xfer_bytes) != tcm_flash_crc32(0, &data[offset], xfer_bytes)) {
+            printf_e("%s error: crc mismatch, address in blocks= 0x%04x, bytes= %d\n",
+                     __func__, address_in_blocks, xfer_bytes);
+#ifdef SAVE_ERR_MSG
+            sprintf(err, "%s error: crc mismatch, address in blocks= 0x%04x, bytes= %d\n",
+                    __func__, address_in_blocks, xfer_bytes);
+            add_error_msg(err);
+#endif
+            retval = -EIO;
+            goto exit;
+        }
+
+        stats.crc32 = tcm_flash_crc32(stats.crc32, rd_buf, xfer_bytes);
+    }
+    stats.verify_time_us = (int)((syna_get_time_ns() / 1000) - time_us);
+
+    if (stats.write_time_us > 0)
+        stats.write_kbps = (int)((long long)data_bytes * 1000000 / 1024 / stats.write_time_us);
+
+    printf_i("%s info: %d bytes in %d chunks, crc32= 0x%08x\n",
+             __func__, stats.bytes, stats.num_chunks, stats.crc32);
+    printf_i("%s info: erase %d us, write %d us (%d KB/s), verify %d us\n",
+             __func__, stats.erase_time_us, stats.write_time_us, stats.write_kbps,
+             stats.verify_time_us);
+
+    retval = 0;
+
+exit:
+    if (p_stats)
+        memcpy(p_stats, &stats, sizeof(struct tcm_flash_stats));
+
+    if (xfer_buf)
+        free(xfer_buf);
+    if (rd_buf)
+        free(rd_buf);
+
+    return retval;
+}
+/*
+ * Function:  tcm_flash_stream_init
+ * --------------------
+ * initialize the sink of streaming readback
+ *
+ * parameter
+ *  fd: file to save the data, or <0 if not required
+ *  p_golden: golden image to compare, or NULL if not required
+ *  golden_bytes: size of golden image
+ *  stop_on_mismatch: stop the streaming at the first mismatch
+ */
+void tcm_flash_stream_init(struct tcm_flash_stream *p_stream, int fd,
+                           const unsigned char *p_golden, int golden_bytes, bool stop_on_mismatch)
+{
+    memset(p_stream, 0x00, sizeof(struct tcm_flash_stream));
+
+    p_stream->fd = fd;
+    p_stream->p_golden = p_golden;
+    p_stream->golden_bytes = (p_golden) ? golden_bytes : 0;
+    p_stream->stop_on_mismatch = stop_on_mismatch;
+    p_stream->mismatch_offset = -1;
+}
+/*
+ * Function:  tcm_flash_stream_put
+ * --------------------
+ * feed one chunk into the stream, the chunk is written to the file,
+ * accumulated into the crc32, and compared with the golden image
+ *
+ * return: <0, fail to write the file
+ *          1, mismatch is found and the stream should be stopped
+ *          0, otherwise
+ */
+int tcm_flash_stream_put(struct tcm_flash_stream *p_stream, const unsigned char *p_data, int bytes)
+{
+    int retval;
+    int written = 0;
+    int offset = p_stream->bytes;
+    int cmp_bytes;
+    int i;
+
+    while ((p_stream->fd >= 0) && (written < bytes)) {
+        retval = (int)write(p_stream->fd, &p_data[written], (size_t)(bytes - written));
+        if (retval < 0) {
+            if (errno == EINTR)
+                continue;
+            printf_e("%s error: fail to write the file (err: %s)\n", __func__, strerror(errno));
+            return -EIO;
+        }
+        written += retval;
+    }
+
+    p_stream->crc32 = tcm_flash_crc32(p_stream->crc32, p_data, bytes);
+    p_stream->bytes += bytes;
+
+    if (!p_stream->p_golden)
+        return 0;
+
+    /* bytes beyond the golden image are treated as mismatched */
+    cmp_bytes = MAX(MIN(bytes, p_stream->golden_bytes - offset), 0);
+    if ((cmp_bytes == bytes) &&
+        (0 == memcmp(p_data, &p_stream->p_golden[offset], (size_t)cmp_bytes)))
+        return 0;
+
+    for (i = 0; i < bytes; i++) {
+        if ((i < cmp_bytes) && (p_data[i] == p_stream->p_golden[offset + i]))
+            continue;
+
+        if (p_stream->mismatch_offset < 0) {
+            p_stream->mismatch_offset = offset + i;
+            printf_i("%s info: first mismatch at offset 0x%x\n", __func__, offset + i);
+        }
+        p_stream->mismatch_bytes += 1;
+    }
+
+    return (p_stream->stop_on_mismatch) ? 1 : 0;
+}
+/*
+ * Function:  tcm_flash_stream_end
+ * --------------------
+ * complete the stream, the golden image longer than the streamed data
+ * is treated as mismatched
+ *
+ * return: 1, mismatch is found
+ *         0, otherwise
+ */
+int tcm_flash_stream_end(struct tcm_flash_stream *p_stream)
+{
+    if (!p_stream->p_golden)
+        return 0;
+
+    if ((p_stream->mismatch_offset < 0) && (p_stream->golden_bytes > p_stream->bytes)) {
+        p_stream->mismatch_offset = p_stream->bytes;
+        p_stream->mismatch_bytes = p_stream->golden_bytes - p_stream->bytes;
+    }
+
+    printf_i("%s info: %d bytes, crc32= 0x%08x, mismatch= %d bytes\n",
+             __func__, p_stream->bytes, p_stream->crc32, p_stream->mismatch_bytes);
+
+    return (p_stream->mismatch_offset < 0) ? 0 : 1;
+}
+/*
+ * Function:  tcm_stream_flash_data
+ * --------------------
+ * read the appointed flash area in chunks and feed them into the stream,
+ * so the whole area is never buffered.
+ * the streaming is stopped at the first mismatch if requested.
+ *
+ * return: <0, fail to read the flash
+ *         otherwise, result of tcm_flash_stream_end()
+ */
+int tcm_stream_flash_data(unsigned short start_address_in_blocks, int data_bytes,
+                          struct tcm_flash_stream *p_stream)
+{
+    int retval = 0;
+    struct tcm_boot_info* boot_info = &g_tcm_handler.boot_info_report;
+    unsigned char *rd_buf = NULL;
+    int block_bytes = boot_info->write_block_size_words * (int)sizeof(short);
+    int chunk_bytes;
+    int offset;
+    int xfer_bytes;
+#ifdef SAVE_ERR_MSG
+    char err[MAX_ERR_STRING_LEN];
+#endif
 
+    if ((!p_stream) || (data_bytes <= 0) || (block_bytes <= 0)) {
+        printf_e("%s error: invalid parameter, data_bytes = %d, block_bytes = %d\n",
+                 __func__, data_bytes, block_bytes);
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: invalid parameter, data_bytes = %d, block_bytes = %d\n",
+                __func__, data_bytes, block_bytes);
+        add_error_msg(err);
+#endif
+        return -EINVAL;
+    }
+
+    chunk_bytes = tcm_get_flash_chunk_size(data_bytes, block_bytes);
+
+    rd_buf = calloc((size_t)chunk_bytes, sizeof(unsigned char));
+    if (!rd_buf) {
+        printf_e("%s error: can't allocate memory for rd_buf (%d bytes)\n", __func__, chunk_bytes);
+#ifdef SAVE_ERR_MSG
+        sprintf(err, "%s error: can't allocate memory for rd_buf (%d bytes)\n", __func__, chunk_bytes);
+        add_error_msg(err);
+#endif
+        return -ENOMEM;
+    }
+
+    for (offset = 0; offset < data_bytes; offset += chunk_bytes) {
+        xfer_bytes = MIN(chunk_bytes, data_bytes - offset);
+
+        retval = tcm_read_flash_data((unsigned short)(start_address_in_blocks + offset / block_bytes),
+                                     rd_buf, xfer_bytes);
+        if (retval < 0)
+            goto exit;
+        if (retval < xfer_bytes) {
+            printf_e("%s error: short read at offset %d, %d of %d bytes\n",
+                     __func__, offset, retval, xfer_bytes);
+#ifdef SAVE_ERR_MSG
+            sprintf(err, "%s error: short read at offset %d, %d of %d bytes\n",
+                    __func__, offset, retval, xfer_bytes);
+            add_error_msg(err);
+#endif
+            retval = -EIO;
+            goto exit;
+        }
+
+        retval = tcm_flash_stream_put(p_stream, rd_buf, xfer_bytes);
+        if (retval < 0)
+            goto exit;
+        if (retval > 0)
+            break;
+    }
+
+    retval = tcm_flash_stream_end(p_stream);
+
+exit:
+    free(rd_buf);
+
+    return retval;
+}
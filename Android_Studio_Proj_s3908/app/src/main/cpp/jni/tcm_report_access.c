@@ -34,6 +34,9 @@
 
 #include "syna_dev_manager.h"
 #include "tcm_control.h"
+#include "syna_test_job.h"
+#include "syna_bus_trace.h"
+#include "syna_frame_latency.h"
 
 #ifdef SAVE_ERR_MSG
 #include "err_msg_ctrl.h"
@@ -175,7 +178,12 @@ int tcm_read_report_frame(int type, int *p_out, int size_out, bool out_in_landsc
 
     /* polling the interrupt to wait for the requested type */
     do {
-        usleep(TCM_POLLING_DELAY_MS * 1000);
+        syna_bus_delay_us(TCM_POLLING_DELAY_MS * 1000);
+
+        /* stop waiting once the test job is cancelled or over its deadline */
+        retval = syna_job_check_abort();
+        if (retval < 0)
+            goto exit;
         /* check the header */
         retval = tcm_read_message(data_buf, sizeof(struct tcm_message_header));
         if (retval < 0) {
@@ -193,6 +201,7 @@ int tcm_read_report_frame(int type, int *p_out, int size_out, bool out_in_landsc
             /* once get the acknowledge of requested report type */
             /* get the size of data payload  */
             if ( type == data_buf[1]) {
+                syna_frame_latency_mark(FRAME_STAMP_HEADER);
                 break;
             }
             /* if a touch report is coming, parse the touch report */
@@ -230,6 +239,7 @@ int tcm_read_report_frame(int type, int *p_out, int size_out, bool out_in_landsc
 #endif
         goto exit;
     }
+    syna_frame_latency_mark(FRAME_STAMP_PAYLOAD);
 
     /* copy data to the output image buffer                                             */
     /*                                                                                  */
@@ -289,6 +299,7 @@ int tcm_read_report_frame(int type, int *p_out, int size_out, bool out_in_landsc
         }
 
     }
+    syna_frame_latency_mark(FRAME_STAMP_REORDER);
 
 exit:
     if(data_buf)
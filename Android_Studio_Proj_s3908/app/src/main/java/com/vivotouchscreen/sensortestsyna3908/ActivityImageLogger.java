@@ -82,6 +82,8 @@ public class ActivityImageLogger extends Activity {
      * components for Image Data Logger Page
      ********************************************************/
     private TableLayout table_layout;
+    private LinearLayout layout_heatmap;
+    private Drawing drawing_heatmap;
     private LinearLayout layout_control_panel;
     private View view_control_panel;
     private Button btn_exit;
@@ -119,11 +121,20 @@ public class ActivityImageLogger extends Activity {
     private int n_value_max;
     private int n_value_min;
     private boolean b_do_rotation;
+    private boolean b_show_heatmap;
     private boolean b_enable_readtime;
     private int n_frame_type;
     private final static int TYPE_CURRENT_FRAME = 0;
     private final static int TYPE_MAX_PIXELS_FRAME = 1;
     private final static int TYPE_MIN_PIXELS_FRAME = 2;
+    private int image_frame_size;
+    /* preview period in the non real-time mode, and the timeout of stream reading */
+    private final static int PREVIEW_INTERVAL_MS = 100;
+    private final static int PREVIEW_TIMEOUT_MS = 200;
+    private final static int RECORDER_TIMEOUT_MS = 500;
+    /* heatmap buffers, the frame is re-ordered into the displayed rows */
+    private int[] heatmap_frame;
+    private int[] heatmap_pixels;
 
     /********************************************************
      * to sync up between the ui thread and the process
@@ -219,6 +230,8 @@ public class ActivityImageLogger extends Activity {
 
         /* UI components - table layout */
         table_layout = findViewById(R.id.table_img_image_data);
+        /* UI components - layout of the heatmap */
+        layout_heatmap = findViewById(R.id.layout_img_heatmap);
         /* UI components - texts od image logger  */
         text_statistics = findViewById(R.id.text_img_statistics);
         text_msg_to_stop = findViewById(R.id.text_img_msg_to_stop);
@@ -456,6 +469,17 @@ public class ActivityImageLogger extends Activity {
         }
     }; /* end Button.OnClickListener() */
 
+    /********************************************************
+     * implementation if the 'HEATMAP' is checked
+     ********************************************************/
+    private CheckBox.OnCheckedChangeListener _checkbox_listener_show_heatmap =
+            new CheckBox.OnCheckedChangeListener() {
+        @Override
+        public void onCheckedChanged(CompoundButton buttonView, boolean isChecked) {
+            b_show_heatmap = isChecked;
+        }
+    }; /* end Button.OnClickListener() */
+
     /********************************************************
      * implementation if the 'IMAGE TYPE' is changed
      ********************************************************/
@@ -523,6 +547,11 @@ public class ActivityImageLogger extends Activity {
         cbtn_do_rotation.setOnCheckedChangeListener(_checkbox_listener_do_rotation);
         cbtn_do_rotation.setChecked(b_do_rotation);
 
+        /* UI components - checked button, heatmap */
+        CheckBox cbtn_show_heatmap = findViewById(R.id.cbtn_img_heatmap);
+        cbtn_show_heatmap.setOnCheckedChangeListener(_checkbox_listener_show_heatmap);
+        cbtn_show_heatmap.setChecked(b_show_heatmap);
+
         /* UI components - property of log saving */
         cbtn_property_log_saving = findViewById(R.id.cbtn_img_log_saving);
         text_property_log_saving = findViewById(R.id.text_img_log);
@@ -581,6 +610,22 @@ public class ActivityImageLogger extends Activity {
         /* clear the queue */
         queue_image_frames.clear();
 
+        /* prepare the canvas of heatmap, or the table layout */
+        layout_heatmap.removeAllViews();
+        if (b_show_heatmap) {
+            table_layout.removeAllViews();
+            table_layout.setVisibility(View.GONE);
+
+            drawing_heatmap = new Drawing(this, display_width, display_height, Color.BLACK);
+            layout_heatmap.addView(drawing_heatmap);
+            layout_heatmap.setVisibility(View.VISIBLE);
+        }
+        else {
+            drawing_heatmap = null;
+            layout_heatmap.setVisibility(View.GONE);
+            table_layout.setVisibility(View.VISIBLE);
+        }
+
         /* create a thread to retrieve the report image from syna device node */
         /* the main thread will do ui updating  */
         Thread t = new Thread(ThreadImageAcquisition);
@@ -638,13 +683,8 @@ public class ActivityImageLogger extends Activity {
             b_running = true;
             flag_err = false;
 
-            /* if the real-time mode is disabled, */
-            /* create a thread to be in charge of output display */
-            /* otherwise, perform the report image collection and showing in this thread */
-            if (!b_enable_readtime) {
-                Thread t = new Thread(ThreadImageOutput);
-                t.start();
-            }
+            /* clear the frame latency of the previous streaming */
+            native_lib.onResetFrameLatency();
 
             /* get the information of report image  */
             image_row = native_lib.getDevImageRow(true);
@@ -658,6 +698,7 @@ public class ActivityImageLogger extends Activity {
                         (image_row + image_column + btn_cnt + force_elecs);
             else
                 size = image_row * image_column;
+            image_frame_size = size;
 
             Log.i(SYNA_TAG, "ActivityImageLogger ThreadImageAcquisition() row = " + image_row
                     + ", col = " + image_column+ ",  num button = " + btn_cnt );
@@ -673,52 +714,59 @@ public class ActivityImageLogger extends Activity {
                 flag_err = true;
             }
 
-            /* collect the report image until the state of is_running is changed */
-            while (b_running && !flag_err) {
-
-                /* allocate a buffer to save image frame */
-                data_buf = new int[size];
-
-                /* call native method to retrieve a report image from syna device */
-                ret = native_lib.onRequestReport(report_type, image_row, image_column,
-                        data_buf, data_buf.length);
+            /* start the native image stream */
+            /* every frame is acquired at the full rate and kept in the recorder for logging, */
+            /* while the preview is decimated to a rate the UI can follow */
+            if (!flag_err) {
+                int preview_mode;
+                if (n_frame_type == TYPE_MAX_PIXELS_FRAME)
+                    preview_mode = native_lib.PREVIEW_MODE_MAX;
+                else if (n_frame_type == TYPE_MIN_PIXELS_FRAME)
+                    preview_mode = native_lib.PREVIEW_MODE_MIN;
+                else
+                    preview_mode = native_lib.PREVIEW_MODE_LATEST;
+
+                native_lib.onSetStreamPreview(preview_mode, 0,
+                        (b_enable_readtime)? 0 : PREVIEW_INTERVAL_MS);
+
+                ret = native_lib.onStartImageStream(report_type, image_row, image_column, size,
+                        native_lib.STREAM_RECORDER_DEPTH, native_lib.STREAM_NO_CAPTURE);
                 if (!ret) {
                     Log.e(SYNA_TAG, "ActivityImageLogger ThreadImageAcquisition() " +
-                            "fail to retrieve the report image");
+                            "fail to start the image stream");
                     b_running = false;
                     flag_err = true;
                 }
                 else {
-                    /* push one image frame into the queue */
-                    queue_image_frames.offer(data_buf);
-
-                    Log.i(SYNA_TAG, "ActivityImageLogger ThreadImageAcquisition() " +
-                            "captured frame idx = " + queue_image_frames.size());
-
-                    /* if real-time showing is enabled, show report data */
-                    if (b_enable_readtime) {
-
-                        /* fetch one image frame */
-                        onFetchImageFromQueue();
+                    Thread t = new Thread(ThreadImageOutput);
+                    t.start();
+                }
+            }
 
-                        runOnUiThread(new Runnable() {
-                            public void run() {
-                                /* remove the previous display */
-                                table_layout.removeAllViews();
-                                table_layout.setStretchAllColumns(true);
-                                /* show the image onto the UI */
-                                onShowReportImage(image_frame, image_column, image_row);
+            /* collect the report image until the state of is_running is changed */
+            int frame_id = 0;
+            while (b_running && !flag_err) {
 
-                                synchronized(ui_sync) { ui_sync.notify(); }
-                            }
-                        });
+                /* allocate a buffer to save image frame */
+                data_buf = new int[size];
 
-                        /* if real-time showing is enabled, wait for the UI completion */
-                        try{
-                            synchronized(ui_sync){ui_sync.wait();}
-                        }catch(InterruptedException ignored){}
+                /* take the next frame recorded by the native stream */
+                int len = native_lib.onReadStreamRecorder(data_buf, RECORDER_TIMEOUT_MS);
+                if (len == native_lib.STREAM_READ_TIMEOUT) {
+                    continue;
+                }
+                else if (len == native_lib.STREAM_READ_END) {
+                    /* the stream is stopped by the error unless it is terminated by user */
+                    if (b_running) {
+                        Log.e(SYNA_TAG, "ActivityImageLogger ThreadImageAcquisition() " +
+                                "fail to retrieve the report image");
+                        b_running = false;
+                        flag_err = true;
                     }
                 }
+                else {
+                    frame_id += 1;
+                }
 
                 /* add the data frame into the file_manager */
                 if(b_log_save) {
@@ -726,10 +774,9 @@ public class ActivityImageLogger extends Activity {
                         log_manager.onAddErrorMessages("Error: Fail to retrieve the report image",
                                 native_lib);
                     }
-                    else {
+                    else if (len > 0) {
                         ret = log_manager.onAddLogData(data_buf,
-                                String.format(Locale.getDefault(), "frame id = %d",
-                                        queue_image_frames.size()));
+                                String.format(Locale.getDefault(), "frame id = %d", frame_id));
                         if (!ret) {
                             Log.e(SYNA_TAG, "ActivityImageLogger ThreadImageAcquisition() " +
                                     "fail to add a report image into the log file");
@@ -739,6 +786,41 @@ public class ActivityImageLogger extends Activity {
 
             } /* end while (b_running && !flag_err) */
 
+            /* stop the native image stream, and then, */
+            /* drain the frames which are recorded but not logged yet */
+            native_lib.onStopImageStream();
+            while (b_log_save && !flag_err) {
+                data_buf = new int[size];
+                if (native_lib.onReadStreamRecorder(data_buf, 0) <= 0)
+                    break;
+
+                frame_id += 1;
+                ret = log_manager.onAddLogData(data_buf,
+                        String.format(Locale.getDefault(), "frame id = %d", frame_id));
+                if (!ret) {
+                    Log.e(SYNA_TAG, "ActivityImageLogger ThreadImageAcquisition() " +
+                            "fail to add a report image into the log file");
+                }
+            }
+
+            /* show how many frames are acquired, logged, previewed or dropped */
+            int[] stats = native_lib.onGetImageStreamStats();
+            if (stats != null) {
+                Log.i(SYNA_TAG, "ActivityImageLogger ThreadImageAcquisition() image stream " +
+                        "acquired = " + stats[native_lib.IMAGE_STREAM_ACQUIRED] +
+                        ", recorded = " + stats[native_lib.IMAGE_STREAM_RECORDED] +
+                        ", recorder dropped = " + stats[native_lib.IMAGE_STREAM_RECORDER_DROPPED] +
+                        ", previews = " + stats[native_lib.IMAGE_STREAM_PREVIEWS] +
+                        ", preview dropped = " + stats[native_lib.IMAGE_STREAM_PREVIEW_DROPPED]);
+            }
+
+            /* show where the frame time is spent, firmware, bus, parsing or delivery */
+            String latency = native_lib.onGetFrameLatencyReport();
+            if (latency != null) {
+                Log.i(SYNA_TAG, "ActivityImageLogger ThreadImageAcquisition() frame latency " +
+                        "(stage,frames,p50_us,p90_us,p99_us,max_us)\n" + latency);
+            }
+
             /* disable the syna report stream */
             ret = native_lib.onStopReport(report_type);
             if (!ret) {
@@ -822,6 +904,8 @@ public class ActivityImageLogger extends Activity {
 
     /********************************************************
      * the thread to handle the image output
+     * the preview is taken from the native stream at the
+     * rate the UI can follow, independent of the acquisition
      ********************************************************/
     private Runnable ThreadImageOutput = new Runnable() {
         @Override
@@ -829,24 +913,38 @@ public class ActivityImageLogger extends Activity {
 
             while (b_running) {
 
+                /* take the latest frame or the aggregate since the last preview */
+                int[] preview = new int[image_frame_size];
+                int num = native_lib.onReadStreamPreview(preview, PREVIEW_TIMEOUT_MS);
+                if (num == native_lib.STREAM_READ_END)
+                    break;
+                if (num == native_lib.STREAM_READ_TIMEOUT)
+                    continue;
+
                 /* fetch one image frame */
-                if (queue_image_frames.size() > 0)
-                    onFetchImageFromQueue();
+                queue_image_frames.offer(preview);
+                onFetchImageFromQueue();
 
                 if (image_frame != null)
                 {
                     runOnUiThread(new Runnable() {
                         public void run() {
-                            /* remove the previous display */
-                            table_layout.removeAllViews();
-                            table_layout.setStretchAllColumns(true);
-                            /* show the image onto the UI */
-                            onShowReportImage(image_frame, image_column, image_row);
+                            if (drawing_heatmap != null) {
+                                /* show the image as a heatmap */
+                                onShowHeatmap(image_frame, image_column, image_row);
+                            }
+                            else {
+                                /* remove the previous display */
+                                table_layout.removeAllViews();
+                                table_layout.setStretchAllColumns(true);
+                                /* show the image onto the UI */
+                                onShowReportImage(image_frame, image_column, image_row);
+                            }
 
                             synchronized(ui_sync) { ui_sync.notify(); }
                         }
                     });
-                    
+
                     try{
                         synchronized(ui_sync) { ui_sync.wait(); }
                     } catch(InterruptedException ignored){}
@@ -928,6 +1026,70 @@ public class ActivityImageLogger extends Activity {
         }
 
     } /* end showReportData() */
+    /********************************************************
+     * show one report image as a heatmap
+     * the image is placed in the same orientation as the table,
+     * and rendered by the native library into the canvas
+     *
+     * the delta image is in blue-white-red, and the threshold_2
+     * is mapped to the full colors
+     * the raw image is in jet, ranged by the values of each frame
+     ********************************************************/
+    private void onShowHeatmap(int[] image, int col_num, int row_num) {
+        int width = drawing_heatmap.getWidth();
+        int height = drawing_heatmap.getHeight();
+        if ((width <= 0) || (height <= 0)) {
+            /* the canvas is not laid out yet */
+            return;
+        }
+        width = Math.min(width, display_width);
+        height = Math.min(height, display_height);
+
+        if ((heatmap_frame == null) || (heatmap_frame.length != col_num * row_num))
+            heatmap_frame = new int[col_num * row_num];
+        if ((heatmap_pixels == null) || (heatmap_pixels.length != width * height))
+            heatmap_pixels = new int[width * height];
+
+        /* re-order the image into the displayed rows, as onShowReportImage() */
+        int offset;
+        int idx = 0;
+        for(int k = 0; k < row_num; k++) {
+            int i = (b_do_rotation)? (row_num - 1 - k) : k;
+
+            for(int j = 0; j < col_num; j++) {
+                offset = j * row_num + i;
+                heatmap_frame[idx++] = image[offset];
+
+                n_value_max = Math.max(n_value_max, image[offset]);
+                n_value_min = Math.min(n_value_min, image[offset]);
+            }
+        }
+
+        String str = " Max. = " + n_value_max + " ,  Min. = " + n_value_min;
+        text_statistics.setText(str);
+
+        boolean ret;
+        if (report_type == native_lib.SYNA_RAW_REPORT_IMG) {
+            ret = native_lib.onRenderHeatmap(heatmap_frame, col_num, row_num,
+                    heatmap_pixels, width, height,
+                    native_lib.HEATMAP_COLORMAP_JET, native_lib.HEATMAP_SCALING_BILINEAR,
+                    0, 0);
+        }
+        else {
+            int range = Math.max(n_delta_threshold_2, 1);
+            ret = native_lib.onRenderHeatmap(heatmap_frame, col_num, row_num,
+                    heatmap_pixels, width, height,
+                    native_lib.HEATMAP_COLORMAP_BWR, native_lib.HEATMAP_SCALING_BILINEAR,
+                    -range, range);
+        }
+        if (!ret) {
+            Log.e(SYNA_TAG, "ActivityImageLogger onShowHeatmap() fail to render the heatmap");
+            return;
+        }
+
+        drawing_heatmap.drawPixels(heatmap_pixels, width, height);
+
+    } /* end onShowHeatmap() */
     /********************************************************
      * fill text into Table Row
      ********************************************************/
@@ -983,6 +1145,7 @@ public class ActivityImageLogger extends Activity {
                 .putInt(STR_CFG_RAW_THRESHOLD_1, n_raw_threshold_1)
                 .putInt(STR_CFG_RAW_THRESHOLD_2, n_raw_threshold_2)
                 .putBoolean(STR_CFG_DO_ROTATION, b_do_rotation)
+                .putBoolean(STR_CFG_SHOW_HEATMAP, b_show_heatmap)
                 .putInt(STR_CFG_DISPLAYED_FRAME_TYPE, n_frame_type)
                 .apply();
     }
@@ -1000,6 +1163,7 @@ public class ActivityImageLogger extends Activity {
         n_raw_threshold_1 = preference.getInt(STR_CFG_RAW_THRESHOLD_1, 5000);
         n_raw_threshold_2 = preference.getInt(STR_CFG_RAW_THRESHOLD_2, 10000);
         b_do_rotation = preference.getBoolean(STR_CFG_DO_ROTATION, false);
+        b_show_heatmap = preference.getBoolean(STR_CFG_SHOW_HEATMAP, false);
         n_frame_type = preference.getInt(STR_CFG_DISPLAYED_FRAME_TYPE, TYPE_CURRENT_FRAME);
     }
 
@@ -1066,6 +1230,8 @@ public class ActivityImageLogger extends Activity {
 
     private final String STR_CFG_DO_ROTATION = "CFG_DO_ROTATION";
 
+    private final String STR_CFG_SHOW_HEATMAP = "CFG_SHOW_HEATMAP";
+
     private final String STR_CFG_DISPLAYED_FRAME_TYPE = "CFG_DISPLAYED_FRAME_TYPE";
 }
 
@@ -1540,6 +1540,22 @@ public class ActivityProductionTester extends Activity {
             return false;
         }
 
+        /* open the reference store, the reference frames are kept in native layer */
+        int ret_ref = native_lib.onOpenReferenceStore(
+                getFilesDir().getPath() + "/" + Common.STR_REF_STORE_FILE);
+        if (ret_ref < 0) {
+            Log.e(SYNA_TAG, "ActivityProductionTester onLoadTestConfigurationFile() " +
+                    "fail to open the reference store");
+        }
+
+        /* keep the test limits in native layer as well, the compiled limits are cached */
+        int ret_limit = native_lib.onLoadTestLimit(str_file,
+                getFilesDir().getPath() + "/" + Common.STR_LIMIT_CACHE_FILE);
+        if (ret_limit < 0) {
+            Log.e(SYNA_TAG, "ActivityProductionTester onLoadTestConfiguration() " +
+                    "fail to load the test limit to native layer");
+        }
+
         /* retrieve the limit for each testing items */
         for (ProductionTest t : test) {
             t.onParseLimitFromTestCfg(test_cfg_manager, row, col, err, native_lib);
@@ -122,8 +122,7 @@ public class ActivitySNRCalculator extends Activity {
     private int required_frames;
     private int frame_row;
     private int frame_column;
-
-    private final int N_FRAMES_WAIT_STABLE = 10;
+    private int touch_threshold;
 
     /********************************************************
      * variables result frames
@@ -468,7 +467,7 @@ public class ActivitySNRCalculator extends Activity {
             onSavePreferences();
 
             /* initial progress bar */
-            progressbar.setMax(required_frames + (N_FRAMES_WAIT_STABLE * 2));
+            progressbar.setMax(required_frames * 2);
             progressbar.setProgress(0);
 
 
@@ -609,12 +608,14 @@ public class ActivitySNRCalculator extends Activity {
 
     /********************************************************
      * function to perform the SNR calculation
-     * basically, there are four main steps
+     * basically, there are six main steps
      *
-     * 1. collect the untouched frames
-     * 2. collect the touch frames
+     * 1. collect the untouched frames, classified natively
+     * 2. collect the touch frames, classified natively
      * 3. calculate the delta frames
-     * 4. calculate the SNR
+     * 4. calculate the noise RMS
+     * 5. locate the touch position
+     * 6. calculate the SNR at the touch position
      *
      ********************************************************/
     int ret_code;
@@ -663,29 +664,18 @@ public class ActivitySNRCalculator extends Activity {
                 frame_row = native_lib.getDevImageRow(true);
                 frame_column = native_lib.getDevImageCol(true);
 
-                /* step 1. collect untouched frames */
-                ret_code = collectUnTouchedFrames(native_lib,
+                /* step 1 & 2. collect untouched and touched frames */
+                ret_code = collectClassifiedFrames(native_lib,
                                             required_frames,
                                             vector_frames_untouched,
-                                            native_lib.SYNA_DELTA_REPORT_IMG,
-                                            frame_row * frame_column);
-                if (ret_code != RET_NO_ERROR) {
-                    Log.e(SYNA_TAG, "ActivitySNRCalculator doSNRCalculation() " +
-                            "fail to collect untouched frames" );
-                }
-
-                /* step 2. collect touched frames */
-                ret_code = collectTouchedFrames(native_lib,
-                                            required_frames,
                                             vector_frames_touched,
                                             native_lib.SYNA_DELTA_REPORT_IMG,
                                             frame_row * frame_column);
                 if (ret_code != RET_NO_ERROR) {
                     Log.e(SYNA_TAG, "ActivitySNRCalculator doSNRCalculation() " +
-                            "fail to collect touched frames");
+                            "fail to collect untouched and touched frames");
                 }
 
-
                 /* step 3. calculate touch strength */
                 ret_code = calculateStrength(vector_frames_delta,
                                             vector_frames_untouched,
@@ -699,8 +689,16 @@ public class ActivitySNRCalculator extends Activity {
                                             frame_row,
                                             frame_column);
 
-                // step 5. calculate the SNR
-                int[] pos = new int[2];
+                // step 5. locate the touch position
+                int[] pos = {-1, -1};
+                StringBuilder touch_str = new StringBuilder() ;
+                ret_code = locateTouchPosition(result_img_delta_avg,
+                                        frame_row,
+                                        frame_column,
+                                        touch_str,
+                                        pos);
+
+                // step 6. calculate the SNR at the touch position
                 StringBuilder result_str = new StringBuilder() ;
                 ret_code = calculateSNR(result_img_delta_avg,
                                         result_img_noise_rms,
@@ -708,6 +706,7 @@ public class ActivitySNRCalculator extends Activity {
                                         frame_column,
                                         result_str,
                                         pos);
+                result_str.append(touch_str);
 
                 /* save data to the log file */
                 if (b_log_save && (ret_code == RET_NO_ERROR)) {
@@ -764,20 +763,26 @@ public class ActivitySNRCalculator extends Activity {
 
     }
     /********************************************************
-     * function to collect the untouched frames
+     * function to collect the untouched and touched frames
      *
-     * update the message on ui
-     * perform report image acquisition, called F_Untouched[n]
+     * the delta frames are classified by the native classifier,
+     * so no fixed frames are discarded to wait for the stable
+     *   1. frames classified as untouched are F_Untouched[n]
+     *   2. change the ui message to ask user to put a finger
+     *   3. frames classified as stable touched are F_Touched[n],
+     *      the touched frames are re-collected if the finger
+     *      is moved or lifted before the completion
      ********************************************************/
-    private int collectUnTouchedFrames(NativeWrapper lib, int total_required_frames,
-                                       Vector<int[]> v, byte report_type, int size)
+    private int collectClassifiedFrames(NativeWrapper lib, int total_required_frames,
+                                        Vector<int[]> v_untouched, Vector<int[]> v_touched,
+                                        byte report_type, int size)
     {
         if (ret_code != RET_NO_ERROR) {
-            Log.e(SYNA_TAG, "ActivitySNRCalculator getUnTouchedFrames() " +
+            Log.e(SYNA_TAG, "ActivitySNRCalculator collectClassifiedFrames() " +
                     "ret_code is not RET_NO_ERROR, exit directly");
             if (b_log_save) {
                 log_manager.onAddErrorMessages("Error: Error occurs " +
-                        "before collecting untouched frames, exit");
+                        "before collecting frames, exit");
             }
             return ret_code;
         }
@@ -786,11 +791,25 @@ public class ActivitySNRCalculator extends Activity {
         /* reset the progress bar */
         onShowProgress(0);
 
-        if (v.size() != 0)
-            v.clear();
+        if (v_untouched.size() != 0)
+            v_untouched.clear();
+        if (v_touched.size() != 0)
+            v_touched.clear();
+
+        /* initialize the classifier, the touch threshold is learned from the noise */
+        boolean ret = lib.onInitTouchClassifier(frame_row, frame_column);
+        if (!ret) {
+            Log.e(SYNA_TAG, "ActivitySNRCalculator collectClassifiedFrames() " +
+                    "fail to initialize the touch classifier" );
+            if (b_log_save) {
+                log_manager.onAddErrorMessages("Error: Fail to initialize the touch classifier");
+            }
+            ret_code = RET_FAIL_TO_START;
+            return ret_code;
+        }
 
         /* start the delta report stream */
-        boolean ret = native_lib.onStartReport(native_lib.SYNA_DELTA_REPORT_IMG, false,
+        ret = native_lib.onStartReport(native_lib.SYNA_DELTA_REPORT_IMG, true,
                 true, false);
         if (!ret) {
             runOnUiThread(new Runnable() {
@@ -798,7 +817,7 @@ public class ActivitySNRCalculator extends Activity {
                     onShowErrorDialog("Error\n\nFail to enable delta report stream.\n");
                 }
             });
-            Log.e(SYNA_TAG, "ActivitySNRCalculator collectUnTouchedFrames() " +
+            Log.e(SYNA_TAG, "ActivitySNRCalculator collectClassifiedFrames() " +
                     "fail to enable the syna report" );
 
             if (b_log_save) {
@@ -807,7 +826,7 @@ public class ActivitySNRCalculator extends Activity {
                 /* create a log file with errors only */
                 ret = log_manager.onCreateLogFile();
                 if (!ret) {
-                    Log.e(SYNA_TAG, "ActivitySNRCalculator collectUnTouchedFrames() " +
+                    Log.e(SYNA_TAG, "ActivitySNRCalculator collectClassifiedFrames() " +
                             "fail to create the log file" );
                 }
             }
@@ -815,14 +834,11 @@ public class ActivitySNRCalculator extends Activity {
             return ret_code;
         }
 
-        int frame_idx = 0;
-        int total_frames = total_required_frames + (N_FRAMES_WAIT_STABLE*2);
-        int latest_frame_idx = total_required_frames + N_FRAMES_WAIT_STABLE;
+        int[] info = new int[lib.TOUCH_INFO_SIZE];
+        int touch_class;
 
-        /* collect the report images, F_Untouched[n],
-         * until reaching the required frames               */
-        while (b_running && (frame_idx < total_frames))
-        {
+        /* collect the report images until reaching the required frames */
+        while (b_running && (v_touched.size() < total_required_frames)) {
             /* allocate a buffer to save image frame */
             int[] data_buf = new int[size];
 
@@ -830,31 +846,60 @@ public class ActivitySNRCalculator extends Activity {
             ret = lib.onRequestReport(report_type, frame_row, frame_column,
                     data_buf, data_buf.length);
             if (!ret) {
-                Log.e(SYNA_TAG, "ActivitySNRCalculator collectUnTouchedFrames() " +
-                        "fail to collect untouched frames");
+                Log.e(SYNA_TAG, "ActivitySNRCalculator collectClassifiedFrames() " +
+                        "fail to collect frames");
                 b_running = false;
                 if (b_log_save) {
-                    log_manager.onAddErrorMessages("Error: Fail to retrieve untouched frames",
-                            native_lib);
+                    log_manager.onAddErrorMessages("Error: Fail to retrieve " +
+                            ((v_untouched.size() < total_required_frames) ?
+                                    "untouched" : "touched") + " frames", native_lib);
                 }
-                ret_code = RET_FAIL_TO_GET_UNTOUCHED_FRAME;
+                ret_code = (v_untouched.size() < total_required_frames) ?
+                        RET_FAIL_TO_GET_UNTOUCHED_FRAME : RET_FAIL_TO_GET_TOUCHED_FRAME;
                 break;
             }
 
-            /* push one image data into queue only when the frame is stable */
-            if ((frame_idx >= N_FRAMES_WAIT_STABLE) && (frame_idx < latest_frame_idx)) {
-                v.add(data_buf);
+            touch_class = lib.onClassifyTouchFrame(data_buf, info);
+
+            /* step 1. push the untouched frames */
+            if (v_untouched.size() < total_required_frames) {
+                if (touch_class == lib.TOUCH_CLASS_UNTOUCHED) {
+                    v_untouched.add(data_buf);
+
+                    /* change the ui message to inform user to put a finger */
+                    if (v_untouched.size() == total_required_frames) {
+                        touch_threshold = info[lib.TOUCH_INFO_THRESHOLD];
+                        Log.i(SYNA_TAG, "ActivitySNRCalculator collectClassifiedFrames() " +
+                                "untouched frames are collected, threshold = " + touch_threshold);
+                        onShowUIMessage(getResources().getString(R.string.snr_msg_to_touch),
+                                false);
+                        /* set the flag to draw a circle at the touch down event */
+                        b_wait_touch = true;
+                    }
+                }
+            }
+            /* step 2. push the touched frames only when the contact is stable, */
+            /*         and there is only one finger on the panel                 */
+            else if ((touch_class == lib.TOUCH_CLASS_STABLE) &&
+                     (lib.onDetectBlobs(data_buf, frame_row, frame_column, touch_threshold,
+                             touch_threshold / 2, 1, null) == 1)) {
+                v_touched.add(data_buf);
+            }
+            else if (v_touched.size() != 0) {
+                Log.i(SYNA_TAG, "ActivitySNRCalculator collectClassifiedFrames() " +
+                        "contact is not stable, discard " + v_touched.size() + " touched frames");
+                v_touched.clear();
             }
 
-
-            frame_idx++;
-            onShowProgress(frame_idx);
+            onShowProgress(v_untouched.size() + v_touched.size());
         }
 
+        b_wait_touch = false;
+
         /* disable the syna report stream */
         ret = native_lib.onStopReport(native_lib.SYNA_DELTA_REPORT_IMG);
         if (!ret) {
-            Log.e(SYNA_TAG, "ActivitySNRCalculator collectUnTouchedFrames() " +
+            Log.e(SYNA_TAG, "ActivitySNRCalculator collectClassifiedFrames() " +
                     "fail to disable the syna report" );
             if (b_log_save) {
                 log_manager.onAddErrorMessages("Error: Fail to stop report image streaming",
@@ -862,142 +907,31 @@ public class ActivitySNRCalculator extends Activity {
             }
         }
 
-        if (v.size() < total_required_frames) {
-            Log.e(SYNA_TAG, "ActivitySNRCalculator collectUnTouchedFrames() " +
+        if (v_untouched.size() < total_required_frames) {
+            Log.e(SYNA_TAG, "ActivitySNRCalculator collectClassifiedFrames() " +
                     "the number of untouched frames is insufficient");
             if (b_log_save) {
                 log_manager.onAddErrorMessages("Error: The number of untouched frames is insufficient" +
-                        ", required = " + total_required_frames + ", captured frames = " + v.size());
+                        ", required = " + total_required_frames + ", captured frames = " +
+                        v_untouched.size());
             }
             ret_code = RET_FAIL_TO_GET_UNTOUCHED_FRAME;
         }
-
-        Log.i(SYNA_TAG, "ActivitySNRCalculator collectUnTouchedFrames() complete");
-
-        return ret_code;
-    }
-    /********************************************************
-     * function to collect the touched frames
-     *
-     * change the ui message to ask user to put a finger on the panel
-     * the loop inside will be triggered when a finger down event occurs
-     * next, do report image acquisition, called F_Touched[n]
-     ********************************************************/
-    private int collectTouchedFrames(NativeWrapper lib, int total_required_frames,
-                                 Vector<int[]> v, byte report_type, int size)
-    {
-        if (ret_code != RET_NO_ERROR) {
-            Log.e(SYNA_TAG, "ActivitySNRCalculator collectTouchedFrames() " +
-                    "ret_code is not RET_NO_ERROR, exit directly");
-            if (b_log_save) {
-                log_manager.onAddErrorMessages("Error: Error occurs " +
-                        "before the touched frames collection, exit");
-            }
-            return ret_code;
-        }
-
-        /* change the ui message to inform user to put a finger */
-        onShowUIMessage(getResources().getString(R.string.snr_msg_to_touch), false);
-
-        /* reset the progress bar */
-        onShowProgress(0);
-
-        if (v.size() != 0)
-            v.clear();
-
-        /* set the flag true to wait for a touch down event */
-        b_wait_touch = true;
-
-        /* busy loop to detect the finger down event */
-        /* once finger down, draw a circle on the touched position and update the message */
-        while (b_running && b_wait_touch) {
-            try {
-                Thread.sleep(20);
-            } catch (InterruptedException e) {
-                e.printStackTrace();
-            }
-        }
-
-        /* to enable the delta report stream */
-        boolean ret = native_lib.onStartReport(native_lib.SYNA_DELTA_REPORT_IMG, true,
-                true, false);
-        if (!ret) {
-            runOnUiThread(new Runnable() {
-                public void run(){
-                    onShowErrorDialog("Error\n\nFail to enable delta report stream.\n");
-                }
-            });
-            Log.e(SYNA_TAG, "ActivitySNRCalculator collectTouchedFrames() " +
-                    "fail to enable the syna report" );
-
-            if (b_log_save) {
-                log_manager.onAddErrorMessages("Error: Fail to start report image streaming",
-                        native_lib);
-                /* create a log file with errors only */
-                ret = log_manager.onCreateLogFile();
-                if (!ret) {
-                    Log.e(SYNA_TAG, "ActivitySNRCalculator collectTouchedFrames() " +
-                            "fail to create the log file" );
-                }
-            }
-            ret_code = RET_FAIL_TO_START;
-            return ret_code;
-        }
-
-        int frame_idx = 0;
-        int total_frames = total_required_frames + (N_FRAMES_WAIT_STABLE*2);
-        int latest_frame_idx = total_required_frames + N_FRAMES_WAIT_STABLE;
-
-        /* collect the report images, F_Touched[n],
-         * until reaching the required frames               */
-        while (b_running && (frame_idx < total_frames)) {
-            /* allocate a buffer to save image frame */
-            int[] data_buf = new int[size];
-            /* call native method to retrieve a report image from syna device */
-            ret = lib.onRequestReport(report_type, frame_row, frame_column,
-                    data_buf, data_buf.length);
-            if (!ret) {
-                Log.e(SYNA_TAG, "ActivitySNRCalculator collectTouchedFrames() " +
-                        "fail to collect touched frames");
-                b_running = false;
-
-                log_manager.onAddErrorMessages("Error: Fail to retrieve touched frames",
-                        native_lib);
-
-                ret_code = RET_FAIL_TO_GET_TOUCHED_FRAME;
-                break;
-            }
-
-            /* push one image data into queue only when the frame is stable */
-            if ((frame_idx >= N_FRAMES_WAIT_STABLE) && (frame_idx < latest_frame_idx)) {
-                v.add(data_buf);
-            }
-
-            frame_idx++;
-            onShowProgress(frame_idx);
-        }
-
-        if (v.size() < total_required_frames) {
-            Log.e(SYNA_TAG, "ActivitySNRCalculator collectTouchedFrames() data is not enough");
+        else if (v_touched.size() < total_required_frames) {
+            Log.e(SYNA_TAG, "ActivitySNRCalculator collectClassifiedFrames() data is not enough");
             b_running = false;
             if (b_log_save) {
                 log_manager.onAddErrorMessages("Error: The number of touched frames is insufficient" +
-                        ", required = " + total_required_frames + ", captured frames = " + v.size());
+                        ", required = " + total_required_frames + ", captured frames = " +
+                        v_touched.size());
             }
+            ret_code = RET_FAIL_TO_GET_TOUCHED_FRAME;
         }
-
-        /* disable the syna report stream */
-        ret = native_lib.onStopReport(native_lib.SYNA_DELTA_REPORT_IMG);
-        if (!ret) {
-            Log.e(SYNA_TAG, "ActivitySNRCalculator collectTouchedFrames() " +
-                    "fail to disable the syna report" );
-            if (b_log_save) {
-                log_manager.onAddErrorMessages("Error: Fail to stop report image streaming",
-                        native_lib);
-            }
+        else {
+            onShowUIMessage(getResources().getString(R.string.snr_msg_collecting_done), false);
         }
 
-        Log.i(SYNA_TAG, "ActivitySNRCalculator collectTouchedFrames() complete");
+        Log.i(SYNA_TAG, "ActivitySNRCalculator collectClassifiedFrames() complete");
 
         return ret_code;
     }
@@ -1181,6 +1115,10 @@ public class ActivitySNRCalculator extends Activity {
      * function to calculate the SNR frame
      *
      * SNR = 20 * log10( Touched_AVG / Noise_RMS )
+     *
+     * the SNR is taken at pos, the peak of the touch blob;
+     * if no blob is located (pos[0] < 0), the max. SNR is
+     * used and pos is filled with its position
      ********************************************************/
     private int calculateSNR(double[] signal_touch, double[] signal_noise,
                              int row, int col, StringBuilder result_str, int[] pos)
@@ -1241,17 +1179,76 @@ public class ActivitySNRCalculator extends Activity {
             }
         }
 
-        /* keep the target pixel */
-        pos[0] = di;
-        pos[1] = dj;
+        /* take the SNR at the touch position, or keep the max. one */
+        String target = "the max. value";
+        if (pos[0] >= 0 && pos[0] < row && pos[1] >= 0 && pos[1] < col) {
+            di = pos[0];
+            dj = pos[1];
+            result_snr = result_img_snr[dj * row + di];
+            target = "the touch value";
+        }
+        else {
+            pos[0] = di;
+            pos[1] = dj;
+        }
 
         /* generate result string */
         result_str.append("SNR                       : ")
                 .append(String.format(Locale.getDefault(), "%4.2f db\n\n",result_snr));
 
         result_str.append("SNR, ")
-                .append(String.format(Locale.getDefault(), "the max. value % 6.2f  at (%02d,%02d)",
-                        result_snr, di, dj));
+                .append(String.format(Locale.getDefault(), "%s % 6.2f  at (%02d,%02d)",
+                        target, result_snr, di, dj));
+
+        return ret_code;
+    }
+
+    /********************************************************
+     * function to locate the touch position
+     *
+     * find the blob of the average of F_Delta[n], and append
+     * the peak, area and weighted centroid to the result;
+     * pos is filled with the peak tixel of the blob
+     ********************************************************/
+    private int locateTouchPosition(double[] signal_touch, int row, int col,
+                                    StringBuilder result_str, int[] pos)
+    {
+        if (ret_code != RET_NO_ERROR) {
+            Log.e(SYNA_TAG, "ActivitySNRCalculator locateTouchPosition() " +
+                    "err_value is not RET_NO_ERROR, do nothing");
+            return ret_code;
+        }
+
+        int[] frame = new int[row * col];
+        for (int i = 0; i < frame.length; i++) {
+            frame[i] = (int)Math.round(signal_touch[i]);
+        }
+
+        int[] blob = new int[native_lib.BLOB_INFO_SIZE];
+        int num_blobs = native_lib.onDetectBlobs(frame, row, col, touch_threshold,
+                touch_threshold / 2, 1, blob);
+        if (num_blobs <= 0) {
+            /* not an error, the SNR is calculated at the max. tixel instead */
+            Log.i(SYNA_TAG, "ActivitySNRCalculator locateTouchPosition() " +
+                    "no touch is found, threshold = " + touch_threshold);
+            result_str.append("\nTouch, ")
+                    .append("no touch is found, threshold = ").append(touch_threshold)
+                    .append(", the SNR is at the max. tixel");
+            return ret_code;
+        }
+
+        pos[0] = blob[native_lib.BLOB_INFO_PEAK_TIXEL] % row;
+        pos[1] = blob[native_lib.BLOB_INFO_PEAK_TIXEL] / row;
+
+        double scale = native_lib.BLOB_CENTROID_SCALE;
+        result_str.append("\nTouch, ")
+                .append(String.format(Locale.getDefault(),
+                        "the centroid at (%05.2f,%05.2f), peak %d at (%02d,%02d), area %d",
+                        blob[native_lib.BLOB_INFO_CENTROID_Y] / scale,
+                        blob[native_lib.BLOB_INFO_CENTROID_X] / scale,
+                        blob[native_lib.BLOB_INFO_PEAK],
+                        pos[0], pos[1],
+                        blob[native_lib.BLOB_INFO_AREA]));
 
         return ret_code;
     }
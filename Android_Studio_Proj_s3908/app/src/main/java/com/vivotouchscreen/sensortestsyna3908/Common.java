@@ -47,4 +47,9 @@ public class Common {
     public static final String STR_CFG_DO_NOSLEEP = "CFG_DO_NOSLEEP";
     public static final String STR_CFG_DO_REZERO = "CFG_DO_REZERO";
 
+    /* file of the reference frames, placed in the app's files directory */
+    public static final String STR_REF_STORE_FILE = "syna_ref_store.bin";
+    /* cache of the compiled test limits, placed in the app's files directory */
+    public static final String STR_LIMIT_CACHE_FILE = "syna_limit_cache.bin";
+
 }
\ No newline at end of file
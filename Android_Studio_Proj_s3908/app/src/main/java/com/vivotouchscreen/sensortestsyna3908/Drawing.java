@@ -81,6 +81,18 @@ public class Drawing extends View {
         //super.onDraw(canvas);
         canvas.drawBitmap(bitmap,0,0,null);
     }
+    /********************************************************
+     * Function to show the pixels rendered by the native library,
+     * the pixels are placed from the top-left corner
+     ********************************************************/
+    public void drawPixels(int[] pixels, int pixels_width, int pixels_height) {
+
+        bitmap.setPixels(pixels, 0, pixels_width, 0, 0,
+                Math.min(pixels_width, width), Math.min(pixels_height, height));
+
+        /* re-paint */
+        invalidate();
+    }
     /********************************************************
      * Function to draw a circle with the appointed center
      ********************************************************/
@@ -184,6 +184,37 @@ class NativeWrapper {
     private native boolean closeSynaDevJNI();
     private native boolean doDevPreparationJNI(boolean do_no_sleep, boolean do_rezero);
 
+    /********************************************************
+     * helper functions to record the bus transactions
+     *
+     * onStartBusTrace() records every read/write to the device into
+     * a binary trace, which can be replayed by syna_cli -p on a workstation.
+     * start it before onOpenDev() to replay the session from the beginning.
+     * onStopBusTrace() returns the number of transactions recorded
+     * both are rejected while the test job or the image stream is running
+     ********************************************************/
+    boolean onStartBusTrace(String trace_file) {
+
+        boolean ret = startBusTraceJNI(trace_file);
+        if (!ret) {
+            Log.e(SYNA_TAG, "NativeWrapper onStartBusTrace() fail to start the trace, " + trace_file);
+            return false;
+        }
+        return true;
+    }
+
+    int onStopBusTrace() {
+
+        int ret = stopBusTraceJNI();
+        if (ret < 0)
+            Log.e(SYNA_TAG, "NativeWrapper onStopBusTrace() fail to stop the trace, " + ret);
+
+        return ret;
+    }
+
+    private native boolean startBusTraceJNI(String trace_file);
+    private native int stopBusTraceJNI();
+
 
     /********************************************************
      * helper functions to perform the device identification
@@ -294,6 +325,18 @@ class NativeWrapper {
     }
     private native int getForceElecsJNI();
 
+    /**
+     * latency of the last sw reset in micro-seconds, measured on tcm device only
+     * return negative value if not available
+     */
+    int getDevResetLatency() {
+        if (!is_initialized)
+            return -1;
+
+        return getResetLatencyJNI();
+    }
+    private native int getResetLatencyJNI();
+
     int getDevFwConfigSize() {
         if (!is_initialized)
             return 0;
@@ -307,6 +350,81 @@ class NativeWrapper {
     }
     private native boolean getFwConfigJNI(byte[] array, int size_of_array);
 
+    /* area of the streaming readback, must be equivalent to enum SYNA_STREAM_AREA */
+    final int STREAM_AREA_STATIC_CONFIG = 0;
+    final int STREAM_AREA_LCM_DATA = 1;
+    final int STREAM_AREA_OEM_DATA = 2;
+    final int STREAM_AREA_PPDT_DATA = 3;
+    final int STREAM_AREA_FORCE_CALIBRATION_DATA = 4;
+    /* order of streaming result, must be equivalent to enum SYNA_STREAM_INFO */
+    final int STREAM_INFO_BYTES = 0;
+    final int STREAM_INFO_CRC32 = 1;
+    final int STREAM_INFO_MISMATCH_OFFSET = 2;
+    final int STREAM_INFO_MISMATCH_BYTES = 3;
+    final int STREAM_INFO_SIZE = 4;
+
+    /**
+     * read back the config or flash area into out_file in native layer,
+     * and compare with golden_file on the fly; both files could be null
+     * return 1 if mismatch is found, 0 if not, or negative value if failed
+     */
+    int onStreamFwConfig(int area, String out_file, String golden_file,
+                         boolean stop_on_mismatch, int[] info) {
+        if (!is_initialized)
+            return -1;
+
+        return streamFwConfigJNI(area, out_file, golden_file, stop_on_mismatch, info);
+    }
+    private native int streamFwConfigJNI(int area, String out_file, String golden_file,
+                                         boolean stop_on_mismatch, int[] info);
+
+    /* area of the flash programming, must be equivalent to enum tcm_data_area */
+    final int PROGRAM_AREA_LCM_DATA = 1;
+    final int PROGRAM_AREA_OEM_DATA = 2;
+    final int PROGRAM_AREA_PPDT_DATA = 3;
+    final int PROGRAM_AREA_FORCE_CALIBRATION_DATA = 4;
+    /* order of programming result, must be equivalent to enum SYNA_PROGRAM_INFO */
+    final int PROGRAM_INFO_BYTES = 0;
+    final int PROGRAM_INFO_CRC32 = 1;
+    final int PROGRAM_INFO_ERASE_TIME_US = 2;
+    final int PROGRAM_INFO_WRITE_TIME_US = 3;
+    final int PROGRAM_INFO_VERIFY_TIME_US = 4;
+    final int PROGRAM_INFO_WRITE_KBPS = 5;
+    final int PROGRAM_INFO_SIZE = 6;
+
+    /**
+     * write the image into the flash area of tcm device, and verify it
+     * by reading back; the result is filled into info
+     * return negative value if failed
+     */
+    int onProgramFwArea(int area, byte[] image, boolean is_4byte_format, int[] info) {
+        if (!is_initialized)
+            return -1;
+
+        int ret = programFwAreaJNI(area, image, is_4byte_format, info);
+        if (ret < 0)
+            Log.e(SYNA_TAG, "NativeWrapper onProgramFwArea() fail to program area " + area + ", " + ret);
+
+        return ret;
+    }
+    private native int programFwAreaJNI(int area, byte[] image, boolean is_4byte_format, int[] info);
+
+    /**
+     * compare the firmware config with the golden image in native layer
+     * config_file is the config saved by onStreamFwConfig(), or null to use the device config
+     * golden_file is the golden image, or the folder of golden images named as <config id>.bin
+     * layout_file lists "<name> <offset> <length>" of each field, could be null
+     * return the differing ranges, one per line as "<offset>,<length>[,<field>...]",
+     * empty string if identical, or null if failed
+     */
+    String onDiffFwConfig(String config_file, String golden_file, String layout_file) {
+        if (!is_initialized)
+            return null;
+
+        return diffFwConfigJNI(config_file, golden_file, layout_file);
+    }
+    private native String diffFwConfigJNI(String config_file, String golden_file, String layout_file);
+
     /********************************************************
      * helper functions to retrieve the report image
      * for a successful report image reading, the steps are as follows
@@ -450,6 +568,372 @@ class NativeWrapper {
     private native boolean requestReportImageJNI(byte type, int row, int column,
                                                  int[] array, int size_of_array);
 
+    /********************************************************
+     * helper functions to acquire the report images in the native
+     * thread, which is decoupled from the consumers
+     * for a proper streaming, the steps are as follows
+     *   - call onStartReport()
+     *   - call onStartImageStream()
+     *   - loop onReadStreamRecorder() to take every frame in order
+     *   - loop onReadStreamPreview() in another thread to show the
+     *     latest frame or the aggregate at its own rate
+     *   - call onStopImageStream() and onStopReport()
+     *
+     * the frames missed by a slow consumer are counted in the
+     * statistics instead of slowing down the acquisition
+     ********************************************************/
+    static final int PREVIEW_MODE_LATEST = 0;
+    static final int PREVIEW_MODE_MAX = 1;
+    static final int PREVIEW_MODE_MIN = 2;
+    static final int PREVIEW_MODE_MEAN = 3;
+
+    static final int IMAGE_STREAM_ACQUIRED = 0;
+    static final int IMAGE_STREAM_RECORDED = 1;
+    static final int IMAGE_STREAM_RECORDER_DROPPED = 2;
+    static final int IMAGE_STREAM_CAPTURED = 3;
+    static final int IMAGE_STREAM_PREVIEWS = 4;
+    static final int IMAGE_STREAM_PREVIEW_FRAMES = 5;
+    static final int IMAGE_STREAM_PREVIEW_DROPPED = 6;
+    static final int IMAGE_STREAM_ERRORS = 7;
+    static final int IMAGE_STREAM_STAT_SIZE = 8;
+
+    static final int STREAM_RECORDER_DEPTH = 256;
+    static final int STREAM_NO_CAPTURE = -1;
+
+    /* return values of onReadStreamRecorder() and onReadStreamPreview() */
+    static final int STREAM_READ_TIMEOUT = 0;
+    static final int STREAM_READ_END = -1;
+
+    boolean onStartImageStream(byte type, int row, int col, int frame_size,
+                               int recorder_depth, int capture_stream) {
+
+        if (!is_initialized) {
+            Log.e(SYNA_TAG, "NativeWrapper onStartImageStream() device is not initialized yet");
+            return false;
+        }
+
+        byte rt_id = getReportId(type);
+        if (rt_id == (byte)0xff) {
+            Log.e(SYNA_TAG, "NativeWrapper onStartImageStream() unknown report id");
+            return false;
+        }
+
+        boolean ret = startImageStreamJNI(rt_id, row, col, frame_size,
+                recorder_depth, capture_stream);
+        if (!ret) {
+            Log.e(SYNA_TAG, "NativeWrapper onStartImageStream() fail to start the stream");
+        }
+        return ret;
+    }
+
+    int onStopImageStream() {
+        int ret = stopImageStreamJNI();
+        if (ret < 0)
+            Log.e(SYNA_TAG, "NativeWrapper onStopImageStream() stream is stopped by error " + ret);
+
+        return ret;
+    }
+
+    boolean onSetStreamPreview(int mode, int num_frames, int interval_ms) {
+        return setStreamPreviewJNI(mode, num_frames, interval_ms);
+    }
+
+    /* return >0, frame is taken */
+    /*        STREAM_READ_TIMEOUT, no frame in time */
+    /*        STREAM_READ_END, stream is stopped or error out */
+    int onReadStreamRecorder(int[] buf, int timeout_ms) {
+        int ret = readStreamRecorderJNI(buf, timeout_ms);
+        if (ret < 0)
+            return STREAM_READ_END;
+
+        return ret;
+    }
+
+    /* return >0, number of frames represented by the preview */
+    /*        STREAM_READ_TIMEOUT, no frame in time */
+    /*        STREAM_READ_END, stream is stopped or error out */
+    int onReadStreamPreview(int[] buf, int timeout_ms) {
+        int ret = readStreamPreviewJNI(buf, timeout_ms);
+        if (ret < 0)
+            return STREAM_READ_END;
+
+        return ret;
+    }
+
+    int[] onGetImageStreamStats() {
+        int[] stats = new int[IMAGE_STREAM_STAT_SIZE];
+
+        if (getImageStreamStatsJNI(stats) < 0)
+            return null;
+
+        return stats;
+    }
+
+    private native boolean startImageStreamJNI(byte type, int row, int col, int frame_size,
+                                               int recorder_depth, int capture_stream);
+    private native int stopImageStreamJNI();
+    private native boolean setStreamPreviewJNI(int mode, int num_frames, int interval_ms);
+    private native int readStreamRecorderJNI(int[] buf, int timeout_ms);
+    private native int readStreamPreviewJNI(int[] buf, int timeout_ms);
+    private native int getImageStreamStatsJNI(int[] stats);
+
+    /********************************************************
+     * helper functions to track the baseline drift over the
+     * long run, e.g. soak or temperature testing
+     * the drift tracker is fed by the image stream, so the
+     * steps are as follows
+     *   - call onStartReport() with the raw report
+     *   - call onStartDriftTracker()
+     *   - call onStartImageStream()
+     *   - loop onReadDriftSnapshot() and onWaitDriftEvent()
+     *   - call onStopImageStream(), onStopDriftTracker() and onStopReport()
+     *
+     * drift values are in 1/DRIFT_SCALE count
+     ********************************************************/
+    static final int DRIFT_MAX_TAU = 4;
+    static final int DRIFT_SCALE = 16;
+
+    static final int DRIFT_SNAPSHOT_TIME_MS = 0;
+    static final int DRIFT_SNAPSHOT_FRAMES = 1;
+    static final int DRIFT_SNAPSHOT_EVENTS = 2;
+    static final int DRIFT_SNAPSHOT_HEADER_SIZE = 3;
+    static final int DRIFT_TAU_MIN = 0;
+    static final int DRIFT_TAU_MAX = 1;
+    static final int DRIFT_TAU_MEAN = 2;
+    static final int DRIFT_TAU_PEAK_TIXEL = 3;
+    static final int DRIFT_TAU_STAT_SIZE = 4;
+
+    static final int DRIFT_EVENT_TIME_MS = 0;
+    static final int DRIFT_EVENT_TAU_INDEX = 1;
+    static final int DRIFT_EVENT_TIXEL = 2;
+    static final int DRIFT_EVENT_DRIFT = 3;
+    static final int DRIFT_EVENT_COUNT = 4;
+    static final int DRIFT_EVENT_INFO_SIZE = 5;
+
+    /* threshold is in count, 0 to disable the event */
+    boolean onStartDriftTracker(int row, int col, int[] tau_ms, int warmup_frames,
+                                int snapshot_interval_ms, int threshold, int event_tau_index,
+                                String log_file) {
+        if (!is_initialized) {
+            Log.e(SYNA_TAG, "NativeWrapper onStartDriftTracker() device is not initialized yet");
+            return false;
+        }
+
+        int ret = startDriftTrackerJNI(col, row, tau_ms, warmup_frames, snapshot_interval_ms,
+                threshold, event_tau_index, log_file);
+        if (ret < 0) {
+            Log.e(SYNA_TAG, "NativeWrapper onStartDriftTracker() fail to start the tracker");
+            return false;
+        }
+        return true;
+    }
+
+    int onStopDriftTracker() {
+        return stopDriftTrackerJNI();
+    }
+
+    /* size of snapshot is DRIFT_SNAPSHOT_HEADER_SIZE + DRIFT_TAU_STAT_SIZE * tau_ms.length */
+    /* return >0, snapshot is taken */
+    /*        STREAM_READ_TIMEOUT, no snapshot in time */
+    /*        STREAM_READ_END, tracker is stopped */
+    int onReadDriftSnapshot(int[] snapshot, int timeout_ms) {
+        int ret = readDriftSnapshotJNI(snapshot, timeout_ms);
+        if (ret < 0)
+            return STREAM_READ_END;
+
+        return ret;
+    }
+
+    /* return >0, event is taken, see DRIFT_EVENT_* */
+    /*        STREAM_READ_TIMEOUT, no event in time */
+    /*        STREAM_READ_END, tracker is stopped */
+    int onWaitDriftEvent(int[] info, int timeout_ms) {
+        int ret = waitDriftEventJNI(info, timeout_ms);
+        if (ret < 0)
+            return STREAM_READ_END;
+
+        return ret;
+    }
+
+    /* return the number of tixels, or negative value if the warm-up is not completed */
+    int onGetDriftFrame(int tau_index, int[] drift) {
+        return getDriftFrameJNI(tau_index, drift);
+    }
+
+    private native int startDriftTrackerJNI(int col, int row, int[] tau_ms, int warmup_frames,
+                                            int snapshot_interval_ms, int threshold,
+                                            int event_tau_index, String log_file);
+    private native int stopDriftTrackerJNI();
+    private native int readDriftSnapshotJNI(int[] snapshot, int timeout_ms);
+    private native int waitDriftEventJNI(int[] info, int timeout_ms);
+    private native int getDriftFrameJNI(int tau_index, int[] drift);
+
+    /********************************************************
+     * helper functions to classify the delta frames into
+     * untouched and stable touched frames, e.g. SNR testing
+     *
+     * the touch is detected by the max. delta, and the contact
+     * is stable once the peak and centroid stay steady for the
+     * stable frames; the threshold is learned from the noise of
+     * untouched frames if TOUCH_THRESHOLD_AUTO is given
+     *
+     * centroid is in 1/TOUCH_CENTROID_SCALE tixel
+     ********************************************************/
+    static final int TOUCH_CLASS_UNTOUCHED = 0;
+    static final int TOUCH_CLASS_ONSET = 1;
+    static final int TOUCH_CLASS_STABLE = 2;
+    static final int TOUCH_CLASS_LIFTOFF = 3;
+
+    static final int TOUCH_INFO_CLASS = 0;
+    static final int TOUCH_INFO_PEAK = 1;
+    static final int TOUCH_INFO_PEAK_TIXEL = 2;
+    static final int TOUCH_INFO_CENTROID_X = 3;
+    static final int TOUCH_INFO_CENTROID_Y = 4;
+    static final int TOUCH_INFO_THRESHOLD = 5;
+    static final int TOUCH_INFO_STABLE_COUNT = 6;
+    static final int TOUCH_INFO_SIZE = 7;
+
+    static final int TOUCH_CENTROID_SCALE = 16;
+    static final int TOUCH_THRESHOLD_AUTO = 0;
+    static final int TOUCH_STABLE_FRAMES = 5;
+    static final int TOUCH_STABLE_DISTANCE = 8;
+    static final int TOUCH_STABLE_PERCENT = 10;
+    static final int TOUCH_SETTLE_FRAMES = 5;
+
+    boolean onInitTouchClassifier(int row, int col, int threshold, int stable_frames,
+                                  int stable_distance, int stable_percent, int settle_frames) {
+        int ret = initTouchClassifierJNI(col, row, threshold, stable_frames,
+                stable_distance, stable_percent, settle_frames);
+        if (ret < 0) {
+            Log.e(SYNA_TAG, "NativeWrapper onInitTouchClassifier() fail to initialize the classifier");
+            return false;
+        }
+        return true;
+    }
+
+    boolean onInitTouchClassifier(int row, int col) {
+        return onInitTouchClassifier(row, col, TOUCH_THRESHOLD_AUTO, TOUCH_STABLE_FRAMES,
+                TOUCH_STABLE_DISTANCE, TOUCH_STABLE_PERCENT, TOUCH_SETTLE_FRAMES);
+    }
+
+    /* return TOUCH_CLASS_* of the frame, or negative value if fail */
+    /* info could be null, otherwise see TOUCH_INFO_* */
+    int onClassifyTouchFrame(int[] frame, int[] info) {
+        return classifyTouchFrameJNI(frame, info);
+    }
+
+    private native int initTouchClassifierJNI(int col, int row, int threshold, int stable_frames,
+                                              int stable_distance, int stable_percent,
+                                              int settle_frames);
+    private native int classifyTouchFrameJNI(int[] frame, int[] info);
+
+    /********************************************************
+     * helper functions to find the connected blobs of the delta
+     * frame, e.g. to locate the touch position from the raw data
+     *
+     * the hysteresis mode is used if the low_threshold is between
+     * 0 and threshold, the blob grows through the tixels over the
+     * low_threshold, but its peak should be over the threshold
+     *
+     * blobs are in descending order of the peak, BLOB_INFO_SIZE
+     * integers per blob; centroid is in 1/BLOB_CENTROID_SCALE tixel
+     ********************************************************/
+    static final int BLOB_INFO_PEAK = 0;
+    static final int BLOB_INFO_PEAK_TIXEL = 1;
+    static final int BLOB_INFO_AREA = 2;
+    static final int BLOB_INFO_SUM = 3;
+    static final int BLOB_INFO_CENTROID_X = 4;
+    static final int BLOB_INFO_CENTROID_Y = 5;
+    static final int BLOB_INFO_SIZE = 6;
+
+    static final int BLOB_CENTROID_SCALE = 16;
+
+    /* return the number of blobs found, which could be more than blobs copied */
+    /*        or negative value if fail */
+    int onDetectBlobs(int[] frame, int row, int col, int threshold, int low_threshold,
+                      int min_area, int[] blobs) {
+        return detectBlobsJNI(frame, col, row, threshold, low_threshold, min_area, blobs);
+    }
+
+    private native int detectBlobsJNI(int[] frame, int col, int row, int threshold,
+                                      int low_threshold, int min_area, int[] blobs);
+
+    /********************************************************
+     * helper functions to trace the latency of the frames
+     * requested by onRequestReport() or the image stream
+     *
+     * each frame is tagged at request, header arrival, payload
+     * complete, reorder complete and the hand-off to its consumer,
+     * the java array of onRequestReport(), or the recorder queue
+     * and the preview of the image stream,
+     * the latency of each stage is kept for the latest 512 frames
+     *
+     * onGetFrameLatency() returns the percentile in micro-seconds,
+     * or -1 if no frame is traced
+     * onGetFrameLatencyReport() returns one stage per line
+     *   <stage>,<frames>,<p50_us>,<p90_us>,<p99_us>,<max_us>
+     ********************************************************/
+    static final int FRAME_LATENCY_FIRMWARE = 0;  /* request -> header */
+    static final int FRAME_LATENCY_BUS = 1;       /* header -> payload */
+    static final int FRAME_LATENCY_PARSE = 2;     /* payload -> reorder */
+    static final int FRAME_LATENCY_DELIVER = 3;   /* reorder -> consumer */
+    static final int FRAME_LATENCY_TOTAL = 4;     /* request -> consumer */
+    static final int FRAME_LATENCY_PERIOD = 5;    /* request -> next request */
+
+    int onGetFrameLatency(int latency, int percent) {
+        int ret = getFrameLatencyJNI(latency, percent);
+        if (ret < 0)
+            return -1;
+
+        return ret;
+    }
+
+    String onGetFrameLatencyReport() {
+        return getFrameLatencyReportJNI();
+    }
+
+    void onResetFrameLatency() {
+        resetFrameLatencyJNI();
+    }
+
+    private native int getFrameLatencyJNI(int latency, int percent);
+    private native String getFrameLatencyReportJNI();
+    private native void resetFrameLatencyJNI();
+
+    /********************************************************
+     * onRenderHeatmap() maps the report image to the colors in
+     * the native layer, and fills the pixel array in the format
+     * of android.graphics.Color, which can be copied into a bitmap
+     * by Drawing.drawPixels() directly
+     *
+     * the range is determined by each frame if range_max <= range_min
+     ********************************************************/
+    static final int HEATMAP_COLORMAP_JET = 0;
+    static final int HEATMAP_COLORMAP_GRAY = 1;
+    static final int HEATMAP_COLORMAP_BWR = 2;
+    static final int HEATMAP_SCALING_NEAREST = 0;
+    static final int HEATMAP_SCALING_BILINEAR = 1;
+
+    boolean onRenderHeatmap(int[] image, int col, int row, int[] pixels, int width, int height,
+                            int colormap, int scaling, int range_min, int range_max) {
+
+        if ((image == null) || (pixels == null)) {
+            Log.e(SYNA_TAG, "NativeWrapper onRenderHeatmap() buffer is null.");
+            return false;
+        }
+        if ((image.length < col * row) || (pixels.length < width * height)) {
+            Log.e(SYNA_TAG, "NativeWrapper onRenderHeatmap() invalid buffer size");
+            return false;
+        }
+
+        return renderHeatmapJNI(image, col, row, pixels, width, height,
+                colormap, scaling, range_min, range_max);
+    }
+    private native boolean renderHeatmapJNI(int[] image, int col, int row,
+                                            int[] pixels, int width, int height,
+                                            int colormap, int scaling,
+                                            int range_min, int range_max);
+
     /********************************************************
      * helper functions to perform the production tests
      * for a proper testing, the steps are as follows
@@ -514,6 +998,180 @@ class NativeWrapper {
                                             int[] limit_max, int size_limit_max,
                                             int[] result, int size_result);
 
+    /********************************************************
+     * helper functions to keep the test limits in native layer
+     * the .ini file is parsed once, and the compiled limits are
+     * cached in cache_file for the next loading
+     *
+     * once the limits are loaded, call onRunProductionTest() with
+     * null limit and size 0, the limit of test_id is used directly
+     ******************************************************/
+    int onLoadTestLimit(String ini_file, String cache_file) {
+        return loadTestLimitJNI(ini_file, cache_file);
+    }
+    void onReleaseTestLimit() {
+        releaseTestLimitJNI();
+    }
+    /**
+     * copy the limit of test_id to the array, for presentation only
+     * return the size of limit, or negative value if not defined
+     */
+    int getTestLimit(int test_id, boolean is_max, int[] limit) {
+        return getTestLimitJNI(test_id, is_max, limit);
+    }
+    private native int loadTestLimitJNI(String ini_file, String cache_file);
+    private native void releaseTestLimitJNI();
+    private native int getTestLimitJNI(int test_id, boolean is_max, int[] limit);
+
+    /********************************************************
+     * helper functions to keep the reference frames in native layer
+     * frames are kept per product, config id and test in the
+     * store file, which is mapped by the native layer
+     *
+     * once the reference frame is in the store, call
+     * onRunProductionTestExHR() with null ref, the frame in
+     * the store is used directly
+     ******************************************************/
+    /* kind of frame, must be equivalent to enum SYNA_REF_KIND */
+    final int REF_KIND_REFERENCE = 0;
+    final int REF_KIND_BASELINE = 1;
+
+    int onOpenReferenceStore(String store_file) {
+        return openReferenceStoreJNI(store_file);
+    }
+    void onCloseReferenceStore() {
+        closeReferenceStoreJNI();
+    }
+    /**
+     * update the frame of test_id with the average of num_frames frames,
+     * which are placed one after another in frames, e.g. the captures
+     * return negative value if failed
+     */
+    int onUpdateReferenceFrame(int test_id, int kind, int row, int col,
+                               int[] frames, int num_frames) {
+        if (!is_initialized) {
+            Log.e(SYNA_TAG, "NativeWrapper onUpdateReferenceFrame() device is not initialized yet");
+            return -1;
+        }
+        return updateReferenceFrameJNI(test_id, kind, col, row, frames, num_frames);
+    }
+    /**
+     * import the frame of test_id in the test configuration file
+     * the frame in the store is kept if it is updated from the captures,
+     * or it is imported from the same frame, which is checked by crc32
+     * return 1 if imported, 0 if the frame in the store is kept,
+     * or negative value if failed
+     */
+    final int REF_IMPORT_KEPT = 0;
+    final int REF_IMPORT_DONE = 1;
+
+    int onImportReferenceFrame(int test_id, int kind, int row, int col, int[] frame) {
+        if (!is_initialized) {
+            Log.e(SYNA_TAG, "NativeWrapper onImportReferenceFrame() device is not initialized yet");
+            return -1;
+        }
+        return importReferenceFrameJNI(test_id, kind, col, row, frame);
+    }
+    /**
+     * copy the frame of test_id to the array, for presentation only
+     * array could be null to check whether the frame is available
+     * return the size of frame, or negative value if not found
+     */
+    int onGetReferenceFrame(int test_id, int kind, int row, int col, int[] frame) {
+        if (!is_initialized) {
+            Log.e(SYNA_TAG, "NativeWrapper onGetReferenceFrame() device is not initialized yet");
+            return -1;
+        }
+        return getReferenceFrameJNI(test_id, kind, col, row, frame);
+    }
+    private native int openReferenceStoreJNI(String store_file);
+    private native void closeReferenceStoreJNI();
+    private native int updateReferenceFrameJNI(int test_id, int kind, int col, int row,
+                                               int[] frames, int num_frames);
+    private native int importReferenceFrameJNI(int test_id, int kind, int col, int row, int[] frame);
+    private native int getReferenceFrameJNI(int test_id, int kind, int col, int row, int[] frame);
+
+    /********************************************************
+     * helper functions to run the production tests in background
+     * the limits are taken from onLoadTestLimit()
+     *
+     * poll getTestJobProgress() for the progress, the device
+     * should not be accessed until the job is completed
+     ******************************************************/
+    /* state of job, must be equivalent to enum SYNA_JOB_STATE */
+    final int JOB_STATE_IDLE = 0;
+    final int JOB_STATE_RUNNING = 1;
+    final int JOB_STATE_DONE = 2;
+    final int JOB_STATE_CANCELLED = 3;
+    /* state of test, must be equivalent to enum SYNA_JOB_TEST_STATE */
+    final int JOB_TEST_PENDING = 0;
+    final int JOB_TEST_RUNNING = 1;
+    final int JOB_TEST_PASS = 2;
+    final int JOB_TEST_FAIL = 3;
+    final int JOB_TEST_ERROR = 4;
+    final int JOB_TEST_CANCELLED = 5;
+    final int JOB_TEST_TIMEOUT = 6;
+    /* order of progress information, must be equivalent to enum SYNA_JOB_PROGRESS_INFO */
+    final int JOB_INFO_STATE = 0;
+    final int JOB_INFO_CURRENT = 1;
+    final int JOB_INFO_COMPLETED = 2;
+    final int JOB_INFO_NUM_TESTS = 3;
+    final int JOB_INFO_SIZE = 4;
+    /* order of test information, must be equivalent to enum SYNA_JOB_TEST_INFO */
+    final int JOB_TEST_INFO_ID = 0;
+    final int JOB_TEST_INFO_STATE = 1;
+    final int JOB_TEST_INFO_RETVAL = 2;
+    final int JOB_TEST_INFO_ELAPSED_MS = 3;
+    final int JOB_TEST_INFO_SIZE = 4;
+
+    /**
+     * deadlines_ms and aux_sizes could be null
+     * is_scheduled, true to re-order the tests to reduce the resets and mode switches,
+     * the results are still indexed in the submitted order
+     * return the handle of job, or negative value if failed
+     */
+    int onSubmitTestJob(int[] test_ids, int[] deadlines_ms, int[] result_sizes, int[] aux_sizes,
+                        int col, int row, boolean is_scheduled) {
+        if (!is_initialized) {
+            Log.e(SYNA_TAG, "NativeWrapper onSubmitTestJob() device is not initialized yet");
+            return -1;
+        }
+        return submitTestJobJNI(test_ids, deadlines_ms, result_sizes, aux_sizes, col, row,
+                                is_scheduled);
+    }
+    boolean onCancelTestJob(int handle) {
+        return cancelTestJobJNI(handle);
+    }
+    /**
+     * return the state of job, or negative value if timeout
+     */
+    int onWaitTestJob(int handle, int timeout_ms) {
+        return waitTestJobJNI(handle, timeout_ms);
+    }
+    void onReleaseTestJob(int handle) {
+        releaseTestJobJNI(handle);
+    }
+    boolean getTestJobProgress(int handle, int[] info) {
+        return getTestJobProgressJNI(handle, info);
+    }
+    boolean getTestJobTestInfo(int handle, int index, int[] info) {
+        return getTestJobTestInfoJNI(handle, index, info);
+    }
+    /**
+     * return the size of result, or negative value if the test is not completed
+     */
+    int getTestJobResult(int handle, int index, boolean is_aux, int[] result) {
+        return getTestJobResultJNI(handle, index, is_aux, result);
+    }
+    private native int submitTestJobJNI(int[] test_ids, int[] deadlines_ms, int[] result_sizes,
+                                        int[] aux_sizes, int col, int row, boolean is_scheduled);
+    private native boolean cancelTestJobJNI(int handle);
+    private native int waitTestJobJNI(int handle, int timeout_ms);
+    private native void releaseTestJobJNI(int handle);
+    private native boolean getTestJobProgressJNI(int handle, int[] info);
+    private native boolean getTestJobTestInfoJNI(int handle, int index, int[] info);
+    private native int getTestJobResultJNI(int handle, int index, boolean is_aux, int[] result);
+
 
     int onRunProductionTestExHR(int row, int column, short[] ref, int limit_surface,
                                 int limit_txroe, int limit_rxroe, int[] result, int size_result,
@@ -612,6 +1270,24 @@ class NativeWrapper {
     private native int runRawCommandJNI(byte type, int cmd, byte[] in, int size_of_in,
                                         byte[] out, int size_of_out);
 
+    /********************************************************
+     * onRunRawScript executes the whole command file in the native layer,
+     * supporting loop/end blocks and expect assertions in addition to
+     * the read/write/wait commands
+     *
+     * return the timing of each command, one command per line
+     *   <line>,<op>,<count>,<fail>,<min_us>,<avg_us>,<max_us>
+     * or null if the script cannot be executed
+     ********************************************************/
+    String onRunRawScript(String script_file, boolean stop_on_fail) {
+        if (!is_initialized)
+            return null;
+
+        Log.i(SYNA_TAG, "NativeWrapper onRunRawScript() " + script_file);
+        return runRawScriptJNI(script_file, stop_on_fail);
+    }
+    private native String runRawScriptJNI(String script_file, boolean stop_on_fail);
+
 
     /********************************************************
      * helper functions being used to monitor the touch event
@@ -752,5 +1428,81 @@ class NativeWrapper {
     private native boolean getPinsMappingJNI(int rxes_offset, int rxes_len,
                                              int txes_offset, int txes_len);
 
+    /********************************************************
+     * helper functions to record and read the capture file
+     *
+     * the capture file keeps the interleaved streams with timestamp,
+     * and an index at the end of file for random access
+     * the stream id must be equivalent to the SYNA_CAPTURE_STREAM in native layer
+     ********************************************************/
+    final int CAPTURE_STREAM_DELTA = 0;
+    final int CAPTURE_STREAM_RAW = 1;
+    final int CAPTURE_STREAM_HYBRID_ABS = 2;
+    final int CAPTURE_STREAM_TOUCH_REPORT = 3;
+    final int CAPTURE_STREAM_GEAR_CHANGE = 4;
+    final int CAPTURE_STREAM_TEST_RESULT = 5;
+
+    boolean onOpenCaptureFile(String path, int row, int col) {
+        boolean ret = openCaptureFileJNI(path, row, col);
+        if (!ret) {
+            Log.e(SYNA_TAG, "NativeWrapper onOpenCaptureFile() fail to create " + path);
+        }
+        return ret;
+    }
+    int onCloseCaptureFile() {
+        return closeCaptureFileJNI();
+    }
+    boolean onWriteCaptureRecord(int stream, int[] data) {
+        return writeCaptureRecordJNI(stream, data, data.length);
+    }
+
+    boolean onOpenCaptureReader(String path) {
+        boolean ret = openCaptureReaderJNI(path);
+        if (!ret) {
+            Log.e(SYNA_TAG, "NativeWrapper onOpenCaptureReader() fail to open " + path);
+        }
+        return ret;
+    }
+    void onCloseCaptureReader() {
+        closeCaptureReaderJNI();
+    }
+    int getCaptureRecordCount(int stream) {
+        return getCaptureRecordCountJNI(stream);
+    }
+    int onReadCaptureRecord(int stream, int n, int[] data) {
+        return readCaptureRecordJNI(stream, n, data, data.length);
+    }
+    long getCaptureRecordTime(int stream, int n) {
+        return getCaptureRecordTimeJNI(stream, n);
+    }
+    int findCaptureRecordByTime(int stream, long timestamp_us) {
+        return findCaptureRecordByTimeJNI(stream, timestamp_us);
+    }
+
+    private native boolean openCaptureFileJNI(String path, int row, int col);
+    private native int closeCaptureFileJNI();
+    private native boolean writeCaptureRecordJNI(int stream, int[] data, int size_of_data);
+    private native boolean openCaptureReaderJNI(String path);
+    private native void closeCaptureReaderJNI();
+    private native int getCaptureRecordCountJNI(int stream);
+    private native int readCaptureRecordJNI(int stream, int n, int[] data, int size_of_data);
+    private native long getCaptureRecordTimeJNI(int stream, int n);
+    private native int findCaptureRecordByTimeJNI(int stream, long timestamp_us);
+
+    /********************************************************
+     * helper function to evaluate the lossless frame codec
+     * with the frames recorded in a capture file
+     *
+     * return the report of compression ratio and throughput
+     ********************************************************/
+    String onRunCodecBenchmark(String path, int stream) {
+        String report = runCodecBenchmarkJNI(path, stream);
+        if (report == null) {
+            Log.e(SYNA_TAG, "NativeWrapper onRunCodecBenchmark() fail to run with " + path);
+        }
+        return report;
+    }
+    private native String runCodecBenchmarkJNI(String path, int stream);
+
 }
 
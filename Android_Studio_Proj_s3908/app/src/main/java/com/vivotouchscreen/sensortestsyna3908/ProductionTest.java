@@ -345,11 +345,17 @@ class ProductionTest {
         int[] result_rx = new int[row + col];
         int[] size_result_rx = new int[1];
 
-        /* clone the reference frame */
-        ref = new short[row * col];
-        for (int i = 0; i < ref_frame.size(); i++) {
-            temp = ref_frame.elementAt(i);
-            ref[i] = (short)temp;
+        /* the reference frame in the store is used by native layer directly */
+        if (is_ref_in_store) {
+            ref = null;
+        }
+        /* otherwise, clone the reference frame */
+        else {
+            ref = new short[row * col];
+            for (int i = 0; i < ref_frame.size(); i++) {
+                temp = ref_frame.elementAt(i);
+                ref[i] = (short)temp;
+            }
         }
 
         /* call function to perform the production  */
@@ -1324,6 +1330,8 @@ class ProductionTest {
     private int limit_txroe;
     private int limit_rxroe;
     private Vector<Integer> ref_frame = new Vector<>();
+    /* flag to indicate the reference frame is kept in the reference store */
+    private boolean is_ref_in_store;
 
     /********************************************************
      * helpers to setup the test limit
@@ -1358,10 +1366,34 @@ class ProductionTest {
             return false;
         }
 
+        /* the frame in .ini file is imported into the reference store, unless the frame */
+        /* in the store is updated by the averaged captures, or imported from the same frame */
+        is_ref_in_store = false;
         boolean ret_ref = test_cfg.onGetTestConfigurationData(str_ref_frame, ref_frame, size, size);
         if (ret_ref) {
             Log.i(SYNA_TAG, "ProductionTest getLimitFromTestCfgExHighResistance() " +
                     "ref_frame size = " + ref_frame.size() );
+
+            int[] frame = new int[size];
+            for (int i = 0; i < size; i++)
+                frame[i] = ref_frame.elementAt(i);
+
+            int ret_import = native_lib.onImportReferenceFrame(id, native_lib.REF_KIND_REFERENCE,
+                    row, col, frame);
+            if (ret_import == native_lib.REF_IMPORT_KEPT) {
+                Log.i(SYNA_TAG, "ProductionTest getLimitFromTestCfgExHighResistance() " +
+                        "ref_frame in the reference store is kept");
+            }
+            is_ref_in_store = (ret_import >= 0);
+        }
+        else if (native_lib.onGetReferenceFrame(id, native_lib.REF_KIND_REFERENCE,
+                row, col, null) == size) {
+            /* the frame in .ini file is missing, use the frame in the reference store */
+            Log.i(SYNA_TAG, "ProductionTest getLimitFromTestCfgExHighResistance() " +
+                    "ref_frame is in the reference store only");
+            ref_frame.clear();
+            is_ref_in_store = true;
+            ret_ref = true;
         }
         else {
             Log.e(SYNA_TAG, "ProductionTest getLimitFromTestCfgExHighResistance() " +
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c)  2012-2018 Synaptics Incorporated. All rights reserved.
+ * This file contains information that is proprietary to Synaptics
+ * Incorporated ("Synaptics"). The holder of this file shall treat all
+ * information contained herein as confidential, shall use the
+ * information only for its intended purpose, and shall not duplicate,
+ * disclose, or disseminate any of this information in any manner unless
+ * Synaptics has otherwise provided express, written permission.
+ * Use of the materials may require a license of intellectual property
+ * from a third party or from Synaptics. Receipt or possession of this
+ * file conveys no express or implied licenses to any intellectual
+ * property rights belonging to Synaptics.
+ * INFORMATION CONTAINED IN THIS DOCUMENT IS PROVIDED "AS-IS," AND
+ * SYNAPTICS EXPRESSLY DISCLAIMS ALL EXPRESS AND IMPLIED WARRANTIES,
+ * INCLUDING ANY IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE, AND ANY WARRANTIES OF NON-INFRINGEMENT OF ANY
+ * INTELLECTUAL PROPERTY RIGHTS. IN NO EVENT SHALL SYNAPTICS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, PUNITIVE, OR
+ * CONSEQUENTIAL DAMAGES ARISING OUT OF OR IN CONNECTION WITH THE USE OF
+ * THE INFORMATION CONTAINED IN THIS DOCUMENT, HOWEVER CAUSED AND BASED
+ * ON ANY THEORY OF LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION, AND EVEN IF SYNAPTICS WAS ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE. IF A TRIBUNAL OF COMPETENT
+ * JURISDICTION DOES NOT PERMIT THE DISCLAIMER OF DIRECT DAMAGES OR ANY
+ * OTHER DAMAGES, SYNAPTICS' TOTAL CUMULATIVE LIABILITY TO ANY PARTY
+ * SHALL NOT EXCEED ONE HUNDRED U.S. DOLLARS.
+ */
+
+/*
+ * host test of the heatmap renderer
+ * render the same frames with the vectorized build and the scalar build
+ * (SYNA_HEATMAP_NO_SIMD), and compare the pixels one by one
+ *
+ * build and run on the host, from this folder:
+ *   gcc -O2 -std=gnu99 -I../../main/cpp/jni -o syna_heatmap_test \
+ *       syna_heatmap_test.c syna_heatmap_scalar.c ../../main/cpp/jni/syna_heatmap.c
+ *   ./syna_heatmap_test
+ *
+ * the NEON kernels are covered by the same build with an arm toolchain,
+ * e.g. arm-linux-gnueabihf-gcc -mfpu=neon, and running under qemu-arm
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "syna_heatmap.h"
+
+int syna_heatmap_scalar_init(struct syna_heatmap *p_heatmap, int colormap, int format, int scaling);
+void syna_heatmap_scalar_release(struct syna_heatmap *p_heatmap);
+void syna_heatmap_scalar_set_range(struct syna_heatmap *p_heatmap, bool is_auto,
+                                   int range_min, int range_max);
+int syna_heatmap_scalar_render(struct syna_heatmap *p_heatmap, const short *p_frame, int cols, int rows,
+                               unsigned int *p_pixels, int width, int height, int stride);
+
+struct test_size {
+    int cols;
+    int rows;
+    int width;
+    int height;
+};
+
+/* image sizes of the sensors, plus odd sizes to cover the tails of the vector loops */
+static const struct test_size g_sizes[] = {
+    {18, 36, 180, 360},
+    {36, 18, 360, 180},
+    {16, 16, 16, 16},
+    {17, 9, 33, 19},
+    {37, 23, 301, 211},
+    {3, 2, 7, 5},
+    {1, 1, 4, 4},
+};
+
+/* seed of the pseudo random frames, the test is repeatable */
+static unsigned int g_seed = 0x5eed1234;
+
+/*
+ * Function:  test_rand
+ * --------------------
+ * helper function to generate the pseudo random number
+ */
+static unsigned int test_rand(void)
+{
+    g_seed = g_seed * 1103515245u + 12345u;
+    return (g_seed >> 8);
+}
+
+/*
+ * Function:  test_fill_frame
+ * --------------------
+ * fill the frame with the pattern
+ *  pattern 0: random value within [-amp, amp]
+ *  pattern 1: gradient with a peak, as a finger on the delta image
+ *  pattern 2: the full 16-bit range, to check the overflow
+ *  pattern 3: flat frame, min. equals to max.
+ */
+static void test_fill_frame(short *p_frame, int cols, int rows, int pattern, int amp)
+{
+    int x, y;
+    int v;
+
+    for (y = 0; y < rows; y++) {
+        for (x = 0; x < cols; x++) {
+            switch (pattern) {
+            case 0:
+                v = (int)(test_rand() % (unsigned int)(2 * amp + 1)) - amp;
+                break;
+            case 1:
+                v = (x + y) * 4 - ((x - cols / 2) * (x - cols / 2) + (y - rows / 2) * (y - rows / 2));
+                break;
+            case 2:
+                v = (int)(test_rand() & 0xffff) - 32768;
+                break;
+            default:
+                v = amp;
+                break;
+            }
+            if (v > 32767)
+                v = 32767;
+            if (v < -32768)
+                v = -32768;
+            p_frame[y * cols + x] = (short)v;
+        }
+    }
+}
+
+/*
+ * Function:  test_compare
+ * --------------------
+ * render one frame by both builds and compare the pixels
+ *
+ * return: number of different pixels, or <0 if fail to render
+ */
+static int test_compare(const struct test_size *p_size, int colormap, int format, int scaling,
+                        bool is_auto, int range_min, int range_max, const short *p_frame)
+{
+    struct syna_heatmap simd, scalar;
+    unsigned int *p_simd = NULL;
+    unsigned int *p_scalar = NULL;
+    int stride = p_size->width + 3;
+    size_t size = (size_t)stride * (size_t)p_size->height;
+    int num_diff = 0;
+    int retval;
+    size_t i;
+
+    retval = syna_heatmap_init(&simd, colormap, format, scaling);
+    if (retval < 0)
+        return retval;
+    retval = syna_heatmap_scalar_init(&scalar, colormap, format, scaling);
+    if (retval < 0) {
+        syna_heatmap_release(&simd);
+        return retval;
+    }
+    syna_heatmap_set_range(&simd, is_auto, range_min, range_max);
+    syna_heatmap_scalar_set_range(&scalar, is_auto, range_min, range_max);
+
+    p_simd = calloc(size, sizeof(unsigned int));
+    p_scalar = calloc(size, sizeof(unsigned int));
+    if ((!p_simd) || (!p_scalar)) {
+        retval = -1;
+        goto exit;
+    }
+
+    retval = syna_heatmap_render(&simd, p_frame, p_size->cols, p_size->rows,
+                                 p_simd, p_size->width, p_size->height, stride);
+    if (retval < 0)
+        goto exit;
+    retval = syna_heatmap_scalar_render(&scalar, p_frame, p_size->cols, p_size->rows,
+                                        p_scalar, p_size->width, p_size->height, stride);
+    if (retval < 0)
+        goto exit;
+
+    for (i = 0; i < size; i++) {
+        if (p_simd[i] == p_scalar[i])
+            continue;
+
+        if (num_diff == 0)
+            printf("  pixel (%d, %d): simd 0x%08x, scalar 0x%08x\n",
+                   (int)(i % (size_t)stride), (int)(i / (size_t)stride), p_simd[i], p_scalar[i]);
+        num_diff += 1;
+    }
+    retval = num_diff;
+
+exit:
+    free(p_simd);
+    free(p_scalar);
+    syna_heatmap_release(&simd);
+    syna_heatmap_scalar_release(&scalar);
+
+    return retval;
+}
+
+int main(void)
+{
+    static const int colormaps[] = {HEATMAP_COLORMAP_JET, HEATMAP_COLORMAP_GRAY, HEATMAP_COLORMAP_BWR};
+    static const int formats[] = {HEATMAP_FORMAT_RGBA, HEATMAP_FORMAT_ARGB_INT};
+    static const int scalings[] = {HEATMAP_SCALING_NEAREST, HEATMAP_SCALING_BILINEAR};
+    /* fixed ranges, the last one is narrower than the frame to check the clamping */
+    static const int ranges[][2] = {{0, 0}, {-500, 500}, {-32768, 32767}, {-20, 20}};
+    const struct test_size *p_size;
+    short *p_frame;
+    int num_cases = 0;
+    int num_failed = 0;
+    int s, p, c, f, k, r;
+    int retval;
+
+    for (s = 0; s < (int)(sizeof(g_sizes) / sizeof(g_sizes[0])); s++) {
+        p_size = &g_sizes[s];
+
+        p_frame = calloc((size_t)(p_size->cols * p_size->rows), sizeof(short));
+        if (!p_frame) {
+            printf("fail to allocate the frame\n");
+            return 1;
+        }
+
+        for (p = 0; p < 4; p++) {
+            test_fill_frame(p_frame, p_size->cols, p_size->rows, p, 300);
+
+            for (c = 0; c < 3; c++) {
+                for (f = 0; f < 2; f++) {
+                    for (k = 0; k < 2; k++) {
+                        for (r = 0; r < (int)(sizeof(ranges) / sizeof(ranges[0])); r++) {
+                            /* range {0, 0} selects the auto range */
+                            retval = test_compare(p_size, colormaps[c], formats[f], scalings[k],
+                                                  (r == 0), ranges[r][0], ranges[r][1], p_frame);
+                            num_cases += 1;
+                            if (retval == 0)
+                                continue;
+
+                            num_failed += 1;
+                            printf("FAIL: %dx%d -> %dx%d, pattern %d, colormap %d, format %d, "
+                                   "scaling %d, range %d (retval = %d)\n",
+                                   p_size->cols, p_size->rows, p_size->width, p_size->height,
+                                   p, colormaps[c], formats[f], scalings[k], r, retval);
+                        }
+                    }
+                }
+            }
+        }
+
+        free(p_frame);
+    }
+
+    printf("%d cases, %d failed\n", num_cases, num_failed);
+
+    return (num_failed == 0) ? 0 : 1;
+}
@@ -7,6 +7,9 @@ LOCAL_MODULE    := native_syna
 # list your C files to compile
 LOCAL_SRC_FILES := native-lib.c \
                    native-datalog.c \
+                   noise_stats.c \
+                   noise_fft.c \
+                   noise_sweep.c \
                    rmi_control.c \
                    syna_control.c \
                    tcm_control.c \
@@ -14,4 +17,9 @@ LOCAL_SRC_FILES := native-lib.c \
 
 LOCAL_LDLIBS    := -L$(SYSROOT)/usr/lib -llog
 
+# vectorized accumulation in noise_stats.c and butterflies in noise_fft.c
+ifeq ($(TARGET_ARCH_ABI),armeabi-v7a)
+LOCAL_ARM_NEON  := true
+endif
+
 include $(BUILD_SHARED_LIBRARY)
@@ -15,3 +15,619 @@
 *
 * ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "native-lib.h"
+#include "native-datalog.h"
+
+/*
+ * the binary log is written by a background thread with two buffers.
+ * the caller fills one buffer while the other one is written to the file,
+ * so the frame acquisition will not be throttled by the file i/o.
+ */
+struct datalog_writer {
+    int fd;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    unsigned char *buf[2];
+    int buf_frames[2];
+    bool buf_pending[2];    /* true, if the buffer is handed to the writer thread */
+    int fill_idx;           /* index of the buffer filled by the caller */
+    bool is_running;
+    bool is_stopping;
+    int error;
+    unsigned int record_size;
+    unsigned int frames_recorded;
+    struct datalog_header header;
+};
+
+static struct datalog_writer g_datalog;
+
+/*
+ * Function:  datalog_get_time_ns
+ * --------------------
+ * helper function to get the monotonic time in nanoseconds
+ * the same clock is used for the frame rate measured in noise_fft.c
+ */
+long long datalog_get_time_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+/*
+ * Function:  datalog_write_all
+ * --------------------
+ * helper function to write the whole buffer to the file descriptor
+ *
+ * return: <0, fail to write the data
+ *         otherwise, succeed
+ */
+static int datalog_write_all(int fd, const unsigned char *p_data, size_t size)
+{
+    ssize_t retval;
+
+    while (size > 0) {
+        retval = write(fd, p_data, size);
+        if (retval < 0) {
+            if (errno == EINTR)
+                continue;
+            printf_e("%s: fail to write data to the log (errno = %d)\n", __FUNCTION__, errno);
+            return -EIO;
+        }
+        p_data += retval;
+        size -= (size_t)retval;
+    }
+    return 0;
+}
+/*
+ * Function:  datalog_writer_thread
+ * --------------------
+ * background thread to write the filled buffers into the log file
+ * buffers are handed over alternately, so the thread follows the same order
+ */
+static void *datalog_writer_thread(void *arg)
+{
+    int idx = 0;
+    int retval;
+    size_t size;
+
+    (void)arg;
+
+    pthread_mutex_lock(&g_datalog.lock);
+    while (1) {
+        while (!g_datalog.buf_pending[idx] && !g_datalog.is_stopping)
+            pthread_cond_wait(&g_datalog.cond, &g_datalog.lock);
+
+        if (!g_datalog.buf_pending[idx])
+            break;
+
+        size = (size_t)g_datalog.buf_frames[idx] * g_datalog.record_size;
+        pthread_mutex_unlock(&g_datalog.lock);
+
+        retval = datalog_write_all(g_datalog.fd, g_datalog.buf[idx], size);
+
+        pthread_mutex_lock(&g_datalog.lock);
+        if (retval < 0)
+            g_datalog.error = retval;
+
+        g_datalog.buf_frames[idx] = 0;
+        g_datalog.buf_pending[idx] = false;
+        pthread_cond_broadcast(&g_datalog.cond);
+
+        idx ^= 1;
+    }
+    pthread_mutex_unlock(&g_datalog.lock);
+
+    return NULL;
+}
+/*
+ * Function:  datalog_open
+ * --------------------
+ * create the binary log, write the file header
+ * and start the background writer thread
+ *
+ * the header must be filled with the device information by the caller
+ *
+ * return: <0, fail to create the log
+ *         otherwise, succeed
+ */
+int datalog_open(const char *path, struct datalog_header *p_header)
+{
+    int retval = 0;
+    int i;
+    size_t buf_size;
+
+    if (!path || !p_header) {
+        printf_e("%s: invalid parameter\n", __FUNCTION__);
+        return -EINVAL;
+    }
+    if (g_datalog.is_running) {
+        printf_e("%s: binary log is already opened\n", __FUNCTION__);
+        return -EBUSY;
+    }
+    if ((p_header->tx_num == 0) || (p_header->rx_num == 0)) {
+        printf_e("%s: invalid image size (tx,rx) = (%d, %d)\n", __FUNCTION__,
+                 p_header->tx_num, p_header->rx_num);
+        return -EINVAL;
+    }
+
+    memset(&g_datalog, 0x00, sizeof(struct datalog_writer));
+    g_datalog.fd = -1;
+
+    memcpy(p_header->magic, DATALOG_MAGIC, sizeof(p_header->magic));
+    p_header->version = DATALOG_VERSION;
+    p_header->header_size = sizeof(struct datalog_header);
+    p_header->record_size = (unsigned int)(sizeof(struct datalog_frame_record) +
+                            p_header->tx_num * p_header->rx_num * sizeof(short));
+    p_header->frames_recorded = 0;
+    p_header->error_count = 0;
+    p_header->start_time = (long long)time(NULL);
+    p_header->start_time_ns = datalog_get_time_ns();
+
+    g_datalog.header = *p_header;
+    g_datalog.record_size = p_header->record_size;
+
+    buf_size = (size_t)g_datalog.record_size * DATALOG_FRAMES_PER_BUFFER;
+    for (i = 0; i < 2; i++) {
+        g_datalog.buf[i] = malloc(buf_size);
+        if (!g_datalog.buf[i]) {
+            printf_e("%s: fail to allocate the buffer (size = %d)\n", __FUNCTION__, (int)buf_size);
+            retval = -ENOMEM;
+            goto exit;
+        }
+    }
+
+    g_datalog.fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (g_datalog.fd < 0) {
+        printf_e("%s: unable to open file (name: %s)\n", __FUNCTION__, path);
+        retval = -EIO;
+        goto exit;
+    }
+
+    retval = datalog_write_all(g_datalog.fd, (unsigned char *)&g_datalog.header,
+                               sizeof(struct datalog_header));
+    if (retval < 0) {
+        printf_e("%s: fail to write header to the log file (name: %s)\n", __FUNCTION__, path);
+        goto exit;
+    }
+
+    pthread_mutex_init(&g_datalog.lock, NULL);
+    pthread_cond_init(&g_datalog.cond, NULL);
+
+    if (pthread_create(&g_datalog.thread, NULL, datalog_writer_thread, NULL) != 0) {
+        printf_e("%s: fail to create the writer thread\n", __FUNCTION__);
+        pthread_cond_destroy(&g_datalog.cond);
+        pthread_mutex_destroy(&g_datalog.lock);
+        retval = -EAGAIN;
+        goto exit;
+    }
+
+    g_datalog.is_running = true;
+    printf_i("%s: binary log is created (name: %s, record size = %d)\n", __FUNCTION__,
+             path, g_datalog.record_size);
+
+exit:
+    if (retval < 0) {
+        if (g_datalog.fd >= 0)
+            close(g_datalog.fd);
+        g_datalog.fd = -1;
+
+        for (i = 0; i < 2; i++) {
+            free(g_datalog.buf[i]);
+            g_datalog.buf[i] = NULL;
+        }
+    }
+    return retval;
+}
+/*
+ * Function:  datalog_acquire_frame
+ * --------------------
+ * get the image area of next frame record, the caller can read the report
+ * image into it directly. the monotonic timestamp is taken at this moment.
+ * the record is kept until datalog_commit_frame() is called.
+ *
+ * return: NULL, if the log is not opened or the writer is failed
+ *         otherwise, the pointer of image area
+ */
+short *datalog_acquire_frame(void)
+{
+    struct datalog_frame_record *p_record;
+    unsigned char *p_slot;
+    int idx;
+
+    if (!g_datalog.is_running)
+        return NULL;
+
+    pthread_mutex_lock(&g_datalog.lock);
+    /* wait for the buffer being written by the writer thread */
+    while (g_datalog.buf_pending[g_datalog.fill_idx] && (g_datalog.error == 0))
+        pthread_cond_wait(&g_datalog.cond, &g_datalog.lock);
+
+    if (g_datalog.error < 0) {
+        pthread_mutex_unlock(&g_datalog.lock);
+        printf_e("%s: writer thread is failed (error = %d)\n", __FUNCTION__, g_datalog.error);
+        return NULL;
+    }
+
+    idx = g_datalog.fill_idx;
+    p_slot = g_datalog.buf[idx] + (size_t)g_datalog.buf_frames[idx] * g_datalog.record_size;
+    pthread_mutex_unlock(&g_datalog.lock);
+
+    memset(p_slot, 0x00, g_datalog.record_size);
+
+    p_record = (struct datalog_frame_record *)p_slot;
+    p_record->timestamp_ns = datalog_get_time_ns();
+
+    return (short *)(p_slot + sizeof(struct datalog_frame_record));
+}
+/*
+ * Function:  datalog_commit_frame
+ * --------------------
+ * complete the frame record acquired by datalog_acquire_frame()
+ * if msg is not null, the message is kept in the image area instead
+ * once the buffer is full, it will be handed to the writer thread
+ *
+ * return: <0, fail to commit the record
+ *         otherwise, succeed
+ */
+int datalog_commit_frame(int frame_id, int gear_idx, unsigned short flags, const char *msg)
+{
+    struct datalog_frame_record *p_record;
+    size_t size_image;
+    int idx;
+
+    if (!g_datalog.is_running)
+        return -EINVAL;
+
+    pthread_mutex_lock(&g_datalog.lock);
+
+    idx = g_datalog.fill_idx;
+    p_record = (struct datalog_frame_record *)(g_datalog.buf[idx] +
+               (size_t)g_datalog.buf_frames[idx] * g_datalog.record_size);
+
+    p_record->frame_id = (unsigned int)frame_id;
+    p_record->gear_idx = (unsigned short)gear_idx;
+    p_record->flags = flags;
+
+    if (msg) {
+        size_image = g_datalog.record_size - sizeof(struct datalog_frame_record);
+        strncpy((char *)(p_record + 1), msg, size_image - 1);
+        ((char *)(p_record + 1))[size_image - 1] = '\0';
+    }
+
+    g_datalog.buf_frames[idx] += 1;
+    g_datalog.frames_recorded += 1;
+
+    if (g_datalog.buf_frames[idx] == DATALOG_FRAMES_PER_BUFFER) {
+        g_datalog.buf_pending[idx] = true;
+        g_datalog.fill_idx = idx ^ 1;
+        pthread_cond_broadcast(&g_datalog.cond);
+    }
+
+    pthread_mutex_unlock(&g_datalog.lock);
+
+    return 0;
+}
+/*
+ * Function:  datalog_close
+ * --------------------
+ * flush the remaining records, stop the writer thread
+ * and update the file header with the number of recorded frames
+ *
+ * return: <0, fail to complete the log
+ *         otherwise, succeed
+ */
+int datalog_close(int error_count)
+{
+    int retval;
+    int i;
+
+    if (!g_datalog.is_running)
+        return -EINVAL;
+
+    pthread_mutex_lock(&g_datalog.lock);
+    if (g_datalog.buf_frames[g_datalog.fill_idx] > 0) {
+        g_datalog.buf_pending[g_datalog.fill_idx] = true;
+        g_datalog.fill_idx ^= 1;
+    }
+    g_datalog.is_stopping = true;
+    pthread_cond_broadcast(&g_datalog.cond);
+    pthread_mutex_unlock(&g_datalog.lock);
+
+    pthread_join(g_datalog.thread, NULL);
+
+    retval = g_datalog.error;
+
+    g_datalog.header.frames_recorded = g_datalog.frames_recorded;
+    g_datalog.header.error_count = (unsigned int)error_count;
+    if (pwrite(g_datalog.fd, &g_datalog.header, sizeof(struct datalog_header), 0) !=
+            sizeof(struct datalog_header)) {
+        printf_e("%s: fail to update the header of log\n", __FUNCTION__);
+        retval = -EIO;
+    }
+
+    close(g_datalog.fd);
+    g_datalog.fd = -1;
+
+    for (i = 0; i < 2; i++) {
+        free(g_datalog.buf[i]);
+        g_datalog.buf[i] = NULL;
+    }
+
+    pthread_cond_destroy(&g_datalog.cond);
+    pthread_mutex_destroy(&g_datalog.lock);
+
+    g_datalog.is_running = false;
+
+    printf_i("%s: binary log is closed (frames = %d, error count = %d)\n", __FUNCTION__,
+             g_datalog.frames_recorded, error_count);
+
+    return retval;
+}
+/*
+ * Function:  datalog_write_text_header
+ * --------------------
+ * helper function to write the header of text log
+ */
+static void datalog_write_text_header(FILE *pfile, struct datalog_header *p_header)
+{
+    int i;
+    time_t t_time_header = (time_t)p_header->start_time;
+    int frames_per_gear = (p_header->num_gears > 0)?
+                          (int)(p_header->total_frames/p_header->num_gears) : 0;
+
+    fprintf(pfile, "Synaptics APK     recorded at %s\n\n", ctime(&t_time_header));
+
+    if (p_header->interface == DATALOG_IF_TCM) {
+        fprintf(pfile, "Interface                : ToucnComm\n");
+        fprintf(pfile, "Device ID                : %4d\n", p_header->device_id);
+        fprintf(pfile, "Firmware Packrat ID      : %7d\n", p_header->build_id);
+        fprintf(pfile, "Data Type                : RT 2, delta image\n");
+        fprintf(pfile, "Image Columns            : %d\n", p_header->tx_num);
+        fprintf(pfile, "Image Rows               : %d\n", p_header->rx_num);
+    }
+    else {
+        fprintf(pfile, "Interface                : RMI4\n");
+        fprintf(pfile, "Device ID                : %4d\n", p_header->device_id);
+        fprintf(pfile, "Firmware Packrat ID      : %7d\n", p_header->build_id);
+        switch(p_header->report_type){
+            case 2:
+                fprintf(pfile, "Data Type                : RT 2, delta image\n");
+                break;
+            case 94:
+                fprintf(pfile, "Data Type                : RT 94, AMP abs delta image\n");
+                break;
+            default:
+                break;
+        }
+        fprintf(pfile, "Tx Channel               : %d\n", p_header->tx_num);
+        fprintf(pfile, "Rx Channel               : %d\n", p_header->rx_num);
+    }
+    fprintf(pfile, "Total Frames Captured    : %d\n", p_header->total_frames);
+    fprintf(pfile, "Number of Frames per Gear: %d\n", frames_per_gear);
+    fprintf(pfile, "Number of Frequency Gears Enabled: %d\n", p_header->num_gears);
+    if ((p_header->num_gears_enabled > 0) && (p_header->num_gears_enabled <= DATALOG_MAX_GEARS)) {
+        fprintf(pfile, "Frequency Gears Enabled  :");
+        for (i = 0; i < (int)p_header->num_gears_enabled; i++)
+            fprintf(pfile, "%s Gear.%d", (i == 0) ? "" : ",", p_header->gear_list[i]);
+        fprintf(pfile, "\n");
+    }
+    fprintf(pfile, "\n");
+    fprintf(pfile, "Delta Threshold          : %4d\n", p_header->threshold);
+    fprintf(pfile, "\n\n");
+}
+/*
+ * Function:  datalog_write_text_image
+ * --------------------
+ * helper function to write the image data of one frame in text
+ * one line is prepared before writing to reduce the file i/o
+ */
+static void datalog_write_text_image(FILE *pfile, struct datalog_header *p_header,
+                                     short *p_image, char *p_line)
+{
+    int i, j;
+    int len;
+
+    len = sprintf(p_line, "        ");
+    for (j = 0; j < (int)p_header->rx_num; j++)
+        len += sprintf(p_line + len, "[R%2d]  ", j);
+    sprintf(p_line + len, "\n");
+    fputs(p_line, pfile);
+
+    for (i = 0; i < (int)p_header->tx_num; i++) {
+        len = sprintf(p_line, "[T%2d]: ", i);
+        for (j = 0; j < (int)p_header->rx_num; j++)
+            len += sprintf(p_line + len, "%6d ", p_image[i*p_header->rx_num + j]);
+        sprintf(p_line + len, "\n");
+        fputs(p_line, pfile);
+    }
+}
+/*
+ * Function:  datalog_convert_to_text
+ * --------------------
+ * regenerate the text log from the binary log
+ * the output is the same format as the one written by noise test before,
+ * the failure log is created only if any failure is found
+ *
+ * return: <0, fail to convert the log
+ *         otherwise, the number of frames converted
+ */
+int datalog_convert_to_text(const char *bin_path, const char *log_path, const char *fail_log_path)
+{
+    int retval = 0;
+    FILE *pfile_bin = NULL;
+    FILE *pfile_log = NULL;
+    FILE *pfile_fail = NULL;
+    struct datalog_header header;
+    struct datalog_frame_record *p_record;
+    unsigned char *p_buf = NULL;
+    char *p_line = NULL;
+    short *p_image;
+    int num_tixels;
+    int i;
+    int frames = 0;
+    int err_cnt = 0;
+    bool result;
+    short max_val = 0, min_val = 0;
+    char timestamp[MAX_STRING_LEN/2];
+
+    if (!bin_path || !log_path || !fail_log_path) {
+        printf_e("%s: invalid parameter\n", __FUNCTION__);
+        return -EINVAL;
+    }
+
+    pfile_bin = fopen(bin_path, "rb");
+    if (!pfile_bin) {
+        printf_e("%s: unable to open file (name: %s)\n", __FUNCTION__, bin_path);
+        retval = -EIO;
+        goto exit;
+    }
+
+    if (fread(&header, sizeof(struct datalog_header), 1, pfile_bin) != 1) {
+        printf_e("%s: fail to read the header (name: %s)\n", __FUNCTION__, bin_path);
+        retval = -EIO;
+        goto exit;
+    }
+    if ((memcmp(header.magic, DATALOG_MAGIC, sizeof(header.magic)) != 0) ||
+        (header.version != DATALOG_VERSION) ||
+        (header.header_size != sizeof(struct datalog_header))) {
+        printf_e("%s: invalid binary log (name: %s)\n", __FUNCTION__, bin_path);
+        retval = -EINVAL;
+        goto exit;
+    }
+
+    num_tixels = (int)(header.tx_num * header.rx_num);
+    if ((num_tixels <= 0) ||
+        (header.record_size != sizeof(struct datalog_frame_record) + num_tixels * sizeof(short))) {
+        printf_e("%s: invalid record size (size = %d)\n", __FUNCTION__, header.record_size);
+        retval = -EINVAL;
+        goto exit;
+    }
+
+    p_buf = malloc(header.record_size);
+    /* 7 chars per tixel, plus the line header */
+    p_line = malloc((size_t)(header.rx_num > header.tx_num ? header.rx_num : header.tx_num) * 8 + 16);
+    if (!p_buf || !p_line) {
+        printf_e("%s: fail to allocate the buffer\n", __FUNCTION__);
+        retval = -ENOMEM;
+        goto exit;
+    }
+
+    pfile_log = fopen(log_path, "w");
+    if (!pfile_log) {
+        printf_e("%s: unable to open file (name: %s)\n", __FUNCTION__, log_path);
+        retval = -EIO;
+        goto exit;
+    }
+    datalog_write_text_header(pfile_log, &header);
+
+    p_record = (struct datalog_frame_record *)p_buf;
+    p_image = (short *)(p_buf + sizeof(struct datalog_frame_record));
+
+    /* the number of records is not trusted, the log may not be closed properly */
+    while (fread(p_buf, header.record_size, 1, pfile_bin) == 1) {
+
+        if (p_record->flags & DATALOG_FLAG_GEAR_ERROR) {
+            fprintf(pfile_log, "%s", (char *)p_image);
+            fprintf(pfile_log, "error: stop the testing in frequency gear-%d\n\n", p_record->gear_idx);
+            continue;
+        }
+
+        frames++;
+
+        sprintf(timestamp, "< %f >",
+                (double)(p_record->timestamp_ns - header.start_time_ns) / 1000000000);
+
+        fprintf(pfile_log, "%s\n", timestamp);
+        fprintf(pfile_log, "frame id = %d\n", p_record->frame_id);
+        fprintf(pfile_log, "frequency gear = Gear.%d\n", p_record->gear_idx);
+
+        if (!(p_record->flags & DATALOG_FLAG_READ_ERROR)) {
+            max_val = p_image[0];
+            min_val = max_val;
+            for (i = 0; i < num_tixels; i++) {
+                max_val = (max_val > p_image[i])? max_val : p_image[i];
+                min_val = (min_val < p_image[i])? min_val : p_image[i];
+            }
+            result = (p_record->flags & DATALOG_FLAG_PASS) != 0;
+
+            datalog_write_text_image(pfile_log, &header, p_image, p_line);
+            fprintf(pfile_log, "max. = %d, min. = %d\n", max_val, min_val);
+            fprintf(pfile_log, "result = %s \n", (result)?"pass":"fail");
+            fprintf(pfile_log, "\n");
+        }
+        else {
+            result = false;
+            fprintf(pfile_log, "%s",  (char *)p_image);
+            fprintf(pfile_log, "result = fail\n\n");
+        }
+
+        if (result)
+            continue;
+
+        err_cnt++;
+
+        /* duplicate the failure frame to the failure log */
+        if (!pfile_fail) {
+            pfile_fail = fopen(fail_log_path, "w");
+            if (!pfile_fail) {
+                printf_e("%s: unable to open file (name: %s)\n", __FUNCTION__, fail_log_path);
+                retval = -EIO;
+                goto exit;
+            }
+            datalog_write_text_header(pfile_fail, &header);
+        }
+
+        fprintf(pfile_fail, "%s\n", timestamp);
+        fprintf(pfile_fail, "frame id = %d\n", p_record->frame_id);
+        fprintf(pfile_fail, "frequency gear = Gear.%d\n", p_record->gear_idx);
+
+        if (!(p_record->flags & DATALOG_FLAG_READ_ERROR)) {
+            datalog_write_text_image(pfile_fail, &header, p_image, p_line);
+            fprintf(pfile_fail, "max. = %d, min. = %d\n", max_val, min_val);
+            fprintf(pfile_fail, "result = fail \n");
+            fprintf(pfile_fail, "\n");
+        }
+        else {
+            fprintf(pfile_fail, "%s",  (char *)p_image);
+            fprintf(pfile_fail, "result = fail\n\n");
+        }
+    }
+
+    /* the error count from ui covers the frames skipped by gear failure */
+    if ((int)header.error_count > err_cnt)
+        err_cnt = (int)header.error_count;
+
+    if (err_cnt == 0)
+        fprintf(pfile_log, "\nSyna Noise Test     \t: Pass\n");
+    else
+        fprintf(pfile_log, "\nSyna Noise Test     \t: Fail (Error Count = %d)\n", err_cnt);
+
+    printf_i("%s: %d frames are converted (name: %s)\n", __FUNCTION__, frames, log_path);
+    retval = frames;
+
+exit:
+    if (pfile_fail)
+        fclose(pfile_fail);
+    if (pfile_log)
+        fclose(pfile_log);
+    if (pfile_bin)
+        fclose(pfile_bin);
+
+    free(p_line);
+    free(p_buf);
+
+    return retval;
+}
@@ -0,0 +1,94 @@
+/* ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+*
+* Copyright (c) 2012-2016 Synaptics Incorporated. All rights reserved.
+*
+* The information in this file is confidential under the terms
+* of a non-disclosure agreement with Synaptics and is provided
+* AS IS without warranties or guarantees of any kind.
+*
+* The information in this file shall remain the exclusive property
+* of Synaptics and may be the subject of Synaptics patents, in
+* whole or part. Synaptics intellectual property rights in the
+* information in this file are not expressly or implicitly licensed
+* or otherwise transferred to you as a result of such information
+* being made available to you.
+*
+* ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+*/
+
+#ifndef _NATIVE_DATALOG_H__
+#define _NATIVE_DATALOG_H__
+
+#define DATALOG_MAGIC "SYNADLOG"
+#define DATALOG_VERSION (1)
+
+#define DATALOG_MAX_GEARS (16)
+
+/* number of frame records kept in each of the two buffers */
+#define DATALOG_FRAMES_PER_BUFFER (32)
+
+enum datalog_interface {
+    DATALOG_IF_RMI = 0,
+    DATALOG_IF_TCM = 1,
+};
+
+enum datalog_frame_flag {
+    DATALOG_FLAG_PASS = 0x01,        /* all tixels are within the threshold */
+    DATALOG_FLAG_READ_ERROR = 0x02,  /* fail to read the frame, error message is kept in the image area */
+    DATALOG_FLAG_GEAR_ERROR = 0x04,  /* fail to change the gear, error message is kept in the image area */
+};
+
+/*
+ * file header, written at the beginning of the binary log
+ *
+ * the image is stored as tx_num lines and rx_num tixels per line,
+ * which is the same layout as the text log, [T..] lines and [R..] columns
+ * on tcm device, tx_num is the image columns and rx_num is the image rows
+ */
+struct datalog_header {
+    char magic[8];
+    unsigned int version;
+    unsigned int header_size;
+    unsigned int interface;
+    int device_id;
+    int build_id;
+    int report_type;
+    unsigned int tx_num;
+    unsigned int rx_num;
+    int threshold;
+    unsigned int total_frames;
+    unsigned int num_gears;
+    unsigned int num_gears_enabled;
+    unsigned char gear_list[DATALOG_MAX_GEARS];
+    unsigned int record_size;
+    unsigned int frames_recorded;   /* updated when the log is closed */
+    unsigned int error_count;       /* updated when the log is closed */
+    unsigned int reserved;
+    long long start_time;           /* wall-clock time, in seconds */
+    long long start_time_ns;        /* CLOCK_MONOTONIC, in nanoseconds */
+};
+
+/*
+ * fixed-size frame record
+ * followed by (tx_num * rx_num) short data of report image
+ */
+struct datalog_frame_record {
+    long long timestamp_ns;         /* CLOCK_MONOTONIC, in nanoseconds */
+    unsigned int frame_id;
+    unsigned short gear_idx;
+    unsigned short flags;
+};
+
+/* monotonic time of the frame records, in nanoseconds */
+long long datalog_get_time_ns(void);
+
+/* helper to record the frames into binary log */
+int datalog_open(const char *path, struct datalog_header *p_header);
+short *datalog_acquire_frame(void);
+int datalog_commit_frame(int frame_id, int gear_idx, unsigned short flags, const char *msg);
+int datalog_close(int error_count);
+
+/* helper to regenerate the text log from binary log */
+int datalog_convert_to_text(const char *bin_path, const char *log_path, const char *fail_log_path);
+
+#endif // _NATIVE_DATALOG_H__
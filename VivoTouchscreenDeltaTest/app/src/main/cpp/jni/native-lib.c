@@ -20,8 +20,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <fcntl.h>
+#include <errno.h>
 
 #include "native-lib.h"
+#include "native-datalog.h"
+#include "noise_sweep.h"
 
 JavaVM * g_jni_vm = NULL;
 JNIEnv * g_jni_env = NULL;
@@ -37,8 +40,18 @@ extern int get_build_id(void);
 extern int get_gear_info(char *info);
 extern int get_finger_cap(void);
 extern int enable_one_specified_gear(int gear);
-extern int write_log_header(FILE *pfile, int total_frames, int num_gears);
-extern bool do_noise_test(FILE *pfile, char *timestamp, int frame_id, int gear_idx);
+extern int get_log_header_info(struct datalog_header *p_header, int total_frames, int num_gears);
+extern bool do_noise_test(int frame_id, int gear_idx);
+extern int start_noise_stats(const short *p_threshold_map, int size);
+extern void stop_noise_stats(void);
+extern int get_noise_stats_frames(void);
+extern int get_noise_stats_result(int type, float *p_out, int size);
+extern int start_noise_fft(int length, float frame_rate);
+extern void stop_noise_fft(void);
+extern float get_noise_fft_frame_rate(void);
+extern int get_noise_fft_spectrum(int tixel, float *p_out, int size);
+extern int get_noise_fft_result(int type, float *p_out, int size);
+extern int get_noise_fft_peaks(float *p_out, int size);
 extern int do_test_preparation();
 extern int do_test_completion();
 extern int get_rmi_tx_info();
@@ -49,9 +62,6 @@ extern bool start_report(bool is_delta, bool is_raw);
 extern bool stop_report(bool is_delta, bool is_raw);
 extern int read_report(bool is_delta, bool is_raw, short *p_image);
 
-FILE *pfile;
-FILE *pfile_fail_log;
-
 /*
  * Function:  JNI_OnLoad
  * --------------------
@@ -247,21 +257,24 @@ JNIEXPORT jboolean JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_
     str_temp_path = (*env)->GetStringUTFChars(env, jfile, NULL);
     sprintf(g_log_file, "%s_all.csv", str_temp_path);
     sprintf(g_fail_log_file, "%s_fail.csv", str_temp_path);
+    sprintf(g_bin_log_file, "%s.bin", str_temp_path);
 
     (*env)->ReleaseStringUTFChars(env, jfile, str_temp_path);
     printf_i("%s: Path of Log File: %s\n", __FUNCTION__, g_log_file);
     printf_i("%s: Path of Failure Log File: %s\n", __FUNCTION__, g_fail_log_file);
+    printf_i("%s: Path of Binary Log File: %s\n", __FUNCTION__, g_bin_log_file);
 
     return (jboolean)true;
 }
 /*
  * Function:  openTest
  * --------------------
- * to open the RMI device, and write header to the file pointer
+ * to open the RMI device, and write header to the binary log
  */
 JNIEXPORT jboolean JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_openTestJNI(
         JNIEnv *env, jobject obj, jint total_frames, jint num_gears)
 {
+    struct datalog_header header;
     /* save JNIEnv */
     g_jni_env = env;
     g_jni_obj = obj;
@@ -270,25 +283,13 @@ JNIEXPORT jboolean JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_
         return (jboolean)false;
     }
 
-    pfile = fopen(g_log_file, "w");
-    if (!pfile){
-        printf_e("%s: unable to open file (name: %s)\n", __FUNCTION__, g_log_file);
-        return (jboolean)false;
-    }
-
-    if (write_log_header(pfile, total_frames, num_gears) != 0) {
-        printf_e("%s: fail to write header to the log file (name: %s)\n", __FUNCTION__, g_log_file);
+    if (get_log_header_info(&header, total_frames, num_gears) != 0) {
+        printf_e("%s: fail to get the device information for the log\n", __FUNCTION__);
         return (jboolean)false;
     }
 
-    pfile_fail_log = fopen(g_fail_log_file, "w");
-    if (!pfile){
-        printf_e("%s: unable to open file (name: %s)\n", __FUNCTION__, g_fail_log_file);
-        return (jboolean)false;
-    }
-
-    if (write_log_header(pfile_fail_log, total_frames, num_gears) != 0) {
-        printf_e("%s: fail to write header to the log file (name: %s)\n", __FUNCTION__, g_fail_log_file);
+    if (datalog_open(g_bin_log_file, &header) < 0) {
+        printf_e("%s: unable to open file (name: %s)\n", __FUNCTION__, g_bin_log_file);
         return (jboolean)false;
     }
 
@@ -302,12 +303,12 @@ JNIEXPORT jboolean JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_
 /*
  * Function:  closeTestJNI
  * --------------------
- * to close the RMI device, and create the log file
+ * to close the RMI device, and complete the binary log
+ * then, the text log (_all.csv and _fail.csv) is converted from the binary log
  */
 JNIEXPORT jboolean JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_closeTestJNI(
         JNIEnv *env, jobject obj, jint jerr_cnt)
 {
-    int ret;
     /* save JNIEnv */
     g_jni_env = env;
     g_jni_obj = obj;
@@ -316,23 +317,15 @@ JNIEXPORT jboolean JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_
         printf_e("%s: fail to stop the noise test\n", __FUNCTION__);
     }
 
-    if (pfile) {
-        fclose(pfile_fail_log);
-
-        if (jerr_cnt == 0) {
-            fprintf(pfile, "\nSyna Noise Test     \t: Pass\n");
+    if (datalog_close(jerr_cnt) == 0) {
+        printf_i("%s: log file is created ! %s\n", __FUNCTION__, g_bin_log_file);
 
-            ret = remove(g_fail_log_file);  // remove file log
-            if (ret == 0)
-                printf_i("%s: %s is removed\n", __FUNCTION__, g_fail_log_file);
+        if (datalog_convert_to_text(g_bin_log_file, g_log_file, g_fail_log_file) < 0) {
+            printf_e("%s: fail to convert the binary log to text\n", __FUNCTION__);
         }
         else {
-            fprintf(pfile, "\nSyna Noise Test     \t: Fail (Error Count = %d)\n", jerr_cnt);
-
-            printf_i("%s: failure log is created ! %s\n", __FUNCTION__, g_fail_log_file);
+            printf_i("%s: log file is created ! %s\n", __FUNCTION__, g_log_file);
         }
-        fclose(pfile);
-        printf_i("%s: log file is created ! %s\n", __FUNCTION__, g_log_file);
     }
 
     close_dev(g_dev_node);
@@ -342,7 +335,7 @@ JNIEXPORT jboolean JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_
 /*
  * Function:  doTestJNI
  * --------------------
- * to close the RMI device
+ * to perform the noise test on one frame
  */
 JNIEXPORT jboolean JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_doTestJNI(
         JNIEnv *env, jobject obj, jint jframe_id, jint jgear_idx)
@@ -352,16 +345,49 @@ JNIEXPORT jboolean JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_
     g_jni_env = env;
     g_jni_obj = obj;
 
-    char timestamp[MAX_STRING_LEN/2];
-    /* get the timestamp */
-    gettimeofday(&t_val_2, NULL);
-    timersub(&t_val_2, &t_val_1, &t_diff);
-    sprintf(timestamp, "< %f >", (t_diff.tv_sec+(1.0*t_diff.tv_usec)/1000000));
-
-    result = do_noise_test(pfile, timestamp, jframe_id, jgear_idx);
+    result = do_noise_test(jframe_id, jgear_idx);
 
     return (jboolean)result;
 }
+/*
+ * Function:  convertLogJNI
+ * --------------------
+ * to regenerate the text log (_all.csv and _fail.csv) from the binary log
+ * the failure log is created only if any failure is found
+ */
+JNIEXPORT jint JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_convertLogJNI(
+        JNIEnv *env, jobject obj, jstring jbin_file, jstring jout_file)
+{
+    int retval;
+    const char *str_bin_path;
+    const char *str_out_path;
+    char log_file[MAX_STRING_LEN];
+    char fail_log_file[MAX_STRING_LEN];
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if (!jbin_file || !jout_file) {
+        printf_e("%s: invalid parameter.\n", __FUNCTION__);
+        return -EINVAL;
+    }
+
+    str_bin_path = (*env)->GetStringUTFChars(env, jbin_file, NULL);
+    str_out_path = (*env)->GetStringUTFChars(env, jout_file, NULL);
+
+    snprintf(log_file, MAX_STRING_LEN, "%s_all.csv", str_out_path);
+    snprintf(fail_log_file, MAX_STRING_LEN, "%s_fail.csv", str_out_path);
+
+    retval = datalog_convert_to_text(str_bin_path, log_file, fail_log_file);
+    if (retval < 0) {
+        printf_e("%s: fail to convert the log (name: %s)\n", __FUNCTION__, str_bin_path);
+    }
+
+    (*env)->ReleaseStringUTFChars(env, jout_file, str_out_path);
+    (*env)->ReleaseStringUTFChars(env, jbin_file, str_bin_path);
+
+    return retval;
+}
 /*
  * Function:  getGearInfoJNI
  * --------------------
@@ -397,9 +423,9 @@ JNIEXPORT jboolean JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_
     g_jni_obj = obj;
 
     if (retval < 0) {
-        if (pfile) {
-            fprintf(pfile, "%s",  err_msg_out);
-            fprintf(pfile, "error: stop the testing in frequency gear-%d\n\n", jgear);
+        /* keep the error message in the binary log */
+        if (datalog_acquire_frame()) {
+            datalog_commit_frame(0, jgear, DATALOG_FLAG_GEAR_ERROR, err_msg_out);
         }
     }
 
@@ -547,4 +573,484 @@ JNIEXPORT jboolean JNICALL  Java_com_vivotouchscreen_synadeltadiff_NativeWrapper
     /* release the java array */
     (*env)->ReleaseShortArrayElements(env, jarray, data_array, 0);
     return (jboolean)true;
-}
\ No newline at end of file
+}
+/* method of NativeWrapper to report the sweep progress, looked up once */
+static jmethodID g_sweep_progress_method = NULL;
+
+/*
+ * Function:  callback_sweep_progress
+ * --------------------
+ * the callback function to notify the activity the progress of noise sweep
+ * the method id is resolved in doNoiseSweepJNI before the sweep starts
+ */
+void callback_sweep_progress(int gear, int frames_done, int frames_total, int frames_failed)
+{
+    if (!g_sweep_progress_method)
+        return;
+
+    (*g_jni_env)->CallVoidMethod(g_jni_env, g_jni_obj, g_sweep_progress_method,
+                                 gear, frames_done, frames_total, frames_failed);
+}
+/*
+ * Function:  doNoiseSweepJNI
+ * --------------------
+ * perform the noise test on all gears in the list,
+ * the frames are captured back to back without returning to java layer
+ *
+ * should be called between openTestJNI and closeTestJNI
+ *
+ * return: <0, fail to perform the sweep
+ *         otherwise, the number of frames failed
+ */
+JNIEXPORT jint JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_doNoiseSweepJNI(
+        JNIEnv *env, jobject obj, jintArray jgears, jint jframes_per_gear)
+{
+    int retval;
+    jint *gears;
+    jsize num_gears;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    num_gears = (*env)->GetArrayLength(env, jgears);
+    if ((num_gears <= 0) || (num_gears > SWEEP_MAX_GEARS)) {
+        printf_e("%s: invalid parameter. (num_gears = %d)\n", __FUNCTION__, num_gears);
+        return -EINVAL;
+    }
+
+    /* resolve the progress callback once, not on every progress tick */
+    if (!g_sweep_progress_method) {
+        jclass clazz = (*env)->GetObjectClass(env, obj);
+        g_sweep_progress_method = (*env)->GetMethodID(env, clazz, "callbackSweepProgress", "(IIII)V");
+        (*env)->DeleteLocalRef(env, clazz);
+        if (!g_sweep_progress_method) {
+            printf_e("%s error: fail on GetMethodID, callbackSweepProgress\n", __FUNCTION__);
+            (*env)->ExceptionClear(env);
+        }
+    }
+
+    gears = (*env)->GetIntArrayElements(env, jgears, NULL);
+    if (!gears) {
+        printf_e("%s: fail to get the gear list\n", __FUNCTION__);
+        return -ENOMEM;
+    }
+
+    retval = noise_sweep_run((const int *)gears, num_gears, jframes_per_gear);
+    if (retval < 0) {
+        printf_e("%s: fail to perform the noise sweep (retval = %d)\n", __FUNCTION__, retval);
+    }
+
+    /* release the java array, no change */
+    (*env)->ReleaseIntArrayElements(env, jgears, gears, JNI_ABORT);
+    return (jint)retval;
+}
+/*
+ * Function:  stopNoiseSweepJNI
+ * --------------------
+ * to terminate the running noise sweep, called from another thread
+ */
+JNIEXPORT void JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_stopNoiseSweepJNI(
+        JNIEnv *env, jobject obj)
+{
+    /* JNIEnv is not saved, the sweep is running on another thread */
+    (void)env;
+    (void)obj;
+
+    noise_sweep_stop();
+}
+/*
+ * Function:  getSweepGearInfoJNI
+ * --------------------
+ * to get the information of the gear in the specified order of last sweep
+ */
+JNIEXPORT jboolean JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_getSweepGearInfoJNI(
+        JNIEnv *env, jobject obj, jint jorder, jintArray jarray)
+{
+    int retval;
+    jint *data_array;
+    jsize len_data_array;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    len_data_array = (*env)->GetArrayLength(env, jarray);
+    if (len_data_array <= 0) {
+        printf_e("%s: invalid parameter. (len_data_array = %d)\n", __FUNCTION__, len_data_array);
+        return (jboolean)false;
+    }
+
+    data_array = (*env)->GetIntArrayElements(env, jarray, NULL);
+    retval = noise_sweep_get_gear_info(jorder, (int *)data_array, len_data_array);
+
+    /* release the java array */
+    (*env)->ReleaseIntArrayElements(env, jarray, data_array, 0);
+    return (jboolean)(retval >= 0);
+}
+/*
+ * Function:  getSweepResultJNI
+ * --------------------
+ * to get the per-tixel result of the gear in the specified order of last sweep
+ */
+JNIEXPORT jboolean JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_getSweepResultJNI(
+        JNIEnv *env, jobject obj, jint jorder, jint jtype, jfloatArray jarray)
+{
+    int retval;
+    jfloat *data_array;
+    jsize len_data_array;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    len_data_array = (*env)->GetArrayLength(env, jarray);
+    if (len_data_array <= 0) {
+        printf_e("%s: invalid parameter. (len_data_array = %d)\n", __FUNCTION__, len_data_array);
+        return (jboolean)false;
+    }
+
+    data_array = (*env)->GetFloatArrayElements(env, jarray, NULL);
+    retval = noise_sweep_get_result(jorder, jtype, (float *)data_array, len_data_array);
+
+    /* release the java array */
+    (*env)->ReleaseFloatArrayElements(env, jarray, data_array, 0);
+    return (jboolean)(retval >= 0);
+}
+/*
+ * Function:  startNoiseStatsJNI
+ * --------------------
+ * to start the per-tixel statistics over the frames of noise test
+ * the threshold map is in the same layout as the report image,
+ * if it is null, the delta threshold is applied to all tixels
+ */
+JNIEXPORT jboolean JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_startNoiseStatsJNI(
+        JNIEnv *env, jobject obj, jshortArray jthreshold_map)
+{
+    int retval;
+    short *data_array = NULL;
+    jsize len_data_array = 0;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    if (jthreshold_map != NULL) {
+        len_data_array = (*env)->GetArrayLength(env, jthreshold_map);
+        data_array = (*env)->GetShortArrayElements(env, jthreshold_map, NULL);
+    }
+
+    retval = start_noise_stats(data_array, len_data_array);
+    if (retval < 0) {
+        printf_e("%s: fail to start the statistics (retval = %d)\n", __FUNCTION__, retval);
+    }
+
+    /* release the java array, no change */
+    if (data_array)
+        (*env)->ReleaseShortArrayElements(env, jthreshold_map, data_array, JNI_ABORT);
+
+    return (jboolean)(retval >= 0);
+}
+/*
+ * Function:  stopNoiseStatsJNI
+ * --------------------
+ * to stop the per-tixel statistics and release the buffers
+ */
+JNIEXPORT void JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_stopNoiseStatsJNI(
+        JNIEnv *env, jobject obj)
+{
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    stop_noise_stats();
+}
+/*
+ * Function:  getNoiseStatsFramesJNI
+ * --------------------
+ * to get the number of frames accumulated in the statistics
+ */
+JNIEXPORT jint JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_getNoiseStatsFramesJNI(
+        JNIEnv *env, jobject obj)
+{
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    return (jint)get_noise_stats_frames();
+}
+/*
+ * Function:  getNoiseStatsResultJNI
+ * --------------------
+ * to get the per-tixel result of the statistics
+ * the result is in the same layout as the report image
+ */
+JNIEXPORT jboolean JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_getNoiseStatsResultJNI(
+        JNIEnv *env, jobject obj, jint jtype, jfloatArray jarray)
+{
+    int retval;
+    jfloat *data_array;
+    jsize len_data_array;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    len_data_array = (*env)->GetArrayLength(env, jarray);
+    if (len_data_array <= 0) {
+        printf_e("%s: invalid parameter. (len_data_array = %d)\n", __FUNCTION__, len_data_array);
+        return (jboolean)false;
+    }
+
+    data_array = (*env)->GetFloatArrayElements(env, jarray, NULL);
+    retval = get_noise_stats_result(jtype, (float *)data_array, len_data_array);
+
+    /* release the java array */
+    (*env)->ReleaseFloatArrayElements(env, jarray, data_array, 0);
+    return (jboolean)(retval >= 0);
+}
+/*
+ * Function:  startNoiseFftJNI
+ * --------------------
+ * to start the temporal spectrum over the frames of noise test
+ * length is the frames per fft segment, a power of 2
+ * if the frame rate is 0, it is measured from the frame arrival
+ */
+JNIEXPORT jboolean JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_startNoiseFftJNI(
+        JNIEnv *env, jobject obj, jint jlength, jfloat jframe_rate)
+{
+    int retval;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    retval = start_noise_fft(jlength, jframe_rate);
+    if (retval < 0) {
+        printf_e("%s: fail to start the spectrum (retval = %d)\n", __FUNCTION__, retval);
+    }
+
+    return (jboolean)(retval >= 0);
+}
+/*
+ * Function:  stopNoiseFftJNI
+ * --------------------
+ * to stop the temporal spectrum and release the buffers
+ */
+JNIEXPORT void JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_stopNoiseFftJNI(
+        JNIEnv *env, jobject obj)
+{
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    stop_noise_fft();
+}
+/*
+ * Function:  getNoiseFftFrameRateJNI
+ * --------------------
+ * to get the frame rate used for the frequency of the spectrum
+ */
+JNIEXPORT jfloat JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_getNoiseFftFrameRateJNI(
+        JNIEnv *env, jobject obj)
+{
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    return (jfloat)get_noise_fft_frame_rate();
+}
+/*
+ * Function:  getNoiseFftSpectrumJNI
+ * --------------------
+ * to get the power spectrum of the tixel, length / 2 + 1 bins
+ * if the tixel is < 0, the spectrum is the average of all tixels
+ */
+JNIEXPORT jint JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_getNoiseFftSpectrumJNI(
+        JNIEnv *env, jobject obj, jint jtixel, jfloatArray jarray)
+{
+    int retval;
+    jfloat *data_array;
+    jsize len_data_array;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    len_data_array = (*env)->GetArrayLength(env, jarray);
+    if (len_data_array <= 0) {
+        printf_e("%s: invalid parameter. (len_data_array = %d)\n", __FUNCTION__, len_data_array);
+        return -EINVAL;
+    }
+
+    data_array = (*env)->GetFloatArrayElements(env, jarray, NULL);
+    retval = get_noise_fft_spectrum(jtixel, (float *)data_array, len_data_array);
+
+    /* release the java array */
+    (*env)->ReleaseFloatArrayElements(env, jarray, data_array, 0);
+    return (jint)retval;
+}
+/*
+ * Function:  getNoiseFftResultJNI
+ * --------------------
+ * to get the per-tixel result of the spectrum
+ * the result is in the same layout as the report image
+ */
+JNIEXPORT jboolean JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_getNoiseFftResultJNI(
+        JNIEnv *env, jobject obj, jint jtype, jfloatArray jarray)
+{
+    int retval;
+    jfloat *data_array;
+    jsize len_data_array;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    len_data_array = (*env)->GetArrayLength(env, jarray);
+    if (len_data_array <= 0) {
+        printf_e("%s: invalid parameter. (len_data_array = %d)\n", __FUNCTION__, len_data_array);
+        return (jboolean)false;
+    }
+
+    data_array = (*env)->GetFloatArrayElements(env, jarray, NULL);
+    retval = get_noise_fft_result(jtype, (float *)data_array, len_data_array);
+
+    /* release the java array */
+    (*env)->ReleaseFloatArrayElements(env, jarray, data_array, 0);
+    return (jboolean)(retval >= 0);
+}
+/*
+ * Function:  getNoiseFftPeaksJNI
+ * --------------------
+ * to get the dominant noise frequencies of the panel average spectrum
+ * return the number of peaks, or negative value if fail
+ */
+JNIEXPORT jint JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_getNoiseFftPeaksJNI(
+        JNIEnv *env, jobject obj, jfloatArray jarray)
+{
+    int retval;
+    jfloat *data_array;
+    jsize len_data_array;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    len_data_array = (*env)->GetArrayLength(env, jarray);
+    if (len_data_array <= 0) {
+        printf_e("%s: invalid parameter. (len_data_array = %d)\n", __FUNCTION__, len_data_array);
+        return -EINVAL;
+    }
+
+    data_array = (*env)->GetFloatArrayElements(env, jarray, NULL);
+    retval = get_noise_fft_peaks((float *)data_array, len_data_array);
+
+    /* release the java array */
+    (*env)->ReleaseFloatArrayElements(env, jarray, data_array, 0);
+    return (jint)retval;
+}
+/*
+ * Function:  setSweepFftLengthJNI
+ * --------------------
+ * to enable the temporal spectrum of each gear in the following sweeps
+ * length is the frames per fft segment, 0 to disable
+ */
+JNIEXPORT jboolean JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_setSweepFftLengthJNI(
+        JNIEnv *env, jobject obj, jint jlength)
+{
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    return (jboolean)(noise_sweep_set_fft_length(jlength) >= 0);
+}
+/*
+ * Function:  getSweepSpectrumJNI
+ * --------------------
+ * to get the power spectrum of the gear in the specified order of last sweep
+ * if the tixel is < 0, the spectrum is the average of all tixels
+ */
+JNIEXPORT jint JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_getSweepSpectrumJNI(
+        JNIEnv *env, jobject obj, jint jorder, jint jtixel, jfloatArray jarray)
+{
+    int retval;
+    jfloat *data_array;
+    jsize len_data_array;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    len_data_array = (*env)->GetArrayLength(env, jarray);
+    if (len_data_array <= 0) {
+        printf_e("%s: invalid parameter. (len_data_array = %d)\n", __FUNCTION__, len_data_array);
+        return -EINVAL;
+    }
+
+    data_array = (*env)->GetFloatArrayElements(env, jarray, NULL);
+    retval = noise_sweep_get_spectrum(jorder, jtixel, (float *)data_array, len_data_array);
+
+    /* release the java array */
+    (*env)->ReleaseFloatArrayElements(env, jarray, data_array, 0);
+    return (jint)retval;
+}
+/*
+ * Function:  getSweepFftResultJNI
+ * --------------------
+ * to get the per-tixel spectrum result of the gear in the specified order of last sweep
+ */
+JNIEXPORT jboolean JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_getSweepFftResultJNI(
+        JNIEnv *env, jobject obj, jint jorder, jint jtype, jfloatArray jarray)
+{
+    int retval;
+    jfloat *data_array;
+    jsize len_data_array;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    len_data_array = (*env)->GetArrayLength(env, jarray);
+    if (len_data_array <= 0) {
+        printf_e("%s: invalid parameter. (len_data_array = %d)\n", __FUNCTION__, len_data_array);
+        return (jboolean)false;
+    }
+
+    data_array = (*env)->GetFloatArrayElements(env, jarray, NULL);
+    retval = noise_sweep_get_fft_result(jorder, jtype, (float *)data_array, len_data_array);
+
+    /* release the java array */
+    (*env)->ReleaseFloatArrayElements(env, jarray, data_array, 0);
+    return (jboolean)(retval >= 0);
+}
+/*
+ * Function:  getSweepPeaksJNI
+ * --------------------
+ * to get the dominant noise frequencies of the gear in the specified order of last sweep
+ * return the number of peaks, or negative value if fail
+ */
+JNIEXPORT jint JNICALL Java_com_vivotouchscreen_synadeltadiff_NativeWrapper_getSweepPeaksJNI(
+        JNIEnv *env, jobject obj, jint jorder, jfloatArray jarray)
+{
+    int retval;
+    jfloat *data_array;
+    jsize len_data_array;
+
+    /* save JNIEnv */
+    g_jni_env = env;
+    g_jni_obj = obj;
+
+    len_data_array = (*env)->GetArrayLength(env, jarray);
+    if (len_data_array <= 0) {
+        printf_e("%s: invalid parameter. (len_data_array = %d)\n", __FUNCTION__, len_data_array);
+        return -EINVAL;
+    }
+
+    data_array = (*env)->GetFloatArrayElements(env, jarray, NULL);
+    retval = noise_sweep_get_peaks(jorder, (float *)data_array, len_data_array);
+
+    /* release the java array */
+    (*env)->ReleaseFloatArrayElements(env, jarray, data_array, 0);
+    return (jint)retval;
+}
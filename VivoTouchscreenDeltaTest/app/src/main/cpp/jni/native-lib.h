@@ -39,6 +39,7 @@ int g_num_frames;
 int g_threshold;
 char g_log_file[MAX_STRING_LEN];
 char g_fail_log_file[MAX_STRING_LEN];
+char g_bin_log_file[MAX_STRING_LEN];
 
 /* the path of syna character device */
 char g_dev_node[MAX_STRING_LEN/8];
@@ -53,9 +54,5 @@ bool g_is_rmi_dev_initialized;
 bool g_is_tcm_dev;
 bool g_is_tcm_dev_initialized;
 
-struct timeval t_val_1, t_val_2, t_diff;
-
-extern FILE *pfile_fail_log;
-
 #endif // _NATIVE_LIB_H__
 
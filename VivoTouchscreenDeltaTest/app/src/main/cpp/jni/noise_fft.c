@@ -0,0 +1,617 @@
+/* ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+*
+* Copyright (c) 2012-2016 Synaptics Incorporated. All rights reserved.
+*
+* The information in this file is confidential under the terms
+* of a non-disclosure agreement with Synaptics and is provided
+* AS IS without warranties or guarantees of any kind.
+*
+* The information in this file shall remain the exclusive property
+* of Synaptics and may be the subject of Synaptics patents, in
+* whole or part. Synaptics intellectual property rights in the
+* information in this file are not expressly or implicitly licensed
+* or otherwise transferred to you as a result of such information
+* being made available to you.
+*
+* ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+*/
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define FFT_USE_NEON
+#endif
+
+#include "native-lib.h"
+#include "native-datalog.h"
+#include "noise_fft.h"
+
+#ifndef M_PI
+#define M_PI (3.14159265358979323846)
+#endif
+
+/*
+ * Function:  noise_fft_release_workspace
+ * --------------------
+ * helper function to release the buffers used for the transform only
+ */
+static void noise_fft_release_workspace(struct noise_fft *p_fft)
+{
+    free(p_fft->p_window);
+    free(p_fft->p_cos);
+    free(p_fft->p_sin);
+    free(p_fft->p_rev);
+    free(p_fft->p_segment);
+    free(p_fft->p_re);
+    free(p_fft->p_im);
+
+    p_fft->p_window = NULL;
+    p_fft->p_cos = NULL;
+    p_fft->p_sin = NULL;
+    p_fft->p_rev = NULL;
+    p_fft->p_segment = NULL;
+    p_fft->p_re = NULL;
+    p_fft->p_im = NULL;
+}
+/*
+ * Function:  noise_fft_release
+ * --------------------
+ * release all buffers of the spectrum
+ */
+void noise_fft_release(struct noise_fft *p_fft)
+{
+    if (!p_fft)
+        return;
+
+    noise_fft_release_workspace(p_fft);
+    free(p_fft->p_power);
+
+    memset(p_fft, 0x00, sizeof(struct noise_fft));
+}
+/*
+ * Function:  noise_fft_finish
+ * --------------------
+ * stop accumulating and release the buffers of the transform,
+ * the averaged spectrum is kept for the results
+ * frames in the incomplete segment are dropped
+ */
+void noise_fft_finish(struct noise_fft *p_fft)
+{
+    if (!p_fft || (p_fft->num <= 0))
+        return;
+
+    noise_fft_release_workspace(p_fft);
+    p_fft->filled = 0;
+}
+/*
+ * Function:  noise_fft_init
+ * --------------------
+ * allocate the spectrum for num tixels, length frames per segment
+ * the frame rate is measured from the frame arrival if it is 0
+ *
+ * return: <0, fail to allocate or invalid parameter
+ *         otherwise, succeed
+ */
+int noise_fft_init(struct noise_fft *p_fft, int num, int length, float frame_rate)
+{
+    int i, j;
+    int bits;
+    int groups;
+    double w;
+
+    if (!p_fft || (num <= 0) || (length < FFT_MIN_LENGTH) || (length > FFT_MAX_LENGTH) ||
+        (length & (length - 1)) || (frame_rate < 0)) {
+        printf_e("%s: invalid parameter (num = %d, length = %d)\n", __FUNCTION__, num, length);
+        return -EINVAL;
+    }
+
+    memset(p_fft, 0x00, sizeof(struct noise_fft));
+
+    groups = (num + FFT_LANES - 1) / FFT_LANES;
+
+    p_fft->p_window = malloc(sizeof(float) * length);
+    p_fft->p_cos = malloc(sizeof(float) * length / 2);
+    p_fft->p_sin = malloc(sizeof(float) * length / 2);
+    p_fft->p_rev = malloc(sizeof(unsigned short) * length);
+    /* lanes beyond the last tixel are kept in zero */
+    p_fft->p_segment = calloc((size_t)groups * length * FFT_LANES, sizeof(float));
+    p_fft->p_re = malloc(sizeof(float) * length * FFT_LANES);
+    p_fft->p_im = malloc(sizeof(float) * length * FFT_LANES);
+    p_fft->p_power = calloc((size_t)num * (length / 2 + 1), sizeof(float));
+    if (!p_fft->p_window || !p_fft->p_cos || !p_fft->p_sin || !p_fft->p_rev ||
+        !p_fft->p_segment || !p_fft->p_re || !p_fft->p_im || !p_fft->p_power) {
+        printf_e("%s: fail to allocate the spectrum (tixels = %d, length = %d)\n", __FUNCTION__,
+                 num, length);
+        noise_fft_release(p_fft);
+        return -ENOMEM;
+    }
+
+    p_fft->num = num;
+    p_fft->length = length;
+    p_fft->bins = length / 2 + 1;
+    p_fft->frame_rate = frame_rate;
+
+    /* hann window */
+    p_fft->window_power = 0;
+    for (i = 0; i < length; i++) {
+        w = 0.5 - 0.5 * cos(2 * M_PI * i / length);
+        p_fft->p_window[i] = (float)w;
+        p_fft->window_power += (float)(w * w);
+    }
+
+    /* twiddle factors, exp(-j * 2pi * k / length) */
+    for (i = 0; i < length / 2; i++) {
+        p_fft->p_cos[i] = (float)cos(2 * M_PI * i / length);
+        p_fft->p_sin[i] = (float)-sin(2 * M_PI * i / length);
+    }
+
+    for (bits = 0; (1 << bits) < length; bits++)
+        ;
+    for (i = 0; i < length; i++) {
+        p_fft->p_rev[i] = 0;
+        for (j = 0; j < bits; j++) {
+            if (i & (1 << j))
+                p_fft->p_rev[i] |= (unsigned short)(1 << (bits - 1 - j));
+        }
+    }
+
+    return 0;
+}
+/*
+ * Function:  noise_fft_radix4
+ * --------------------
+ * helper function to perform the first two stages as one radix-4 pass,
+ * the twiddle factors are 1 and -j, no multiplication is needed
+ * the input is in bit-reversed order
+ */
+static void noise_fft_radix4(float *p_re, float *p_im, int length)
+{
+    int n;
+    float *re, *im;
+#ifdef FFT_USE_NEON
+    float32x4_t ar, ai, br, bi, cr, ci, dr, di;
+    float32x4_t sr, si, tr, ti, ur, ui, vr, vi;
+#else
+    int l;
+    float ar, ai, br, bi, cr, ci, dr, di;
+#endif
+
+    for (n = 0; n < length; n += 4) {
+        re = p_re + n * FFT_LANES;
+        im = p_im + n * FFT_LANES;
+#ifdef FFT_USE_NEON
+        ar = vld1q_f32(re);
+        ai = vld1q_f32(im);
+        br = vld1q_f32(re + FFT_LANES);
+        bi = vld1q_f32(im + FFT_LANES);
+        cr = vld1q_f32(re + 2 * FFT_LANES);
+        ci = vld1q_f32(im + 2 * FFT_LANES);
+        dr = vld1q_f32(re + 3 * FFT_LANES);
+        di = vld1q_f32(im + 3 * FFT_LANES);
+
+        sr = vaddq_f32(ar, br);
+        si = vaddq_f32(ai, bi);
+        tr = vsubq_f32(ar, br);
+        ti = vsubq_f32(ai, bi);
+        ur = vaddq_f32(cr, dr);
+        ui = vaddq_f32(ci, di);
+        vr = vsubq_f32(cr, dr);
+        vi = vsubq_f32(ci, di);
+
+        vst1q_f32(re, vaddq_f32(sr, ur));
+        vst1q_f32(im, vaddq_f32(si, ui));
+        vst1q_f32(re + 2 * FFT_LANES, vsubq_f32(sr, ur));
+        vst1q_f32(im + 2 * FFT_LANES, vsubq_f32(si, ui));
+        /* -j * v */
+        vst1q_f32(re + FFT_LANES, vaddq_f32(tr, vi));
+        vst1q_f32(im + FFT_LANES, vsubq_f32(ti, vr));
+        vst1q_f32(re + 3 * FFT_LANES, vsubq_f32(tr, vi));
+        vst1q_f32(im + 3 * FFT_LANES, vaddq_f32(ti, vr));
+#else
+        for (l = 0; l < FFT_LANES; l++) {
+            ar = re[l] + re[FFT_LANES + l];
+            ai = im[l] + im[FFT_LANES + l];
+            br = re[l] - re[FFT_LANES + l];
+            bi = im[l] - im[FFT_LANES + l];
+            cr = re[2 * FFT_LANES + l] + re[3 * FFT_LANES + l];
+            ci = im[2 * FFT_LANES + l] + im[3 * FFT_LANES + l];
+            dr = re[2 * FFT_LANES + l] - re[3 * FFT_LANES + l];
+            di = im[2 * FFT_LANES + l] - im[3 * FFT_LANES + l];
+
+            re[l] = ar + cr;
+            im[l] = ai + ci;
+            re[2 * FFT_LANES + l] = ar - cr;
+            im[2 * FFT_LANES + l] = ai - ci;
+            /* -j * d */
+            re[FFT_LANES + l] = br + di;
+            im[FFT_LANES + l] = bi - dr;
+            re[3 * FFT_LANES + l] = br - di;
+            im[3 * FFT_LANES + l] = bi + dr;
+        }
+#endif
+    }
+}
+/*
+ * Function:  noise_fft_radix2
+ * --------------------
+ * helper function to perform the remaining radix-2 stages
+ */
+static void noise_fft_radix2(struct noise_fft *p_fft, float *p_re, float *p_im)
+{
+    int length = p_fft->length;
+    int size, half, step;
+    int n, k;
+    float wr, wi;
+    float *re0, *im0, *re1, *im1;
+#ifdef FFT_USE_NEON
+    float32x4_t r0, i0, r1, i1, tr, ti;
+#else
+    int l;
+    float tr, ti;
+#endif
+
+    for (size = 8; size <= length; size <<= 1) {
+        half = size >> 1;
+        step = length / size;
+
+        for (n = 0; n < length; n += size) {
+            for (k = 0; k < half; k++) {
+                wr = p_fft->p_cos[k * step];
+                wi = p_fft->p_sin[k * step];
+                re0 = p_re + (n + k) * FFT_LANES;
+                im0 = p_im + (n + k) * FFT_LANES;
+                re1 = re0 + half * FFT_LANES;
+                im1 = im0 + half * FFT_LANES;
+#ifdef FFT_USE_NEON
+                r1 = vld1q_f32(re1);
+                i1 = vld1q_f32(im1);
+                tr = vmlsq_n_f32(vmulq_n_f32(r1, wr), i1, wi);
+                ti = vmlaq_n_f32(vmulq_n_f32(r1, wi), i1, wr);
+                r0 = vld1q_f32(re0);
+                i0 = vld1q_f32(im0);
+
+                vst1q_f32(re1, vsubq_f32(r0, tr));
+                vst1q_f32(im1, vsubq_f32(i0, ti));
+                vst1q_f32(re0, vaddq_f32(r0, tr));
+                vst1q_f32(im0, vaddq_f32(i0, ti));
+#else
+                for (l = 0; l < FFT_LANES; l++) {
+                    tr = re1[l] * wr - im1[l] * wi;
+                    ti = re1[l] * wi + im1[l] * wr;
+
+                    re1[l] = re0[l] - tr;
+                    im1[l] = im0[l] - ti;
+                    re0[l] += tr;
+                    im0[l] += ti;
+                }
+#endif
+            }
+        }
+    }
+}
+/*
+ * Function:  noise_fft_process_segment
+ * --------------------
+ * helper function to transform the buffered segment, FFT_LANES tixels
+ * at a time, and accumulate the one-sided power spectrum
+ * the mean of each tixel is removed before the window is applied, and
+ * the power is scaled so that the sum over bins is the variance
+ */
+static void noise_fft_process_segment(struct noise_fft *p_fft)
+{
+    int g, n, l, k;
+    int tixel;
+    int length = p_fft->length;
+    int groups = (p_fft->num + FFT_LANES - 1) / FFT_LANES;
+    float mean[FFT_LANES];
+    float *p_in;
+    float *p_power;
+    float scale;
+    float power;
+
+    scale = 1.0f / ((float)length * p_fft->window_power);
+
+    for (g = 0; g < groups; g++) {
+        p_in = p_fft->p_segment + (size_t)g * length * FFT_LANES;
+
+        for (l = 0; l < FFT_LANES; l++)
+            mean[l] = 0;
+        for (n = 0; n < length; n++) {
+            for (l = 0; l < FFT_LANES; l++)
+                mean[l] += p_in[n * FFT_LANES + l];
+        }
+        for (l = 0; l < FFT_LANES; l++)
+            mean[l] /= length;
+
+        /* load in bit-reversed order */
+        for (n = 0; n < length; n++) {
+            for (l = 0; l < FFT_LANES; l++) {
+                p_fft->p_re[p_fft->p_rev[n] * FFT_LANES + l] =
+                        (p_in[n * FFT_LANES + l] - mean[l]) * p_fft->p_window[n];
+                p_fft->p_im[p_fft->p_rev[n] * FFT_LANES + l] = 0;
+            }
+        }
+
+        noise_fft_radix4(p_fft->p_re, p_fft->p_im, length);
+        noise_fft_radix2(p_fft, p_fft->p_re, p_fft->p_im);
+
+        for (l = 0; l < FFT_LANES; l++) {
+            tixel = g * FFT_LANES + l;
+            if (tixel >= p_fft->num)
+                break;
+
+            p_power = p_fft->p_power + (size_t)tixel * p_fft->bins;
+            for (k = 0; k < p_fft->bins; k++) {
+                power = p_fft->p_re[k * FFT_LANES + l] * p_fft->p_re[k * FFT_LANES + l] +
+                        p_fft->p_im[k * FFT_LANES + l] * p_fft->p_im[k * FFT_LANES + l];
+                /* one-sided, except DC and nyquist */
+                if ((k > 0) && (k < length / 2))
+                    power *= 2;
+                p_power[k] += power * scale;
+            }
+        }
+    }
+
+    p_fft->segments += 1;
+}
+/*
+ * Function:  noise_fft_add_frame
+ * --------------------
+ * buffer one frame into the current segment,
+ * the segment is transformed once length frames are buffered
+ */
+void noise_fft_add_frame(struct noise_fft *p_fft, const short *p_image)
+{
+    int i;
+    float *p_frame;
+
+    if (!p_fft || !p_image || (p_fft->num <= 0) || !p_fft->p_segment)
+        return;
+
+    p_fft->last_ns = datalog_get_time_ns();
+    if (p_fft->frames == 0)
+        p_fft->first_ns = p_fft->last_ns;
+
+    p_frame = p_fft->p_segment + p_fft->filled * FFT_LANES;
+    for (i = 0; i < p_fft->num; i++) {
+        p_frame[(size_t)(i / FFT_LANES) * p_fft->length * FFT_LANES + (i % FFT_LANES)] =
+                p_image[i];
+    }
+
+    p_fft->frames += 1;
+    p_fft->filled += 1;
+
+    if (p_fft->filled >= p_fft->length) {
+        noise_fft_process_segment(p_fft);
+        p_fft->filled = 0;
+    }
+}
+/*
+ * Function:  noise_fft_get_frame_rate
+ * --------------------
+ * get the frame rate used for the frequency in Hz,
+ * measured from the frame arrival if it is not configured
+ *
+ * return: the frame rate, 0 if it is unknown
+ */
+float noise_fft_get_frame_rate(struct noise_fft *p_fft)
+{
+    if (!p_fft)
+        return 0;
+
+    if (p_fft->frame_rate > 0)
+        return p_fft->frame_rate;
+
+    if ((p_fft->frames < 2) || (p_fft->last_ns <= p_fft->first_ns))
+        return 0;
+
+    return (float)((double)(p_fft->frames - 1) * 1000000000.0 /
+                   (double)(p_fft->last_ns - p_fft->first_ns));
+}
+/*
+ * Function:  noise_fft_get_spectrum
+ * --------------------
+ * get the power spectrum averaged over segments, length / 2 + 1 bins
+ * if tixel is < 0, the spectrum is the average of all tixels
+ *
+ * return: <0, invalid parameter or no segment transformed
+ *         otherwise, the number of bins
+ */
+int noise_fft_get_spectrum(struct noise_fft *p_fft, int tixel, float *p_out, int size)
+{
+    int i, k;
+    int bins;
+    float *p_power;
+
+    if (!p_fft || !p_out || (p_fft->num <= 0) || (tixel >= p_fft->num)) {
+        printf_e("%s: invalid parameter (tixel = %d)\n", __FUNCTION__, tixel);
+        return -EINVAL;
+    }
+
+    if (p_fft->segments == 0) {
+        printf_e("%s: no segment is transformed\n", __FUNCTION__);
+        return -ENODATA;
+    }
+
+    bins = (size < p_fft->bins) ? size : p_fft->bins;
+
+    if (tixel >= 0) {
+        p_power = p_fft->p_power + (size_t)tixel * p_fft->bins;
+        for (k = 0; k < bins; k++)
+            p_out[k] = p_power[k] / p_fft->segments;
+        return bins;
+    }
+
+    for (k = 0; k < bins; k++)
+        p_out[k] = 0;
+    for (i = 0; i < p_fft->num; i++) {
+        p_power = p_fft->p_power + (size_t)i * p_fft->bins;
+        for (k = 0; k < bins; k++)
+            p_out[k] += p_power[k];
+    }
+    for (k = 0; k < bins; k++)
+        p_out[k] /= (float)p_fft->num * p_fft->segments;
+
+    return bins;
+}
+/*
+ * Function:  noise_fft_get_result
+ * --------------------
+ * get the per-tixel result of the spectrum
+ * the layout of output is the same as the image
+ *
+ * return: <0, invalid parameter or no segment transformed
+ *         otherwise, the number of tixels
+ */
+int noise_fft_get_result(struct noise_fft *p_fft, int type, float *p_out, int size)
+{
+    int i, k;
+    int num;
+    int peak_bin;
+    float sum;
+    float *p_power;
+
+    if (!p_fft || !p_out || (p_fft->num <= 0)) {
+        printf_e("%s: invalid parameter\n", __FUNCTION__);
+        return -EINVAL;
+    }
+
+    if (p_fft->segments == 0) {
+        printf_e("%s: no segment is transformed\n", __FUNCTION__);
+        return -ENODATA;
+    }
+
+    num = (size < p_fft->num) ? size : p_fft->num;
+
+    for (i = 0; i < num; i++) {
+        p_power = p_fft->p_power + (size_t)i * p_fft->bins;
+
+        peak_bin = 1;
+        sum = 0;
+        for (k = 1; k < p_fft->bins; k++) {
+            sum += p_power[k];
+            if (p_power[k] > p_power[peak_bin])
+                peak_bin = k;
+        }
+
+        switch (type) {
+            case FFT_RESULT_PEAK_BIN:
+                p_out[i] = (float)peak_bin;
+                break;
+            case FFT_RESULT_PEAK_POWER:
+                p_out[i] = p_power[peak_bin] / p_fft->segments;
+                break;
+            case FFT_RESULT_AC_POWER:
+                p_out[i] = sum / p_fft->segments;
+                break;
+            default:
+                printf_e("%s: unknown result type %d\n", __FUNCTION__, type);
+                return -EINVAL;
+        }
+    }
+
+    return num;
+}
+/*
+ * Function:  noise_fft_compare
+ * --------------------
+ * comparison of qsort
+ */
+static int noise_fft_compare(const void *a, const void *b)
+{
+    float x = *(const float *)a;
+    float y = *(const float *)b;
+
+    return (x > y) - (x < y);
+}
+/*
+ * Function:  noise_fft_get_peaks
+ * --------------------
+ * find the dominant frequencies, the local maxima of the panel average
+ * spectrum in descending order of power, DC is excluded
+ * a local maximum within FFT_PEAK_MIN_RATIO of the median bin power is
+ * the noise floor, it is not reported
+ * FFT_PEAK_INFO_MAX values per peak, the order follows enum fft_peak_info
+ *
+ * return: <0, invalid parameter or no segment transformed
+ *         otherwise, the number of peaks
+ */
+int noise_fft_get_peaks(struct noise_fft *p_fft, float *p_out, int size)
+{
+    int retval;
+    int i, k, j;
+    int num_peaks = 0;
+    int max_peaks;
+    int bins;
+    int tixel;
+    float frame_rate;
+    float floor_power;
+    float spectrum[FFT_MAX_LENGTH / 2 + 1];
+    float sorted[FFT_MAX_LENGTH / 2];
+    float *p_power;
+    float *p_peak;
+
+    if (!p_fft || !p_out) {
+        printf_e("%s: invalid parameter\n", __FUNCTION__);
+        return -EINVAL;
+    }
+
+    retval = noise_fft_get_spectrum(p_fft, -1, spectrum, FFT_MAX_LENGTH / 2 + 1);
+    if (retval < 0)
+        return retval;
+
+    bins = retval;
+    frame_rate = noise_fft_get_frame_rate(p_fft);
+
+    /* median bin power except DC as the noise floor */
+    memcpy(sorted, &spectrum[1], sizeof(float) * (bins - 1));
+    qsort(sorted, (size_t)(bins - 1), sizeof(float), noise_fft_compare);
+    floor_power = sorted[(bins - 1) / 2] * FFT_PEAK_MIN_RATIO;
+    max_peaks = size / FFT_PEAK_INFO_MAX;
+    if (max_peaks > FFT_MAX_PEAKS)
+        max_peaks = FFT_MAX_PEAKS;
+
+    for (k = 1; k < bins; k++) {
+        if (spectrum[k] <= floor_power)
+            continue;
+
+        if ((spectrum[k] <= spectrum[k - 1]) ||
+            ((k < bins - 1) && (spectrum[k] < spectrum[k + 1])))
+            continue;
+
+        /* insert in descending order of power */
+        for (j = num_peaks; j > 0; j--) {
+            if (p_out[(j - 1) * FFT_PEAK_INFO_MAX + FFT_PEAK_POWER] >= spectrum[k])
+                break;
+            if (j < max_peaks)
+                memcpy(&p_out[j * FFT_PEAK_INFO_MAX], &p_out[(j - 1) * FFT_PEAK_INFO_MAX],
+                       sizeof(float) * FFT_PEAK_INFO_MAX);
+        }
+        if (j >= max_peaks)
+            continue;
+
+        tixel = 0;
+        for (i = 1; i < p_fft->num; i++) {
+            p_power = p_fft->p_power + (size_t)i * p_fft->bins;
+            if (p_power[k] > p_fft->p_power[(size_t)tixel * p_fft->bins + k])
+                tixel = i;
+        }
+
+        p_peak = &p_out[j * FFT_PEAK_INFO_MAX];
+        p_peak[FFT_PEAK_BIN] = (float)k;
+        p_peak[FFT_PEAK_RATIO] = (float)k / p_fft->length;
+        p_peak[FFT_PEAK_FREQ] = frame_rate * k / p_fft->length;
+        p_peak[FFT_PEAK_POWER] = spectrum[k];
+        p_peak[FFT_PEAK_TIXEL] = (float)tixel;
+
+        if (num_peaks < max_peaks)
+            num_peaks += 1;
+    }
+
+    return num_peaks;
+}
@@ -0,0 +1,87 @@
+/* ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+*
+* Copyright (c) 2012-2016 Synaptics Incorporated. All rights reserved.
+*
+* The information in this file is confidential under the terms
+* of a non-disclosure agreement with Synaptics and is provided
+* AS IS without warranties or guarantees of any kind.
+*
+* The information in this file shall remain the exclusive property
+* of Synaptics and may be the subject of Synaptics patents, in
+* whole or part. Synaptics intellectual property rights in the
+* information in this file are not expressly or implicitly licensed
+* or otherwise transferred to you as a result of such information
+* being made available to you.
+*
+* ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+*/
+
+#ifndef _NOISE_FFT_H__
+#define _NOISE_FFT_H__
+
+/* frames of one fft segment, must be a power of 2 */
+#define FFT_MIN_LENGTH (16)
+#define FFT_MAX_LENGTH (1024)
+
+/* tixels transformed together, one per simd lane */
+#define FFT_LANES (4)
+
+/* max. number of dominant frequencies reported */
+#define FFT_MAX_PEAKS (8)
+
+/* a peak must exceed the median bin power of the panel average by this ratio, 10 dB */
+#define FFT_PEAK_MIN_RATIO (10.0f)
+
+/* type of the per-tixel result, must be equivalent to the same id in java layer */
+enum fft_result_type {
+    FFT_RESULT_PEAK_BIN = 0,        /* bin of the max. power, DC is excluded */
+    FFT_RESULT_PEAK_POWER,
+    FFT_RESULT_AC_POWER,            /* sum of power except DC, equals to the variance */
+};
+
+/* order of the peak information, must be equivalent to the same id in java layer */
+enum fft_peak_info {
+    FFT_PEAK_BIN = 0,
+    FFT_PEAK_RATIO,                 /* frequency relative to the frame rate, bin / length */
+    FFT_PEAK_FREQ,                  /* frequency in Hz, based on the frame rate */
+    FFT_PEAK_POWER,                 /* power of the panel average */
+    FFT_PEAK_TIXEL,                 /* tixel with the max. power at this bin */
+    FFT_PEAK_INFO_MAX,
+};
+
+/*
+ * temporal spectrum of each tixel over a frame stream
+ * frames are buffered into segments of length frames, each segment is
+ * windowed and transformed, the power spectra are averaged over segments
+ */
+struct noise_fft {
+    int num;                        /* number of tixels */
+    int length;                     /* frames of one segment */
+    int bins;                       /* length / 2 + 1 */
+    int filled;                     /* frames in the current segment */
+    unsigned int segments;          /* segments transformed */
+    unsigned int frames;            /* frames accumulated */
+    float frame_rate;               /* 0, measured from the frame arrival */
+    long long first_ns;
+    long long last_ns;
+    float window_power;             /* sum of the squared window */
+    float *p_window;
+    float *p_cos;
+    float *p_sin;
+    unsigned short *p_rev;          /* bit-reversed index */
+    float *p_segment;               /* interleaved by FFT_LANES, [group][frame][lane] */
+    float *p_re;
+    float *p_im;
+    float *p_power;                 /* accumulated power, [tixel][bin] */
+};
+
+int noise_fft_init(struct noise_fft *p_fft, int num, int length, float frame_rate);
+void noise_fft_release(struct noise_fft *p_fft);
+void noise_fft_finish(struct noise_fft *p_fft);
+void noise_fft_add_frame(struct noise_fft *p_fft, const short *p_image);
+float noise_fft_get_frame_rate(struct noise_fft *p_fft);
+int noise_fft_get_spectrum(struct noise_fft *p_fft, int tixel, float *p_out, int size);
+int noise_fft_get_result(struct noise_fft *p_fft, int type, float *p_out, int size);
+int noise_fft_get_peaks(struct noise_fft *p_fft, float *p_out, int size);
+
+#endif // _NOISE_FFT_H__
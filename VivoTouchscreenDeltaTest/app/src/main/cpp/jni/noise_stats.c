@@ -0,0 +1,314 @@
+/* ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+*
+* Copyright (c) 2012-2016 Synaptics Incorporated. All rights reserved.
+*
+* The information in this file is confidential under the terms
+* of a non-disclosure agreement with Synaptics and is provided
+* AS IS without warranties or guarantees of any kind.
+*
+* The information in this file shall remain the exclusive property
+* of Synaptics and may be the subject of Synaptics patents, in
+* whole or part. Synaptics intellectual property rights in the
+* information in this file are not expressly or implicitly licensed
+* or otherwise transferred to you as a result of such information
+* being made available to you.
+*
+* ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+*/
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define STATS_USE_NEON
+#endif
+
+#include "native-lib.h"
+#include "noise_stats.h"
+
+/*
+ * Function:  noise_stats_release
+ * --------------------
+ * release all buffers of the statistics
+ */
+void noise_stats_release(struct noise_stats *p_stats)
+{
+    if (!p_stats)
+        return;
+
+    free(p_stats->p_min);
+    free(p_stats->p_max);
+    free(p_stats->p_threshold);
+    free(p_stats->p_blk_sum);
+    free(p_stats->p_blk_over);
+    free(p_stats->p_sum);
+    free(p_stats->p_sum_sq);
+    free(p_stats->p_over);
+
+    memset(p_stats, 0x00, sizeof(struct noise_stats));
+}
+/*
+ * Function:  noise_stats_reset
+ * --------------------
+ * clear the accumulated statistics, the threshold map is kept
+ */
+void noise_stats_reset(struct noise_stats *p_stats)
+{
+    int i;
+
+    if (!p_stats || (p_stats->num <= 0))
+        return;
+
+    for (i = 0; i < p_stats->num; i++) {
+        p_stats->p_min[i] = 32767;
+        p_stats->p_max[i] = -32768;
+    }
+    memset(p_stats->p_blk_sum, 0x00, sizeof(int) * p_stats->num);
+    memset(p_stats->p_blk_over, 0x00, sizeof(unsigned short) * p_stats->num);
+    memset(p_stats->p_sum, 0x00, sizeof(long long) * p_stats->num);
+    memset(p_stats->p_sum_sq, 0x00, sizeof(long long) * p_stats->num);
+    memset(p_stats->p_over, 0x00, sizeof(unsigned int) * p_stats->num);
+
+    p_stats->frames = 0;
+    p_stats->blk_frames = 0;
+}
+/*
+ * Function:  noise_stats_init
+ * --------------------
+ * allocate the statistics for num tixels
+ * the threshold map is initialized to the max. value, nothing is counted
+ *
+ * return: <0, fail to allocate
+ *         otherwise, succeed
+ */
+int noise_stats_init(struct noise_stats *p_stats, int num)
+{
+    int i;
+
+    if (!p_stats || (num <= 0)) {
+        printf_e("%s: invalid parameter (num = %d)\n", __FUNCTION__, num);
+        return -EINVAL;
+    }
+
+    memset(p_stats, 0x00, sizeof(struct noise_stats));
+
+    p_stats->p_min = malloc(sizeof(short) * num);
+    p_stats->p_max = malloc(sizeof(short) * num);
+    p_stats->p_threshold = malloc(sizeof(short) * num);
+    p_stats->p_blk_sum = malloc(sizeof(int) * num);
+    p_stats->p_blk_over = malloc(sizeof(unsigned short) * num);
+    p_stats->p_sum = malloc(sizeof(long long) * num);
+    p_stats->p_sum_sq = malloc(sizeof(long long) * num);
+    p_stats->p_over = malloc(sizeof(unsigned int) * num);
+    if (!p_stats->p_min || !p_stats->p_max || !p_stats->p_threshold ||
+        !p_stats->p_blk_sum || !p_stats->p_blk_over ||
+        !p_stats->p_sum || !p_stats->p_sum_sq || !p_stats->p_over) {
+        printf_e("%s: fail to allocate the statistics (tixels = %d)\n", __FUNCTION__, num);
+        noise_stats_release(p_stats);
+        return -ENOMEM;
+    }
+
+    p_stats->num = num;
+
+    for (i = 0; i < num; i++)
+        p_stats->p_threshold[i] = 32767;
+
+    noise_stats_reset(p_stats);
+
+    return 0;
+}
+/*
+ * Function:  noise_stats_set_threshold
+ * --------------------
+ * configure the threshold map
+ * if p_map is NULL, all tixels use the same threshold
+ *
+ * return: <0, invalid parameter
+ *         otherwise, succeed
+ */
+int noise_stats_set_threshold(struct noise_stats *p_stats, const short *p_map, int size, int threshold)
+{
+    int i;
+
+    if (!p_stats || (p_stats->num <= 0)) {
+        printf_e("%s: statistics is not initialized\n", __FUNCTION__);
+        return -EINVAL;
+    }
+
+    if (p_map) {
+        if (size != p_stats->num) {
+            printf_e("%s: invalid size of threshold map (size = %d, tixels = %d)\n",
+                     __FUNCTION__, size, p_stats->num);
+            return -EINVAL;
+        }
+        memcpy(p_stats->p_threshold, p_map, sizeof(short) * size);
+    }
+    else {
+        if (threshold > 32767)
+            threshold = 32767;
+        if (threshold < -32768)
+            threshold = -32768;
+
+        for (i = 0; i < p_stats->num; i++)
+            p_stats->p_threshold[i] = (short)threshold;
+    }
+
+    return 0;
+}
+/*
+ * Function:  noise_stats_flush_block
+ * --------------------
+ * helper function to move the block sums into 64-bit sums
+ */
+static void noise_stats_flush_block(struct noise_stats *p_stats)
+{
+    int i;
+
+    for (i = 0; i < p_stats->num; i++) {
+        p_stats->p_sum[i] += p_stats->p_blk_sum[i];
+        p_stats->p_over[i] += p_stats->p_blk_over[i];
+    }
+    memset(p_stats->p_blk_sum, 0x00, sizeof(int) * p_stats->num);
+    memset(p_stats->p_blk_over, 0x00, sizeof(unsigned short) * p_stats->num);
+
+    p_stats->blk_frames = 0;
+}
+/*
+ * Function:  noise_stats_add_frame
+ * --------------------
+ * accumulate one frame into the statistics
+ * the same comparison as the noise test is used, fail if value > threshold
+ */
+void noise_stats_add_frame(struct noise_stats *p_stats, const short *p_image)
+{
+    int i = 0;
+    int num;
+    int value;
+
+    if (!p_stats || !p_image || (p_stats->num <= 0))
+        return;
+
+    num = p_stats->num;
+
+#ifdef STATS_USE_NEON
+    for (; i + 8 <= num; i += 8) {
+        int16x8_t v = vld1q_s16(p_image + i);
+        int16x4_t v_lo = vget_low_s16(v);
+        int16x4_t v_hi = vget_high_s16(v);
+        int32x4_t sq_lo = vmull_s16(v_lo, v_lo);
+        int32x4_t sq_hi = vmull_s16(v_hi, v_hi);
+        uint16x8_t over = vcgtq_s16(v, vld1q_s16(p_stats->p_threshold + i));
+
+        vst1q_s16(p_stats->p_min + i, vminq_s16(vld1q_s16(p_stats->p_min + i), v));
+        vst1q_s16(p_stats->p_max + i, vmaxq_s16(vld1q_s16(p_stats->p_max + i), v));
+
+        vst1q_s32(p_stats->p_blk_sum + i,
+                  vaddw_s16(vld1q_s32(p_stats->p_blk_sum + i), v_lo));
+        vst1q_s32(p_stats->p_blk_sum + i + 4,
+                  vaddw_s16(vld1q_s32(p_stats->p_blk_sum + i + 4), v_hi));
+
+        vst1q_s64((int64_t *)p_stats->p_sum_sq + i,
+                  vaddw_s32(vld1q_s64((int64_t *)p_stats->p_sum_sq + i), vget_low_s32(sq_lo)));
+        vst1q_s64((int64_t *)p_stats->p_sum_sq + i + 2,
+                  vaddw_s32(vld1q_s64((int64_t *)p_stats->p_sum_sq + i + 2), vget_high_s32(sq_lo)));
+        vst1q_s64((int64_t *)p_stats->p_sum_sq + i + 4,
+                  vaddw_s32(vld1q_s64((int64_t *)p_stats->p_sum_sq + i + 4), vget_low_s32(sq_hi)));
+        vst1q_s64((int64_t *)p_stats->p_sum_sq + i + 6,
+                  vaddw_s32(vld1q_s64((int64_t *)p_stats->p_sum_sq + i + 6), vget_high_s32(sq_hi)));
+
+        /* the mask is 0xffff if over, subtraction increases the counter by 1 */
+        vst1q_u16(p_stats->p_blk_over + i, vsubq_u16(vld1q_u16(p_stats->p_blk_over + i), over));
+    }
+#endif
+
+    for (; i < num; i++) {
+        value = p_image[i];
+
+        if (value < p_stats->p_min[i])
+            p_stats->p_min[i] = (short)value;
+        if (value > p_stats->p_max[i])
+            p_stats->p_max[i] = (short)value;
+
+        p_stats->p_blk_sum[i] += value;
+        p_stats->p_sum_sq[i] += value * value;
+
+        if (value > p_stats->p_threshold[i])
+            p_stats->p_blk_over[i] += 1;
+    }
+
+    p_stats->frames += 1;
+    p_stats->blk_frames += 1;
+
+    if (p_stats->blk_frames >= STATS_BLOCK_FRAMES)
+        noise_stats_flush_block(p_stats);
+}
+/*
+ * Function:  noise_stats_get_result
+ * --------------------
+ * get the per-tixel result of the accumulated frames
+ * the layout of output is the same as the image
+ *
+ * return: <0, invalid parameter or no frame accumulated
+ *         otherwise, the number of tixels
+ */
+int noise_stats_get_result(struct noise_stats *p_stats, int type, float *p_out, int size)
+{
+    int i;
+    int num;
+    double sum;
+    double mean;
+    double var;
+
+    if (!p_stats || !p_out || (p_stats->num <= 0)) {
+        printf_e("%s: invalid parameter\n", __FUNCTION__);
+        return -EINVAL;
+    }
+
+    if (p_stats->frames == 0) {
+        printf_e("%s: no frame is accumulated\n", __FUNCTION__);
+        return -ENODATA;
+    }
+
+    num = (size < p_stats->num) ? size : p_stats->num;
+
+    for (i = 0; i < num; i++) {
+        switch (type) {
+            case STATS_RESULT_MIN:
+                p_out[i] = p_stats->p_min[i];
+                break;
+            case STATS_RESULT_MAX:
+                p_out[i] = p_stats->p_max[i];
+                break;
+            case STATS_RESULT_P2P:
+                p_out[i] = p_stats->p_max[i] - p_stats->p_min[i];
+                break;
+            case STATS_RESULT_OVER_COUNT:
+                p_out[i] = (float)(p_stats->p_over[i] + p_stats->p_blk_over[i]);
+                break;
+            case STATS_RESULT_MEAN:
+            case STATS_RESULT_STD:
+            case STATS_RESULT_VARIANCE:
+                sum = (double)(p_stats->p_sum[i] + p_stats->p_blk_sum[i]);
+                mean = sum / p_stats->frames;
+                if (type == STATS_RESULT_MEAN) {
+                    p_out[i] = (float)mean;
+                    break;
+                }
+                /* population variance */
+                var = (double)p_stats->p_sum_sq[i] / p_stats->frames - mean * mean;
+                if (var < 0)
+                    var = 0;
+                p_out[i] = (type == STATS_RESULT_STD) ? (float)sqrt(var) : (float)var;
+                break;
+            default:
+                printf_e("%s: unknown result type %d\n", __FUNCTION__, type);
+                return -EINVAL;
+        }
+    }
+
+    return num;
+}
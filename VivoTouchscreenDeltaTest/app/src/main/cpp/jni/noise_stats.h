@@ -0,0 +1,64 @@
+/* ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+*
+* Copyright (c) 2012-2016 Synaptics Incorporated. All rights reserved.
+*
+* The information in this file is confidential under the terms
+* of a non-disclosure agreement with Synaptics and is provided
+* AS IS without warranties or guarantees of any kind.
+*
+* The information in this file shall remain the exclusive property
+* of Synaptics and may be the subject of Synaptics patents, in
+* whole or part. Synaptics intellectual property rights in the
+* information in this file are not expressly or implicitly licensed
+* or otherwise transferred to you as a result of such information
+* being made available to you.
+*
+* ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+*/
+
+#ifndef _NOISE_STATS_H__
+#define _NOISE_STATS_H__
+
+/*
+ * frames accumulated in the 32-bit block sums before flushed into 64-bit sums
+ * 32768 * (-32768) is the lower bound of int
+ */
+#define STATS_BLOCK_FRAMES (32768)
+
+/* type of the per-tixel result, must be equivalent to the same id in java layer */
+enum stats_result_type {
+    STATS_RESULT_MIN = 0,
+    STATS_RESULT_MAX,
+    STATS_RESULT_MEAN,
+    STATS_RESULT_STD,
+    STATS_RESULT_P2P,
+    STATS_RESULT_VARIANCE,
+    STATS_RESULT_OVER_COUNT,    /* frames where the tixel is over its threshold */
+};
+
+/*
+ * streaming per-tixel statistics of a frame stream
+ * memory is in O(number of tixels), no frame is kept
+ */
+struct noise_stats {
+    int num;                        /* number of tixels */
+    unsigned int frames;            /* frames accumulated */
+    unsigned int blk_frames;        /* frames accumulated in the block sums */
+    short *p_min;
+    short *p_max;
+    short *p_threshold;             /* threshold map */
+    int *p_blk_sum;
+    unsigned short *p_blk_over;
+    long long *p_sum;
+    long long *p_sum_sq;
+    unsigned int *p_over;
+};
+
+int noise_stats_init(struct noise_stats *p_stats, int num);
+void noise_stats_release(struct noise_stats *p_stats);
+void noise_stats_reset(struct noise_stats *p_stats);
+int noise_stats_set_threshold(struct noise_stats *p_stats, const short *p_map, int size, int threshold);
+void noise_stats_add_frame(struct noise_stats *p_stats, const short *p_image);
+int noise_stats_get_result(struct noise_stats *p_stats, int type, float *p_out, int size);
+
+#endif // _NOISE_STATS_H__
@@ -0,0 +1,390 @@
+/* ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+*
+* Copyright (c) 2012-2016 Synaptics Incorporated. All rights reserved.
+*
+* The information in this file is confidential under the terms
+* of a non-disclosure agreement with Synaptics and is provided
+* AS IS without warranties or guarantees of any kind.
+*
+* The information in this file shall remain the exclusive property
+* of Synaptics and may be the subject of Synaptics patents, in
+* whole or part. Synaptics intellectual property rights in the
+* information in this file are not expressly or implicitly licensed
+* or otherwise transferred to you as a result of such information
+* being made available to you.
+*
+* ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+*/
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "native-lib.h"
+#include "native-datalog.h"
+#include "noise_sweep.h"
+
+/* help functions */
+extern int get_image_size(void);
+extern int enable_one_specified_gear(int gear);
+extern int do_noise_frame(short *p_image, int frame_id, int gear_idx);
+extern void callback_sweep_progress(int gear, int frames_done, int frames_total, int frames_failed);
+
+static struct noise_sweep g_sweep;
+
+/* set by another thread to terminate the sweep */
+static volatile bool g_sweep_stop;
+
+/* frames per fft segment, 0 to disable the spectrum analysis */
+static int g_sweep_fft_length;
+
+/*
+ * Function:  noise_sweep_release
+ * --------------------
+ * release the statistics of previous sweep
+ */
+void noise_sweep_release(void)
+{
+    int i;
+
+    for (i = 0; i < SWEEP_MAX_GEARS; i++) {
+        noise_stats_release(&g_sweep.gears[i].stats);
+        noise_fft_release(&g_sweep.gears[i].fft);
+    }
+
+    memset(&g_sweep, 0x00, sizeof(struct noise_sweep));
+}
+/*
+ * Function:  noise_sweep_stop
+ * --------------------
+ * request to terminate the running sweep
+ * the sweep will stop after the current frame
+ */
+void noise_sweep_stop(void)
+{
+    g_sweep_stop = true;
+}
+/*
+ * Function:  noise_sweep_set_fft_length
+ * --------------------
+ * enable the temporal spectrum of each gear in the following sweeps,
+ * length is the frames per fft segment, 0 to disable
+ *
+ * return: <0, invalid length
+ *         otherwise, succeed
+ */
+int noise_sweep_set_fft_length(int length)
+{
+    if ((length != 0) &&
+        ((length < FFT_MIN_LENGTH) || (length > FFT_MAX_LENGTH) || (length & (length - 1)))) {
+        printf_e("%s: invalid fft length %d\n", __FUNCTION__, length);
+        return -EINVAL;
+    }
+
+    g_sweep_fft_length = length;
+    return 0;
+}
+/*
+ * Function:  noise_sweep_wait_settle
+ * --------------------
+ * read and drop the frames after gear switching,
+ * until the mean of |delta| is stable for SWEEP_SETTLE_STABLE_FRAMES frames
+ *
+ * return: the number of frames dropped
+ */
+static int noise_sweep_wait_settle(short *p_image, int num, int gear)
+{
+    int i;
+    int frames = 0;
+    int stable = 0;
+    int mean;
+    int prev_mean = -1;
+    long long sum;
+
+    while ((frames < SWEEP_SETTLE_MAX_FRAMES) && (!g_sweep_stop)) {
+        frames += 1;
+
+        if (do_noise_frame(p_image, 0, gear) < 0) {
+            stable = 0;
+            prev_mean = -1;
+            continue;
+        }
+
+        sum = 0;
+        for (i = 0; i < num; i++)
+            sum += (p_image[i] < 0) ? -p_image[i] : p_image[i];
+        mean = (int)(sum / num);
+
+        /* allowed change is prev_mean / SWEEP_SETTLE_RATIO, at least 1 */
+        if ((prev_mean >= 0) &&
+            (abs(mean - prev_mean) * SWEEP_SETTLE_RATIO <=
+             ((prev_mean > SWEEP_SETTLE_RATIO) ? prev_mean : SWEEP_SETTLE_RATIO)))
+            stable += 1;
+        else
+            stable = 0;
+
+        prev_mean = mean;
+
+        if (stable >= SWEEP_SETTLE_STABLE_FRAMES)
+            break;
+    }
+
+    printf_i("%s: gear %d is settled after %d frames (mean = %d)\n", __FUNCTION__,
+             gear, frames, prev_mean);
+    return frames;
+}
+/*
+ * Function:  noise_sweep_run
+ * --------------------
+ * perform the noise test on all gears in the list
+ * each gear is enabled, settled, then the frames are captured back to back.
+ * per-gear per-tixel statistics are kept for noise_sweep_get_result().
+ * if the fft length is set, the temporal spectrum of each gear is kept as
+ * well, the frame rate is measured from the frames captured back to back.
+ * if the binary log is opened, all captured frames are recorded as well.
+ *
+ * should be called between openTestJNI and closeTestJNI
+ *
+ * return: <0, fail to perform the sweep
+ *         otherwise, the number of frames failed, including the gear errors
+ */
+int noise_sweep_run(const int *p_gears, int num_gears, int frames_per_gear)
+{
+    int retval = 0;
+    int i, f;
+    int num;
+    int gear;
+    int frame_id = 0;
+    int err_cnt = 0;
+    int frames_total;
+    short *p_local = NULL;
+    short *p_image;
+    bool is_logged;
+    bool is_failed;
+    struct noise_sweep_gear *p_gear;
+
+    if (!p_gears || (num_gears <= 0) || (num_gears > SWEEP_MAX_GEARS) || (frames_per_gear <= 0)) {
+        printf_e("%s: invalid parameter (gears = %d, frames = %d)\n", __FUNCTION__,
+                 num_gears, frames_per_gear);
+        return -EINVAL;
+    }
+
+    noise_sweep_release();
+    g_sweep_stop = false;
+
+    num = get_image_size();
+    if (num <= 0) {
+        printf_e("%s: invalid image size %d\n", __FUNCTION__, num);
+        return -ENODEV;
+    }
+
+    p_local = malloc(sizeof(short) * num);
+    if (!p_local) {
+        printf_e("%s: fail to allocate the frame buffer\n", __FUNCTION__);
+        return -ENOMEM;
+    }
+
+    g_sweep.num_gears = num_gears;
+    g_sweep.frames_per_gear = frames_per_gear;
+    g_sweep.num_tixels = num;
+
+    frames_total = num_gears * frames_per_gear;
+
+    for (i = 0; i < num_gears; i++) {
+        p_gear = &g_sweep.gears[i];
+        p_gear->gear = p_gears[i];
+
+        retval = noise_stats_init(&p_gear->stats, num);
+        if (retval < 0)
+            goto exit;
+
+        noise_stats_set_threshold(&p_gear->stats, NULL, 0, g_threshold);
+    }
+
+    for (i = 0; (i < num_gears) && (!g_sweep_stop); i++) {
+        p_gear = &g_sweep.gears[i];
+        gear = p_gear->gear;
+
+        /* change to specified gear */
+        if (enable_one_specified_gear(gear) < 0) {
+            printf_e("%s: fail to change to gear %d\n", __FUNCTION__, gear);
+            /* keep the error message in the binary log */
+            if (datalog_acquire_frame()) {
+                datalog_commit_frame(0, gear, DATALOG_FLAG_GEAR_ERROR, err_msg_out);
+            }
+            p_gear->error_frames = frames_per_gear;
+            err_cnt += frames_per_gear;
+            frame_id += frames_per_gear;
+            callback_sweep_progress(gear, frame_id, frames_total, err_cnt);
+            continue;
+        }
+
+        p_gear->settle_frames = noise_sweep_wait_settle(p_local, num, gear);
+
+        /* the transform buffers are allocated for the current gear only */
+        if (g_sweep_fft_length > 0) {
+            if (noise_fft_init(&p_gear->fft, num, g_sweep_fft_length, 0) < 0)
+                printf_e("%s: fail to initialize the spectrum of gear %d\n", __FUNCTION__, gear);
+        }
+
+        for (f = 0; (f < frames_per_gear) && (!g_sweep_stop); f++) {
+            frame_id += 1;
+            is_failed = false;
+
+            /* read into the record of binary log directly, if it is opened */
+            p_image = datalog_acquire_frame();
+            is_logged = (p_image != NULL);
+            if (!is_logged)
+                p_image = p_local;
+
+            retval = do_noise_frame(p_image, frame_id, gear);
+            if (retval < 0) {
+                if (is_logged)
+                    datalog_commit_frame(frame_id, gear, DATALOG_FLAG_READ_ERROR, err_msg_out);
+                p_gear->error_frames += 1;
+                err_cnt += 1;
+                is_failed = true;
+            }
+            else {
+                noise_stats_add_frame(&p_gear->stats, p_image);
+                noise_fft_add_frame(&p_gear->fft, p_image);
+                if (is_logged)
+                    datalog_commit_frame(frame_id, gear, (retval == 0) ? DATALOG_FLAG_PASS : 0, NULL);
+                if (retval > 0) {
+                    p_gear->fail_frames += 1;
+                    err_cnt += 1;
+                    is_failed = true;
+                }
+            }
+
+            /* a failed frame is reported at once to keep the failure count live */
+            if ((f % SWEEP_PROGRESS_INTERVAL == 0) || (f == frames_per_gear - 1) || is_failed)
+                callback_sweep_progress(gear, frame_id, frames_total, err_cnt);
+        }
+
+        noise_fft_finish(&p_gear->fft);
+
+        printf_i("%s: gear %d completed (frames = %d, settle = %d, error = %d, fail = %d)\n",
+                 __FUNCTION__, gear, p_gear->stats.frames, p_gear->settle_frames,
+                 p_gear->error_frames, p_gear->fail_frames);
+    }
+
+    if (g_sweep_stop)
+        printf_i("%s: sweep is terminated at frame %d\n", __FUNCTION__, frame_id);
+
+    retval = err_cnt;
+
+exit:
+    free(p_local);
+    if (retval < 0)
+        noise_sweep_release();
+
+    return retval;
+}
+/*
+ * Function:  noise_sweep_get_gear_info
+ * --------------------
+ * get the information of the gear in the specified order of the sweep
+ * the order of values follows enum sweep_gear_info
+ *
+ * return: <0, invalid parameter
+ *         otherwise, the number of values
+ */
+int noise_sweep_get_gear_info(int order, int *p_info, int size)
+{
+    int info[SWEEP_INFO_MAX];
+    struct noise_sweep_gear *p_gear;
+
+    if (!p_info || (order < 0) || (order >= g_sweep.num_gears)) {
+        printf_e("%s: invalid parameter (order = %d)\n", __FUNCTION__, order);
+        return -EINVAL;
+    }
+
+    p_gear = &g_sweep.gears[order];
+    info[SWEEP_INFO_GEAR] = p_gear->gear;
+    info[SWEEP_INFO_FRAMES] = (int)p_gear->stats.frames;
+    info[SWEEP_INFO_SETTLE_FRAMES] = p_gear->settle_frames;
+    info[SWEEP_INFO_ERROR_FRAMES] = p_gear->error_frames;
+    info[SWEEP_INFO_FAIL_FRAMES] = p_gear->fail_frames;
+
+    if (size > SWEEP_INFO_MAX)
+        size = SWEEP_INFO_MAX;
+    memcpy(p_info, info, sizeof(int) * size);
+
+    return size;
+}
+/*
+ * Function:  noise_sweep_get_result
+ * --------------------
+ * get the per-tixel result of the gear in the specified order of the sweep
+ * the layout of output is the same as the image read from device
+ * type is one of enum stats_result_type
+ *
+ * return: <0, invalid parameter or no frame captured
+ *         otherwise, the number of tixels
+ */
+int noise_sweep_get_result(int order, int type, float *p_out, int size)
+{
+    if (!p_out || (order < 0) || (order >= g_sweep.num_gears)) {
+        printf_e("%s: invalid parameter (order = %d)\n", __FUNCTION__, order);
+        return -EINVAL;
+    }
+
+    return noise_stats_get_result(&g_sweep.gears[order].stats, type, p_out, size);
+}
+/*
+ * Function:  noise_sweep_get_spectrum
+ * --------------------
+ * get the power spectrum of the gear in the specified order of the sweep
+ * if tixel is < 0, the spectrum is the average of all tixels
+ *
+ * return: <0, invalid parameter or no spectrum
+ *         otherwise, the number of bins
+ */
+int noise_sweep_get_spectrum(int order, int tixel, float *p_out, int size)
+{
+    if (!p_out || (order < 0) || (order >= g_sweep.num_gears)) {
+        printf_e("%s: invalid parameter (order = %d)\n", __FUNCTION__, order);
+        return -EINVAL;
+    }
+
+    return noise_fft_get_spectrum(&g_sweep.gears[order].fft, tixel, p_out, size);
+}
+/*
+ * Function:  noise_sweep_get_fft_result
+ * --------------------
+ * get the per-tixel spectrum result of the gear in the specified order of the sweep
+ * type is one of enum fft_result_type
+ *
+ * return: <0, invalid parameter or no spectrum
+ *         otherwise, the number of tixels
+ */
+int noise_sweep_get_fft_result(int order, int type, float *p_out, int size)
+{
+    if (!p_out || (order < 0) || (order >= g_sweep.num_gears)) {
+        printf_e("%s: invalid parameter (order = %d)\n", __FUNCTION__, order);
+        return -EINVAL;
+    }
+
+    return noise_fft_get_result(&g_sweep.gears[order].fft, type, p_out, size);
+}
+/*
+ * Function:  noise_sweep_get_peaks
+ * --------------------
+ * get the dominant noise frequencies of the gear in the specified order of
+ * the sweep, relative to the frame rate measured on that gear
+ *
+ * return: <0, invalid parameter or no spectrum
+ *         otherwise, the number of peaks
+ */
+int noise_sweep_get_peaks(int order, float *p_out, int size)
+{
+    if (!p_out || (order < 0) || (order >= g_sweep.num_gears)) {
+        printf_e("%s: invalid parameter (order = %d)\n", __FUNCTION__, order);
+        return -EINVAL;
+    }
+
+    return noise_fft_get_peaks(&g_sweep.gears[order].fft, p_out, size);
+}
@@ -0,0 +1,73 @@
+/* ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+*
+* Copyright (c) 2012-2016 Synaptics Incorporated. All rights reserved.
+*
+* The information in this file is confidential under the terms
+* of a non-disclosure agreement with Synaptics and is provided
+* AS IS without warranties or guarantees of any kind.
+*
+* The information in this file shall remain the exclusive property
+* of Synaptics and may be the subject of Synaptics patents, in
+* whole or part. Synaptics intellectual property rights in the
+* information in this file are not expressly or implicitly licensed
+* or otherwise transferred to you as a result of such information
+* being made available to you.
+*
+* ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+*/
+
+#ifndef _NOISE_SWEEP_H__
+#define _NOISE_SWEEP_H__
+
+#include "noise_stats.h"
+#include "noise_fft.h"
+
+#define SWEEP_MAX_GEARS (16)
+
+/* frames to wait for the delta image being settled after gear switching */
+#define SWEEP_SETTLE_MAX_FRAMES (30)
+#define SWEEP_SETTLE_STABLE_FRAMES (3)
+/* settled, if the mean of |delta| changes less than 1/SWEEP_SETTLE_RATIO */
+#define SWEEP_SETTLE_RATIO (10)
+
+/* frames between two progress callbacks */
+#define SWEEP_PROGRESS_INTERVAL (10)
+
+/* order of the gear information, must be equivalent to the same id in java layer */
+enum sweep_gear_info {
+    SWEEP_INFO_GEAR = 0,
+    SWEEP_INFO_FRAMES,
+    SWEEP_INFO_SETTLE_FRAMES,
+    SWEEP_INFO_ERROR_FRAMES,
+    SWEEP_INFO_FAIL_FRAMES,
+    SWEEP_INFO_MAX,
+};
+
+/* per-tixel statistics of one gear */
+struct noise_sweep_gear {
+    int gear;
+    int settle_frames;      /* frames dropped before the image is settled */
+    int error_frames;       /* frames failed to read */
+    int fail_frames;        /* frames with any tixel over the threshold */
+    struct noise_stats stats;
+    struct noise_fft fft;   /* temporal spectrum, if it is enabled */
+};
+
+struct noise_sweep {
+    int num_gears;
+    int frames_per_gear;
+    int num_tixels;
+    struct noise_sweep_gear gears[SWEEP_MAX_GEARS];
+};
+
+int noise_sweep_run(const int *p_gears, int num_gears, int frames_per_gear);
+void noise_sweep_stop(void);
+void noise_sweep_release(void);
+int noise_sweep_get_gear_info(int order, int *p_info, int size);
+int noise_sweep_get_result(int order, int type, float *p_out, int size);
+int noise_sweep_set_fft_length(int length);
+int noise_sweep_get_spectrum(int order, int tixel, float *p_out, int size);
+int noise_sweep_get_fft_result(int order, int type, float *p_out, int size);
+int noise_sweep_get_peaks(int order, float *p_out, int size);
+
+#endif // _NOISE_SWEEP_H__
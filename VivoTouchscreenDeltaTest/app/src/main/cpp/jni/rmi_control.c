@@ -2685,166 +2685,65 @@ void rmi_get_f54_gear_info(char *p_info)
     }
 }
 /*
- * Function:  rmi_write_log_header
+ * Function:  rmi_get_f54_gear_list
  * --------------------
- * write necessary information to the header of log file
+ * helper function to get the list of enabled gears
+ *
+ * return: the number of enabled gears
  */
-void rmi_write_log_header(FILE *pfile, int total_frames, int num_gears)
+int rmi_get_f54_gear_list(unsigned char *p_list, int max_cnt)
 {
-    long sec;
-    time_t t_time_header;
-
-    gettimeofday(&t_val_1, NULL);
-    sec = t_val_1.tv_sec;
-    t_time_header = (time_t)sec;
-
-    fprintf(pfile, "Synaptics APK     recorded at %s\n\n", ctime(&t_time_header));
-    fprintf(pfile, "Interface                : RMI4\n");
-    fprintf(pfile, "Device ID                : %4d\n", rmi_get_asic_type());
-    fprintf(pfile, "Firmware Packrat ID      : %7d\n", rmi_get_build_id());
-    switch(g_report_type){
-        case 2:
-            fprintf(pfile, "Data Type                : RT 2, delta image\n");
-            break;
-        case 94:
-            fprintf(pfile, "Data Type                : RT 94, AMP abs delta image\n");
-            break;
-        default:
-            break;
+    int i;
+    int cnt = 0;
+
+    for (i = 0; i < g_rmi_pdt.number_of_sensing_frequencies; i++) {
+        if ((gear_en[i] == 1) && (cnt < max_cnt)) {
+            p_list[cnt++] = (unsigned char)i;
+        }
     }
-    fprintf(pfile, "Tx Channel               : %d\n", g_rmi_pdt.tx_assigned);
-    fprintf(pfile, "Rx Channel               : %d\n", g_rmi_pdt.rx_assigned);
-    fprintf(pfile, "Total Frames Captured    : %d\n", total_frames);
-    fprintf(pfile, "Number of Frames per Gear: %d\n", total_frames/num_gears);
-    fprintf(pfile, "Number of Frequency Gears Enabled: %d\n", num_gears);
-    fprintf(pfile, "\n");
-    fprintf(pfile, "Delta Threshold          : %4d\n", g_threshold);
-    fprintf(pfile, "\n\n");
+    return cnt;
 }
 /*
  * Function:  rmi_do_noise_test
  * --------------------
  * entry function to perform noise testing
- * to get several delta frames and compare each tixle with threshold
+ * to get one delta frame and compare each tixle with threshold
  * fail, if the value is over the threshold
+ *
+ * the image is stored to p_image, (tx * rx) short data
+ *
+ * return: <0, fail to read the report image, message is kept in err_msg_out
+ *         0, all tixels are within the threshold
+ *         1, any tixel is over the threshold
  */
-bool rmi_do_noise_test(FILE *pfile, char *timestamp, int frame_id, int gear_idx)
+int rmi_do_noise_test(short *p_image, int frame_id, int gear_idx)
 {
     int retval;
-    short *rt_image;
-    bool result = true;
-
-    printf_i("%s: frame id = %d\n", __FUNCTION__, frame_id);
-
-    /* create buffer to store the report data */
+    int i;
     int tx_num = g_rmi_pdt.tx_assigned;
     int rx_num = g_rmi_pdt.rx_assigned;
-    rt_image = (short *) calloc((size_t) (tx_num * rx_num), sizeof(short));
-    if(!rt_image) {
-        printf_e("%s: fail to allocate the buffer for report image acquisition\n", __FUNCTION__);
-        sprintf(err_msg_out, "%s: fail to allocate the buffer for report image acquisition\n", __FUNCTION__);
-        result = false;
-        goto write_file;
-    }
 
-    /* call read_f54_report function to get the RT image */
-    retval = read_rmi_f54_report(g_report_type, rt_image);
-    if(retval < 0){
-        printf_e("%s: fail to read report\n", __FUNCTION__);
-        result = false;
-        goto write_file;
-    }
+    printf_i("%s: frame id = %d, gear = %d\n", __FUNCTION__, frame_id, gear_idx);
 
-
-write_file:
-    /* write data to the log file */
-    if (!pfile){
-        printf_e("%s: pfile is null.\n", __FUNCTION__);
-        result = false;
-        goto exit_func;
+    if (!p_image) {
+        printf_e("%s: p_image is NULL\n", __FUNCTION__);
+        sprintf(err_msg_out, "%s: p_image is NULL.\n", __FUNCTION__);
+        return -EINVAL;
     }
 
-    fprintf(pfile, "%s\n", timestamp);
-    fprintf(pfile, "frame id = %d\n", frame_id);
-    fprintf(pfile, "frequency gear = Gear.%d\n", gear_idx);
-
-    /* save error message to the log */
+    /* call read_f54_report function to get the RT image */
+    retval = read_rmi_f54_report(g_report_type, p_image);
     if(retval < 0){
-        fprintf(pfile, "%s",  err_msg_out);
-        fprintf(pfile, "result = fail\n\n");
-        result = false;
-
-        if (pfile_fail_log) {
-            fprintf(pfile_fail_log, "%s\n", timestamp);
-            fprintf(pfile_fail_log, "frame id = %d\n", frame_id);
-            fprintf(pfile_fail_log, "frequency gear = Gear.%d\n", gear_idx);
-            fprintf(pfile_fail_log, "%s",  err_msg_out);
-            fprintf(pfile_fail_log, "result = fail\n\n");
-        }
-
-        goto exit_func;
+        printf_e("%s: fail to read report\n", __FUNCTION__);
+        return retval;
     }
 
-    /* write testing data */
-    short max_val, min_val;
-
-    max_val = rt_image[0];
-    min_val = max_val;
-
-    for(int i = 0; i < tx_num; i++) {
-        if (i == 0) {
-            fprintf(pfile, "        ");
-            for (int j = 0 ; j < rx_num; j ++)
-                fprintf(pfile, "[R%2d]  ", j);
-            fprintf(pfile, "\n");
-        }
-        fprintf(pfile, "[T%2d]: ", i);
-
-        for(int j = 0; j < rx_num; j++) {
-            fprintf(pfile, "%6d ", rt_image[i*rx_num+ j]);
-
-            /* determine it pass or fail on this Tixel */
-            if (rt_image[i*rx_num+ j] > g_threshold) {
-                result = false;
-            }
-
-            max_val = (max_val > rt_image[i*rx_num+ j])? max_val : rt_image[i*rx_num+ j];
-            min_val = (min_val < rt_image[i*rx_num+ j])? min_val : rt_image[i*rx_num+ j];
-        }
-        fprintf(pfile, "\n");
-    }
-    fprintf(pfile, "max. = %d, min. = %d\n", max_val, min_val);
-    fprintf(pfile, "result = %s \n", (result)?"pass":"fail");
-    fprintf(pfile, "\n");
-
-    if (result == false) {
-        if (pfile_fail_log) {
-            fprintf(pfile_fail_log, "%s\n", timestamp);
-            fprintf(pfile_fail_log, "frame id = %d\n", frame_id);
-            fprintf(pfile_fail_log, "frequency gear = Gear.%d\n", gear_idx);
-
-            for(int i = 0; i < tx_num; i++) {
-                if (i == 0) {
-                    fprintf(pfile_fail_log, "        ");
-                    for (int j = 0 ; j < rx_num; j ++)
-                        fprintf(pfile_fail_log, "[R%2d]  ", j);
-                    fprintf(pfile_fail_log, "\n");
-                }
-                fprintf(pfile_fail_log, "[T%2d]: ", i);
-
-                for(int j = 0; j < rx_num; j++) {
-                    fprintf(pfile_fail_log, "%6d ", rt_image[i*rx_num+ j]);
-                }
-                fprintf(pfile_fail_log, "\n");
-            }
-            fprintf(pfile_fail_log, "max. = %d, min. = %d\n", max_val, min_val);
-            fprintf(pfile_fail_log, "result = fail \n");
-            fprintf(pfile_fail_log, "\n");
+    /* determine it pass or fail on each Tixel */
+    for (i = 0; i < tx_num * rx_num; i++) {
+        if (p_image[i] > g_threshold) {
+            return 1;
         }
     }
 
-exit_func:
-    free(rt_image);
-
-    return result;
+    return 0;
 }
\ No newline at end of file
@@ -1316,6 +1316,7 @@ int rmi_get_identify_info(char *info_buffer);
 int rmi_get_asic_type(void);
 int rmi_get_build_id(void);
 void rmi_get_f54_gear_info(char *p_info);
+int rmi_get_f54_gear_list(unsigned char *p_list, int max_cnt);
 int rmi_get_finger_cap(void);
 int rmi_f54_enable_one_gear(int gear);
 
@@ -1324,10 +1325,7 @@ int rmi_f54_read_report_image(int report_type, short *p_image, int image_col, in
 int read_rmi_f54_report(int type, short *buf);
 
 /* perform noise test with RT2 */
-bool rmi_do_noise_test(FILE *pfile, char *timestamp, int frame_id, int gear_idx);
-
-/* helper to write data log */
-void rmi_write_log_header(FILE *pfile, int total_frames, int num_gears);
+int rmi_do_noise_test(short *p_image, int frame_id, int gear_idx);
 
 
 #endif // _RMI_ACCESS_H__
\ No newline at end of file
@@ -22,6 +22,9 @@
 #include <sys/stat.h>
 
 #include "native-lib.h"
+#include "native-datalog.h"
+#include "noise_stats.h"
+#include "noise_fft.h"
 #include "rmi_control.h"
 #include "tcm_control.h"
 
@@ -30,6 +33,13 @@
 
 #define NUMBER_OF_NODES_TO_SCAN (10)
 
+/* per-tixel statistics over the frames of noise test */
+static struct noise_stats g_noise_stats;
+static bool g_is_noise_stats_started = false;
+
+/* temporal spectrum over the frames of noise test */
+static struct noise_fft g_noise_fft;
+static bool g_is_noise_fft_started = false;
 
 bool is_rmi_dev_existed()
 {
@@ -281,21 +291,39 @@ int enable_one_specified_gear(int gear)
     return retval;
 }
 
-int write_log_header(FILE *pfile, int total_frames, int num_gears)
+int get_log_header_info(struct datalog_header *p_header, int total_frames, int num_gears)
 {
-    if (!pfile) {
-        printf_e("%s: input file pointer is null\n", __FUNCTION__);
+    if (!p_header) {
+        printf_e("%s: input header is null\n", __FUNCTION__);
         return -EINVAL;
     }
 
+    memset(p_header, 0x00, sizeof(struct datalog_header));
+    p_header->report_type = g_report_type;
+    p_header->threshold = g_threshold;
+    p_header->total_frames = (unsigned int)total_frames;
+    p_header->num_gears = (unsigned int)num_gears;
+
     if (g_is_rmi_dev) {
         if (g_is_rmi_dev_initialized) {
-            rmi_write_log_header(pfile, total_frames, num_gears);
+            p_header->interface = DATALOG_IF_RMI;
+            p_header->device_id = rmi_get_asic_type();
+            p_header->build_id = rmi_get_build_id();
+            p_header->tx_num = (unsigned int)g_rmi_pdt.tx_assigned;
+            p_header->rx_num = (unsigned int)g_rmi_pdt.rx_assigned;
+            p_header->num_gears_enabled =
+                (unsigned int)rmi_get_f54_gear_list(p_header->gear_list, DATALOG_MAX_GEARS);
         }
     }
     else if (g_is_tcm_dev) {
         if (g_is_tcm_dev_initialized) {
-            tcm_write_log_header(pfile, total_frames, num_gears);
+            p_header->interface = DATALOG_IF_TCM;
+            p_header->device_id = tcm_get_asic_id();
+            p_header->build_id = tcm_get_build_id();
+            p_header->tx_num = (unsigned int)tcm_get_image_cols();
+            p_header->rx_num = (unsigned int)tcm_get_image_rows();
+            p_header->num_gears_enabled =
+                (unsigned int)tcm_get_gear_list(p_header->gear_list, DATALOG_MAX_GEARS);
         }
     }
 
@@ -345,26 +373,189 @@ int do_test_completion()
     return retval;
 }
 
-bool do_noise_test(FILE *pfile, char *timestamp, int frame_id, int gear_idx)
+int get_image_size(void)
 {
-    bool result = false;
+    int size = 0;
 
-    if (!pfile) {
-        printf_e("%s: input file pointer is null\n", __FUNCTION__);
-        return false;
+    if (g_is_rmi_dev) {
+        if (g_is_rmi_dev_initialized) {
+            size = g_rmi_pdt.tx_assigned * g_rmi_pdt.rx_assigned;
+        }
     }
+    else if (g_is_tcm_dev) {
+        if (g_is_tcm_dev_initialized) {
+            size = tcm_get_image_rows() * tcm_get_image_cols();
+        }
+    }
+    return size;
+}
+
+int do_noise_frame(short *p_image, int frame_id, int gear_idx)
+{
+    int retval = -ENODEV;
+
+    err_msg_out[0] = '\0';
 
     if (g_is_rmi_dev) {
         if (g_is_rmi_dev_initialized) {
-            result = rmi_do_noise_test(pfile, timestamp, frame_id, gear_idx);
+            retval = rmi_do_noise_test(p_image, frame_id, gear_idx);
         }
     }
     else if (g_is_tcm_dev) {
         if (g_is_tcm_dev_initialized) {
-            result = tcm_do_noise_test(pfile, timestamp, frame_id, gear_idx);
+            retval = tcm_do_noise_test(p_image, frame_id, gear_idx);
         }
     }
-    return result;
+    return retval;
+}
+
+bool do_noise_test(int frame_id, int gear_idx)
+{
+    int retval;
+    short *p_image;
+    unsigned short flags;
+
+    /* read the report image into the record of binary log directly */
+    p_image = datalog_acquire_frame();
+    if (!p_image) {
+        printf_e("%s: binary log is not available\n", __FUNCTION__);
+        return false;
+    }
+
+    retval = do_noise_frame(p_image, frame_id, gear_idx);
+    if (retval < 0) {
+        flags = DATALOG_FLAG_READ_ERROR;
+        datalog_commit_frame(frame_id, gear_idx, flags, err_msg_out);
+    }
+    else {
+        if (g_is_noise_stats_started)
+            noise_stats_add_frame(&g_noise_stats, p_image);
+        if (g_is_noise_fft_started)
+            noise_fft_add_frame(&g_noise_fft, p_image);
+
+        flags = (retval == 0)? DATALOG_FLAG_PASS : 0;
+        datalog_commit_frame(frame_id, gear_idx, flags, NULL);
+    }
+
+    return (retval == 0);
+}
+
+int start_noise_stats(const short *p_threshold_map, int size)
+{
+    int retval;
+
+    if (g_is_noise_stats_started)
+        noise_stats_release(&g_noise_stats);
+
+    g_is_noise_stats_started = false;
+
+    retval = noise_stats_init(&g_noise_stats, get_image_size());
+    if (retval < 0) {
+        printf_e("%s: fail to initialize the statistics\n", __FUNCTION__);
+        return retval;
+    }
+
+    /* use the delta threshold on all tixels, if no map is given */
+    retval = noise_stats_set_threshold(&g_noise_stats, p_threshold_map, size, g_threshold);
+    if (retval < 0) {
+        printf_e("%s: fail to set the threshold map\n", __FUNCTION__);
+        noise_stats_release(&g_noise_stats);
+        return retval;
+    }
+
+    g_is_noise_stats_started = true;
+    return 0;
+}
+
+void stop_noise_stats(void)
+{
+    if (g_is_noise_stats_started)
+        noise_stats_release(&g_noise_stats);
+
+    g_is_noise_stats_started = false;
+}
+
+int get_noise_stats_frames(void)
+{
+    if (!g_is_noise_stats_started)
+        return -ENODEV;
+
+    return (int)g_noise_stats.frames;
+}
+
+int get_noise_stats_result(int type, float *p_out, int size)
+{
+    if (!g_is_noise_stats_started) {
+        printf_e("%s: statistics is not started\n", __FUNCTION__);
+        return -ENODEV;
+    }
+
+    return noise_stats_get_result(&g_noise_stats, type, p_out, size);
+}
+
+int start_noise_fft(int length, float frame_rate)
+{
+    int retval;
+
+    if (g_is_noise_fft_started)
+        noise_fft_release(&g_noise_fft);
+
+    g_is_noise_fft_started = false;
+
+    retval = noise_fft_init(&g_noise_fft, get_image_size(), length, frame_rate);
+    if (retval < 0) {
+        printf_e("%s: fail to initialize the spectrum\n", __FUNCTION__);
+        return retval;
+    }
+
+    g_is_noise_fft_started = true;
+    return 0;
+}
+
+void stop_noise_fft(void)
+{
+    if (g_is_noise_fft_started)
+        noise_fft_release(&g_noise_fft);
+
+    g_is_noise_fft_started = false;
+}
+
+float get_noise_fft_frame_rate(void)
+{
+    if (!g_is_noise_fft_started)
+        return 0;
+
+    return noise_fft_get_frame_rate(&g_noise_fft);
+}
+
+int get_noise_fft_spectrum(int tixel, float *p_out, int size)
+{
+    if (!g_is_noise_fft_started) {
+        printf_e("%s: spectrum is not started\n", __FUNCTION__);
+        return -ENODEV;
+    }
+
+    return noise_fft_get_spectrum(&g_noise_fft, tixel, p_out, size);
+}
+
+int get_noise_fft_result(int type, float *p_out, int size)
+{
+    if (!g_is_noise_fft_started) {
+        printf_e("%s: spectrum is not started\n", __FUNCTION__);
+        return -ENODEV;
+    }
+
+    return noise_fft_get_result(&g_noise_fft, type, p_out, size);
+}
+
+int get_noise_fft_peaks(float *p_out, int size)
+{
+    if (!g_is_noise_fft_started) {
+        printf_e("%s: spectrum is not started\n", __FUNCTION__);
+        return -ENODEV;
+    }
+
+    return noise_fft_get_peaks(&g_noise_fft, p_out, size);
 }
 
 bool start_report(bool is_delta, bool is_raw)
@@ -937,6 +937,25 @@ void tcm_get_gear_info(char *p_info)
         }
     }
 }
+/*
+ * Function:  tcm_get_gear_list
+ * --------------------
+ * helper function to get the list of enabled gears
+ *
+ * return: the number of enabled gears
+ */
+int tcm_get_gear_list(unsigned char *p_list, int max_cnt)
+{
+    int i;
+    int cnt = 0;
+
+    for (i = 0; i < 16; i++) {
+        if ((CHECK_BIT(g_tcm_gear_enabled_table, i) != 0x00) && (cnt < max_cnt)) {
+            p_list[cnt++] = (unsigned char)i;
+        }
+    }
+    return cnt;
+}
 /*
  * Function:  tcm_get_finger_cap
  * --------------------
@@ -1087,148 +1106,36 @@ exit:
  * Function:  tcm_do_noise_test
  * --------------------
  * function to perform noise test in tcm
+ * to get one delta frame and compare each tixle with threshold
+ *
+ * the image is stored to p_image, (rows * cols) short data
+ *
+ * return: <0, fail to read the report image, message is kept in err_msg_out
+ *         0, all tixels are within the threshold
+ *         1, any tixel is over the threshold
  */
-bool tcm_do_noise_test(FILE *pfile, char *timestamp, int frame_id, int gear_idx)
+int tcm_do_noise_test(short *p_image, int frame_id, int gear_idx)
 {
     int retval = 0;
-    short *rt_image;
-    bool result = true;
-
-    printf_i("%s: frame id = %d\n", __FUNCTION__, frame_id);
-
-    /* create buffer to store the report data */
+    int i;
     int rows = tcm_get_image_rows();
     int cols = tcm_get_image_cols();
-    rt_image = (short *) calloc((size_t) (rows * cols), sizeof(short));
-    if(!rt_image) {
-        printf_e("%s: fail to allocate the buffer for report image acquisition\n", __FUNCTION__);
-        sprintf(err_msg_out, "%s: fail to allocate the buffer for report image acquisition\n", __FUNCTION__);
-        result = false;
-        goto write_file;
-    }
+
+    printf_i("%s: frame id = %d, gear = %d\n", __FUNCTION__, frame_id, gear_idx);
 
     /* to get the delta report */
-    retval = tcm_read_report_image(rt_image, REPORT_DELTA, cols, rows);
+    retval = tcm_read_report_image(p_image, REPORT_DELTA, cols, rows);
     if(retval < 0){
         printf_e("%s: fail to read delta report\n", __FUNCTION__);
-        result = false;
-        goto write_file;
-    }
-
-
-write_file:
-/* write data to the log file */
-    if (!pfile){
-        printf_e("%s: pfile is null.\n", __FUNCTION__);
-        result = false;
-        goto exit_func;
+        return retval;
     }
 
-    fprintf(pfile, "%s\n", timestamp);
-    fprintf(pfile, "frame id = %d\n", frame_id);
-    fprintf(pfile, "frequency gear = Gear.%d\n", gear_idx);
-
-    /* save error message to the log */
-    if(retval < 0){
-        fprintf(pfile, "%s",  err_msg_out);
-        fprintf(pfile, "result = fail\n\n");
-        result = false;
-
-        if (pfile_fail_log) {
-            fprintf(pfile_fail_log, "%s\n", timestamp);
-            fprintf(pfile_fail_log, "frame id = %d\n", frame_id);
-            fprintf(pfile_fail_log, "frequency gear = Gear.%d\n", gear_idx);
-            fprintf(pfile_fail_log, "%s",  err_msg_out);
-            fprintf(pfile_fail_log, "result = fail\n\n");
+    /* determine it pass or fail on each Tixel */
+    for (i = 0; i < rows * cols; i++) {
+        if (p_image[i] > g_threshold) {
+            return 1;
         }
-
-        goto exit_func;
     }
 
-    /* write testing data */
-    short max_val, min_val;
-
-    max_val = rt_image[0];
-    min_val = max_val;
-
-    for(int i = 0; i < cols; i++) {
-        if (i == 0) {
-            fprintf(pfile, "        ");
-            for (int j = 0 ; j < rows; j ++)
-                fprintf(pfile, "[R%2d]  ", j);
-            fprintf(pfile, "\n");
-        }
-        fprintf(pfile, "[T%2d]: ", i);
-
-        for(int j = 0; j < rows; j++) {
-            fprintf(pfile, "%6d ", rt_image[i*rows+ j]);
-
-            /* determine it pass or fail on this Tixel */
-            if (rt_image[i*rows+ j] > g_threshold) {
-                result = false;
-            }
-
-            max_val = (max_val > rt_image[i*rows+ j])? max_val : rt_image[i*rows+ j];
-            min_val = (min_val < rt_image[i*rows+ j])? min_val : rt_image[i*rows+ j];
-        }
-        fprintf(pfile, "\n");
-    }
-    fprintf(pfile, "max. = %d, min. = %d\n", max_val, min_val);
-    fprintf(pfile, "result = %s \n", (result)?"pass":"fail");
-    fprintf(pfile, "\n");
-
-    if (result == false) {
-        if (pfile_fail_log) {
-            fprintf(pfile_fail_log, "%s\n", timestamp);
-            fprintf(pfile_fail_log, "frame id = %d\n", frame_id);
-            fprintf(pfile_fail_log, "frequency gear = Gear.%d\n", gear_idx);
-
-            for(int i = 0; i < cols; i++) {
-                if (i == 0) {
-                    fprintf(pfile_fail_log, "        ");
-                    for (int j = 0 ; j < rows; j ++)
-                        fprintf(pfile_fail_log, "[R%2d]  ", j);
-                    fprintf(pfile_fail_log, "\n");
-                }
-                fprintf(pfile_fail_log, "[T%2d]: ", i);
-
-                for(int j = 0; j < rows; j++) {
-                    fprintf(pfile_fail_log, "%6d ", rt_image[i*rows+ j]);
-                }
-                fprintf(pfile_fail_log, "\n");
-            }
-            fprintf(pfile_fail_log, "max. = %d, min. = %d\n", max_val, min_val);
-            fprintf(pfile_fail_log, "result = fail \n");
-            fprintf(pfile_fail_log, "\n");
-        }
-    }
-exit_func:
-    free(rt_image);
-
-    return result;
-}
-
-void tcm_write_log_header(FILE *pfile, int total_frames, int num_gears)
-{
-    long sec;
-    time_t t_time_header;
-
-    gettimeofday(&t_val_1, NULL);
-    sec = t_val_1.tv_sec;
-    t_time_header = (time_t)sec;
-
-    fprintf(pfile, "Synaptics APK     recorded at %s\n\n", ctime(&t_time_header));
-    fprintf(pfile, "Interface                : ToucnComm\n");
-    fprintf(pfile, "Device ID                : %4d\n", g_tcm_asic_id);
-    fprintf(pfile, "Firmware Packrat ID      : %7d\n", tcm_get_build_id());
-    fprintf(pfile, "Data Type                : RT 2, delta image\n");
-    fprintf(pfile, "Image Columns            : %d\n", tcm_get_image_cols());
-    fprintf(pfile, "Image Rows               : %d\n", tcm_get_image_rows());
-    fprintf(pfile, "Total Frames Captured    : %d\n", total_frames);
-    fprintf(pfile, "Number of Frames per Gear: %d\n", total_frames/num_gears);
-    fprintf(pfile, "Number of Frequency Gears Enabled: %d\n", num_gears);
-    fprintf(pfile, "\n");
-    fprintf(pfile, "Delta Threshold          : %4d\n", g_threshold);
-    fprintf(pfile, "\n\n");
+    return 0;
 }
-
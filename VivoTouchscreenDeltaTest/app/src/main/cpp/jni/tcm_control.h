@@ -164,6 +164,7 @@ int tcm_get_build_id(void);
 int tcm_get_normal_finger_threshold();
 int tcm_get_enabled_gear_table();
 void tcm_get_gear_info(char *p_info);
+int tcm_get_gear_list(unsigned char *p_list, int max_cnt);
 int tcm_get_finger_cap();
 
 /* helper to perform report reading */
@@ -174,10 +175,7 @@ int tcm_read_report_image(short *p_image, unsigned char type, int image_col, int
 int tcm_request_freq_gear(int gear_idx);
 
 /* perform noise test with delta report */
-bool tcm_do_noise_test(FILE *pfile, char *timestamp, int frame_id, int gear_idx);
-
-/* helper to write data log */
-void tcm_write_log_header(FILE *pfile, int total_frames, int num_gears);
+int tcm_do_noise_test(short *p_image, int frame_id, int gear_idx);
 
 
 #endif // _TCM_ACCESS_H__
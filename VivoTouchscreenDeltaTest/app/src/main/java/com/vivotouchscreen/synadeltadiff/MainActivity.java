@@ -469,6 +469,7 @@ public class MainActivity extends AppCompatActivity {
 
         if (is_testing) {
             is_testing = false;
+            native_lib.onStopNoiseSweep();
 
             handler.postDelayed(new Runnable() {
                 @Override
@@ -510,6 +511,7 @@ public class MainActivity extends AppCompatActivity {
                     Log.i(SYNA_TAG, "onKeyDown() + KEYCODE_VOLUME_UP");
                     /* stop the testing */
                     is_testing = false;
+                    native_lib.onStopNoiseSweep();
 
                     handler.postDelayed(new Runnable() {
                         @Override
@@ -684,15 +686,22 @@ public class MainActivity extends AppCompatActivity {
                 Log.i(SYNA_TAG, "deleteLogFile()) + file " + path_file + filename + "_fail.csv is deleted.");
             }
         }
+
+        File bin_log_file = new File(path_file + filename + ".bin");
+        if (bin_log_file.exists()) {
+            if (bin_log_file.delete()) {
+                Log.i(SYNA_TAG, "deleteLogFile()) + file " + path_file + filename + ".bin is deleted.");
+            }
+        }
     }
 
     /**
      * function to perform the noise testing
      * <p>
      * (1) create a thread to perform noise testing
-     * (1) enable one specified gear
-     * (2) get the amount of delta images. if any Tixel > Threshold, it means testing failure
-     * (3) loop (2) and (3) until all available gears finished the test
+     * (2) pass all available gears to the native sweep, each gear is enabled and
+     *     the delta images are captured back to back. if any Tixel > Threshold, it means testing failure
+     * (3) collect the result of each gear after the sweep is completed
      */
     public void doTesting() {
         Log.i(SYNA_TAG, "doTesting() + ");
@@ -700,6 +709,7 @@ public class MainActivity extends AppCompatActivity {
         new Thread(new Runnable() {
             public void run() {
                 boolean ret;
+                int ret_sweep;
                 int gear;
                 int frames;
                 int max_frames_per_gear = test_frames_total / gears.size();
@@ -735,80 +745,81 @@ public class MainActivity extends AppCompatActivity {
                     return;
                 }
 
-                /* walk through all available gears, and enable each one by calling the native method */
+                /* update UI with the progress reported by the native sweep */
+                native_lib.setSweepProgressListener(new NativeWrapper.SweepProgressListener() {
+                    public void onSweepProgress(int gear, int frames_done, int frames_total, int frames_failed) {
+                        /* the test may be stopped before the sweep is started */
+                        if (!is_testing)
+                            native_lib.onStopNoiseSweep();
+
+                        test_frames_current = frames_done;
+                        test_failure_cnt = frames_failed;
+                        test_gear_current = "Gear-" + gear;
+                        runOnUiThread(new Runnable() {
+                            public void run() {
+                                TextGears_testing.setText(test_gear_current);
+                                TextFrames_testing.setText(String.valueOf(test_frames_current));
+                                TextErrCnt.setText(String.valueOf(test_failure_cnt));
+                                Progress.setProgress(test_frames_current);
+                            }
+                        });
+                    }
+                });
+
+                /* walk through all available gears in the native layer */
+                /* the frames of each gear are captured back to back */
+                int[] gear_list = new int[gears.size()];
+                for (int i = 0; i < gears.size(); i++)
+                    gear_list[i] = gears.get(i);
+
+                ret_sweep = native_lib.onNoiseSweep(gear_list, max_frames_per_gear);
+                native_lib.setSweepProgressListener(null);
+                if (ret_sweep < 0) {
+                    Log.e(SYNA_TAG, "doTesting() fail to perform the noise sweep, ret = " + ret_sweep);
+                    test_failure_cnt = test_frames_total;
+                } else {
+                    test_failure_cnt = ret_sweep;
+                }
+
+                /* collect the test detail for each gear */
+                int[] info = new int[native_lib.SWEEP_INFO_SIZE];
                 for (int i = 0; i < gears.size(); i++) {
                     gear = gears.get(i);
-                    test_gear_current = "Gear-" + gear;
-
-                    Log.i(SYNA_TAG, "frequency selection: gear- " + gear);
 
                     if (i != 0)
                         test_result_detail.append("\n");
 
                     test_result_detail.append((i + 1)).append(".  Gear-").append(gear).append(" : ");
 
-                    /* update UI, show current gear selection */
-                    runOnUiThread(new Runnable() {
-                        public void run() {
-                            TextGears_testing.setText(test_gear_current);
-                        }
-                    });
-
-                    /* change to specified gear */
-                    ret = native_lib.setGear(gear);
-                    if (!ret) {
-                        test_result_detail.append("Fail to change gear\n");
-                        test_failure_cnt += test_frames_total / gears.size();
-                        /* update UI, show error information */
-                        /* skip all testing in that gear */
-                        runOnUiThread(new Runnable() {
-                            public void run() {
-                                Progress.incrementProgressBy(test_frames_total / gears.size());
-                                TextErrCnt.setText(String.valueOf(test_failure_cnt));
-                                TextResult_detail.setText(test_result_detail);
-                            }
-                        });
+                    if (!native_lib.getSweepGearInfo(i, info)) {
+                        test_result_detail.append("Fail");
                         continue;
                     }
 
-                    /* do noise testing via the native function */
-                    frames = 0;
-                    err_per_gear = 0;
-                    while ((is_testing) && (frames < max_frames_per_gear)) {
-                        /* do noise testing */
-                        test_frames_current += 1;
-                        ret = native_lib.onNoiseTest(test_frames_current, gear);
-                        if (!ret) {
-                            test_failure_cnt += 1;
-                            err_per_gear += 1;
-                        }
-                        /* update UI, show the testing progress and status */
-                        runOnUiThread(new Runnable() {
-                            public void run() {
-                                TextFrames_testing.setText(String.valueOf(test_frames_current));
-                                Progress.incrementProgressBy(1); /* update progress */
-                                TextErrCnt.setText(String.valueOf(test_failure_cnt));
-                            }
-                        });
-
-                        frames += 1;
-                    }
+                    err_per_gear = info[native_lib.SWEEP_INFO_ERROR_FRAMES] + info[native_lib.SWEEP_INFO_FAIL_FRAMES];
+                    frames = info[native_lib.SWEEP_INFO_FRAMES] + info[native_lib.SWEEP_INFO_ERROR_FRAMES];
 
-                    if (err_per_gear != 0) {
+                    if ((info[native_lib.SWEEP_INFO_FRAMES] == 0) &&
+                            (info[native_lib.SWEEP_INFO_ERROR_FRAMES] == max_frames_per_gear)) {
+                        test_result_detail.append("Fail to change gear");
+                    } else if (err_per_gear != 0) {
                         test_result_detail.append("Fail (error: ").append(err_per_gear).append(")");
-                    } else if ((!is_testing) && (frames < max_frames_per_gear)) {
+                    } else if (frames < max_frames_per_gear) {
                         test_result_detail.append("Terminated");
                     } else {
                         test_result_detail.append("Pass");
                     }
-                    /* update test detail for each gear */
-                    runOnUiThread(new Runnable() {
-                        public void run() {
-                            TextResult_detail.setText(test_result_detail.toString());
-                        }
-                    });
                 }
 
+                /* update test detail and the error count */
+                runOnUiThread(new Runnable() {
+                    public void run() {
+                        Progress.setProgress(test_frames_current);
+                        TextErrCnt.setText(String.valueOf(test_failure_cnt));
+                        TextResult_detail.setText(test_result_detail.toString());
+                    }
+                });
+
 
                 /* close the syna /dev */
                 native_lib.onCloseTest(test_failure_cnt);
@@ -150,6 +150,18 @@ class NativeWrapper {
      */
     private native boolean closeTestJNI(int ng_points);
 
+    /********************************************************
+     * a method to regenerate the text log from the binary log
+     ********************************************************/
+    int onConvertLog(String bin_file, String out_file) {
+        return convertLogJNI(bin_file, out_file);
+    }
+    /**
+     * a native method to convert the binary log to _all.csv and _fail.csv
+     * return the number of converted frames, or negative value if failed
+     */
+    private native int convertLogJNI(String bin_file, String out_file);
+
     /********************************************************
      * a method to perform actual noise testing
      ********************************************************/
@@ -174,6 +186,183 @@ class NativeWrapper {
      */
     private native boolean setGearJNI(int gear_id);
 
+    /********************************************************
+     * a method to keep per-tixel statistics over the noise testing
+     ********************************************************/
+    /* type of per-tixel result, must be equivalent to enum stats_result_type */
+    final int STATS_RESULT_MIN = 0;
+    final int STATS_RESULT_MAX = 1;
+    final int STATS_RESULT_MEAN = 2;
+    final int STATS_RESULT_STD = 3;
+    final int STATS_RESULT_P2P = 4;
+    final int STATS_RESULT_VARIANCE = 5;
+    final int STATS_RESULT_OVER_COUNT = 6;
+
+    boolean onStartNoiseStats(short[] threshold_map) {
+        return startNoiseStatsJNI(threshold_map);
+    }
+    void onStopNoiseStats() {
+        stopNoiseStatsJNI();
+    }
+    int getNoiseStatsFrames() {
+        return getNoiseStatsFramesJNI();
+    }
+    boolean getNoiseStatsResult(int type, float[] result) {
+        return getNoiseStatsResultJNI(type, result);
+    }
+    /**
+     * a native method to start the statistics, the frames of onNoiseTest are accumulated
+     * threshold_map is in the same layout as the report image,
+     * or null to apply the delta threshold to all tixels
+     */
+    private native boolean startNoiseStatsJNI(short[] threshold_map);
+    private native void stopNoiseStatsJNI();
+    /**
+     * native methods to get the number of accumulated frames and the per-tixel result
+     * the per-tixel result is in the same layout as the report image
+     */
+    private native int getNoiseStatsFramesJNI();
+    private native boolean getNoiseStatsResultJNI(int type, float[] result);
+
+    /********************************************************
+     * a method to perform the noise testing on all gears
+     ********************************************************/
+    /* order of gear information, must be equivalent to enum sweep_gear_info */
+    final int SWEEP_INFO_GEAR = 0;
+    final int SWEEP_INFO_FRAMES = 1;
+    final int SWEEP_INFO_SETTLE_FRAMES = 2;
+    final int SWEEP_INFO_ERROR_FRAMES = 3;
+    final int SWEEP_INFO_FAIL_FRAMES = 4;
+    final int SWEEP_INFO_SIZE = 5;
+
+    interface SweepProgressListener {
+        void onSweepProgress(int gear, int frames_done, int frames_total, int frames_failed);
+    }
+    private SweepProgressListener sweep_listener = null;
+
+    void setSweepProgressListener(SweepProgressListener listener) {
+        sweep_listener = listener;
+    }
+    /**
+     * called by native layer during the sweep
+     * frames_failed is the number of failed frames so far, including the gear errors
+     */
+    void callbackSweepProgress(int gear, int frames_done, int frames_total, int frames_failed) {
+        if (sweep_listener != null)
+            sweep_listener.onSweepProgress(gear, frames_done, frames_total, frames_failed);
+    }
+
+    int onNoiseSweep(int[] gears, int frames_per_gear) {
+        return doNoiseSweepJNI(gears, frames_per_gear);
+    }
+    void onStopNoiseSweep() {
+        stopNoiseSweepJNI();
+    }
+    boolean getSweepGearInfo(int order, int[] info) {
+        return getSweepGearInfoJNI(order, info);
+    }
+    boolean getSweepResult(int order, int type, float[] result) {
+        return getSweepResultJNI(order, type, result);
+    }
+    /**
+     * a native method to perform the noise testing on all gears in the list
+     * should be called between onOpenTest and onCloseTest
+     * return the number of failed frames, or negative value if failed
+     */
+    private native int doNoiseSweepJNI(int[] gears, int frames_per_gear);
+    /**
+     * a native method to terminate the running sweep
+     */
+    private native void stopNoiseSweepJNI();
+    /**
+     * native methods to get the result of last sweep
+     * type of per-tixel result is one of STATS_RESULT_*
+     */
+    private native boolean getSweepGearInfoJNI(int order, int[] info);
+    private native boolean getSweepResultJNI(int order, int type, float[] result);
+
+    /********************************************************
+     * a method to analyze the temporal noise spectrum of each tixel
+     * over the noise testing, or of each gear in the sweep
+     ********************************************************/
+    /* frames per fft segment, must be a power of 2 in the range */
+    final int FFT_MIN_LENGTH = 16;
+    final int FFT_MAX_LENGTH = 1024;
+    final int FFT_MAX_PEAKS = 8;
+    /* type of per-tixel result, must be equivalent to enum fft_result_type */
+    final int FFT_RESULT_PEAK_BIN = 0;
+    final int FFT_RESULT_PEAK_POWER = 1;
+    final int FFT_RESULT_AC_POWER = 2;
+    /* order of peak information, must be equivalent to enum fft_peak_info */
+    final int FFT_PEAK_BIN = 0;
+    final int FFT_PEAK_RATIO = 1;
+    final int FFT_PEAK_FREQ = 2;
+    final int FFT_PEAK_POWER = 3;
+    final int FFT_PEAK_TIXEL = 4;
+    final int FFT_PEAK_INFO_SIZE = 5;
+
+    boolean onStartNoiseFft(int length, float frame_rate) {
+        return startNoiseFftJNI(length, frame_rate);
+    }
+    void onStopNoiseFft() {
+        stopNoiseFftJNI();
+    }
+    float getNoiseFftFrameRate() {
+        return getNoiseFftFrameRateJNI();
+    }
+    int getNoiseFftSpectrum(int tixel, float[] spectrum) {
+        return getNoiseFftSpectrumJNI(tixel, spectrum);
+    }
+    boolean getNoiseFftResult(int type, float[] result) {
+        return getNoiseFftResultJNI(type, result);
+    }
+    int getNoiseFftPeaks(float[] peaks) {
+        return getNoiseFftPeaksJNI(peaks);
+    }
+    boolean setSweepFftLength(int length) {
+        return setSweepFftLengthJNI(length);
+    }
+    int getSweepSpectrum(int order, int tixel, float[] spectrum) {
+        return getSweepSpectrumJNI(order, tixel, spectrum);
+    }
+    boolean getSweepFftResult(int order, int type, float[] result) {
+        return getSweepFftResultJNI(order, type, result);
+    }
+    int getSweepPeaks(int order, float[] peaks) {
+        return getSweepPeaksJNI(order, peaks);
+    }
+    /**
+     * a native method to start the spectrum, the frames of onNoiseTest are buffered
+     * into segments of length frames, the power spectra are averaged over segments
+     * frame_rate is used for the frequency in Hz, or 0 to measure from the frames
+     */
+    private native boolean startNoiseFftJNI(int length, float frame_rate);
+    private native void stopNoiseFftJNI();
+    private native float getNoiseFftFrameRateJNI();
+    /**
+     * native methods to get the result of the spectrum
+     * the spectrum is length / 2 + 1 bins, tixel -1 for the average of all tixels
+     * the per-tixel result is in the same layout as the report image
+     * the peaks are FFT_PEAK_INFO_SIZE values each, in descending order of power,
+     * a peak not 10 dB above the median bin power is the noise floor and is not reported
+     * return the number of bins or peaks, or negative value if failed
+     */
+    private native int getNoiseFftSpectrumJNI(int tixel, float[] spectrum);
+    private native boolean getNoiseFftResultJNI(int type, float[] result);
+    private native int getNoiseFftPeaksJNI(float[] peaks);
+    /**
+     * a native method to enable the spectrum of each gear in the following sweeps
+     * length is the frames per fft segment, 0 to disable
+     */
+    private native boolean setSweepFftLengthJNI(int length);
+    /**
+     * native methods to get the spectrum of each gear in last sweep
+     * the frequency in Hz is based on the frame rate measured on that gear
+     */
+    private native int getSweepSpectrumJNI(int order, int tixel, float[] spectrum);
+    private native boolean getSweepFftResultJNI(int order, int type, float[] result);
+    private native int getSweepPeaksJNI(int order, float[] peaks);
+
     /********************************************************
      * a method to reate the specific folder for vivo using
      ********************************************************/